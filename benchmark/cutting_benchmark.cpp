@@ -0,0 +1,65 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "tools/graph_cutter/cutting_utils.h"
+
+namespace {
+// A chain of ADD operators where every operator also reads the output of the operator `skip` steps back, so both
+// directions of the traversal meet many visited operators, like the residual connections of real models.
+void BuildSyntheticGraph(Graph& graph, uint32_t num_ops, uint32_t skip) {
+    std::vector<DataBlob*> blobs = {graph.AddDataBlob("blob_0")};
+    blobs.reserve(num_ops + 1);
+    for (uint32_t op_index = 0; op_index < num_ops; op_index++) {
+        auto* shortcut = blobs[op_index + 1 >= skip ? op_index + 1 - skip : 0];
+        auto* output   = graph.AddDataBlob("blob_" + std::to_string(op_index + 1));
+        graph.AddOperator(OperatorType::ADD, {blobs.back(), shortcut}, {output});
+        blobs.push_back(output);
+    }
+    graph.SetGraphInputs({blobs.front()->GetID()});
+    graph.SetGraphOutputs({blobs.back()->GetID()});
+}
+
+template <typename Func> double MeasureMilliseconds(Func&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void RunBenchmark(uint32_t num_ops) {
+    Model model;
+    auto& graph = model.GetMainGraph();
+    BuildSyntheticGraph(graph, num_ops, 8);
+    // Cut the middle half of the chain.
+    std::vector<std::string> inputs  = {"blob_" + std::to_string(num_ops / 4)};
+    std::vector<std::string> outputs = {"blob_" + std::to_string(num_ops / 4 * 3)};
+
+    CuttingUtils::OperatorIndex index;
+    size_t                      view_ops = 0;
+    auto index_ms = MeasureMilliseconds([&]() { index = CuttingUtils::BuildOperatorIndex(graph); });
+    auto view_ms  = MeasureMilliseconds(
+        [&]() { view_ops = CuttingUtils::CutGraphView(graph, index, inputs, outputs).GetOperators().size(); });
+    auto cut_ms = MeasureMilliseconds([&]() { CuttingUtils::CutGraphImpl(model, inputs, outputs); });
+
+    std::cout << std::setw(10) << num_ops << std::setw(12) << view_ops << std::fixed << std::setprecision(2)
+              << std::setw(14) << index_ms << std::setw(14) << view_ms << std::setw(14) << cut_ms << "\n";
+}
+}  // namespace
+
+// Usage: cutting_benchmark [num_ops ...], 10k, 100k and 1M operators by default.
+int main(int argc, char** argv) {
+    std::vector<uint32_t> sizes = {10000, 100000, 1000000};
+    if (argc > 1) {
+        sizes.clear();
+        for (int arg = 1; arg < argc; arg++) {
+            sizes.push_back(std::stoul(argv[arg]));
+        }
+    }
+    std::cout << std::setw(10) << "ops" << std::setw(12) << "kept_ops" << std::setw(14) << "index_ms" << std::setw(14)
+              << "view_ms" << std::setw(14) << "cut_ms" << "\n";
+    for (auto num_ops : sizes) {
+        RunBenchmark(num_ops);
+    }
+    return 0;
+}
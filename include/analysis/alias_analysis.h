@@ -0,0 +1,29 @@
+#pragma once
+
+#include "model/graph.h"
+
+/**
+ * AliasAnalysis finds activation blobs which don't need memory of their own, because they can live inside another
+ * blob:
+ *   - RESHAPE: outputs of RESHAPE, SQUEEZE, EXPAND_DIMS and CAST to the same type reinterpret their input.
+ *   - IN_PLACE: elementwise ops write the output into an input of the same shape and type, if nothing reads that
+ *     input (or any blob sharing its memory) afterwards.
+ *   - CONCAT_SLICE: inputs of CONCAT and PACK are written by their producers straight into slices of the output.
+ *   - SPLIT_SLICE: outputs of SPLIT and SPLITV are slices of the input.
+ * Slices are only contiguous if every dim before the axis is 1. Aliased blobs must have static shapes, the same data
+ * type and quant params as their base, must not be graph outputs, and can't be written if the base is a graph input or
+ * a constant. Aliases chain, so every alias refers to the root blob which owns the memory, with a byte offset into it.
+ */
+class AliasAnalysis {
+ public:
+    enum class AliasKind { RESHAPE, IN_PLACE, CONCAT_SLICE, SPLIT_SLICE };
+
+    struct Alias {
+        BLOBID_T  blob_id;
+        BLOBID_T  base_id;
+        size_t    byte_offset;
+        AliasKind kind;
+    };
+
+    static std::vector<Alias> Analyze(const Graph& graph);
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "model/graph.h"
+
+/**
+ * CostModel estimates the work of operators analytically from shapes, data types and options. MACs count the
+ * multiply-accumulates of convolutions, matmuls and recurrent cells; FLOPs count MACs twice plus one operation per
+ * element for bias, elementwise, pooling and reduction work (a few per element for softmax). Data movement operators
+ * cost memory traffic only. Weight bytes are the constant inputs as stored, activation bytes the other inputs read and
+ * the outputs written. Blobs with unknown dims count as zero, run shape_specializer first for exact numbers.
+ */
+class CostModel {
+ public:
+    struct OperatorCost {
+        const Operator* op;
+        uint64_t        macs;
+        uint64_t        flops;
+        uint64_t        weight_bytes;
+        uint64_t        input_bytes;
+        uint64_t        output_bytes;
+
+        uint64_t MemoryBytes() const { return weight_bytes + input_bytes + output_bytes; }
+        // FLOPs per byte of memory traffic.
+        double ArithmeticIntensity() const {
+            return MemoryBytes() == 0 ? 0.0 : static_cast<double>(flops) / static_cast<double>(MemoryBytes());
+        }
+    };
+
+    // Peak numbers of the target, an operator below the ridge point (peak_gflops / peak_gbps) is memory bound. The
+    // defaults are in the range of a mobile CPU.
+    struct Roofline {
+        double peak_gflops = 100.0;
+        double peak_gbps   = 25.0;
+
+        bool   IsComputeBound(const OperatorCost& cost) const;
+        // Lower bound of the execution time, i.e. the slower of compute and memory traffic.
+        double EstimateSeconds(const OperatorCost& cost) const;
+    };
+
+    static OperatorCost EstimateOperator(const Graph& graph, const Operator& op);
+
+    // Costs of all operators in execution order.
+    static std::vector<OperatorCost> EstimateGraph(const Graph& graph);
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "analysis/alias_analysis.h"
+#include "model/graph.h"
+
+/**
+ * MemoryPlanner assigns every activation tensor (non-constant blob) an offset in one arena, so that a runtime
+ * allocates once. Lifetimes are intervals over operator execution order: a tensor lives from its producer to its last
+ * consumer, graph inputs from the first operator and graph outputs to the last one. Tensors with overlapping
+ * lifetimes never overlap in the arena. Offset assignment is one of:
+ *   - GREEDY_BY_SIZE: largest tensors first, each one in the smallest gap left between placed tensors it overlaps.
+ *   - BEST_FIT: tensors in execution order, each one in the smallest gap, like a best-fit heap allocator.
+ * Tensors with unknown dims can't be planned and are left out with a warning, use shape_specializer first.
+ * Blobs found by AliasAnalysis get no allocation of their own, their lifetimes extend the blob owning the memory.
+ */
+class MemoryPlanner {
+ public:
+    enum class Strategy { GREEDY_BY_SIZE, BEST_FIT };
+
+    struct Allocation {
+        BLOBID_T blob_id;
+        uint32_t first_op;
+        uint32_t last_op;
+        size_t   bytes;
+        size_t   offset;
+    };
+
+    struct MemoryPlan {
+        std::vector<Allocation>           allocations;
+        std::vector<AliasAnalysis::Alias> aliases;
+        size_t                            alignment;
+        // Arena size with the plan and the sum of all tensor sizes without any reuse.
+        size_t arena_bytes;
+        size_t naive_bytes;
+    };
+
+    static MemoryPlan Plan(const Graph&                             graph,
+                           Strategy                                 strategy,
+                           size_t                                   alignment = 64,
+                           const std::vector<AliasAnalysis::Alias>& aliases   = {});
+
+    // Arena offsets are valid only if tensors which are alive at the same time don't share bytes.
+    static bool Verify(const MemoryPlan& plan);
+
+    // Serialize the plan to be embedded in model metadata, tensors are referred by their exported indices. The layout
+    // is little-endian: uint32 version, uint32 alignment, uint64 arena_bytes, uint32 count, then per tensor uint32
+    // tensor_index, uint32 first_op, uint32 last_op, uint64 offset, uint64 bytes. Aliases follow as uint32 count, then
+    // per alias uint32 tensor_index, uint32 base_tensor_index, uint64 byte_offset.
+    static std::vector<uint8_t> Encode(const MemoryPlan& plan, const std::map<BLOBID_T, uint32_t>& tensor_indices);
+
+    static constexpr const char* metadata_name = "activation_memory_plan";
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "analysis/cost_model.h"
+
+/**
+ * PipelinePartitioner splits the operators of a graph into sequential stages, each one a contiguous range of the
+ * topological order, so that a stage only depends on the model inputs and earlier stages. Operators are weighted by
+ * the roofline time of CostModel. The partition first finds the smallest possible cost of the slowest stage, then,
+ * among partitions whose stages all stay within `tolerance` of it, picks the one with the fewest bytes crossing stage
+ * boundaries. Blobs with unknown dims cross boundaries for free, so the partition is only as good as the shapes.
+ */
+class PipelinePartitioner {
+ public:
+    struct Stage {
+        // Range [begin, end) of the topological order.
+        uint32_t begin;
+        uint32_t end;
+        double   seconds;
+        // Activation blobs read from the model inputs or earlier stages, and blobs which are read by later stages or
+        // are model outputs. Model inputs and outputs come first in their original order.
+        std::vector<BLOBID_T> inputs;
+        std::vector<BLOBID_T> outputs;
+    };
+
+    struct Partition {
+        std::vector<Stage> stages;
+        // Bytes of blobs passed from stage i and earlier to stage i + 1 and later.
+        std::vector<uint64_t> boundary_bytes;
+    };
+
+    static Partition Run(const Graph&               graph,
+                         uint32_t                   num_stages,
+                         const CostModel::Roofline& roofline,
+                         double                     tolerance = 0.1);
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+
+#include "model/graph.h"
+
+/**
+ * RepeatedBlockDetector finds structurally identical blocks, e.g. the layers of a transformer or the residual blocks
+ * of a ResNet stage, so that per-operator work is done once per block shape instead of once per layer.
+ *
+ * A block is a range of consecutive operators in topological order, and a family is a run of consecutive blocks.
+ * Operators at the same position of two blocks must have the same type, options, input/output shapes and data types,
+ * and read the same kind of inputs:
+ *   - constants match by shape and data type only, weights of every layer differ.
+ *   - activations match if they come from the same output of producers at the same distance in topological order,
+ *     i.e. the same operator of the own block or the same operator of the previous block, or if both read the very
+ *     same tensor, e.g. an attention mask shared by all layers.
+ * Candidate block sizes are the distances between repeated operator signatures. The family covering the most
+ * operators is taken first, ties are broken towards smaller blocks, and the search repeats on the rest of the graph.
+ */
+class RepeatedBlockDetector {
+ public:
+    struct BlockFamily {
+        uint32_t                                  num_ops;    // operators per block
+        std::vector<std::vector<const Operator*>> instances;  // operators of every block in topological order
+    };
+
+    // Families in the order they are found, i.e. by covered operators. Blocks have at least `min_block_ops` operators.
+    static std::vector<BlockFamily> Run(const Graph& graph, uint32_t min_block_ops = 2);
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "model/graph.h"
+
+/**
+ * ShapeInference recomputes output shapes and data types of operators from their input shapes, options and constant
+ * inputs (e.g. the shape tensor of RESHAPE), visiting operators once in topological order so that every operator sees
+ * inferred inputs. Unknown dims are kept as -1 and propagate to dependent dims.
+ * Operators which can't be inferred statically (missing constant inputs, bidirectional sequence ops, ...) keep the
+ * shapes they were imported with.
+ */
+class ShapeInference {
+ public:
+    // Return the number of blobs whose shape or data type changed.
+    static uint32_t Run(Graph& graph);
+
+    // Infer outputs of a single operator from the current state of its inputs. Return false if it isn't inferable, the
+    // outputs are left untouched then.
+    static bool InferOperator(const Graph& graph, const Operator& op);
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace common {
+
+// LZ77 byte codec in the block format of LZ4: tokens of literal and match lengths, 16-bit offsets and no entropy
+// coding, which keeps decompression at memory speed. Return the compressed bytes, or false if `src` doesn't decode to
+// exactly `dst_size` bytes.
+std::vector<uint8_t> lz_compress(const uint8_t* src, size_t src_size);
+bool                 lz_decompress(const uint8_t* src, size_t src_size, uint8_t* dst, size_t dst_size);
+
+// A buffer to pack, keyed by the caller. Elements wider than one byte are shuffled byte plane by byte plane before
+// compression, which groups the sign and exponent bytes of floats into long runs.
+struct ArchiveInput {
+    uint32_t       key;
+    const uint8_t* data;
+    size_t         size;
+    uint32_t       element_size;
+};
+
+struct CompressionStats {
+    uint64_t raw_bytes        = 0;
+    uint64_t compressed_bytes = 0;
+    double   seconds          = 0.0;
+};
+
+/**
+ * BufferArchive reads buffers packed by pack_buffers. Every buffer is cut into chunks of `chunk_size` raw bytes that
+ * are compressed on their own, and an index of buffers and chunks precedes the compressed data:
+ *   header:  magic "CTB1", chunk_size, number of buffers, number of chunks (uint32 each)
+ *   buffers: key, element_size (uint32), raw size (uint64), first chunk, number of chunks (uint32)
+ *   chunks:  offset into the data (uint64), stored size, 1 if compressed or 0 if stored raw (uint32)
+ * So chunks decompress in parallel, and any chunk can be read without the ones before it. The archive doesn't own the
+ * bytes, they must outlive it.
+ */
+class BufferArchive {
+ public:
+    BufferArchive(const uint8_t* data, size_t size);
+
+    size_t   num_buffers() const { return buffers_.size(); }
+    uint32_t key(size_t buffer) const { return buffers_[buffer].key; }
+    uint64_t raw_size(size_t buffer) const { return buffers_[buffer].size; }
+    uint32_t num_chunks(size_t buffer) const { return buffers_[buffer].num_chunks; }
+    uint32_t chunk_size() const { return chunk_size_; }
+
+    // Write chunk `chunk` of a buffer, i.e. raw bytes [chunk * chunk_size, (chunk + 1) * chunk_size), to `output`.
+    void unpack_chunk(size_t buffer, uint32_t chunk, uint8_t* output) const;
+    // Write every buffer to outputs[buffer] of raw_size(buffer) bytes, skipping null outputs. Chunks of all buffers
+    // are spread over `num_threads` threads.
+    void unpack(const std::vector<uint8_t*>& outputs, size_t num_threads) const;
+
+ private:
+    struct BufferEntry {
+        uint32_t key;
+        uint32_t element_size;
+        uint64_t size;
+        uint32_t first_chunk;
+        uint32_t num_chunks;
+    };
+    struct ChunkEntry {
+        uint64_t offset;
+        uint32_t stored_size;
+        uint32_t compressed;
+    };
+
+    const uint8_t*           data_;  // compressed chunks
+    size_t                   data_size_;
+    uint32_t                 chunk_size_;
+    std::vector<BufferEntry> buffers_;
+    std::vector<ChunkEntry>  chunks_;
+};
+
+// Pack buffers into one archive, compressing chunks on `num_threads` threads. Chunks that don't shrink are stored raw.
+std::vector<uint8_t> pack_buffers(const std::vector<ArchiveInput>& inputs,
+                                  size_t                           num_threads,
+                                  uint32_t                         chunk_size = 1 << 20);
+
+}  // namespace common
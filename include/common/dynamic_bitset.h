@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace common {
+
+// Fixed size set of dense indices packed in 64-bit words, so that set operations run a word at a time.
+class DynamicBitset {
+ public:
+    DynamicBitset() = default;
+    explicit DynamicBitset(size_t size) : size_(size), words_((size + 63) / 64, 0) {}
+
+    size_t size() const { return size_; }
+
+    bool test(size_t index) const { return (words_[index >> 6] >> (index & 63)) & 1; }
+    void set(size_t index) { words_[index >> 6] |= uint64_t(1) << (index & 63); }
+    // Set the bit and return whether it was clear before, i.e. whether the index is visited for the first time.
+    bool test_and_set(size_t index) {
+        uint64_t mask      = uint64_t(1) << (index & 63);
+        bool     was_clear = (words_[index >> 6] & mask) == 0;
+        words_[index >> 6] |= mask;
+        return was_clear;
+    }
+
+    DynamicBitset& operator&=(const DynamicBitset& other) {
+        for (size_t word = 0; word < words_.size() && word < other.words_.size(); word++) {
+            words_[word] &= other.words_[word];
+        }
+        for (size_t word = other.words_.size(); word < words_.size(); word++) {
+            words_[word] = 0;
+        }
+        return *this;
+    }
+
+    size_t count() const {
+        size_t bits = 0;
+        for (auto word : words_) {
+            bits += __builtin_popcountll(word);
+        }
+        return bits;
+    }
+
+    // Call func(index) for every set bit in increasing order, skipping empty words.
+    template <typename Func> void for_each(Func&& func) const {
+        for (size_t word = 0; word < words_.size(); word++) {
+            for (uint64_t bits = words_[word]; bits != 0; bits &= bits - 1) {
+                func(word * 64 + __builtin_ctzll(bits));
+            }
+        }
+    }
+
+ private:
+    size_t                size_ = 0;
+    std::vector<uint64_t> words_;
+};
+
+}  // namespace common
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace common {
+
+// IEEE 754 binary16 stored in uint16_t. Conversions round to nearest even, values beyond the half range become
+// infinity and NaN becomes a quiet NaN keeping the top bits of its payload, as F16C instructions do.
+uint16_t float_to_half(float value);
+float    half_to_float(uint16_t value);
+
+// Array conversions, with AVX-512 or F16C instructions when the CPU has them and the scalar routines otherwise. Results
+// are the same on every path.
+void float_to_half(const float* input, size_t size, uint16_t* output);
+void half_to_float(const uint16_t* input, size_t size, float* output);
+
+}  // namespace common
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <functional>
+#include <tuple>
+#include <vector>
+#include <stdint.h>
+#include <string.h>
+
+namespace common {
+
+inline void hash_combine(size_t& seed, size_t value) {
+    seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+template <typename _Tp> inline size_t hash_value(const _Tp& value) { return std::hash<_Tp> {}(value); }
+
+template <typename _Tp> inline size_t hash_value(const std::vector<_Tp>& values) {
+    size_t seed = values.size();
+    for (const auto& value : values) {
+        hash_combine(seed, hash_value(value));
+    }
+    return seed;
+}
+
+template <typename... _Tp> inline size_t hash_tuple(const std::tuple<_Tp...>& values) {
+    size_t seed = sizeof...(_Tp);
+    std::apply([&](const auto&... value) { (hash_combine(seed, hash_value(value)), ...); }, values);
+    return seed;
+}
+
+// FNV-style hash over 64-bit words, used to bucket buffers by content. Callers must compare the bytes of buckets
+// that collide, the hash alone doesn't prove equality.
+inline uint64_t hash_bytes(const uint8_t* data, size_t size) {
+    constexpr uint64_t prime = 0x100000001b3ULL;
+    uint64_t           hash  = 0xcbf29ce484222325ULL ^ size;
+    size_t             index = 0;
+    for (; index + sizeof(uint64_t) <= size; index += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, data + index, sizeof(uint64_t));
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 29;
+    }
+    for (; index < size; index++) {
+        hash = (hash ^ data[index]) * prime;
+    }
+    return hash;
+}
+
+}  // namespace common
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <iterator>
 #include <type_traits>
 
 template <typename T> class Range {
@@ -23,6 +24,12 @@ template <typename T> class Range {
 
 template <typename Derived, typename Base, typename Value> class IteratorAdaptor {
  public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef Value                   value_type;
+    typedef std::ptrdiff_t          difference_type;
+    typedef Value*                  pointer;
+    typedef Value                   reference;
+
     IteratorAdaptor(const Base& iter) : m_iterator_(iter) {}
 
     Derived& operator++() {
@@ -35,8 +42,8 @@ template <typename Derived, typename Base, typename Value> class IteratorAdaptor
         return copy;
     }
 
-    bool operator==(const IteratorAdaptor& it) { return m_iterator_ == it.m_iterator_; }
-    bool operator!=(const IteratorAdaptor& it) { return m_iterator_ != it.m_iterator_; }
+    bool operator==(const IteratorAdaptor& it) const { return m_iterator_ == it.m_iterator_; }
+    bool operator!=(const IteratorAdaptor& it) const { return m_iterator_ != it.m_iterator_; }
 
     Value operator*() { return AsDerived().dereference(); }
 
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+namespace common {
+
+// Read-only memory mapping of a whole file. Pages are loaded on first access, so reading a few tables of a large file
+// touches a few pages only.
+class MappedFile {
+ public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return data_; }
+    size_t         size() const { return size_; }
+
+ private:
+    const uint8_t* data_ = nullptr;
+    size_t         size_ = 0;
+};
+
+}  // namespace common
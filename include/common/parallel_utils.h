@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <functional>
+
+namespace common {
+
+// Number of worker threads used when the caller doesn't ask for a specific number, at least 1.
+size_t default_num_threads();
+
+// Call func(index) for every index in [0, count) on up to num_threads threads, each one taking the next index when it
+// is done with the previous one. Return after all calls finished, rethrowing the first exception if any call threw.
+void parallel_for(size_t count, size_t num_threads, const std::function<void(size_t)>& func);
+
+}  // namespace common
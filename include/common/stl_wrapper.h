@@ -5,11 +5,11 @@
 namespace common {
 
 template <typename _Tp, typename _Func> inline auto all_of(_Tp&& container, _Func&& unary_func) {
-    std::all_of(std::begin(container), std::end(container), std::forward<_Func>(unary_func));
+    return std::all_of(std::begin(container), std::end(container), std::forward<_Func>(unary_func));
 }
 
 template <typename _Tp, typename _Func> inline auto any_of(_Tp&& container, _Func&& unary_func) {
-    std::any_of(std::begin(container), std::end(container), std::forward<_Func>(unary_func));
+    return std::any_of(std::begin(container), std::end(container), std::forward<_Func>(unary_func));
 }
 
 template <typename _Tp, typename _Up> inline auto copy(_Tp&& container, _Up output_it) {
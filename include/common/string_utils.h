@@ -19,4 +19,15 @@ std::string lstrip(const std::string& str);
 std::string rstrip(const std::string& str);
 std::string strip(const std::string& str);
 
+// Replace `suffix` at the end of str with `replacement`, or append `replacement` if str doesn't end with it, e.g. the
+// paths of files derived from an output file: replace_suffix("model.tflite", ".tflite", "_stage0.tflite").
+std::string replace_suffix(const std::string& str, const std::string& suffix, const std::string& replacement);
+
+// Parse str as a decimal int into `value`. Return false and leave `value` unchanged if str is not one, e.g. "", "8x"
+// or a number out of the range of int.
+bool parse_int(const std::string& str, int& value);
+
+// Escape quotes, backslashes and control characters so that str can be written inside a JSON string.
+std::string escape_json(const std::string& str);
+
 }  // namespace common
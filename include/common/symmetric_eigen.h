@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <vector>
+
+namespace common {
+
+// Eigen decomposition of the symmetric n x n row-major `matrix` by Householder tridiagonalization and the implicit QL
+// algorithm, O(n^3). Return the eigenvalues in descending order; `matrix` is overwritten with the eigenvectors, row i
+// being the unit eigenvector of eigenvalue i.
+std::vector<double> symmetric_eigen(std::vector<double>& matrix, size_t n);
+
+}  // namespace common
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <algorithm>
+#include <initializer_list>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "common/id_generator.h"
@@ -35,16 +37,86 @@ class Shape {
     std::vector<int> dims_;
 };
 
+// Immutable array shared by every holder of the same values, see QuantValues.
+template <typename T> std::shared_ptr<const std::vector<T>> InternQuantValues(const T* first, const T* last);
+
+// Scales or zero points of a quantized tensor. A single value, i.e. per-tensor quantization, is stored inline without
+// allocating. Per-channel arrays are interned in a pool shared by all blobs, so tensors with equal values (e.g. the
+// all-zero zero points of symmetric quantization) hold one array, and copying a QuantParam never copies it.
+template <typename T> class QuantValues {
+ public:
+    using value_type     = T;
+    using const_iterator = const T*;
+    using iterator       = const T*;
+
+    QuantValues() = default;
+    QuantValues(const std::vector<T>& values) { assign(values.data(), values.data() + values.size()); }
+    QuantValues(std::initializer_list<T> values) { assign(values.begin(), values.end()); }
+
+    void assign(const T* first, const T* last) {
+        size_t size = last - first;
+        // Read the source before releasing the array, `first` may point into it.
+        if (size <= 1) {
+            value_ = size == 0 ? T() : *first;
+            array_.reset();
+        } else {
+            array_ = InternQuantValues(first, last);
+        }
+        size_ = static_cast<uint32_t>(size);
+    }
+
+    size_t   size() const { return size_; }
+    bool     empty() const { return size_ == 0; }
+    const T* data() const { return array_ != nullptr ? array_->data() : &value_; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size_; }
+    const T& operator[](size_t index) const { return data()[index]; }
+
+    std::vector<T> ToVector() const { return std::vector<T>(begin(), end()); }
+
+    friend bool operator==(const QuantValues& lhs, const QuantValues& rhs) {
+        return (lhs.array_ != nullptr && lhs.array_ == rhs.array_) ||
+               (lhs.size_ == rhs.size_ && std::equal(lhs.begin(), lhs.end(), rhs.begin()));
+    }
+    friend bool operator==(const QuantValues& lhs, const std::vector<T>& rhs) {
+        return lhs.size_ == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+    friend bool operator!=(const QuantValues& lhs, const QuantValues& rhs) { return !(lhs == rhs); }
+    friend bool operator!=(const QuantValues& lhs, const std::vector<T>& rhs) { return !(lhs == rhs); }
+
+ private:
+    T                                     value_ = T();
+    uint32_t                              size_  = 0;
+    std::shared_ptr<const std::vector<T>> array_;
+};
+
 class Graph;
 class Operator;
 
 class DataBlob {
  public:
+    // Stored inside the blob, per-tensor parameters need no allocation at all.
     struct QuantParam {
-        float                max;
-        float                min;
-        std::vector<float>   scales;
-        std::vector<int64_t> zero_points;
+        float                max = 0.0f;
+        float                min = 0.0f;
+        QuantValues<float>   scales;
+        QuantValues<int64_t> zero_points;
+        int32_t              quantized_dimension = 0;  // axis of per-channel scales and zero points
+    };
+
+    // Layout of a sparse constant as in TFLite: the buffer holds the non-zero values (or blocks) only, and every
+    // dimension of `traversal_order` is either dense or compressed like the column indices of a CSR matrix.
+    struct SparsityParam {
+        struct DimensionMetadata {
+            bool                 sparse;      // SPARSE_CSR, or DENSE of `dense_size`
+            int32_t              dense_size;
+            std::vector<int32_t> array_segments;
+            std::vector<int32_t> array_indices;
+        };
+
+        std::vector<int32_t>           traversal_order;  // dims of the tensor, then dims of the block
+        std::vector<int32_t>           block_map;        // tensor dim of every block dim
+        std::vector<DimensionMetadata> dim_metadata;     // in traversal order
     };
 
     class OperatorIterator
@@ -73,15 +145,22 @@ class DataBlob {
     DataType GetDataType() const { return data_type_; }
 
     void                    SetProducer(const Operator* op);
+    void                    ResetProducer() { producer_ = INVALID_ID; }
     Operator*               GetProducer() const;
     void                    AddConsumer(const Operator* op);
+    void                    RemoveConsumer(const Operator* op);
     Range<OperatorIterator> GetConsumers() const;
 
     QuantParam&       GetQuantParam() { return *quantization_params_; }
     const QuantParam& GetQuantParam() const { return *quantization_params_; }
-    bool              HasQuantParam() const { return quantization_params_ != nullptr; }
+    bool              HasQuantParam() const { return quantization_params_.has_value(); }
     QuantParam&       CreateQuantParam();
 
+    SparsityParam&       GetSparsityParam() { return *sparsity_params_; }
+    const SparsityParam& GetSparsityParam() const { return *sparsity_params_; }
+    bool                 HasSparsityParam() const { return sparsity_params_ != nullptr; }
+    SparsityParam&       CreateSparsityParam();
+
     friend std::ostream& operator<<(std::ostream& os, const DataBlob& blob);
 
  private:
@@ -91,7 +170,8 @@ class DataBlob {
     NODEID_T              producer_   = INVALID_ID;
     std::vector<NODEID_T> consumers_;
 
-    Shape                       blob_shape_;
-    std::unique_ptr<QuantParam> quantization_params_;
-    std::string                 name_;
+    Shape                          blob_shape_;
+    std::optional<QuantParam>      quantization_params_;
+    std::unique_ptr<SparsityParam> sparsity_params_;
+    std::string                    name_;
 };
@@ -41,6 +41,10 @@ class Graph {
     std::vector<uint8_t>*       GetBuffer(BLOBID_T blob_id);
 
     Operator* AddOperator(OperatorType op_type);
+    // Create an operator and link it with blobs on both sides, i.e. blobs know their producer and consumers.
+    Operator* AddOperator(OperatorType                  op_type,
+                          const std::vector<DataBlob*>& inputs,
+                          const std::vector<DataBlob*>& outputs);
     DataBlob* AddDataBlob(std::string name);
 
     template <typename T> void SetBuffer(BLOBID_T blob_id, const std::vector<T>& buffer) {
@@ -48,18 +52,33 @@ class Graph {
         buffers_[blob_id] = std::vector<uint8_t>(bytes);
         memcpy(buffers_.at(blob_id).data(), buffer.data(), bytes);
     }
+    void SetBuffer(BLOBID_T blob_id, std::vector<uint8_t>&& buffer) { buffers_[blob_id] = std::move(buffer); }
+    // Read an INT32/INT64 constant as int64 values. Return false if the blob isn't an integer constant.
+    bool GetIntegerConstant(BLOBID_T blob_id, std::vector<int64_t>& values) const;
 
     void EraseOperator(Operator* op) { operators_.erase(op->GetID()); }
     void EraseOperator(std::function<bool(const Operator*)>);
-    void EraseBlob(DataBlob* blob) { data_blobs_.erase(blob->GetID()); }
+    void EraseBlob(DataBlob* blob);
     void EraseBlob(std::function<bool(const DataBlob*)>);
 
+    // Unlike EraseOperator, detach the operator from producer/consumer lists of its blobs before erasing it.
+    void RemoveOperator(Operator* op);
+    // Let all consumers of `from` read `to` instead. Graph outputs are not touched.
+    void RedirectConsumers(DataBlob* from, DataBlob* to);
+
+    // Operators sorted in execution order. Ties are broken by operator id, so a graph which is already in topological
+    // order (e.g. freshly imported) keeps its original order.
+    std::vector<Operator*> TopologicalSort() const;
+
     const std::vector<BLOBID_T>& GetGraphInputs() const { return graph_inputs_; }
     const std::vector<BLOBID_T>& GetGraphOutputs() const { return graph_outputs_; }
 
     void SetGraphInputs(const std::vector<BLOBID_T>& inputs) { graph_inputs_ = inputs; }
     void SetGraphOutputs(const std::vector<BLOBID_T>& outputs) { graph_outputs_ = outputs; }
 
+    bool IsGraphInput(BLOBID_T blob_id) const;
+    bool IsGraphOutput(BLOBID_T blob_id) const;
+
  private:
     DataBlobMap data_blobs_;
     OperatorMap operators_;
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "model/graph.h"
+
+/**
+ * GraphView is a read-only subset of a Graph: some of its operators in execution order, the blobs they read and
+ * write, and its own inputs and outputs. Nothing is copied, so a view costs little more than its operator list, and
+ * many views of one graph can be read concurrently as long as the graph isn't modified meanwhile.
+ */
+class GraphView {
+ public:
+    // The whole graph, including blobs which no operator touches.
+    explicit GraphView(const Graph& graph);
+    GraphView(const Graph&                 graph,
+              std::vector<const Operator*> sorted_ops,
+              std::vector<BLOBID_T>        inputs,
+              std::vector<BLOBID_T>        outputs);
+
+    const Graph&                        GetGraph() const { return graph_; }
+    const std::vector<const Operator*>& GetOperators() const { return sorted_ops_; }
+    const std::vector<const DataBlob*>& GetDataBlobs() const { return data_blobs_; }
+    const std::vector<BLOBID_T>&        GetGraphInputs() const { return inputs_; }
+    const std::vector<BLOBID_T>&        GetGraphOutputs() const { return outputs_; }
+
+ private:
+    const Graph&                 graph_;
+    std::vector<const Operator*> sorted_ops_;
+    std::vector<const DataBlob*> data_blobs_;
+    std::vector<BLOBID_T>        inputs_;
+    std::vector<BLOBID_T>        outputs_;
+};
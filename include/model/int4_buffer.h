@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+/**
+ * INT4 buffers pack two values per byte like TFLite does: the element of even index in the low nibble and the next
+ * one in the high nibble, so a tensor of n elements takes (n + 1) / 2 bytes.
+ */
+class Int4Buffer {
+ public:
+    // A view of `size` elements, the packed bytes must outlive it.
+    Int4Buffer(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    size_t size() const { return size_; }
+    // Unpack one element on the fly, sign-extended to [-8, 7].
+    int8_t operator[](size_t index) const {
+        uint8_t nibble = (index & 1) ? data_[index >> 1] >> 4 : data_[index >> 1] & 0x0f;
+        return static_cast<int8_t>((nibble ^ 0x08) - 0x08);
+    }
+
+    static std::vector<uint8_t> Pack(const std::vector<int8_t>& values);
+    static std::vector<int8_t>  Unpack(const uint8_t* data, size_t size);
+
+ private:
+    const uint8_t* data_;
+    size_t         size_;
+};
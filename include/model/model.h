@@ -1,18 +1,28 @@
 #pragma once
 
+#include <map>
+#include <string>
+
 #include "model/graph.h"
 
 struct ModelFlags {};
 
 class Model {
  public:
+    // Named byte buffers which are carried in tflite Metadata, e.g. an activation memory plan.
+    using MetadataMap = std::map<std::string, std::vector<uint8_t>>;
+
     Graph&       GetMainGraph() { return graph_; }
     const Graph& GetMainGraph() const { return graph_; }
 
     ModelFlags&       GetModelFlags() { return flags_; };
     const ModelFlags& GetModelFlags() const { return flags_; };
 
+    void               SetMetadata(const std::string& name, std::vector<uint8_t> data) { metadata_[name] = data; }
+    const MetadataMap& GetMetadata() const { return metadata_; }
+
  private:
-    ModelFlags flags_;
-    Graph      graph_;
+    ModelFlags  flags_;
+    Graph       graph_;
+    MetadataMap metadata_;
 };
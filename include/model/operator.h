@@ -38,9 +38,18 @@ class Operator {
 
     void AddInputBlob(const DataBlob* blob);
     void AddOutputBlob(const DataBlob* blob);
+    // Only updates the operator side, the caller keeps consumer list of blobs consistent.
+    void SetInputBlob(size_t index, const DataBlob* blob);
+    // Only updates the operator side, the caller keeps producers of blobs consistent.
+    void SetOutputBlob(size_t index, const DataBlob* blob);
 
     Range<DataBlobIterator> GetInputBlobs() const;
     Range<DataBlobIterator> GetOutputBlobs() const;
+    DataBlob*               GetInputBlob(size_t index) const;
+    DataBlob*               GetOutputBlob(size_t index) const;
+
+    const std::vector<BLOBID_T>& GetInputIDs() const { return inputs_; }
+    const std::vector<BLOBID_T>& GetOutputIDs() const { return outputs_; }
 
     template <typename T> T* GetOption() {
         if (option_ == nullptr) {
@@ -54,6 +63,10 @@ class Operator {
         return static_cast<const T*>(option_.get());
     }
 
+    bool              HasOption() const { return option_ != nullptr; }
+    const BaseOption* GetBaseOption() const { return option_.get(); }
+    void              SetOption(std::unique_ptr<BaseOption> option) { option_ = std::move(option); }
+
  private:
     const Graph& graph_;
     NODEID_T     node_index_;
@@ -1,10 +1,41 @@
 #pragma once
 
+#include <memory>
+#include <tuple>
 #include <vector>
 
+#include "common/hash_utils.h"
 #include "model/types.h"
 
-struct BaseOption {};
+/**
+ * BaseOption is the type-erased handle stored in Operator. Graph passes compare and hash options through it without
+ * knowing the concrete type, e.g. common subexpression elimination merges operators with equal options.
+ */
+struct BaseOption {
+    virtual ~BaseOption() = default;
+
+    virtual bool                        Equals(const BaseOption& other) const = 0;
+    virtual size_t                      Hash() const                          = 0;
+    virtual std::unique_ptr<BaseOption> Clone() const                         = 0;
+};
+
+/**
+ * OptionImpl implements BaseOption for a concrete option by CRTP. The derived option only lists its fields in Tie(),
+ * which keeps equality and hashing in sync with the fields whenever a new field is added.
+ */
+template <typename Derived> struct OptionImpl : public BaseOption {
+    bool Equals(const BaseOption& other) const override {
+        auto* other_option = dynamic_cast<const Derived*>(&other);
+        return other_option != nullptr && AsDerived().Tie() == other_option->Tie();
+    }
+
+    size_t Hash() const override { return common::hash_tuple(AsDerived().Tie()); }
+
+    std::unique_ptr<BaseOption> Clone() const override { return std::make_unique<Derived>(AsDerived()); }
+
+ private:
+    const Derived& AsDerived() const { return *static_cast<const Derived*>(this); }
+};
 
 /// Define necessary param type in option
 enum Padding { SAME = 0, VALID = 1 };
@@ -12,24 +43,28 @@ enum Padding { SAME = 0, VALID = 1 };
 enum MirrorPadType { REFLECT = 0, SYMMETRIC = 1 };
 
 /// Options based on op type
-struct Conv2DOption : public BaseOption {
+struct Conv2DOption : public OptionImpl<Conv2DOption> {
     int          stride_w;
     int          stride_h;
     int          dilation_w;
     int          dilation_h;
     Padding      pad_type;
     OperatorType activation_type;
+
+    auto Tie() const { return std::tie(stride_w, stride_h, dilation_w, dilation_h, pad_type, activation_type); }
 };
 
-struct Pool2DOption : public BaseOption {
+struct Pool2DOption : public OptionImpl<Pool2DOption> {
     int     stride_w;
     int     stride_h;
     int     filter_w;
     int     filter_h;
     Padding pad_type;
+
+    auto Tie() const { return std::tie(stride_w, stride_h, filter_w, filter_h, pad_type); }
 };
 
-struct DepthwiseConv2DOption : public BaseOption {
+struct DepthwiseConv2DOption : public OptionImpl<DepthwiseConv2DOption> {
     int          stride_w;
     int          stride_h;
     int          dilation_w;
@@ -37,16 +72,22 @@ struct DepthwiseConv2DOption : public BaseOption {
     int          depth_multiplier;
     Padding      pad_type;
     OperatorType activation_type;
+
+    auto Tie() const {
+        return std::tie(stride_w, stride_h, dilation_w, dilation_h, depth_multiplier, pad_type, activation_type);
+    }
 };
 
-struct TransposeConv2DOption : public BaseOption {
+struct TransposeConv2DOption : public OptionImpl<TransposeConv2DOption> {
     int          stride_w;
     int          stride_h;
     Padding      pad_type;
     OperatorType activation_type;
+
+    auto Tie() const { return std::tie(stride_w, stride_h, pad_type, activation_type); }
 };
 
-struct Conv3DOption : public BaseOption {
+struct Conv3DOption : public OptionImpl<Conv3DOption> {
     int          stride_d;
     int          stride_w;
     int          stride_h;
@@ -55,122 +96,190 @@ struct Conv3DOption : public BaseOption {
     int          dilation_h_factor;
     Padding      pad_type;
     OperatorType activation_type;
+
+    auto Tie() const {
+        return std::tie(stride_d, stride_w, stride_h, dilation_d_factor, dilation_w_factor, dilation_h_factor, pad_type,
+                        activation_type);
+    }
 };
 
-struct ReshapeOption : public BaseOption {
+struct ReshapeOption : public OptionImpl<ReshapeOption> {
     std::vector<int32_t> new_shape;
+
+    auto Tie() const { return std::tie(new_shape); }
 };
 
-struct SoftmaxOption : public BaseOption {
+struct SoftmaxOption : public OptionImpl<SoftmaxOption> {
     float beta;
+
+    auto Tie() const { return std::tie(beta); }
 };
 
-struct AddOption : public BaseOption {
+struct AddOption : public OptionImpl<AddOption> {
     bool         pot_scale_int16;
     OperatorType activation_type;
+
+    auto Tie() const { return std::tie(pot_scale_int16, activation_type); }
 };
 
-struct MulOption : public BaseOption {
+struct MulOption : public OptionImpl<MulOption> {
     OperatorType activation_type;
+
+    auto Tie() const { return std::tie(activation_type); }
 };
 
-struct SubOption : public BaseOption {
+struct SubOption : public OptionImpl<SubOption> {
     bool         pot_scale_int16;
     OperatorType activation_type;
+
+    auto Tie() const { return std::tie(pot_scale_int16, activation_type); }
 };
 
-struct DivOption : public BaseOption {
+struct DivOption : public OptionImpl<DivOption> {
     OperatorType activation_type;
+
+    auto Tie() const { return std::tie(activation_type); }
 };
 
-struct ConcatOption : public BaseOption {
+struct ConcatOption : public OptionImpl<ConcatOption> {
     int          axis;
     OperatorType activation_type;
+
+    auto Tie() const { return std::tie(axis, activation_type); }
 };
 
-struct ResizeOption : public BaseOption {
+struct ResizeOption : public OptionImpl<ResizeOption> {
     bool align_corners;
     bool half_pixel_centers;
+
+    auto Tie() const { return std::tie(align_corners, half_pixel_centers); }
 };
 
-struct FullyConnectedOption : public BaseOption {
+struct FullyConnectedOption : public OptionImpl<FullyConnectedOption> {
     bool         keep_num_dims;
     bool         asym_quantize_inputs;
     OperatorType activation_type;
+
+    auto Tie() const { return std::tie(keep_num_dims, asym_quantize_inputs, activation_type); }
 };
 
-struct PackOption : public BaseOption {
+struct PackOption : public OptionImpl<PackOption> {
     int values_count;
     int axis;
+
+    auto Tie() const { return std::tie(values_count, axis); }
 };
 
-struct UnPackOption : public BaseOption {
+struct UnPackOption : public OptionImpl<UnPackOption> {
     int number;
     int axis;
+
+    auto Tie() const { return std::tie(number, axis); }
 };
 
-struct CastOption : public BaseOption {
+struct CastOption : public OptionImpl<CastOption> {
     DataType in_data_type;
     DataType out_data_type;
+
+    auto Tie() const { return std::tie(in_data_type, out_data_type); }
 };
 
-struct GatherOption : public BaseOption {
+struct GatherOption : public OptionImpl<GatherOption> {
     int axis;
     int batch_dims;
+
+    auto Tie() const { return std::tie(axis, batch_dims); }
 };
 
-struct DepthToSpaceOption : public BaseOption {
+struct DepthToSpaceOption : public OptionImpl<DepthToSpaceOption> {
     int block_size;
+
+    auto Tie() const { return std::tie(block_size); }
 };
 
-struct SpaceToDepthOption : public BaseOption {
+struct SpaceToDepthOption : public OptionImpl<SpaceToDepthOption> {
     int block_size;
+
+    auto Tie() const { return std::tie(block_size); }
 };
 
 // For split and splitV
-struct SplitOption : public BaseOption {
+struct SplitOption : public OptionImpl<SplitOption> {
     int num_splits;
+
+    auto Tie() const { return std::tie(num_splits); }
 };
 
-struct StridedSliceOption : public BaseOption {
+struct StridedSliceOption : public OptionImpl<StridedSliceOption> {
     int  begin_mask;
     int  end_mask;
     int  ellipsis_mask;
     int  new_axis_mask;
     int  shrink_axis_mask;
     bool offset;
+
+    auto Tie() const { return std::tie(begin_mask, end_mask, ellipsis_mask, new_axis_mask, shrink_axis_mask, offset); }
 };
 
-struct LeakyReLUOption : public BaseOption {
+struct LeakyReLUOption : public OptionImpl<LeakyReLUOption> {
     float alpha;
+
+    auto Tie() const { return std::tie(alpha); }
 };
 
-struct GELUOption : public BaseOption {
+struct GELUOption : public OptionImpl<GELUOption> {
     float approximate;
+
+    auto Tie() const { return std::tie(approximate); }
 };
 
-struct MirrorPadOption : public BaseOption {
+struct MirrorPadOption : public OptionImpl<MirrorPadOption> {
     MirrorPadType mirror_pad_type;
+
+    auto Tie() const { return std::tie(mirror_pad_type); }
 };
 
-struct OneHotOption : public BaseOption {
+struct OneHotOption : public OptionImpl<OneHotOption> {
     int axis;
+
+    auto Tie() const { return std::tie(axis); }
 };
 
-struct ShapeOption : public BaseOption {
+struct ShapeOption : public OptionImpl<ShapeOption> {
     DataType out_type;
+
+    auto Tie() const { return std::tie(out_type); }
 };
 
-struct ArgMaxOption : public BaseOption {
+struct ArgMaxOption : public OptionImpl<ArgMaxOption> {
     DataType out_type;
+
+    auto Tie() const { return std::tie(out_type); }
 };
 
-struct ArgMinOption : public BaseOption {
+struct ArgMinOption : public OptionImpl<ArgMinOption> {
     DataType out_type;
+
+    auto Tie() const { return std::tie(out_type); }
 };
 
-struct BatchMatmulOption : public BaseOption {
+struct BatchMatmulOption : public OptionImpl<BatchMatmulOption> {
     bool adj_x;
     bool adj_y;
     bool asym_quantize_inputs;
+
+    auto Tie() const { return std::tie(adj_x, adj_y, asym_quantize_inputs); }
+};
+
+// For mean, sum and reduce_* operators
+struct ReducerOption : public OptionImpl<ReducerOption> {
+    bool keep_dims;
+
+    auto Tie() const { return std::tie(keep_dims); }
+};
+
+struct SqueezeOption : public OptionImpl<SqueezeOption> {
+    std::vector<int32_t> squeeze_dims;
+
+    auto Tie() const { return std::tie(squeeze_dims); }
 };
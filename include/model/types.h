@@ -104,6 +104,7 @@ enum class OperatorType {
     REDUCE_ANY,
     REDUCE_ALL,
     WHERE,
+    SHAPE,
     ALL_OP_TYPES
 };
 
@@ -170,6 +171,9 @@ template <> struct DataTypeImpl<DataType::BOOL> {
     typedef bool Type;
 };
 
+// Storage bits of one element, 0 for types without a fixed width, i.e. UNDEFINED and STRING.
+uint32_t GetBitWidth(DataType data_type);
+
 #define ENUM_TYPE_TO_STR_DECLARE(EnumT) std::string ToStr(EnumT)
 
 ENUM_TYPE_TO_STR_DECLARE(OperatorType);
@@ -32,7 +32,11 @@ template <typename Tp, typename Up> class TfLiteOptionResolver : public BaseOpti
     }
 
     void ParseOption(const void* builtin_options, Operator& op) const {
-        auto* option        = op.GetOption<BaseOptionT>();
+        auto* option = op.GetOption<BaseOptionT>();
+        // Options table is optional in flatbuffer, the option keeps default values if the model omits it.
+        if (builtin_options == nullptr) {
+            return;
+        }
         auto* tflite_option = static_cast<const TfLiteOptionT*>(builtin_options);
         ParseOptionImpl(*option, *tflite_option);
     }
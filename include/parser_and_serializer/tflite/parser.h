@@ -1,5 +1,6 @@
 #pragma once
 
+#include "common/buffer_archive.h"
 #include "model/model.h"
 #include "op_resolver.h"
 #include "schema_generated.h"
@@ -8,6 +9,11 @@ class TfLiteParser {
  public:
     std::unique_ptr<Model> ImportModel(const std::string& tflite_file_path);
 
+    // Threads decompressing buffers packed by TfLiteSerializer::EnableCompression, all hardware threads by default.
+    void SetNumThreads(size_t num_threads) { num_threads_ = num_threads; }
+    // Sizes and unpacking time of compressed buffers of the last imported model, zero if it has none.
+    const common::CompressionStats& GetCompressionStats() const { return compression_stats_; }
+
  private:
     void LoadOperators(const tflite::Model& input_model, Model* model);
 
@@ -15,9 +21,17 @@ class TfLiteParser {
 
     void LoadTensors(const tflite::Model& input_model, Model* model);
 
+    void LoadSparsity(const tflite::SparsityParameters& sparsity, DataBlob* data_blob);
+
+    void LoadCompressedBuffers(const tflite::Model& input_model, Model* model);
+
     void LoadInputsOutputs(const tflite::Model& input_model, Model* model);
 
+    void LoadMetadata(const tflite::Model& input_model, Model* model);
+
     OperatorResolver          op_resolver_;
     std::vector<OperatorType> op_type_table_;
     std::vector<DataBlob*>    data_blob_table_;
+    size_t                    num_threads_ = 0;
+    common::CompressionStats  compression_stats_;
 };
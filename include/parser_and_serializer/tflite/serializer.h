@@ -1,6 +1,8 @@
 #pragma once
 
+#include "common/buffer_archive.h"
 #include "flatbuffers/flatbuffers.h"
+#include "model/graph_view.h"
 #include "model/model.h"
 #include "model/types.h"
 #include "parser_and_serializer/tflite/op_resolver.h"
@@ -11,25 +13,71 @@ using flatbuffers::Vector;
 
 class TfLiteSerializer {
  public:
+    // A graph exported as its own subgraph, reachable by the signature key.
+    struct Signature {
+        std::string key;
+        GraphView   graph;
+    };
+
     void ExportToTfLite(const Model& model, std::string output_path);
+    // Export only a view of the main graph, e.g. a cut of it, together with the model metadata. A serializer exports
+    // one model, use one serializer per thread to export views concurrently.
+    void ExportToTfLite(const Model& model, const GraphView& main_graph, std::string output_path);
+    // Export several graphs into one model with one subgraph and SignatureDef per signature, e.g. variants of a
+    // network. Constant buffers with the same content are stored once, so subgraphs share their common weights.
+    void ExportToTfLite(const std::vector<Signature>& signatures, std::string output_path);
+
+    // Pack constant buffers of at least `min_buffer_bytes` into one compressed archive, stored as metadata named
+    // utils::compressed_buffers_name, and leave their tensor buffers empty. The file stays a valid flatbuffer, but only
+    // TfLiteParser restores the constants.
+    void EnableCompression(uint64_t min_buffer_bytes = 1 << 16, size_t num_threads = 0);
+    // Sizes and packing time of the last export with compression enabled.
+    const common::CompressionStats& GetCompressionStats() const { return compression_stats_; }
+
+    // Tensors are exported in the order of their names, so the index of a tensor can be known before exporting, e.g.
+    // to refer tensors in metadata.
+    static std::map<BLOBID_T, uint32_t> GetTensorIndices(const Graph& graph);
+    static std::map<BLOBID_T, uint32_t> GetTensorIndices(const GraphView& graph);
 
  private:
-    Offset<Vector<Offset<tflite::SubGraph>>> ExportSubGraphs(const Model&                    model,
-                                                             flatbuffers::FlatBufferBuilder* builder);
+    // The first graph is the main subgraph. Signatures are exported only when keys are given, one per graph.
+    void ExportModel(const std::vector<const GraphView*>& graphs,
+                     const std::vector<std::string>&      signature_keys,
+                     const Model::MetadataMap&            metadata,
+                     std::string                          output_path);
 
-    Offset<Vector<Offset<tflite::Tensor>>> ExportTensors(const Graph&                    subgraph,
+    Offset<tflite::SubGraph> ExportSubGraph(const GraphView&                subgraph,
+                                            const std::string&              name,
+                                            flatbuffers::FlatBufferBuilder* builder);
+
+    Offset<tflite::SignatureDef> ExportSignatureDef(const GraphView&                subgraph,
+                                                    const std::string&              key,
+                                                    uint32_t                        subgraph_index,
+                                                    flatbuffers::FlatBufferBuilder* builder);
+
+    Offset<Vector<Offset<tflite::Tensor>>> ExportTensors(const GraphView&                subgraph,
                                                          flatbuffers::FlatBufferBuilder* builder);
 
-    Offset<Vector<Offset<tflite::Operator>>> ExportOperators(const Graph&                    subgraph,
+    Offset<tflite::SparsityParameters> ExportSparsity(const DataBlob::SparsityParam&  sparsity,
+                                                      flatbuffers::FlatBufferBuilder* builder);
+
+    Offset<Vector<Offset<tflite::Operator>>> ExportOperators(const GraphView&                subgraph,
                                                              flatbuffers::FlatBufferBuilder* builder);
 
-    Offset<Vector<Offset<tflite::OperatorCode>>> ExportOpCodes(const Model&                    model,
-                                                               flatbuffers::FlatBufferBuilder* builder);
+    Offset<Vector<Offset<tflite::OperatorCode>>> ExportOpCodes(const std::vector<const GraphView*>& graphs,
+                                                               flatbuffers::FlatBufferBuilder*      builder);
 
-    std::vector<Offset<tflite::Buffer>> ExportBuffers(const Model& model, flatbuffers::FlatBufferBuilder* builder);
+    std::vector<Offset<tflite::Buffer>> ExportBuffers(const std::vector<const GraphView*>& graphs,
+                                                      flatbuffers::FlatBufferBuilder*      builder);
 
     OperatorResolver             op_resolver_;
     std::vector<OperatorType>    op_type_table_;
     std::map<BLOBID_T, uint32_t> data_blob_index_map_;
     std::map<BLOBID_T, uint32_t> buffer_index_map_;
+
+    bool                              compression_enabled_   = false;
+    uint64_t                          compression_min_bytes_ = 0;
+    size_t                            compression_threads_   = 0;
+    std::vector<common::ArchiveInput> archive_inputs_;
+    common::CompressionStats          compression_stats_;
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "model/options.h"
@@ -8,6 +9,9 @@
 #include "schema_generated.h"
 
 namespace utils {
+// Metadata entry holding the constant buffers packed by TfLiteSerializer::EnableCompression.
+constexpr char compressed_buffers_name[] = "custom_tflite_compressed_buffers";
+
 std::string GetContents(const std::string& model_path);
 
 template <typename T> std::vector<T> GetVecData(const ::flatbuffers::Vector<T>* flatbuffer_vec) {
@@ -27,4 +31,10 @@ Padding           GetMappedPaddingOf(::tflite::Padding padding);
 OperatorType                     GetMappedActTypeOf(::tflite::ActivationFunctionType op_code);
 ::tflite::ActivationFunctionType GetMappedActTypeOf(OperatorType op_code);
 
+// Array segments or indices of a sparse dimension, empty if absent.
+std::vector<int32_t> GetSparseIndices(::tflite::SparseIndexVector type, const void* indices);
+// Stored as the narrowest vector type holding all values.
+std::pair<::tflite::SparseIndexVector, ::flatbuffers::Offset<void>>
+CreateSparseIndices(::flatbuffers::FlatBufferBuilder& builder, const std::vector<int32_t>& indices);
+
 }  // namespace utils
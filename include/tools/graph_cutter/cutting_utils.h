@@ -1,18 +1,74 @@
-#include <set>
+#include <istream>
+#include <unordered_map>
 #include <vector>
 
+#include "common/dynamic_bitset.h"
+#include "model/graph_view.h"
 #include "model/model.h"
 
 class CuttingUtils {
  public:
+    // Operators of a graph numbered densely in topological order, with successors and predecessors in CSR form, i.e.
+    // the neighbours of operator i are adjacency[offsets[i], offsets[i + 1]). Reachability is computed on bitsets over
+    // these indices, build the index once and share it between cuts of the same graph.
+    struct OperatorIndex {
+        std::vector<Operator*>                 sorted_ops;
+        std::unordered_map<NODEID_T, uint32_t> op_indices;
+        std::vector<uint32_t>                  successor_offsets;
+        std::vector<uint32_t>                  successors;
+        std::vector<uint32_t>                  predecessor_offsets;
+        std::vector<uint32_t>                  predecessors;
+    };
+
+    // One cut of a batch run.
+    struct CutJob {
+        std::vector<std::string> input_tensors;
+        std::vector<std::string> output_tensors;
+        std::string              output_path;
+    };
+
+    static OperatorIndex BuildOperatorIndex(const Graph& graph);
+
+    // One job per line as `<from> <to> <output_tflite>`, tensors separated by ','. Blank lines and lines starting with
+    // '#' are skipped. `source` names the input in errors.
+    static std::vector<CutJob> ParseJobs(std::istream& jobs, const std::string& source);
+
     static void CutGraphImpl(Model&                          model,
                              const std::vector<std::string>& input_tensors,
                              const std::vector<std::string>& output_tensors);
 
+    // Same cut as CutGraphImpl as a view, leaving the graph untouched so that many cuts can share one import and one
+    // index. Operators of the view keep the topological order of the index.
+    static GraphView CutGraphView(const Graph&                    graph,
+                                  const OperatorIndex&            index,
+                                  const std::vector<std::string>& input_tensors,
+                                  const std::vector<std::string>& output_tensors);
+
+    // The operators in range [begin, end) of the topological order of the index as a view, e.g. one stage of a
+    // pipeline partition.
+    static GraphView CutStageView(const Graph&          graph,
+                                  const OperatorIndex&  index,
+                                  uint32_t              begin,
+                                  uint32_t              end,
+                                  std::vector<BLOBID_T> inputs,
+                                  std::vector<BLOBID_T> outputs);
+
  private:
-    static std::set<const Operator*> CollectOpsForward(const Graph& graph, const std::vector<BLOBID_T>&);
+    static std::vector<BLOBID_T> FindBlobs(const Graph& graph, const std::vector<std::string>& tensors);
+
+    // Operators on paths from the inputs to the outputs, i.e. reachable forward from the inputs and backward from the
+    // outputs.
+    static common::DynamicBitset CollectOpsBetween(const Graph&                 graph,
+                                                   const OperatorIndex&         index,
+                                                   const std::vector<BLOBID_T>& inputs,
+                                                   const std::vector<BLOBID_T>& outputs);
 
-    static std::set<const Operator*> CollectOpsBackward(const Graph& graph, const std::vector<BLOBID_T>&);
+    // Breadth-first search from `seeds` along the CSR adjacency.
+    static common::DynamicBitset CollectReachableOps(const std::vector<uint32_t>& offsets,
+                                                     const std::vector<uint32_t>& adjacency,
+                                                     const std::vector<uint32_t>& seeds);
 
-    static void RemoveUnnecessaryOpsAndBlobs(Graph& graph, const std::set<const Operator*>& ops_to_keep);
+    static void RemoveUnnecessaryOpsAndBlobs(Graph&                       graph,
+                                             const OperatorIndex&         index,
+                                             const common::DynamicBitset& ops_to_keep);
 };
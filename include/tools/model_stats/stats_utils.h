@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+
+#include "common/mapped_file.h"
+
+class StatsUtils {
+ public:
+    struct TypeStats {
+        uint64_t tensors    = 0;
+        uint64_t parameters = 0;
+        uint64_t bytes      = 0;
+    };
+
+    struct ModelStats {
+        uint64_t file_bytes = 0;
+        uint32_t subgraphs  = 0;
+        uint64_t operators  = 0;
+        uint64_t tensors    = 0;
+
+        std::map<std::string, uint64_t>  op_counts;
+        std::map<std::string, TypeStats> constants;  // by data type, every buffer counted once
+
+        uint64_t parameters                   = 0;
+        uint64_t quantized_parameters         = 0;
+        uint64_t constant_tensors             = 0;
+        uint64_t quantized_constant_tensors   = 0;
+        uint64_t per_channel_tensors          = 0;
+        uint64_t activation_tensors           = 0;
+        uint64_t quantized_activation_tensors = 0;
+        uint64_t quantized_operators          = 0;  // operators without floating point inputs or outputs
+    };
+
+    // Read tables of a tflite model in place, no buffer is copied and constant data is never touched. Throws if the
+    // file isn't a valid model.
+    static ModelStats CollectStats(const common::MappedFile& file);
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "model/graph.h"
+
+/**
+ * CommonSubexpressionElimination merges operators which compute the same value, i.e. operators sharing the operator
+ * type, option contents and input blobs. Operators are visited once in topological order and bucketed by a hash of
+ * (type, option, input blob ids), so the pass is linear in the size of graph. Consumers of a duplicate are redirected
+ * to the first equivalent operator, which in turn exposes duplicates among the consumers.
+ * Constant blobs with identical contents are unified beforehand, so two TRANSPOSEs of the same tensor are recognized
+ * even if each of them owns a separate copy of the permutation tensor.
+ */
+class CommonSubexpressionElimination {
+ public:
+    // Return the number of eliminated operators.
+    static uint32_t Run(Graph& graph);
+
+ private:
+    static uint32_t MergeDuplicatedConstants(Graph& graph);
+
+    static bool IsEquivalent(const Operator& op1, const Operator& op2);
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "model/graph.h"
+
+/**
+ * Float16Conversion stores float32 constants as float16, which halves their size, and lets a DEQUANTIZE rebuild the
+ * float32 tensor `<name>_dequantized` for the consumers, so that kernels keep computing in float32. Delegates that run
+ * in float16 can fold the DEQUANTIZE away.
+ *
+ * Constants with values beyond the float16 range (65504) are left alone, as they would turn into infinity.
+ */
+class Float16Conversion {
+ public:
+    struct ConvertedTensor {
+        std::string name;
+        uint64_t    elements;
+        float       max_error;   // largest absolute difference to the float32 values
+        float       mean_error;  // mean absolute difference to the float32 values
+    };
+
+    // Constants are selected by name, all float32 constants with at least `min_elements` elements if `tensor_names`
+    // is empty. Buffers are converted on `num_threads` threads, the number of hardware threads if 0.
+    static std::vector<ConvertedTensor> Run(Graph&                          graph,
+                                            const std::vector<std::string>& tensor_names,
+                                            uint64_t                        min_elements = 1024,
+                                            size_t                          num_threads  = 0);
+};
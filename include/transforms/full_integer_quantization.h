@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "model/graph.h"
+
+/**
+ * FullIntegerQuantization turns a float32 graph into an int8 one from calibration ranges of its activations, so that
+ * every kernel runs on integers and the graph keeps its float32 interface:
+ *   - Activations become int8 with asymmetric per-tensor scales and zero points from their [min, max] range, widened
+ *     to hold 0. Operators whose kernels need equal parameters on their inputs and outputs (pooling, reshaping,
+ *     resizing, slicing, CONCAT, MAXIMUM, ...) get the union of the ranges of those tensors, and LOGISTIC, SOFTMAX,
+ *     TANH, L2_NORMALIZATION and LOG_SOFTMAX outputs take the fixed parameters of their kernels.
+ *   - Weights are quantized by WeightQuantization, symmetric per channel, and biases become int32 with scales
+ *     input_scale * weight_scale, each operator getting its own copy of a shared bias. Other float32 constants are
+ *     quantized per tensor from their own values.
+ *   - A QUANTIZE follows every float32 graph input, a DEQUANTIZE precedes every float32 graph output. Internal
+ *     tensors of graph inputs and outputs are named `<name>_int8`.
+ *   - Options are made consistent with int8 kernels, e.g. pot_scale_int16 of ADD and SUB is cleared and
+ *     asym_quantize_inputs of FULLY_CONNECTED and BATCH_MATMUL, which only hybrid kernels read, is reset.
+ *
+ * Operators without int8 kernels, activations without a range, biases without one value per output channel, and
+ * tensors sharing parameters with a LOGISTIC, SOFTMAX, ... output that aren't computed from outputs of the same fixed
+ * parameters, e.g. a CONCAT of LOGISTIC and TANH outputs, are reported as errors before the graph is touched.
+ */
+class FullIntegerQuantization {
+ public:
+    struct Range {
+        float min;
+        float max;
+    };
+
+    struct Summary {
+        uint32_t activations;     // float32 activations turned into int8
+        uint32_t weights;         // weights quantized by WeightQuantization
+        uint32_t constants;       // other float32 constants, including weights shared between operators
+        uint32_t quantize_ops;    // QUANTIZE inserted behind graph inputs
+        uint32_t dequantize_ops;  // DEQUANTIZE inserted in front of graph outputs
+    };
+
+    // Ranges are keyed by tensor name. Weights are quantized on `num_threads` threads, the number of hardware threads
+    // if 0.
+    static Summary Run(Graph& graph, const std::unordered_map<std::string, Range>& ranges, size_t num_threads = 0);
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "model/graph.h"
+
+/**
+ * LowRankFactorization replaces the float32 constant weights W [m, n] of selected FULLY_CONNECTED operators, and the
+ * 2-D constant y of BATCH_MATMUL operators (W = y^T, or y itself with adj_y), by their truncated SVD of rank r, the
+ * product of A [m, r] and B [r, n]. The operator becomes two FULLY_CONNECTED operators:
+ *   input -> FULLY_CONNECTED(B) -> <output>_lowrank [..., r] -> FULLY_CONNECTED(A, bias, activation) -> output
+ *
+ * The rank r is the least one keeping `energy_threshold` of the energy of W, i.e. of the sum of its squared singular
+ * values. Singular vectors come from the eigen decomposition of the Gram matrix of the shorter side of W. An operator
+ * is rewritten only if r (m + n) < m n, so that both MACs and parameters go down.
+ */
+class LowRankFactorization {
+ public:
+    struct FactorizedLayer {
+        std::string  op_output;  // name of the first output of the operator
+        OperatorType op_type;
+        int32_t      output_channels;  // m
+        int32_t      input_channels;   // n
+        int32_t      rank;
+        double       retained_energy;  // share of the energy of W kept by rank r
+        uint64_t     original_params;
+        uint64_t     factorized_params;
+        uint64_t     original_macs;
+        uint64_t     factorized_macs;
+        bool         factorized;  // false if rank r doesn't save MACs and the operator is left alone
+    };
+
+    // Operators are selected by the name of their first output. The Gram matrices and projections are computed on
+    // `num_threads` threads, the number of hardware threads if 0, and at most `num_threads` layers are held in memory
+    // at once. Return the layers in the same order.
+    static std::vector<FactorizedLayer> Run(Graph&                          graph,
+                                            const std::vector<std::string>& op_outputs,
+                                            double                          energy_threshold,
+                                            size_t                          num_threads = 0);
+
+    // Names of the first outputs of factorizable operators whose weights have at least `min_elements` elements.
+    static std::vector<std::string> FindCandidates(const Graph& graph, uint64_t min_elements);
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "analysis/cost_model.h"
+#include "model/graph.h"
+
+/**
+ * MixedPrecision chooses the storage precision of the float32 weights of every CONV2D, DEPTHWISE_CONV2D,
+ * FULLY_CONNECTED, TRANSPOSE_CONV2D and BATCH_MATMUL operator among float32, float16, int8 and int4, and applies the
+ * plan with Float16Conversion and WeightQuantization.
+ *
+ * Every choice is rated by its weight bytes, the roofline time of the operator reading weights of that size (float16
+ * keeps the float32 operator and adds the DEQUANTIZE rebuilding its weights on every run) and, as a cheap proxy of the
+ * accuracy loss, the SNR of the rounded weights: signal power over rounding error power in dB. Choices below
+ * `min_snr_db` are dropped, int4 is only offered where kernels take it. Without a size or time budget, every operator
+ * takes its smallest choice left. Otherwise all operators start from float32, and the planner repeatedly takes the step
+ * to a smaller choice that adds the least relative noise (10^(-SNR/10)) per saved share of the exceeded budgets, until
+ * the budgets are met.
+ */
+class MixedPrecision {
+ public:
+    enum class Precision { FLOAT32, FLOAT16, INT8, INT4 };
+
+    struct Budget {
+        uint64_t max_weight_bytes = 0;    // total weight bytes of the planned operators, no limit if 0
+        double   max_seconds      = 0.0;  // total roofline time of the planned operators, no limit if 0
+        double   min_snr_db       = 0.0;  // least SNR of any choice taken
+    };
+
+    struct Choice {
+        Precision precision;
+        uint64_t  weight_bytes;  // including scales and zero points
+        double    seconds;
+        double    snr_db;        // infinity for float32
+    };
+
+    struct LayerPlan {
+        std::string         op_output;  // name of the first output of the operator
+        OperatorType        op_type;
+        std::string         weights;
+        uint64_t            elements;
+        std::vector<Choice> choices;  // float32 first, then smaller ones
+        size_t              chosen;   // index into choices
+    };
+
+    struct Plan {
+        std::vector<LayerPlan> layers;
+        bool                   budget_met;
+    };
+
+    // Plan without changing the graph. Weights with fewer than `min_elements` elements stay float32 and are left out.
+    // SNRs are measured on `num_threads` threads, the number of hardware threads if 0.
+    static Plan Analyze(Graph&                     graph,
+                        const Budget&              budget,
+                        const CostModel::Roofline& roofline     = CostModel::Roofline(),
+                        uint64_t                   min_elements = 1024,
+                        size_t                     num_threads  = 0);
+
+    // Plan and convert the weights as planned.
+    static Plan Run(Graph&                     graph,
+                    const Budget&              budget,
+                    const CostModel::Roofline& roofline     = CostModel::Roofline(),
+                    uint64_t                   min_elements = 1024,
+                    size_t                     num_threads  = 0);
+
+    static const char* GetPrecisionName(Precision precision);
+};
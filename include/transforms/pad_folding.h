@@ -0,0 +1,20 @@
+#pragma once
+
+#include "model/graph.h"
+
+/**
+ * PadFolding removes explicit PAD/PADV2/MIRROR_PAD operators in front of CONV2D, DEPTHWISE_CONV2D and MAX_POOL when
+ * the constant paddings are exactly what Padding::SAME computes for the consumer's stride, filter and dilation. The
+ * consumer reads the unpadded activation and switches to SAME padding, which saves a full copy of the activation.
+ *
+ * Folding has to keep the values seen by the window unchanged:
+ *   - convolutions pad with zero (the zero point of quantized tensors), so PAD and PADV2 with a zero value fold.
+ *   - MAX_POOL with SAME padding ignores the padded area, so PADV2 with the lowest value folds, zero padding folds
+ *     when the input can't be negative, and MIRROR_PAD folds when every mirrored value lies in the same window.
+ *   - AVERAGE_POOL with SAME padding excludes the padded area from the divisor, hence it's never folded.
+ */
+class PadFolding {
+ public:
+    // Return the number of consumers which absorb the padding.
+    static uint32_t Run(Graph& graph);
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "model/graph.h"
+
+/**
+ * PatternFusion replaces float subgraphs which spell out an activation with the builtin operator:
+ *   - GELU (tanh approximation): 0.5 * x * (1 + TANH(sqrt(2 / pi) * (x + 0.044715 * x^3))), x^3 as POW or MULs.
+ *   - HARDSWISH: x * ReLU6(x + 3) / 6, ReLU6 either as operator or fused into ADD.
+ *   - LOG_SOFTMAX: LOG(SOFTMAX(x)) with beta 1.
+ *   - LEAKY_RELU: MAXIMUM(x, alpha * x) with 0 <= alpha < 1.
+ * Products and scales are matched in any association and operand order, scales by MUL or DIV. Coefficients are read
+ * from constant buffers. Intermediate tensors must not be used elsewhere, otherwise the subgraph is kept.
+ */
+class PatternFusion {
+ public:
+    // Return the number of fused patterns.
+    static uint32_t Run(Graph& graph);
+};
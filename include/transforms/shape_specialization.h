@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "model/graph.h"
+
+/**
+ * ShapeSpecialization fixes the shapes of graph inputs and turns the graph into a fully static one:
+ *   - Shapes are propagated through all operators by ShapeInference.
+ *   - SHAPE operators with a known input shape, and integer shape arithmetic over constants (CAST, binary ops, PACK,
+ *     CONCAT, GATHER, SLICE, STRIDED_SLICE, reduce, reshape-likes), are folded into constant buffers.
+ *   - RESHAPE new_shape in the option and the shape tensor are rewritten to the concrete output shape, so a computed
+ *     shape tensor becomes dead and is removed.
+ * Folding and inference are repeated until nothing changes, since a folded value may unlock inference downstream.
+ */
+class ShapeSpecialization {
+ public:
+    using InputShapes = std::unordered_map<std::string, std::vector<int>>;
+
+    // Inputs are matched by blob name, an unknown name is reported as error. Return the number of folded operators,
+    // rewritten reshapes and removed dead operators.
+    static uint32_t Run(Graph& graph, const InputShapes& input_shapes);
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "model/graph.h"
+
+/**
+ * SparseEncoding stores pruned FULLY_CONNECTED weights in the block-sparse CSR layout of TFLite, which shrinks the
+ * model and lets the sparse FULLY_CONNECTED kernels skip the zero blocks.
+ *
+ * Weights [O, I] are cut into blocks [block_rows, block_cols]. The buffer keeps the non-zero blocks only, row by row
+ * of blocks and row-major within a block, and the SparsityParam describes the layout as TFLite expects it:
+ *   - traversal_order is [0, 1] followed by the block dims, and block_map the tensor dim of every block dim. Block
+ *     dims of size 1 are left out, i.e. 1x4 blocks have traversal_order [0, 1, 2] and block_map [1].
+ *   - dim 0 is DENSE with O / block_rows rows, dim 1 SPARSE_CSR whose segments and indices are the row pointers and
+ *     the block columns, and the block dims are DENSE.
+ * A block is zero if all its bytes are zero, so quantized weights are encoded as well and the encoding is lossless.
+ */
+class SparseEncoding {
+ public:
+    struct EncodedTensor {
+        std::string name;
+        float       sparsity;      // fraction of zero blocks
+        uint64_t    dense_bytes;   // size of the dense buffer
+        uint64_t    sparse_bytes;  // size of the non-zero blocks and the indices
+    };
+
+    // Encodes the weights with at least `min_elements` elements and a fraction of zero blocks of at least
+    // `min_sparsity`, if their dims are multiples of the block and the encoding is smaller than the dense buffer.
+    static std::vector<EncodedTensor> Run(Graph&   graph,
+                                          float    min_sparsity,
+                                          int32_t  block_rows   = 1,
+                                          int32_t  block_cols   = 4,
+                                          uint64_t min_elements = 1024);
+
+    // The dense buffer of a sparse constant, for any layout TFLite supports.
+    static std::vector<uint8_t> Densify(const Graph& graph, const DataBlob& blob);
+};
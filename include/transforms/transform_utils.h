@@ -0,0 +1,17 @@
+#pragma once
+
+#include "model/graph.h"
+
+// Helpers shared by graph transforms.
+namespace transforms {
+
+bool IsSameQuantParam(const DataBlob& blob1, const DataBlob& blob2);
+
+// Erase the blob together with its buffer if no operator reads it and it isn't a graph input or output.
+bool EraseBlobIfUnused(Graph& graph, DataBlob* blob);
+
+// Remove operators whose outputs are neither read by other operators nor graph outputs, together with blobs left
+// unused. Operators without outputs are kept. Return the number of removed operators.
+uint32_t RemoveDeadOperators(Graph& graph);
+
+}  // namespace transforms
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "model/graph.h"
+
+/**
+ * WeightClustering palettizes float32 constants: k-means finds a codebook of `num_clusters` values, per tensor or per
+ * channel along the first axis, i.e. per output channel of CONV2D and FULLY_CONNECTED, and every weight is replaced by
+ * its nearest codebook value.
+ *   - GATHER: the constant becomes the UINT8 indices, one byte per weight, which a CAST widens to the INT16 positions
+ *     `<name>_positions` that TFLite GATHER takes. A GATHER from the FLOAT32 codebook `<name>_codebook` rebuilds the
+ *     float32 tensor `<name>_clustered` for the consumers. Per-channel codebooks are [channels, K] and gathered with
+ *     batch_dims 1, so the result has the shape of the original constant in both cases.
+ *   - IN_PLACE: the constant keeps its type and shape and holds the codebook values, so all kernels still run it,
+ *     and compressed containers or delegates that palettize on their own store it with a few bits per weight.
+ *
+ * Clustering is one-dimensional: the values are sorted once, and every Lloyd iteration moves the boundaries between
+ * neighbouring centroids and takes the new means from prefix sums, which costs O(K log n) instead of O(K n). Codebooks
+ * start at the quantiles of the values, so dense regions get more centroids. Large channels are fitted on an evenly
+ * strided sample.
+ */
+class WeightClustering {
+ public:
+    enum class Reconstruction { GATHER, IN_PLACE };
+
+    struct ClusteredTensor {
+        std::string name;
+        uint32_t    channels;         // number of codebooks
+        uint64_t    elements;
+        uint64_t    original_bytes;   // size of the float32 buffer
+        uint64_t    clustered_bytes;  // size of the codebooks and the indices as stored in the model
+        float       max_error;        // largest absolute difference to the original values
+        float       mean_error;       // mean absolute difference to the original values
+    };
+
+    // Constants are selected by name, all float32 constants with at least `min_elements` elements if `tensor_names`
+    // is empty. `num_clusters` is in [2, 256]. Tensors are clustered on `num_threads` threads, the number of hardware
+    // threads if 0.
+    static std::vector<ClusteredTensor> Run(Graph&                          graph,
+                                            const std::vector<std::string>& tensor_names,
+                                            uint32_t                        num_clusters,
+                                            bool                            per_channel,
+                                            Reconstruction                  reconstruction = Reconstruction::GATHER,
+                                            uint64_t                        min_elements   = 1024,
+                                            size_t                          num_threads    = 0);
+};
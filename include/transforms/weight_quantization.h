@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "model/graph.h"
+
+/**
+ * WeightQuantization stores the constant float32 weights of CONV2D, DEPTHWISE_CONV2D, FULLY_CONNECTED,
+ * TRANSPOSE_CONV2D and BATCH_MATMUL operators as int8 in [-127, 127] with symmetric scales and zero points of 0. Every
+ * output channel gets its own scale, except for BATCH_MATMUL whose kernels take one scale per tensor.
+ *
+ * INT4 weights take [-7, 7] and are nibble-packed, see Int4Buffer. Kernels take them for CONV2D, DEPTHWISE_CONV2D and
+ * FULLY_CONNECTED only. Both float32 and already quantized int8 weights can be quantized to int4.
+ *
+ * The bias becomes int32 with scales input_scale * weight_scale when the input activation is quantized per tensor.
+ * Otherwise it stays float32, and kernels run with float activations and quantized weights (dynamic range
+ * quantization). Weights shared with other operators are left alone, so are tensors smaller than `min_elements`,
+ * whose scales would cost more than they save.
+ */
+class WeightQuantization {
+ public:
+    struct QuantizedWeight {
+        std::string  weights;          // name of the quantized constant
+        OperatorType op_type;          // type of the operator reading it
+        uint32_t     channels;         // number of scales
+        uint64_t     original_bytes;   // size of the float32 or int8 buffer
+        uint64_t     quantized_bytes;  // size of the quantized buffer
+        bool         bias_quantized;   // whether the bias became int32 as well
+    };
+
+    // Operators are selected by the name of their first output, all supported operators if `op_outputs` is empty.
+    // `weight_type` is INT8 or INT4. Buffers are quantized on `num_threads` threads, the number of hardware threads if
+    // 0.
+    static std::vector<QuantizedWeight> Run(Graph&                          graph,
+                                            const std::vector<std::string>& op_outputs,
+                                            DataType                        weight_type  = DataType::INT8,
+                                            uint64_t                        min_elements = 1024,
+                                            size_t                          num_threads  = 0);
+
+    // The float32 weights that Run quantizes to `weight_type` for `op`, or null if there are none. `channel_axis` is
+    // the axis of their output channels, or -1 for per-tensor scales.
+    static DataBlob* GetFloatWeights(Graph& graph, Operator& op, DataType weight_type, int& channel_axis);
+};
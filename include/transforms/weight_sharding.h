@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "model/graph_view.h"
+
+/**
+ * WeightSharding rewrites a graph into one shard of a tensor-parallel model. The constant weights of selected
+ * FULLY_CONNECTED, CONV2D and BATCH_MATMUL operators are split into `num_shards` equal slices along a channel
+ * dimension, and the graph of shard i keeps only slice i:
+ *   - OUTPUT_CHANNEL: the partial operator computes its slice of output channels (with its slice of bias), and a
+ *     CONCAT along the last axis rebuilds the full output.
+ *   - INPUT_CHANNEL: a SPLIT hands the partial operator its slice of input channels, every shard computes a partial
+ *     sum over its channels, and a chain of ADD in shard order rebuilds the full output. Bias and fused activation
+ *     are applied once, by shard 0 and by the last ADD respectively.
+ *
+ * The partial result of shard i, `<output>_shard<i>`, becomes a graph output, and the partial results of the other
+ * shards become graph inputs of the same names. Serving exchanges these tensors between processes, so every process
+ * holds 1/num_shards of the sharded weights. Sharded operators may depend on each other, e.g. the layers of a stack,
+ * so a shard runs in stages with an exchange between consecutive stages: stage s computes the partial results of the
+ * operators of stage s, which are the most sharded operators on any path into them, and the operators combining the
+ * partial results of stage s - 1. The last stage produces the outputs of the graph.
+ */
+class WeightSharding {
+ public:
+    enum class Axis { OUTPUT_CHANNEL, INPUT_CHANNEL };
+
+    // Shard i owns channels [i * channels / N, (i + 1) * channels / N) of the operator.
+    struct ShardedOperator {
+        std::string              output;        // original output, rebuilt by the combining operators
+        OperatorType             op_type;       // type of the sharded operator
+        OperatorType             combine_type;  // CONCAT of output channel slices or ADD of partial sums
+        int32_t                  channels;      // size of the split channel dimension
+        std::vector<std::string> partials;      // partial result of every shard in shard order
+        uint32_t                 stage;         // stage computing the partial results, combined in the next one
+    };
+
+    // Operators are selected by the name of their first output. Return the sharded operators in the same order.
+    static std::vector<ShardedOperator> Run(Graph&                          graph,
+                                            const std::vector<std::string>& op_outputs,
+                                            Axis                            axis,
+                                            uint32_t                        num_shards,
+                                            uint32_t                        shard_index);
+
+    // Views of the stages of a graph rewritten by Run, in execution order. Every operator runs in the first stage
+    // where its inputs are available. The inputs of a stage are the graph inputs it reads, including the partial
+    // results of the other shards of earlier stages, and the activations which earlier stages of the same shard
+    // output. The outputs of a stage are its own partial results, the activations read by later stages and the
+    // graph outputs it computes. Tensors are matched between stages by name.
+    static std::vector<GraphView> SplitStages(const Graph& graph, const std::vector<ShardedOperator>& sharded_ops);
+
+    // Names of the first outputs of shardable operators whose constant weights take at least `min_weight_bytes`, in
+    // topological order.
+    static std::vector<std::string> FindCandidates(const Graph& graph, uint64_t min_weight_bytes);
+};
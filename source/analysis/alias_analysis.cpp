@@ -0,0 +1,270 @@
+#include "analysis/alias_analysis.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "common/stl_wrapper.h"
+
+namespace {
+using Alias     = AliasAnalysis::Alias;
+using AliasKind = AliasAnalysis::AliasKind;
+
+constexpr size_t   unknown_bytes = SIZE_MAX;
+constexpr uint32_t end_of_graph  = UINT32_MAX;
+
+size_t GetBytes(const DataBlob& blob) {
+    size_t num_elements = 1;
+    for (auto dim : blob.GetShape().GetDims()) {
+        if (dim < 0) {
+            return unknown_bytes;
+        }
+        num_elements *= static_cast<size_t>(dim);
+    }
+    auto bits = GetBitWidth(blob.GetDataType());
+    return bits == 0 ? unknown_bytes : (num_elements * bits + 7) / 8;
+}
+
+bool IsSameQuantization(const DataBlob& lhs, const DataBlob& rhs) {
+    if (lhs.HasQuantParam() != rhs.HasQuantParam()) {
+        return false;
+    }
+    return !lhs.HasQuantParam() || (lhs.GetQuantParam().scales == rhs.GetQuantParam().scales &&
+                                    lhs.GetQuantParam().zero_points == rhs.GetQuantParam().zero_points);
+}
+
+// Slices along `axis` are contiguous in memory only if all outer dims are 1.
+bool IsOuterAxis(const std::vector<int>& dims, int64_t axis) {
+    if (axis < 0) {
+        axis += static_cast<int64_t>(dims.size());
+    }
+    return axis >= 0 && axis < static_cast<int64_t>(dims.size()) &&
+           std::all_of(dims.begin(), dims.begin() + axis, [](int dim) { return dim == 1; });
+}
+
+bool IsInPlaceCandidate(OperatorType op_type) {
+    switch (op_type) {
+        case OperatorType::ABS:
+        case OperatorType::ADD:
+        case OperatorType::COSINE:
+        case OperatorType::DIV:
+        case OperatorType::ELU:
+        case OperatorType::EXP:
+        case OperatorType::GELU:
+        case OperatorType::HARDSWISH:
+        case OperatorType::LEAKY_RELU:
+        case OperatorType::LOG:
+        case OperatorType::LOGISTIC:
+        case OperatorType::MAXIMUM:
+        case OperatorType::MINIMUM:
+        case OperatorType::MUL:
+        case OperatorType::NEG:
+        case OperatorType::POW:
+        case OperatorType::ReLU:
+        case OperatorType::ReLU1:
+        case OperatorType::ReLU6:
+        case OperatorType::RSQRT:
+        case OperatorType::SIN:
+        case OperatorType::SQRT:
+        case OperatorType::SQUARE:
+        case OperatorType::SQUARED_DIFFERENCE:
+        case OperatorType::SUB:
+        case OperatorType::TANH:
+            return true;
+        default:
+            return false;
+    }
+}
+
+class AliasBuilder {
+ public:
+    explicit AliasBuilder(const Graph& graph) : graph_(graph) {}
+
+    std::vector<Alias> Build() {
+        auto sorted_ops = graph_.TopologicalSort();
+        for (uint32_t index = 0; index < sorted_ops.size(); index++) {
+            op_indices_[sorted_ops[index]] = index;
+        }
+        for (uint32_t index = 0; index < sorted_ops.size(); index++) {
+            const auto* op = sorted_ops[index];
+            switch (op->GetOpType()) {
+                case OperatorType::CAST:
+                case OperatorType::EXPAND_DIMS:
+                case OperatorType::RESHAPE:
+                case OperatorType::SQUEEZE:
+                    VisitReshape(*op);
+                    break;
+                case OperatorType::CONCAT:
+                case OperatorType::PACK:
+                    VisitConcat(*op);
+                    break;
+                case OperatorType::SPLIT:
+                case OperatorType::SPLITV:
+                    VisitSplit(*op);
+                    break;
+                default:
+                    if (IsInPlaceCandidate(op->GetOpType())) {
+                        VisitInPlace(*op, index);
+                    }
+                    break;
+            }
+        }
+
+        std::vector<Alias> aliases;
+        for (const auto& [blob_id, location] : locations_) {
+            aliases.push_back({blob_id, location.root, location.offset, kinds_.at(blob_id)});
+        }
+        std::sort(aliases.begin(), aliases.end(),
+                  [](const Alias& lhs, const Alias& rhs) { return lhs.blob_id < rhs.blob_id; });
+        return aliases;
+    }
+
+ private:
+    struct Location {
+        BLOBID_T root;
+        size_t   offset;
+    };
+
+    Location Locate(BLOBID_T blob_id) const {
+        auto location = locations_.find(blob_id);
+        return location == locations_.end() ? Location {blob_id, 0} : location->second;
+    }
+
+    bool IsConstant(const DataBlob& blob) const { return graph_.GetBuffer(blob.GetID()) != nullptr; }
+
+    // Index of the last operator reading any blob which shares memory with the root.
+    uint32_t GetGroupLastUse(BLOBID_T root) const {
+        auto last_use = group_last_uses_.find(root);
+        return last_use == group_last_uses_.end() ? GetLastUse(*graph_.GetDataBlob(root)) : last_use->second;
+    }
+
+    uint32_t GetLastUse(const DataBlob& blob) const {
+        if (graph_.IsGraphOutput(blob.GetID())) {
+            return end_of_graph;
+        }
+        uint32_t last_use = 0;
+        for (auto* consumer : blob.GetConsumers()) {
+            last_use = std::max(last_use, op_indices_.at(consumer));
+        }
+        return last_use;
+    }
+
+    // Common requirements of an alias blob which lives inside the memory of base.
+    bool IsAliasable(const DataBlob& blob, const DataBlob& base) const {
+        return !IsConstant(blob) && !IsConstant(base) && !graph_.IsGraphOutput(blob.GetID()) &&
+               !graph_.IsGraphInput(blob.GetID()) && blob.GetDataType() == base.GetDataType() &&
+               IsSameQuantization(blob, base) && GetBytes(blob) != unknown_bytes && GetBytes(base) != unknown_bytes;
+    }
+
+    // Move blob, together with blobs aliased to it, into the memory of base at the given offset.
+    void AddAlias(const DataBlob& blob, const DataBlob& base, size_t offset, AliasKind kind) {
+        auto base_location = Locate(base.GetID());
+        auto root          = base_location.root;
+        offset += base_location.offset;
+        auto group_last_use = std::max(GetGroupLastUse(root), GetGroupLastUse(blob.GetID()));
+        auto blob_members   = std::move(members_[blob.GetID()]);
+        members_.erase(blob.GetID());
+        group_last_uses_.erase(blob.GetID());
+
+        auto& root_members = members_[root];
+        for (auto member : blob_members) {
+            locations_[member].root = root;
+            locations_[member].offset += offset;
+            root_members.push_back(member);
+        }
+        locations_[blob.GetID()] = {root, offset};
+        kinds_[blob.GetID()]     = kind;
+        root_members.push_back(blob.GetID());
+        group_last_uses_[root] = group_last_use;
+    }
+
+    void VisitReshape(const Operator& op) {
+        const auto* input  = op.GetInputBlob(0);
+        const auto* output = op.GetOutputBlob(0);
+        if (IsAliasable(*output, *input) && GetBytes(*output) == GetBytes(*input)) {
+            AddAlias(*output, *input, 0, AliasKind::RESHAPE);
+        }
+    }
+
+    void VisitInPlace(const Operator& op, uint32_t op_index) {
+        const auto* output = op.GetOutputBlob(0);
+        for (const auto* input : op.GetInputBlobs()) {
+            // Writing is only safe if the memory isn't read after this operator and isn't owned by the user.
+            auto root = Locate(input->GetID()).root;
+            if (IsAliasable(*output, *input) && input->GetShape() == output->GetShape() &&
+                !graph_.IsGraphInput(root) && GetGroupLastUse(root) == op_index) {
+                AddAlias(*output, *input, 0, AliasKind::IN_PLACE);
+                return;
+            }
+        }
+    }
+
+    void VisitConcat(const Operator& op) {
+        const auto* output = op.GetOutputBlob(0);
+        int         axis   = 0;
+        if (op.GetOpType() == OperatorType::CONCAT) {
+            if (!op.HasOption() || op.GetOption<ConcatOption>()->activation_type != OperatorType::NONE) {
+                return;
+            }
+            axis = op.GetOption<ConcatOption>()->axis;
+        } else if (op.HasOption()) {
+            axis = op.GetOption<PackOption>()->axis;
+        }
+        if (!IsOuterAxis(output->GetShape().GetDims(), axis)) {
+            return;
+        }
+        size_t offset = 0;
+        for (const auto* input : op.GetInputBlobs()) {
+            auto bytes = GetBytes(*input);
+            if (bytes == unknown_bytes) {
+                return;
+            }
+            // The producer writes into the slice, so the input can't be shared with anyone else.
+            bool is_exclusive = input->GetProducer() != nullptr && locations_.count(input->GetID()) == 0 &&
+                                std::count(op.GetInputIDs().begin(), op.GetInputIDs().end(), input->GetID()) == 1 &&
+                                common::all_of(input->GetConsumers(), [&](const Operator* consumer) {
+                                    return consumer == &op;
+                                });
+            if (is_exclusive && IsAliasable(*input, *output)) {
+                AddAlias(*input, *output, offset, AliasKind::CONCAT_SLICE);
+            }
+            offset += bytes;
+        }
+    }
+
+    void VisitSplit(const Operator& op) {
+        // SPLIT takes (axis, input) while SPLITV takes (input, size_splits, axis).
+        bool                 is_split = op.GetOpType() == OperatorType::SPLIT;
+        const auto*          input    = op.GetInputBlob(is_split ? 1 : 0);
+        std::vector<int64_t> axis;
+        if (!graph_.GetIntegerConstant(op.GetInputIDs()[is_split ? 0 : 2], axis) || axis.size() != 1 ||
+            !IsOuterAxis(input->GetShape().GetDims(), axis[0])) {
+            return;
+        }
+        size_t offset = 0;
+        for (const auto* output : op.GetOutputBlobs()) {
+            auto bytes = GetBytes(*output);
+            if (bytes == unknown_bytes) {
+                return;
+            }
+            if (IsAliasable(*output, *input)) {
+                AddAlias(*output, *input, offset, AliasKind::SPLIT_SLICE);
+            }
+            offset += bytes;
+        }
+    }
+
+    const Graph&                                        graph_;
+    std::unordered_map<const Operator*, uint32_t>       op_indices_;
+    std::unordered_map<BLOBID_T, Location>              locations_;
+    std::unordered_map<BLOBID_T, AliasKind>             kinds_;
+    std::unordered_map<BLOBID_T, std::vector<BLOBID_T>> members_;
+    std::unordered_map<BLOBID_T, uint32_t>              group_last_uses_;
+};
+}  // namespace
+
+std::vector<AliasAnalysis::Alias> AliasAnalysis::Analyze(const Graph& graph) {
+    LOG(INFO) << "AliasAnalysis::Analyze Start.";
+    auto aliases = AliasBuilder(graph).Build();
+    LOG(INFO) << "AliasAnalysis::Analyze End. " << aliases.size() << " blobs share memory with others.";
+    return aliases;
+}
@@ -0,0 +1,246 @@
+#include "analysis/cost_model.h"
+
+#include <algorithm>
+
+namespace {
+using OperatorCost = CostModel::OperatorCost;
+
+// Elements of a blob, 0 if any dim is unknown.
+uint64_t NumElements(const DataBlob* blob) {
+    if (blob == nullptr) {
+        return 0;
+    }
+    uint64_t num_elements = 1;
+    for (auto dim : blob->GetShape().GetDims()) {
+        if (dim < 0) {
+            return 0;
+        }
+        num_elements *= static_cast<uint64_t>(dim);
+    }
+    return num_elements;
+}
+
+uint64_t GetBytes(const DataBlob* blob) {
+    return blob == nullptr ? 0 : (NumElements(blob) * GetBitWidth(blob->GetDataType()) + 7) / 8;
+}
+
+// Dim of an input at index, negative indices count from the back, 0 if the dim is missing or unknown.
+uint64_t InputDim(const Operator& op, size_t input_index, int dim_index) {
+    if (input_index >= op.GetInputIDs().size()) {
+        return 0;
+    }
+    const auto* blob = op.GetInputBlob(input_index);
+    if (blob == nullptr) {
+        return 0;
+    }
+    const auto& dims = blob->GetShape().GetDims();
+    if (dim_index < 0) {
+        dim_index += static_cast<int>(dims.size());
+    }
+    if (dim_index < 0 || dim_index >= static_cast<int>(dims.size()) || dims[dim_index] < 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(dims[dim_index]);
+}
+
+uint64_t InputElements(const Operator& op, size_t input_index) {
+    return input_index < op.GetInputIDs().size() ? NumElements(op.GetInputBlob(input_index)) : 0;
+}
+
+uint64_t OutputElements(const Operator& op) { return NumElements(op.GetOutputBlob(0)); }
+
+bool HasInput(const Operator& op, size_t input_index) {
+    return input_index < op.GetInputIDs().size() && op.GetInputBlob(input_index) != nullptr;
+}
+
+bool IsElementwise(OperatorType op_type) {
+    switch (op_type) {
+        case OperatorType::ABS:
+        case OperatorType::ADD:
+        case OperatorType::COSINE:
+        case OperatorType::DEQUANTIZE:
+        case OperatorType::DIV:
+        case OperatorType::ELU:
+        case OperatorType::EQUAL:
+        case OperatorType::EXP:
+        case OperatorType::GELU:
+        case OperatorType::HARDSWISH:
+        case OperatorType::LEAKY_RELU:
+        case OperatorType::LOG:
+        case OperatorType::LOGISTIC:
+        case OperatorType::MAXIMUM:
+        case OperatorType::MINIMUM:
+        case OperatorType::MUL:
+        case OperatorType::NEG:
+        case OperatorType::NOT_EQUAL:
+        case OperatorType::POW:
+        case OperatorType::PReLU:
+        case OperatorType::QUANTIZE:
+        case OperatorType::ReLU:
+        case OperatorType::ReLU1:
+        case OperatorType::ReLU6:
+        case OperatorType::RSQRT:
+        case OperatorType::SELECT:
+        case OperatorType::SELECT_V2:
+        case OperatorType::SIN:
+        case OperatorType::SQRT:
+        case OperatorType::SQUARE:
+        case OperatorType::SQUARED_DIFFERENCE:
+        case OperatorType::SUB:
+        case OperatorType::TANH:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool IsReduction(OperatorType op_type) {
+    switch (op_type) {
+        case OperatorType::ARGMAX:
+        case OperatorType::ARGMIN:
+        case OperatorType::MEAN:
+        case OperatorType::REDUCE_ALL:
+        case OperatorType::REDUCE_ANY:
+        case OperatorType::REDUCE_MAX:
+        case OperatorType::REDUCE_MIN:
+        case OperatorType::REDUCE_PROD:
+        case OperatorType::SUM:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Bias adds are counted on top of the MACs if the bias input exists.
+void AddMatmulWork(const Operator& op, uint64_t macs, size_t bias_index, OperatorCost& cost) {
+    cost.macs  = macs;
+    cost.flops = 2 * macs + (HasInput(op, bias_index) ? OutputElements(op) : 0);
+}
+
+void EstimateWork(const Operator& op, OperatorCost& cost) {
+    auto op_type = op.GetOpType();
+    switch (op_type) {
+        case OperatorType::CONV2D:
+            // NHWC input with OHWI filter, dilations and strides are already reflected in the output shape.
+            AddMatmulWork(op, OutputElements(op) * InputDim(op, 1, 1) * InputDim(op, 1, 2) * InputDim(op, 1, 3), 2,
+                          cost);
+            break;
+        case OperatorType::DEPTHWISE_CONV2D:
+            // Filter is [1, H, W, C * depth_multiplier], every output element reads one filter window.
+            AddMatmulWork(op, OutputElements(op) * InputDim(op, 1, 1) * InputDim(op, 1, 2), 2, cost);
+            break;
+        case OperatorType::CONV3D:
+            // NDHWC input with DHWIO filter.
+            AddMatmulWork(op,
+                          OutputElements(op) * InputDim(op, 1, 0) * InputDim(op, 1, 1) * InputDim(op, 1, 2) *
+                              InputDim(op, 1, 3),
+                          2, cost);
+            break;
+        case OperatorType::TRANSPOSE_CONV2D:
+            // Inputs are (output_shape, filter, input, [bias]), every input element scatters an OHW window.
+            AddMatmulWork(op, InputElements(op, 2) * InputDim(op, 1, 0) * InputDim(op, 1, 1) * InputDim(op, 1, 2), 3,
+                          cost);
+            break;
+        case OperatorType::FULLY_CONNECTED:
+            // Weights are [units, input_size].
+            AddMatmulWork(op, OutputElements(op) * InputDim(op, 1, 1), 2, cost);
+            break;
+        case OperatorType::BATCH_MATMUL: {
+            // The reduction dim is the last dim of x, or the one before it if x is adjoint.
+            bool adj_x = op.HasOption() && op.GetOption<BatchMatmulOption>()->adj_x;
+            AddMatmulWork(op, OutputElements(op) * InputDim(op, 0, adj_x ? -2 : -1), op.GetInputIDs().size(), cost);
+            break;
+        }
+        case OperatorType::UNIDIRECTIONAL_LSTM: {
+            // Four gates, each one multiplies the input by [n_cell, n_input] and the state by [n_cell, n_output].
+            uint64_t steps = InputDim(op, 0, -1) == 0 ? 0 : InputElements(op, 0) / InputDim(op, 0, -1);
+            uint64_t macs  = steps * 4 * InputDim(op, 4, 0) * (InputDim(op, 4, 1) + InputDim(op, 8, 1));
+            cost.macs      = macs;
+            // Gate activations and the cell update take a handful of elementwise operations per cell.
+            cost.flops = 2 * macs + steps * 10 * InputDim(op, 4, 0);
+            break;
+        }
+        case OperatorType::UNIDIRECTIONAL_RNN: {
+            // Weights are [units, input_size] and recurrent weights [units, units].
+            uint64_t steps = InputDim(op, 0, -1) == 0 ? 0 : InputElements(op, 0) / InputDim(op, 0, -1);
+            uint64_t macs  = steps * InputDim(op, 1, 0) * (InputDim(op, 1, 1) + InputDim(op, 2, 1));
+            cost.macs      = macs;
+            cost.flops     = 2 * macs + 2 * steps * InputDim(op, 1, 0);
+            break;
+        }
+        case OperatorType::AVERAGE_POOL:
+        case OperatorType::L2_POOL:
+        case OperatorType::MAX_POOL: {
+            uint64_t window = 0;
+            if (op.HasOption()) {
+                const auto* option = op.GetOption<Pool2DOption>();
+                window = static_cast<uint64_t>(std::max(option->filter_h, 0)) * std::max(option->filter_w, 0);
+            }
+            cost.flops = OutputElements(op) * window;
+            break;
+        }
+        case OperatorType::SOFTMAX:
+        case OperatorType::LOG_SOFTMAX:
+            // Max, exp with subtraction, sum and normalization.
+            cost.flops = 4 * OutputElements(op);
+            break;
+        case OperatorType::BATCH_NORMALIZATION:
+        case OperatorType::L2_NORMALIZATION:
+        case OperatorType::LOCAL_RESPONSE_NORMALIZATION:
+            cost.flops = 3 * OutputElements(op);
+            break;
+        case OperatorType::RESIZE_BILINEAR:
+            // Four taps weighted and summed per output element.
+            cost.flops = 8 * OutputElements(op);
+            break;
+        default:
+            if (IsElementwise(op_type)) {
+                cost.flops = OutputElements(op);
+            } else if (IsReduction(op_type)) {
+                cost.flops = InputElements(op, 0);
+            }
+            // Everything else only moves data.
+            break;
+    }
+}
+}  // namespace
+
+bool CostModel::Roofline::IsComputeBound(const OperatorCost& cost) const {
+    // Intensity above the ridge point means compute saturates before bandwidth does.
+    return peak_gbps > 0 && cost.ArithmeticIntensity() >= peak_gflops / peak_gbps;
+}
+
+double CostModel::Roofline::EstimateSeconds(const OperatorCost& cost) const {
+    double compute_seconds = peak_gflops > 0 ? static_cast<double>(cost.flops) / (peak_gflops * 1e9) : 0.0;
+    double memory_seconds  = peak_gbps > 0 ? static_cast<double>(cost.MemoryBytes()) / (peak_gbps * 1e9) : 0.0;
+    return std::max(compute_seconds, memory_seconds);
+}
+
+CostModel::OperatorCost CostModel::EstimateOperator(const Graph& graph, const Operator& op) {
+    OperatorCost cost {&op, 0, 0, 0, 0, 0};
+    for (auto input_id : op.GetInputIDs()) {
+        const auto* buffer = graph.GetBuffer(input_id);
+        if (buffer != nullptr) {
+            cost.weight_bytes += buffer->size();
+        } else {
+            cost.input_bytes += GetBytes(graph.GetDataBlob(input_id));
+        }
+    }
+    for (const auto* output : op.GetOutputBlobs()) {
+        cost.output_bytes += GetBytes(output);
+    }
+    EstimateWork(op, cost);
+    return cost;
+}
+
+std::vector<CostModel::OperatorCost> CostModel::EstimateGraph(const Graph& graph) {
+    LOG(INFO) << "CostModel::EstimateGraph Start.";
+    std::vector<OperatorCost> costs;
+    uint64_t                  total_flops = 0;
+    for (const auto* op : graph.TopologicalSort()) {
+        costs.push_back(EstimateOperator(graph, *op));
+        total_flops += costs.back().flops;
+    }
+    LOG(INFO) << "CostModel::EstimateGraph End. " << costs.size() << " operators take " << total_flops << " FLOPs.";
+    return costs;
+}
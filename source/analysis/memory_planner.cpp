@@ -0,0 +1,213 @@
+#include "analysis/memory_planner.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "common/stl_wrapper.h"
+
+namespace {
+using Allocation = MemoryPlanner::Allocation;
+
+constexpr uint32_t plan_version = 1;
+
+size_t AlignUp(size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+bool IsLifetimeOverlapped(const Allocation& lhs, const Allocation& rhs) {
+    return lhs.first_op <= rhs.last_op && rhs.first_op <= lhs.last_op;
+}
+
+// Collect lifetimes of blobs owning memory, `naive_bytes` sums up all blobs including aliases.
+std::vector<Allocation> CollectLifetimes(const Graph&                             graph,
+                                         const std::vector<AliasAnalysis::Alias>& aliases,
+                                         size_t                                   alignment,
+                                         size_t&                                  naive_bytes) {
+    auto                                          sorted_ops = graph.TopologicalSort();
+    std::unordered_map<const Operator*, uint32_t> op_indices;
+    for (uint32_t index = 0; index < sorted_ops.size(); index++) {
+        op_indices[sorted_ops[index]] = index;
+    }
+    uint32_t last_op = sorted_ops.empty() ? 0 : static_cast<uint32_t>(sorted_ops.size() - 1);
+
+    std::vector<Allocation> allocations;
+    for (const auto* blob : graph.GetDataBlobs()) {
+        if (graph.GetBuffer(blob->GetID()) != nullptr) {
+            continue;
+        }
+        const auto& dims = blob->GetShape().GetDims();
+        if (common::any_of(dims, [](int dim) { return dim < 0; })) {
+            LOG(WARN) << "Skip `" << blob->GetName() << "` in memory plan, its shape " << blob->GetShape()
+                      << " isn't static.";
+            continue;
+        }
+        size_t num_elements = 1;
+        for (auto dim : dims) {
+            num_elements *= static_cast<size_t>(dim);
+        }
+        size_t bytes = (num_elements * GetBitWidth(blob->GetDataType()) + 7) / 8;
+        if (bytes == 0) {
+            continue;
+        }
+        // Blobs without producer, e.g. graph inputs, are alive from the first operator.
+        auto*    producer = blob->GetProducer();
+        uint32_t first_op = producer == nullptr ? 0 : op_indices.at(producer);
+        uint32_t last_use = first_op;
+        for (auto* consumer : blob->GetConsumers()) {
+            last_use = std::max(last_use, op_indices.at(consumer));
+        }
+        if (graph.IsGraphOutput(blob->GetID())) {
+            last_use = last_op;
+        }
+        allocations.push_back({blob->GetID(), first_op, last_use, bytes, 0});
+    }
+    // An alias doesn't own memory, the blob owning it has to be alive whenever the alias is.
+    naive_bytes = 0;
+    std::unordered_map<BLOBID_T, size_t> allocation_indices;
+    for (size_t index = 0; index < allocations.size(); index++) {
+        allocation_indices[allocations[index].blob_id] = index;
+        naive_bytes += AlignUp(allocations[index].bytes, alignment);
+    }
+    std::vector<bool> is_alias(allocations.size(), false);
+    for (const auto& alias : aliases) {
+        auto alias_index = allocation_indices.find(alias.blob_id);
+        auto base_index  = allocation_indices.find(alias.base_id);
+        if (alias_index == allocation_indices.end() || base_index == allocation_indices.end()) {
+            continue;
+        }
+        auto& base                    = allocations[base_index->second];
+        base.first_op                 = std::min(base.first_op, allocations[alias_index->second].first_op);
+        base.last_op                  = std::max(base.last_op, allocations[alias_index->second].last_op);
+        is_alias[alias_index->second] = true;
+    }
+    size_t kept = 0;
+    for (size_t index = 0; index < allocations.size(); index++) {
+        if (!is_alias[index]) {
+            allocations[kept++] = allocations[index];
+        }
+    }
+    allocations.resize(kept);
+
+    std::sort(allocations.begin(), allocations.end(), [](const Allocation& lhs, const Allocation& rhs) {
+        return std::tie(lhs.first_op, lhs.blob_id) < std::tie(rhs.first_op, rhs.blob_id);
+    });
+    return allocations;
+}
+
+// Place allocations one by one in the given order. Each one goes to the smallest gap between already placed
+// allocations alive at the same time, or on top of them if no gap is large enough.
+void AssignOffsets(std::vector<Allocation>& allocations, const std::vector<size_t>& order, size_t alignment) {
+    // Indices of placed allocations, sorted by offset.
+    std::vector<size_t> placed;
+    placed.reserve(order.size());
+    for (auto index : order) {
+        auto&  allocation  = allocations[index];
+        size_t bytes       = AlignUp(allocation.bytes, alignment);
+        size_t best_offset = SIZE_MAX;
+        size_t best_gap    = SIZE_MAX;
+        size_t top         = 0;
+        for (auto placed_index : placed) {
+            const auto& other = allocations[placed_index];
+            if (!IsLifetimeOverlapped(allocation, other)) {
+                continue;
+            }
+            if (other.offset >= top + bytes && other.offset - top < best_gap) {
+                best_gap    = other.offset - top;
+                best_offset = top;
+            }
+            top = std::max(top, other.offset + AlignUp(other.bytes, alignment));
+        }
+        allocation.offset = best_offset == SIZE_MAX ? top : best_offset;
+
+        auto position =
+            std::upper_bound(placed.begin(), placed.end(), allocation.offset,
+                             [&](size_t offset, size_t other) { return offset < allocations[other].offset; });
+        placed.insert(position, index);
+    }
+}
+
+template <typename T> void AppendValue(std::vector<uint8_t>& bytes, T value) {
+    uint8_t raw[sizeof(T)];
+    memcpy(raw, &value, sizeof(T));
+    bytes.insert(bytes.end(), raw, raw + sizeof(T));
+}
+}  // namespace
+
+MemoryPlanner::MemoryPlan MemoryPlanner::Plan(const Graph&                             graph,
+                                               Strategy                                 strategy,
+                                               size_t                                   alignment,
+                                               const std::vector<AliasAnalysis::Alias>& aliases) {
+    LOG(INFO) << "MemoryPlanner::Plan Start.";
+    REPORT_ERROR_IF(alignment == 0, "Alignment of memory plan should be positive.");
+    MemoryPlan plan;
+    plan.alignment   = alignment;
+    plan.aliases     = aliases;
+    plan.allocations = CollectLifetimes(graph, aliases, alignment, plan.naive_bytes);
+
+    std::vector<size_t> order(plan.allocations.size());
+    for (size_t index = 0; index < order.size(); index++) {
+        order[index] = index;
+    }
+    // Allocations are sorted by execution order already, which is the order of BEST_FIT.
+    if (strategy == Strategy::GREEDY_BY_SIZE) {
+        std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+            return plan.allocations[lhs].bytes > plan.allocations[rhs].bytes;
+        });
+    }
+    AssignOffsets(plan.allocations, order, alignment);
+
+    plan.arena_bytes = 0;
+    for (const auto& allocation : plan.allocations) {
+        plan.arena_bytes = std::max(plan.arena_bytes, allocation.offset + AlignUp(allocation.bytes, alignment));
+    }
+    LOG(INFO) << "MemoryPlanner::Plan End. Arena takes " << plan.arena_bytes << " bytes for "
+              << plan.allocations.size() << " tensors, " << plan.naive_bytes << " bytes without reuse.";
+    return plan;
+}
+
+bool MemoryPlanner::Verify(const MemoryPlan& plan) {
+    const auto& allocations = plan.allocations;
+    for (size_t index = 0; index < allocations.size(); index++) {
+        const auto& allocation = allocations[index];
+        if (allocation.offset % plan.alignment != 0 || allocation.offset + allocation.bytes > plan.arena_bytes) {
+            return false;
+        }
+        for (size_t other_index = index + 1; other_index < allocations.size(); other_index++) {
+            const auto& other = allocations[other_index];
+            if (IsLifetimeOverlapped(allocation, other) && allocation.offset < other.offset + other.bytes &&
+                other.offset < allocation.offset + allocation.bytes) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::vector<uint8_t> MemoryPlanner::Encode(const MemoryPlan& plan, const std::map<BLOBID_T, uint32_t>& tensor_indices) {
+    std::vector<uint8_t> bytes;
+    AppendValue<uint32_t>(bytes, plan_version);
+    AppendValue<uint32_t>(bytes, static_cast<uint32_t>(plan.alignment));
+    AppendValue<uint64_t>(bytes, plan.arena_bytes);
+    AppendValue<uint32_t>(bytes, static_cast<uint32_t>(plan.allocations.size()));
+    for (const auto& allocation : plan.allocations) {
+        auto tensor_index = tensor_indices.find(allocation.blob_id);
+        REPORT_ERROR_IF(tensor_index == tensor_indices.end(), "Blob ", allocation.blob_id,
+                        " in memory plan isn't exported.");
+        AppendValue<uint32_t>(bytes, tensor_index->second);
+        AppendValue<uint32_t>(bytes, allocation.first_op);
+        AppendValue<uint32_t>(bytes, allocation.last_op);
+        AppendValue<uint64_t>(bytes, allocation.offset);
+        AppendValue<uint64_t>(bytes, allocation.bytes);
+    }
+    AppendValue<uint32_t>(bytes, static_cast<uint32_t>(plan.aliases.size()));
+    for (const auto& alias : plan.aliases) {
+        auto tensor_index = tensor_indices.find(alias.blob_id);
+        auto base_index   = tensor_indices.find(alias.base_id);
+        REPORT_ERROR_IF(tensor_index == tensor_indices.end() || base_index == tensor_indices.end(), "Alias of blob ",
+                        alias.blob_id, " in memory plan isn't exported.");
+        AppendValue<uint32_t>(bytes, tensor_index->second);
+        AppendValue<uint32_t>(bytes, base_index->second);
+        AppendValue<uint64_t>(bytes, alias.byte_offset);
+    }
+    return bytes;
+}
@@ -0,0 +1,225 @@
+#include "analysis/pipeline_partitioner.h"
+
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "common/stl_wrapper.h"
+
+namespace {
+using Stage = PipelinePartitioner::Stage;
+
+constexpr uint64_t infinite_bytes = UINT64_MAX;
+
+uint64_t GetBytes(const DataBlob& blob) {
+    uint64_t num_elements = 1;
+    for (auto dim : blob.GetShape().GetDims()) {
+        if (dim < 0) {
+            return 0;
+        }
+        num_elements *= static_cast<uint64_t>(dim);
+    }
+    return (num_elements * GetBitWidth(blob.GetDataType()) + 7) / 8;
+}
+
+// Smallest cost of the slowest stage when operators are split into at most `num_stages` ranges, by binary search over
+// the greedy packing which closes a stage as soon as the next operator doesn't fit.
+double FindBottleneck(const std::vector<double>& prefix_costs, uint32_t num_stages) {
+    size_t num_ops = prefix_costs.size() - 1;
+    double low     = prefix_costs.back() / num_stages;
+    double high    = prefix_costs.back();
+    for (size_t index = 0; index < num_ops; index++) {
+        low = std::max(low, prefix_costs[index + 1] - prefix_costs[index]);
+    }
+    auto is_feasible = [&](double limit) {
+        uint32_t stages = 1;
+        size_t   begin  = 0;
+        for (size_t end = 1; end <= num_ops; end++) {
+            if (prefix_costs[end] - prefix_costs[begin] > limit) {
+                stages++;
+                begin = end - 1;
+            }
+        }
+        return stages <= num_stages;
+    };
+    if (is_feasible(low)) {
+        return low;
+    }
+    for (int iteration = 0; iteration < 100 && high - low > 1e-9 * high; iteration++) {
+        double middle = (low + high) / 2;
+        (is_feasible(middle) ? high : low) = middle;
+    }
+    return high;
+}
+
+// Bytes of activation blobs produced before each position and read at or after it, i.e. the traffic of a cut there.
+std::vector<uint64_t> CollectBoundaryBytes(const Graph&                                         graph,
+                                           const std::vector<Operator*>&                        sorted_ops,
+                                           const std::unordered_map<const Operator*, uint32_t>& op_indices) {
+    std::vector<int64_t> deltas(sorted_ops.size() + 1, 0);
+    for (uint32_t index = 0; index < sorted_ops.size(); index++) {
+        for (const auto* blob : sorted_ops[index]->GetOutputBlobs()) {
+            uint32_t last_use = index;
+            for (const auto* consumer : blob->GetConsumers()) {
+                auto consumer_index = op_indices.find(consumer);
+                if (consumer_index != op_indices.end()) {
+                    last_use = std::max(last_use, consumer_index->second);
+                }
+            }
+            if (last_use > index && graph.GetBuffer(blob->GetID()) == nullptr) {
+                auto bytes = static_cast<int64_t>(GetBytes(*blob));
+                deltas[index + 1] += bytes;
+                deltas[last_use + 1] -= bytes;
+            }
+        }
+    }
+    std::vector<uint64_t> boundary_bytes(sorted_ops.size() + 1, 0);
+    int64_t               crossing = 0;
+    for (size_t position = 0; position <= sorted_ops.size(); position++) {
+        crossing += deltas[position];
+        boundary_bytes[position] = static_cast<uint64_t>(crossing);
+    }
+    return boundary_bytes;
+}
+
+// Split [0, num_ops) into exactly `num_stages` ranges costing at most `limit` each, with the fewest boundary bytes.
+// dp[j][k] is the fewest bytes to cover the first k operators with j stages, the last stage starts at one of the
+// positions i whose range [i, k) fits the limit. Those positions form a sliding window, so a monotonic deque keeps
+// its minimum and the whole search is O(num_stages * num_ops).
+std::vector<uint32_t> FindCuts(const std::vector<double>&   prefix_costs,
+                               const std::vector<uint64_t>& boundary_bytes,
+                               uint32_t                     num_stages,
+                               double                       limit) {
+    size_t                             num_ops = prefix_costs.size() - 1;
+    std::vector<uint64_t>              previous(num_ops + 1, infinite_bytes);
+    std::vector<uint64_t>              current(num_ops + 1, infinite_bytes);
+    std::vector<std::vector<uint32_t>> parents(num_stages, std::vector<uint32_t>(num_ops + 1, 0));
+    previous[0] = 0;
+    for (uint32_t stage = 1; stage <= num_stages; stage++) {
+        std::fill(current.begin(), current.end(), infinite_bytes);
+        auto cost_with_cut = [&](size_t begin) { return previous[begin] + (begin == 0 ? 0 : boundary_bytes[begin]); };
+
+        std::deque<size_t> window;
+        size_t             next_begin = stage - 1;
+        for (size_t end = stage; end + (num_stages - stage) <= num_ops; end++) {
+            for (; next_begin < end; next_begin++) {
+                if (previous[next_begin] == infinite_bytes) {
+                    continue;
+                }
+                while (!window.empty() && cost_with_cut(window.back()) >= cost_with_cut(next_begin)) {
+                    window.pop_back();
+                }
+                window.push_back(next_begin);
+            }
+            while (!window.empty() && prefix_costs[end] - prefix_costs[window.front()] > limit) {
+                window.pop_front();
+            }
+            if (!window.empty()) {
+                current[end]            = cost_with_cut(window.front());
+                parents[stage - 1][end] = static_cast<uint32_t>(window.front());
+            }
+        }
+        previous.swap(current);
+    }
+    REPORT_ERROR_IF(previous[num_ops] == infinite_bytes, "No pipeline partition fits the stage cost limit ", limit,
+                    ".");
+
+    std::vector<uint32_t> cuts(num_stages + 1);
+    cuts[num_stages] = static_cast<uint32_t>(num_ops);
+    for (uint32_t stage = num_stages; stage > 0; stage--) {
+        cuts[stage - 1] = parents[stage - 1][cuts[stage]];
+    }
+    return cuts;
+}
+
+// Put blobs which are also graph inputs or outputs first, in their order in the graph.
+std::vector<BLOBID_T> OrderBoundary(const std::vector<BLOBID_T>& blob_ids, const std::vector<BLOBID_T>& graph_ids) {
+    std::vector<BLOBID_T> ordered;
+    for (auto graph_id : graph_ids) {
+        if (std::find(blob_ids.begin(), blob_ids.end(), graph_id) != blob_ids.end() &&
+            std::find(ordered.begin(), ordered.end(), graph_id) == ordered.end()) {
+            ordered.push_back(graph_id);
+        }
+    }
+    for (auto blob_id : blob_ids) {
+        if (std::find(graph_ids.begin(), graph_ids.end(), blob_id) == graph_ids.end()) {
+            ordered.push_back(blob_id);
+        }
+    }
+    return ordered;
+}
+
+void CollectStageBoundary(const Graph&                                         graph,
+                          const std::vector<Operator*>&                        sorted_ops,
+                          const std::unordered_map<const Operator*, uint32_t>& op_indices,
+                          Stage&                                               stage) {
+    std::vector<BLOBID_T>        inputs;
+    std::vector<BLOBID_T>        outputs;
+    std::unordered_set<BLOBID_T> visited_inputs;
+    for (auto index = stage.begin; index < stage.end; index++) {
+        for (const auto* blob : sorted_ops[index]->GetInputBlobs()) {
+            auto producer_index = op_indices.find(blob->GetProducer());
+            bool is_outer       = producer_index == op_indices.end() || producer_index->second < stage.begin;
+            if (is_outer && graph.GetBuffer(blob->GetID()) == nullptr && visited_inputs.insert(blob->GetID()).second) {
+                inputs.push_back(blob->GetID());
+            }
+        }
+        for (const auto* blob : sorted_ops[index]->GetOutputBlobs()) {
+            bool is_read_later = common::any_of(blob->GetConsumers(), [&](const Operator* consumer) {
+                auto consumer_index = op_indices.find(consumer);
+                return consumer_index != op_indices.end() && consumer_index->second >= stage.end;
+            });
+            if (is_read_later || graph.IsGraphOutput(blob->GetID())) {
+                outputs.push_back(blob->GetID());
+            }
+        }
+    }
+    stage.inputs  = OrderBoundary(inputs, graph.GetGraphInputs());
+    stage.outputs = OrderBoundary(outputs, graph.GetGraphOutputs());
+}
+}  // namespace
+
+PipelinePartitioner::Partition PipelinePartitioner::Run(const Graph&               graph,
+                                                        uint32_t                   num_stages,
+                                                        const CostModel::Roofline& roofline,
+                                                        double                     tolerance) {
+    LOG(INFO) << "PipelinePartitioner::Run Start.";
+    auto sorted_ops = graph.TopologicalSort();
+    REPORT_ERROR_IF(num_stages == 0 || num_stages > sorted_ops.size(), "Cannot split ", sorted_ops.size(),
+                    " operators into ", num_stages, " stages.");
+    REPORT_ERROR_IF(tolerance < 0, "Tolerance of stage cost should not be negative.");
+
+    std::unordered_map<const Operator*, uint32_t> op_indices;
+    std::vector<double>                           prefix_costs(sorted_ops.size() + 1, 0.0);
+    for (uint32_t index = 0; index < sorted_ops.size(); index++) {
+        op_indices[sorted_ops[index]] = index;
+        prefix_costs[index + 1] =
+            prefix_costs[index] + roofline.EstimateSeconds(CostModel::EstimateOperator(graph, *sorted_ops[index]));
+    }
+    auto boundary_bytes = CollectBoundaryBytes(graph, sorted_ops, op_indices);
+    auto bottleneck     = FindBottleneck(prefix_costs, num_stages);
+    // A tiny slack keeps the bottleneck itself feasible despite rounding of prefix sums.
+    auto limit = bottleneck * (1.0 + tolerance) + 1e-12 * prefix_costs.back();
+    auto cuts  = FindCuts(prefix_costs, boundary_bytes, num_stages, limit);
+
+    Partition partition;
+    for (uint32_t index = 0; index < num_stages; index++) {
+        Stage stage;
+        stage.begin   = cuts[index];
+        stage.end     = cuts[index + 1];
+        stage.seconds = prefix_costs[stage.end] - prefix_costs[stage.begin];
+        CollectStageBoundary(graph, sorted_ops, op_indices, stage);
+        partition.stages.push_back(std::move(stage));
+        if (index + 1 < num_stages) {
+            partition.boundary_bytes.push_back(boundary_bytes[cuts[index + 1]]);
+        }
+    }
+    uint64_t total_boundary_bytes = 0;
+    for (auto bytes : partition.boundary_bytes) {
+        total_boundary_bytes += bytes;
+    }
+    LOG(INFO) << "PipelinePartitioner::Run End. Slowest stage takes " << bottleneck << " s at best, "
+              << total_boundary_bytes << " bytes cross stage boundaries.";
+    return partition;
+}
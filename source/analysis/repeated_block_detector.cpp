@@ -0,0 +1,205 @@
+#include "analysis/repeated_block_detector.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "common/hash_utils.h"
+#include "common/stl_wrapper.h"
+
+namespace {
+// Block sizes tried per search, the most frequent distances between repeated signatures first.
+constexpr size_t max_candidates = 64;
+
+using BlockFamily = RepeatedBlockDetector::BlockFamily;
+
+struct OperatorSequence {
+    std::vector<Operator*>                 ops;
+    std::unordered_map<NODEID_T, uint32_t> positions;
+    std::vector<size_t>                    signatures;
+};
+
+// A run of `num_blocks` blocks of `num_ops` operators beginning at position `start`.
+struct Repeat {
+    uint32_t start;
+    uint32_t num_ops;
+    uint32_t num_blocks;
+};
+
+bool IsSameKind(const Graph& graph, const DataBlob& blob1, const DataBlob& blob2) {
+    return blob1.GetShape() == blob2.GetShape() && blob1.GetDataType() == blob2.GetDataType() &&
+           (graph.GetBuffer(blob1.GetID()) == nullptr) == (graph.GetBuffer(blob2.GetID()) == nullptr);
+}
+
+size_t HashKind(const Graph& graph, const DataBlob* blob) {
+    if (blob == nullptr) {
+        return 0;
+    }
+    size_t seed = common::hash_value(blob->GetShape().GetDims());
+    common::hash_combine(seed, static_cast<int>(blob->GetDataType()));
+    common::hash_combine(seed, graph.GetBuffer(blob->GetID()) != nullptr);
+    return seed;
+}
+
+// Equal for operators at the same position of two blocks, weights and connectivity aside.
+size_t HashSignature(const Graph& graph, const Operator& op) {
+    size_t seed = common::hash_value(static_cast<int>(op.GetOpType()));
+    if (op.HasOption()) {
+        common::hash_combine(seed, op.GetBaseOption()->Hash());
+    }
+    for (const auto* blob : op.GetInputBlobs()) {
+        common::hash_combine(seed, HashKind(graph, blob));
+    }
+    for (const auto* blob : op.GetOutputBlobs()) {
+        common::hash_combine(seed, HashKind(graph, blob));
+    }
+    return seed;
+}
+
+OperatorSequence BuildSequence(const Graph& graph) {
+    OperatorSequence sequence;
+    sequence.ops = graph.TopologicalSort();
+    for (uint32_t position = 0; position < sequence.ops.size(); position++) {
+        sequence.positions[sequence.ops[position]->GetID()] = position;
+        sequence.signatures.push_back(HashSignature(graph, *sequence.ops[position]));
+    }
+    return sequence;
+}
+
+bool IsSameInput(const Graph&            graph,
+                 const OperatorSequence& sequence,
+                 uint32_t                position1,
+                 uint32_t                position2,
+                 const DataBlob*         blob1,
+                 const DataBlob*         blob2) {
+    if (blob1 == blob2) {
+        return true;
+    }
+    if (blob1 == nullptr || blob2 == nullptr || !IsSameKind(graph, *blob1, *blob2)) {
+        return false;
+    }
+    if (graph.GetBuffer(blob1->GetID()) != nullptr) {
+        return true;
+    }
+    const auto* producer1 = blob1->GetProducer();
+    const auto* producer2 = blob2->GetProducer();
+    if (producer1 == nullptr || producer2 == nullptr) {
+        return false;
+    }
+    return position1 - sequence.positions.at(producer1->GetID()) ==
+               position2 - sequence.positions.at(producer2->GetID()) &&
+           common::get_first_index(producer1->GetOutputIDs(), blob1->GetID()) ==
+               common::get_first_index(producer2->GetOutputIDs(), blob2->GetID());
+}
+
+bool IsSameOperator(const Graph& graph, const OperatorSequence& sequence, uint32_t position1, uint32_t position2) {
+    const auto* op1 = sequence.ops[position1];
+    const auto* op2 = sequence.ops[position2];
+    if (sequence.signatures[position1] != sequence.signatures[position2] || op1->GetOpType() != op2->GetOpType() ||
+        op1->HasOption() != op2->HasOption() || op1->GetInputIDs().size() != op2->GetInputIDs().size() ||
+        op1->GetOutputIDs().size() != op2->GetOutputIDs().size()) {
+        return false;
+    }
+    if (op1->HasOption() && !op1->GetBaseOption()->Equals(*op2->GetBaseOption())) {
+        return false;
+    }
+    for (size_t index = 0; index < op1->GetOutputIDs().size(); index++) {
+        const auto* output1 = op1->GetOutputBlob(index);
+        const auto* output2 = op2->GetOutputBlob(index);
+        if (output1 == nullptr || output2 == nullptr || !IsSameKind(graph, *output1, *output2)) {
+            return false;
+        }
+    }
+    for (size_t index = 0; index < op1->GetInputIDs().size(); index++) {
+        if (!IsSameInput(graph, sequence, position1, position2, op1->GetInputBlob(index), op2->GetInputBlob(index))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Distances between consecutive operators of the same signature, the most frequent first. Distances shorter than
+// `min_block_ops` are rounded up to a multiple.
+std::vector<uint32_t> FindCandidateSizes(const OperatorSequence& sequence, uint32_t min_block_ops) {
+    std::unordered_map<size_t, uint32_t>   last_positions;
+    std::unordered_map<uint32_t, uint32_t> distance_counts;
+    for (uint32_t position = 0; position < sequence.ops.size(); position++) {
+        auto [last_position, is_first] = last_positions.emplace(sequence.signatures[position], position);
+        if (is_first) {
+            continue;
+        }
+        // Blocks smaller than allowed are grouped, e.g. pairs of layers.
+        auto distance = position - last_position->second;
+        distance_counts[(min_block_ops + distance - 1) / distance * distance]++;
+        last_position->second = position;
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> counted_distances(distance_counts.begin(), distance_counts.end());
+    std::sort(counted_distances.begin(), counted_distances.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second != rhs.second ? lhs.second > rhs.second : lhs.first < rhs.first;
+    });
+    std::vector<uint32_t> sizes;
+    for (size_t index = 0; index < counted_distances.size() && index < max_candidates; index++) {
+        sizes.push_back(counted_distances[index].first);
+    }
+    return sizes;
+}
+
+// The longest run of blocks of `num_ops` operators. Operator i matching operator i + num_ops for `run` consecutive
+// positions means `run / num_ops + 1` blocks.
+Repeat FindRepeat(const Graph&                graph,
+                  const OperatorSequence&     sequence,
+                  const std::vector<uint8_t>& covered,
+                  uint32_t                    num_ops) {
+    Repeat   longest {0, num_ops, 0};
+    uint32_t run = 0;
+    for (uint32_t position = 0; position + num_ops < sequence.ops.size(); position++) {
+        if (covered[position] || covered[position + num_ops] ||
+            !IsSameOperator(graph, sequence, position, position + num_ops)) {
+            run = 0;
+            continue;
+        }
+        run++;
+        uint32_t num_blocks = run / num_ops + 1;
+        if (num_blocks >= 2 && num_blocks > longest.num_blocks) {
+            longest = {position + 1 - run, num_ops, num_blocks};
+        }
+    }
+    return longest;
+}
+}  // namespace
+
+std::vector<RepeatedBlockDetector::BlockFamily> RepeatedBlockDetector::Run(const Graph& graph, uint32_t min_block_ops) {
+    LOG(INFO) << "RepeatedBlockDetector::Run Start.";
+    auto sequence   = BuildSequence(graph);
+    auto candidates = FindCandidateSizes(sequence, std::max(min_block_ops, 1U));
+
+    std::vector<uint8_t>     covered(sequence.ops.size(), 0);
+    std::vector<BlockFamily> families;
+    uint32_t                 covered_ops = 0;
+    while (true) {
+        Repeat best {0, 0, 0};
+        for (auto num_ops : candidates) {
+            auto repeat   = FindRepeat(graph, sequence, covered, num_ops);
+            auto coverage = repeat.num_ops * repeat.num_blocks;
+            if (repeat.num_blocks >= 2 && (coverage > best.num_ops * best.num_blocks ||
+                                           (coverage == best.num_ops * best.num_blocks && num_ops < best.num_ops))) {
+                best = repeat;
+            }
+        }
+        if (best.num_blocks < 2) {
+            break;
+        }
+
+        BlockFamily family {best.num_ops, {}};
+        for (uint32_t block = 0; block < best.num_blocks; block++) {
+            auto begin = best.start + block * best.num_ops;
+            family.instances.emplace_back(sequence.ops.begin() + begin, sequence.ops.begin() + begin + best.num_ops);
+            std::fill(covered.begin() + begin, covered.begin() + begin + best.num_ops, 1);
+        }
+        covered_ops += best.num_ops * best.num_blocks;
+        families.push_back(std::move(family));
+    }
+    LOG(INFO) << "RepeatedBlockDetector::Run End. Found " << families.size() << " block families covering "
+              << covered_ops << " of " << sequence.ops.size() << " operators.";
+    return families;
+}
@@ -0,0 +1,873 @@
+#include "analysis/shape_inference.h"
+
+#include <algorithm>
+
+namespace {
+using Dims = std::vector<int>;
+
+constexpr int unknown_dim = -1;
+
+// Shapes and data types of operator outputs, initialized with current values so that inference only overwrites what
+// it knows.
+struct Outputs {
+    std::vector<Dims>     dims;
+    std::vector<DataType> types;
+};
+
+const Dims& InputDims(const Operator& op, size_t index) { return op.GetInputBlob(index)->GetShape().GetDims(); }
+
+DataType InputType(const Operator& op, size_t index) { return op.GetInputBlob(index)->GetDataType(); }
+
+bool GetConstant(const Graph& graph, const Operator& op, size_t index, std::vector<int64_t>& values) {
+    return index < op.GetInputIDs().size() && graph.GetIntegerConstant(op.GetInputIDs()[index], values);
+}
+
+template <typename OptionT> const OptionT* GetOption(const Operator& op) {
+    return op.HasOption() ? op.GetOption<OptionT>() : nullptr;
+}
+
+int MultiplyDims(int lhs, int rhs) { return lhs < 0 || rhs < 0 ? unknown_dim : lhs * rhs; }
+
+int AddDims(int lhs, int rhs) { return lhs < 0 || rhs < 0 ? unknown_dim : lhs + rhs; }
+
+int64_t NumElements(const Dims& dims) {
+    int64_t num_elements = 1;
+    for (auto dim : dims) {
+        if (dim < 0) {
+            return unknown_dim;
+        }
+        num_elements *= dim;
+    }
+    return num_elements;
+}
+
+bool NormalizeAxis(int64_t axis, size_t rank, int& normalized_axis) {
+    if (axis < 0) {
+        axis += static_cast<int64_t>(rank);
+    }
+    normalized_axis = static_cast<int>(axis);
+    return axis >= 0 && axis < static_cast<int64_t>(rank);
+}
+
+// Numpy style broadcast. An unknown dim broadcast with 1 stays unknown, with a known dim it takes the known dim.
+bool BroadcastDims(const Dims& lhs, const Dims& rhs, Dims& result) {
+    size_t rank = std::max(lhs.size(), rhs.size());
+    Dims   broadcast_dims(rank);
+    for (size_t index = 0; index < rank; index++) {
+        int lhs_dim = index < rank - lhs.size() ? 1 : lhs[index - (rank - lhs.size())];
+        int rhs_dim = index < rank - rhs.size() ? 1 : rhs[index - (rank - rhs.size())];
+        if (lhs_dim == 1 || lhs_dim == rhs_dim) {
+            broadcast_dims[index] = rhs_dim;
+        } else if (rhs_dim == 1 || rhs_dim < 0) {
+            broadcast_dims[index] = lhs_dim;
+        } else if (lhs_dim < 0) {
+            broadcast_dims[index] = rhs_dim;
+        } else {
+            return false;
+        }
+    }
+    result = std::move(broadcast_dims);
+    return true;
+}
+
+int ConvOutputSize(int in_size, int filter, int stride, int dilation, Padding pad_type) {
+    if (in_size < 0 || filter < 0 || stride <= 0) {
+        return unknown_dim;
+    }
+    int effective_filter = (filter - 1) * std::max(dilation, 1) + 1;
+    if (pad_type == Padding::SAME) {
+        return (in_size + stride - 1) / stride;
+    }
+    return std::max((in_size - effective_filter + stride) / stride, 0);
+}
+
+bool InferSameAsInput(const Operator& op, Outputs& outputs) {
+    outputs.dims[0] = InputDims(op, 0);
+    return true;
+}
+
+bool InferBroadcast(const Operator& op, Outputs& outputs) {
+    Dims dims = InputDims(op, 0);
+    for (size_t index = 1; index < op.GetInputIDs().size(); index++) {
+        if (!BroadcastDims(dims, InputDims(op, index), dims)) {
+            return false;
+        }
+    }
+    outputs.dims[0] = dims;
+    return true;
+}
+
+template <typename OptionT> bool InferConv2D(const Operator& op, Outputs& outputs) {
+    const auto& input  = InputDims(op, 0);
+    const auto& filter = InputDims(op, 1);
+    const auto* option = GetOption<OptionT>(op);
+    if (input.size() != 4 || filter.size() != 4 || option == nullptr) {
+        return false;
+    }
+    // CONV2D filter is OHWI while DEPTHWISE_CONV2D filter is 1HWO.
+    int out_channels = op.GetOpType() == OperatorType::CONV2D ? filter[0] : filter[3];
+    outputs.dims[0]  = {input[0],
+                        ConvOutputSize(input[1], filter[1], option->stride_h, option->dilation_h, option->pad_type),
+                        ConvOutputSize(input[2], filter[2], option->stride_w, option->dilation_w, option->pad_type),
+                        out_channels};
+    return true;
+}
+
+bool InferConv3D(const Operator& op, Outputs& outputs) {
+    const auto& input  = InputDims(op, 0);
+    const auto& filter = InputDims(op, 1);
+    const auto* option = GetOption<Conv3DOption>(op);
+    if (input.size() != 5 || filter.size() != 5 || option == nullptr) {
+        return false;
+    }
+    // NDHWC input with DHWIO filter.
+    outputs.dims[0] = {
+        input[0],
+        ConvOutputSize(input[1], filter[0], option->stride_d, option->dilation_d_factor, option->pad_type),
+        ConvOutputSize(input[2], filter[1], option->stride_h, option->dilation_h_factor, option->pad_type),
+        ConvOutputSize(input[3], filter[2], option->stride_w, option->dilation_w_factor, option->pad_type),
+        filter[4]};
+    return true;
+}
+
+bool InferTransposeConv2D(const Graph& graph, const Operator& op, Outputs& outputs) {
+    // Inputs are (output_shape, filter, input, [bias]).
+    std::vector<int64_t> output_shape;
+    outputs.types[0] = InputType(op, 2);
+    if (GetConstant(graph, op, 0, output_shape)) {
+        outputs.dims[0] = Dims(output_shape.begin(), output_shape.end());
+        return true;
+    }
+    const auto& filter = InputDims(op, 1);
+    const auto& input  = InputDims(op, 2);
+    const auto* option = GetOption<TransposeConv2DOption>(op);
+    if (input.size() != 4 || filter.size() != 4 || option == nullptr) {
+        return false;
+    }
+    auto output_size = [&](int in_size, int filter_size, int stride) {
+        if (in_size < 0 || filter_size < 0) {
+            return unknown_dim;
+        }
+        return option->pad_type == Padding::SAME ? in_size * stride : (in_size - 1) * stride + filter_size;
+    };
+    outputs.dims[0] = {input[0], output_size(input[1], filter[1], option->stride_h),
+                       output_size(input[2], filter[2], option->stride_w), filter[0]};
+    return true;
+}
+
+bool InferPool2D(const Operator& op, Outputs& outputs) {
+    const auto& input  = InputDims(op, 0);
+    const auto* option = GetOption<Pool2DOption>(op);
+    if (input.size() != 4 || option == nullptr) {
+        return false;
+    }
+    outputs.dims[0] = {input[0], ConvOutputSize(input[1], option->filter_h, option->stride_h, 1, option->pad_type),
+                       ConvOutputSize(input[2], option->filter_w, option->stride_w, 1, option->pad_type), input[3]};
+    return true;
+}
+
+bool InferFullyConnected(const Operator& op, Outputs& outputs) {
+    const auto& input   = InputDims(op, 0);
+    const auto& weights = InputDims(op, 1);
+    const auto* option  = GetOption<FullyConnectedOption>(op);
+    if (input.empty() || weights.size() != 2) {
+        return false;
+    }
+    if (option != nullptr && option->keep_num_dims) {
+        outputs.dims[0]        = input;
+        outputs.dims[0].back() = weights[0];
+        return true;
+    }
+    auto num_elements = NumElements(input);
+    int  batch        = num_elements < 0 || weights[1] <= 0 ? unknown_dim : num_elements / weights[1];
+    outputs.dims[0]   = {batch, weights[0]};
+    return true;
+}
+
+bool InferBatchMatmul(const Operator& op, Outputs& outputs) {
+    const auto& lhs    = InputDims(op, 0);
+    const auto& rhs    = InputDims(op, 1);
+    const auto* option = GetOption<BatchMatmulOption>(op);
+    if (lhs.size() < 2 || rhs.size() < 2) {
+        return false;
+    }
+    bool adj_x = option != nullptr && option->adj_x;
+    bool adj_y = option != nullptr && option->adj_y;
+    Dims batch;
+    if (!BroadcastDims(Dims(lhs.begin(), lhs.end() - 2), Dims(rhs.begin(), rhs.end() - 2), batch)) {
+        return false;
+    }
+    batch.push_back(adj_x ? lhs[lhs.size() - 1] : lhs[lhs.size() - 2]);
+    batch.push_back(adj_y ? rhs[rhs.size() - 2] : rhs[rhs.size() - 1]);
+    outputs.dims[0] = batch;
+    return true;
+}
+
+bool InferReshape(const Graph& graph, const Operator& op, Outputs& outputs) {
+    std::vector<int64_t> new_shape;
+    // The shape tensor takes precedence over the option, as in TfLite kernel.
+    if (!GetConstant(graph, op, 1, new_shape)) {
+        const auto* option = GetOption<ReshapeOption>(op);
+        if (op.GetInputIDs().size() > 1 || option == nullptr || option->new_shape.empty()) {
+            return false;
+        }
+        new_shape.assign(option->new_shape.begin(), option->new_shape.end());
+    }
+    Dims dims(new_shape.begin(), new_shape.end());
+    auto wildcard = std::find(dims.begin(), dims.end(), -1);
+    if (wildcard != dims.end()) {
+        *wildcard           = 1;
+        auto num_elements   = NumElements(InputDims(op, 0));
+        auto known_elements = NumElements(dims);
+        *wildcard           = num_elements < 0 || known_elements <= 0 ? unknown_dim : num_elements / known_elements;
+    }
+    outputs.dims[0] = dims;
+    return true;
+}
+
+bool InferSqueeze(const Operator& op, Outputs& outputs) {
+    const auto& input  = InputDims(op, 0);
+    const auto* option = GetOption<SqueezeOption>(op);
+    std::vector<bool> squeezed(input.size(), false);
+    if (option == nullptr || option->squeeze_dims.empty()) {
+        for (size_t index = 0; index < input.size(); index++) {
+            squeezed[index] = input[index] == 1;
+        }
+    } else {
+        for (auto squeeze_dim : option->squeeze_dims) {
+            int axis = 0;
+            if (!NormalizeAxis(squeeze_dim, input.size(), axis)) {
+                return false;
+            }
+            squeezed[axis] = true;
+        }
+    }
+    outputs.dims[0].clear();
+    for (size_t index = 0; index < input.size(); index++) {
+        if (!squeezed[index]) {
+            outputs.dims[0].push_back(input[index]);
+        }
+    }
+    return true;
+}
+
+bool InferExpandDims(const Graph& graph, const Operator& op, Outputs& outputs) {
+    std::vector<int64_t> axis;
+    int                  normalized_axis = 0;
+    Dims                 dims            = InputDims(op, 0);
+    if (!GetConstant(graph, op, 1, axis) || axis.size() != 1 ||
+        !NormalizeAxis(axis[0], dims.size() + 1, normalized_axis)) {
+        return false;
+    }
+    dims.insert(dims.begin() + normalized_axis, 1);
+    outputs.dims[0] = dims;
+    return true;
+}
+
+bool InferTranspose(const Graph& graph, const Operator& op, Outputs& outputs) {
+    std::vector<int64_t> perm;
+    const auto&          input = InputDims(op, 0);
+    if (!GetConstant(graph, op, 1, perm) || perm.size() != input.size()) {
+        return false;
+    }
+    Dims dims(perm.size());
+    for (size_t index = 0; index < perm.size(); index++) {
+        int axis = 0;
+        if (!NormalizeAxis(perm[index], input.size(), axis)) {
+            return false;
+        }
+        dims[index] = input[axis];
+    }
+    outputs.dims[0] = dims;
+    return true;
+}
+
+bool InferConcat(const Operator& op, Outputs& outputs) {
+    const auto* option = GetOption<ConcatOption>(op);
+    Dims        dims   = InputDims(op, 0);
+    int         axis   = 0;
+    if (option == nullptr || !NormalizeAxis(option->axis, dims.size(), axis)) {
+        return false;
+    }
+    for (size_t index = 1; index < op.GetInputIDs().size(); index++) {
+        const auto& input = InputDims(op, index);
+        if (input.size() != dims.size()) {
+            return false;
+        }
+        dims[axis] = AddDims(dims[axis], input[axis]);
+    }
+    outputs.dims[0] = dims;
+    return true;
+}
+
+bool InferPack(const Operator& op, Outputs& outputs) {
+    const auto* option = GetOption<PackOption>(op);
+    Dims        dims   = InputDims(op, 0);
+    int         axis   = 0;
+    if (option == nullptr || !NormalizeAxis(option->axis, dims.size() + 1, axis)) {
+        return false;
+    }
+    dims.insert(dims.begin() + axis, static_cast<int>(op.GetInputIDs().size()));
+    outputs.dims[0] = dims;
+    return true;
+}
+
+bool InferUnpack(const Operator& op, Outputs& outputs) {
+    const auto* option = GetOption<UnPackOption>(op);
+    Dims        dims   = InputDims(op, 0);
+    int         axis   = 0;
+    if (option == nullptr || !NormalizeAxis(option->axis, dims.size(), axis)) {
+        return false;
+    }
+    dims.erase(dims.begin() + axis);
+    std::fill(outputs.dims.begin(), outputs.dims.end(), dims);
+    return true;
+}
+
+bool InferSplit(const Graph& graph, const Operator& op, Outputs& outputs) {
+    // Inputs are (axis, input).
+    std::vector<int64_t> axis_value;
+    Dims                 dims = InputDims(op, 1);
+    int                  axis = 0;
+    if (!GetConstant(graph, op, 0, axis_value) || axis_value.size() != 1 ||
+        !NormalizeAxis(axis_value[0], dims.size(), axis)) {
+        return false;
+    }
+    int num_splits = static_cast<int>(outputs.dims.size());
+    dims[axis]     = dims[axis] < 0 ? unknown_dim : dims[axis] / num_splits;
+    std::fill(outputs.dims.begin(), outputs.dims.end(), dims);
+    std::fill(outputs.types.begin(), outputs.types.end(), InputType(op, 1));
+    return true;
+}
+
+bool InferSplitV(const Graph& graph, const Operator& op, Outputs& outputs) {
+    // Inputs are (input, size_splits, axis), at most one split size is -1.
+    std::vector<int64_t> size_splits;
+    std::vector<int64_t> axis_value;
+    const auto&          input = InputDims(op, 0);
+    int                  axis  = 0;
+    if (!GetConstant(graph, op, 1, size_splits) || !GetConstant(graph, op, 2, axis_value) || axis_value.size() != 1 ||
+        !NormalizeAxis(axis_value[0], input.size(), axis) || size_splits.size() != outputs.dims.size()) {
+        return false;
+    }
+    int64_t known_size = 0;
+    for (auto size : size_splits) {
+        known_size += std::max<int64_t>(size, 0);
+    }
+    for (size_t index = 0; index < size_splits.size(); index++) {
+        Dims dims = input;
+        if (size_splits[index] >= 0) {
+            dims[axis] = static_cast<int>(size_splits[index]);
+        } else {
+            dims[axis] = input[axis] < 0 ? unknown_dim : input[axis] - static_cast<int>(known_size);
+        }
+        outputs.dims[index] = dims;
+    }
+    return true;
+}
+
+bool InferSlice(const Graph& graph, const Operator& op, Outputs& outputs) {
+    std::vector<int64_t> begin;
+    std::vector<int64_t> size;
+    const auto&          input = InputDims(op, 0);
+    if (!GetConstant(graph, op, 1, begin) || !GetConstant(graph, op, 2, size) || begin.size() != input.size() ||
+        size.size() != input.size()) {
+        return false;
+    }
+    Dims dims(input.size());
+    for (size_t index = 0; index < input.size(); index++) {
+        if (size[index] >= 0) {
+            dims[index] = static_cast<int>(size[index]);
+        } else {
+            dims[index] = input[index] < 0 ? unknown_dim : input[index] - static_cast<int>(begin[index]);
+        }
+    }
+    outputs.dims[0] = dims;
+    return true;
+}
+
+bool InferStridedSlice(const Graph& graph, const Operator& op, Outputs& outputs) {
+    std::vector<int64_t> begin;
+    std::vector<int64_t> end;
+    std::vector<int64_t> strides;
+    const auto&          input  = InputDims(op, 0);
+    const auto*          option = GetOption<StridedSliceOption>(op);
+    if (option == nullptr || option->ellipsis_mask != 0 || option->new_axis_mask != 0 ||
+        !GetConstant(graph, op, 1, begin) || !GetConstant(graph, op, 2, end) || !GetConstant(graph, op, 3, strides) ||
+        begin.size() != input.size() || end.size() != input.size() || strides.size() != input.size()) {
+        return false;
+    }
+    Dims dims;
+    for (size_t index = 0; index < input.size(); index++) {
+        bool shrink = (option->shrink_axis_mask >> index) & 1;
+        if (shrink) {
+            continue;
+        }
+        int64_t dim    = input[index];
+        int64_t stride = strides[index];
+        if (dim < 0 || stride == 0) {
+            dims.push_back(unknown_dim);
+            continue;
+        }
+        int64_t start = begin[index];
+        int64_t stop  = option->offset ? begin[index] + end[index] : end[index];
+        if ((option->begin_mask >> index) & 1) {
+            start = stride > 0 ? 0 : dim - 1;
+        } else {
+            start = start < 0 ? start + dim : start;
+            start = stride > 0 ? std::clamp<int64_t>(start, 0, dim) : std::clamp<int64_t>(start, -1, dim - 1);
+        }
+        if ((option->end_mask >> index) & 1) {
+            stop = stride > 0 ? dim : -1;
+        } else {
+            stop = stop < 0 ? stop + dim : stop;
+            stop = stride > 0 ? std::clamp<int64_t>(stop, 0, dim) : std::clamp<int64_t>(stop, -1, dim - 1);
+        }
+        int64_t length = stride > 0 ? (stop - start + stride - 1) / stride : (start - stop - stride - 1) / -stride;
+        dims.push_back(static_cast<int>(std::max<int64_t>(length, 0)));
+    }
+    outputs.dims[0] = dims;
+    return true;
+}
+
+bool InferPad(const Graph& graph, const Operator& op, Outputs& outputs) {
+    std::vector<int64_t> paddings;
+    Dims                 dims = InputDims(op, 0);
+    if (!GetConstant(graph, op, 1, paddings) || paddings.size() != 2 * dims.size()) {
+        return false;
+    }
+    for (size_t index = 0; index < dims.size(); index++) {
+        dims[index] = AddDims(dims[index], static_cast<int>(paddings[2 * index] + paddings[2 * index + 1]));
+    }
+    outputs.dims[0] = dims;
+    return true;
+}
+
+bool InferReduce(const Graph& graph, const Operator& op, Outputs& outputs) {
+    std::vector<int64_t> axes;
+    const auto&          input     = InputDims(op, 0);
+    const auto*          option    = GetOption<ReducerOption>(op);
+    bool                 keep_dims = option != nullptr && option->keep_dims;
+    if (!GetConstant(graph, op, 1, axes)) {
+        return false;
+    }
+    std::vector<bool> reduced(input.size(), false);
+    for (auto axis : axes) {
+        int normalized_axis = 0;
+        if (!NormalizeAxis(axis, input.size(), normalized_axis)) {
+            return false;
+        }
+        reduced[normalized_axis] = true;
+    }
+    Dims dims;
+    for (size_t index = 0; index < input.size(); index++) {
+        if (!reduced[index]) {
+            dims.push_back(input[index]);
+        } else if (keep_dims) {
+            dims.push_back(1);
+        }
+    }
+    outputs.dims[0] = dims;
+    return true;
+}
+
+template <typename OptionT> bool InferArgMinMax(const Graph& graph, const Operator& op, Outputs& outputs) {
+    std::vector<int64_t> axis_value;
+    Dims                 dims = InputDims(op, 0);
+    int                  axis = 0;
+    if (!GetConstant(graph, op, 1, axis_value) || axis_value.size() != 1 ||
+        !NormalizeAxis(axis_value[0], dims.size(), axis)) {
+        return false;
+    }
+    dims.erase(dims.begin() + axis);
+    outputs.dims[0] = dims;
+    const auto* option = GetOption<OptionT>(op);
+    if (option != nullptr && (option->out_type == DataType::INT32 || option->out_type == DataType::INT64)) {
+        outputs.types[0] = option->out_type;
+    }
+    return true;
+}
+
+bool InferGather(const Operator& op, Outputs& outputs) {
+    const auto& params     = InputDims(op, 0);
+    const auto& indices    = InputDims(op, 1);
+    const auto* option     = GetOption<GatherOption>(op);
+    int         axis       = 0;
+    int         batch_dims = 0;
+    if (!NormalizeAxis(option == nullptr ? 0 : option->axis, params.size(), axis)) {
+        return false;
+    }
+    if (option != nullptr && option->batch_dims != 0 &&
+        !NormalizeAxis(option->batch_dims, indices.size() + 1, batch_dims)) {
+        return false;
+    }
+    // params[:axis] + indices[batch_dims:] + params[axis + 1:]
+    Dims dims(params.begin(), params.begin() + axis);
+    dims.insert(dims.end(), indices.begin() + batch_dims, indices.end());
+    dims.insert(dims.end(), params.begin() + axis + 1, params.end());
+    outputs.dims[0] = dims;
+    return true;
+}
+
+bool InferGatherND(const Operator& op, Outputs& outputs) {
+    const auto& params  = InputDims(op, 0);
+    const auto& indices = InputDims(op, 1);
+    if (indices.empty() || indices.back() < 0 || indices.back() > static_cast<int>(params.size())) {
+        return false;
+    }
+    Dims dims(indices.begin(), indices.end() - 1);
+    dims.insert(dims.end(), params.begin() + indices.back(), params.end());
+    outputs.dims[0] = dims;
+    return true;
+}
+
+bool InferTile(const Graph& graph, const Operator& op, Outputs& outputs) {
+    std::vector<int64_t> multiples;
+    Dims                 dims = InputDims(op, 0);
+    if (!GetConstant(graph, op, 1, multiples) || multiples.size() != dims.size()) {
+        return false;
+    }
+    for (size_t index = 0; index < dims.size(); index++) {
+        dims[index] = MultiplyDims(dims[index], static_cast<int>(multiples[index]));
+    }
+    outputs.dims[0] = dims;
+    return true;
+}
+
+bool InferBroadcastTo(const Graph& graph, const Operator& op, Outputs& outputs) {
+    std::vector<int64_t> shape;
+    if (!GetConstant(graph, op, 1, shape)) {
+        return false;
+    }
+    outputs.dims[0] = Dims(shape.begin(), shape.end());
+    return true;
+}
+
+bool InferResize(const Graph& graph, const Operator& op, Outputs& outputs) {
+    std::vector<int64_t> size;
+    const auto&          input = InputDims(op, 0);
+    if (input.size() != 4 || !GetConstant(graph, op, 1, size) || size.size() != 2) {
+        return false;
+    }
+    outputs.dims[0] = {input[0], static_cast<int>(size[0]), static_cast<int>(size[1]), input[3]};
+    return true;
+}
+
+bool InferDepthToSpace(const Operator& op, Outputs& outputs) {
+    const auto& input  = InputDims(op, 0);
+    const auto* option = GetOption<DepthToSpaceOption>(op);
+    if (input.size() != 4 || option == nullptr || option->block_size <= 0) {
+        return false;
+    }
+    int block       = option->block_size;
+    int channels    = input[3] < 0 ? unknown_dim : input[3] / (block * block);
+    outputs.dims[0] = {input[0], MultiplyDims(input[1], block), MultiplyDims(input[2], block), channels};
+    return true;
+}
+
+bool InferSpaceToDepth(const Operator& op, Outputs& outputs) {
+    const auto& input  = InputDims(op, 0);
+    const auto* option = GetOption<SpaceToDepthOption>(op);
+    if (input.size() != 4 || option == nullptr || option->block_size <= 0) {
+        return false;
+    }
+    int block       = option->block_size;
+    int height      = input[1] < 0 ? unknown_dim : input[1] / block;
+    int width       = input[2] < 0 ? unknown_dim : input[2] / block;
+    outputs.dims[0] = {input[0], height, width, MultiplyDims(input[3], block * block)};
+    return true;
+}
+
+// SPACE_TO_BATCH_ND pads spatial dims and moves blocks into batch, BATCH_TO_SPACE_ND crops after the inverse move.
+bool InferSpaceBatchND(const Graph& graph, const Operator& op, Outputs& outputs) {
+    std::vector<int64_t> block_shape;
+    std::vector<int64_t> paddings;
+    Dims                 dims = InputDims(op, 0);
+    if (!GetConstant(graph, op, 1, block_shape) || !GetConstant(graph, op, 2, paddings) ||
+        paddings.size() != 2 * block_shape.size() || dims.size() < block_shape.size() + 1) {
+        return false;
+    }
+    bool to_batch    = op.GetOpType() == OperatorType::SPACE_TO_BATCH_ND;
+    int  block_total = 1;
+    for (size_t index = 0; index < block_shape.size(); index++) {
+        int block = static_cast<int>(block_shape[index]);
+        int pads  = static_cast<int>(paddings[2 * index] + paddings[2 * index + 1]);
+        int dim   = dims[index + 1];
+        if (dim >= 0) {
+            dims[index + 1] = to_batch ? (dim + pads) / block : dim * block - pads;
+        }
+        block_total *= block;
+    }
+    if (dims[0] >= 0) {
+        dims[0] = to_batch ? dims[0] * block_total : dims[0] / block_total;
+    }
+    outputs.dims[0] = dims;
+    return true;
+}
+
+bool InferOneHot(const Graph& graph, const Operator& op, Outputs& outputs) {
+    // Inputs are (indices, depth, on_value, off_value).
+    std::vector<int64_t> depth;
+    Dims                 dims   = InputDims(op, 0);
+    const auto*          option = GetOption<OneHotOption>(op);
+    int                  axis   = 0;
+    if (!GetConstant(graph, op, 1, depth) || depth.size() != 1 ||
+        !NormalizeAxis(option == nullptr ? -1 : option->axis, dims.size() + 1, axis)) {
+        return false;
+    }
+    dims.insert(dims.begin() + axis, static_cast<int>(depth[0]));
+    outputs.dims[0]  = dims;
+    outputs.types[0] = InputType(op, 2);
+    return true;
+}
+
+bool InferTopK(const Graph& graph, const Operator& op, Outputs& outputs) {
+    std::vector<int64_t> k;
+    Dims                 dims = InputDims(op, 0);
+    if (dims.empty() || outputs.dims.size() != 2 || !GetConstant(graph, op, 1, k) || k.size() != 1) {
+        return false;
+    }
+    dims.back()      = static_cast<int>(k[0]);
+    outputs.dims     = {dims, dims};
+    outputs.types[1] = DataType::INT32;
+    return true;
+}
+
+bool InferShape(const Operator& op, Outputs& outputs) {
+    const auto* option = GetOption<ShapeOption>(op);
+    outputs.dims[0]    = {static_cast<int>(InputDims(op, 0).size())};
+    outputs.types[0]   = option != nullptr && option->out_type == DataType::INT64 ? DataType::INT64 : DataType::INT32;
+    return true;
+}
+
+bool InferSequence(const Operator& op, Outputs& outputs) {
+    // UNIDIRECTIONAL_LSTM reads n_output from recurrent_to_output_weights [n_cell, n_output], UNIDIRECTIONAL_RNN reads
+    // num_units from weights [num_units, input_size].
+    bool   is_lstm      = op.GetOpType() == OperatorType::UNIDIRECTIONAL_LSTM;
+    size_t weight_index = is_lstm ? 8 : 1;
+    if (op.GetInputIDs().size() <= weight_index) {
+        return false;
+    }
+    Dims        dims    = InputDims(op, 0);
+    const auto& weights = InputDims(op, weight_index);
+    if (dims.empty() || weights.size() != 2) {
+        return false;
+    }
+    dims.back()     = is_lstm ? weights[1] : weights[0];
+    outputs.dims[0] = dims;
+    return true;
+}
+
+bool Infer(const Graph& graph, const Operator& op, Outputs& outputs) {
+    if (op.GetInputIDs().empty() || outputs.dims.empty()) {
+        return false;
+    }
+    switch (op.GetOpType()) {
+        case OperatorType::ABS:
+        case OperatorType::BATCH_NORMALIZATION:
+        case OperatorType::COSINE:
+        case OperatorType::ELU:
+        case OperatorType::EXP:
+        case OperatorType::GELU:
+        case OperatorType::HARDSWISH:
+        case OperatorType::L2_NORMALIZATION:
+        case OperatorType::LEAKY_RELU:
+        case OperatorType::LOCAL_RESPONSE_NORMALIZATION:
+        case OperatorType::LOG:
+        case OperatorType::LOG_SOFTMAX:
+        case OperatorType::LOGISTIC:
+        case OperatorType::NEG:
+        case OperatorType::ReLU:
+        case OperatorType::ReLU1:
+        case OperatorType::ReLU6:
+        case OperatorType::REVERSEV2:
+        case OperatorType::RSQRT:
+        case OperatorType::SIN:
+        case OperatorType::SOFTMAX:
+        case OperatorType::SQRT:
+        case OperatorType::SQUARE:
+        case OperatorType::TANH:
+            return InferSameAsInput(op, outputs);
+        case OperatorType::QUANTIZE:
+            // The quantized type is only recorded in the output itself.
+            outputs.types[0] = op.GetOutputBlob(0)->GetDataType();
+            return InferSameAsInput(op, outputs);
+        case OperatorType::DEQUANTIZE:
+            outputs.types[0] = DataType::FLOAT32;
+            return InferSameAsInput(op, outputs);
+        case OperatorType::CAST: {
+            const auto* option = GetOption<CastOption>(op);
+            outputs.types[0]   = option != nullptr && option->out_data_type != DataType::UNDEFINED
+                                     ? option->out_data_type
+                                     : op.GetOutputBlob(0)->GetDataType();
+            return InferSameAsInput(op, outputs);
+        }
+        case OperatorType::ADD:
+        case OperatorType::DIV:
+        case OperatorType::MAXIMUM:
+        case OperatorType::MINIMUM:
+        case OperatorType::MUL:
+        case OperatorType::POW:
+        case OperatorType::PReLU:
+        case OperatorType::SQUARED_DIFFERENCE:
+        case OperatorType::SUB:
+            return InferBroadcast(op, outputs);
+        case OperatorType::EQUAL:
+        case OperatorType::NOT_EQUAL:
+            outputs.types[0] = DataType::BOOL;
+            return InferBroadcast(op, outputs);
+        case OperatorType::SELECT:
+        case OperatorType::SELECT_V2:
+            outputs.types[0] = InputType(op, 1);
+            return InferBroadcast(op, outputs);
+        case OperatorType::CONV2D:
+            return InferConv2D<Conv2DOption>(op, outputs);
+        case OperatorType::DEPTHWISE_CONV2D:
+            return InferConv2D<DepthwiseConv2DOption>(op, outputs);
+        case OperatorType::CONV3D:
+            return InferConv3D(op, outputs);
+        case OperatorType::TRANSPOSE_CONV2D:
+            return InferTransposeConv2D(graph, op, outputs);
+        case OperatorType::AVERAGE_POOL:
+        case OperatorType::L2_POOL:
+        case OperatorType::MAX_POOL:
+            return InferPool2D(op, outputs);
+        case OperatorType::FULLY_CONNECTED:
+            return InferFullyConnected(op, outputs);
+        case OperatorType::BATCH_MATMUL:
+            return InferBatchMatmul(op, outputs);
+        case OperatorType::RESHAPE:
+            return InferReshape(graph, op, outputs);
+        case OperatorType::SQUEEZE:
+            return InferSqueeze(op, outputs);
+        case OperatorType::EXPAND_DIMS:
+            return InferExpandDims(graph, op, outputs);
+        case OperatorType::TRANSPOSE:
+            return InferTranspose(graph, op, outputs);
+        case OperatorType::CONCAT:
+            return InferConcat(op, outputs);
+        case OperatorType::PACK:
+            return InferPack(op, outputs);
+        case OperatorType::UNPACK:
+            return InferUnpack(op, outputs);
+        case OperatorType::SPLIT:
+            return InferSplit(graph, op, outputs);
+        case OperatorType::SPLITV:
+            return InferSplitV(graph, op, outputs);
+        case OperatorType::SLICE:
+            return InferSlice(graph, op, outputs);
+        case OperatorType::STRIDED_SLICE:
+            return InferStridedSlice(graph, op, outputs);
+        case OperatorType::MIRROR_PAD:
+        case OperatorType::PAD:
+        case OperatorType::PADV2:
+            return InferPad(graph, op, outputs);
+        case OperatorType::MEAN:
+        case OperatorType::REDUCE_ALL:
+        case OperatorType::REDUCE_ANY:
+        case OperatorType::REDUCE_MAX:
+        case OperatorType::REDUCE_MIN:
+        case OperatorType::REDUCE_PROD:
+        case OperatorType::SUM:
+            return InferReduce(graph, op, outputs);
+        case OperatorType::ARGMAX:
+            return InferArgMinMax<ArgMaxOption>(graph, op, outputs);
+        case OperatorType::ARGMIN:
+            return InferArgMinMax<ArgMinOption>(graph, op, outputs);
+        case OperatorType::GATHER:
+            return InferGather(op, outputs);
+        case OperatorType::GATHER_ND:
+            return InferGatherND(op, outputs);
+        case OperatorType::TILE:
+            return InferTile(graph, op, outputs);
+        case OperatorType::BROADCAST_TO:
+            return InferBroadcastTo(graph, op, outputs);
+        case OperatorType::RESIZE_BILINEAR:
+        case OperatorType::RESIZE_NEAREST_NEIGHBOR:
+            return InferResize(graph, op, outputs);
+        case OperatorType::DEPTH_TO_SPACE:
+            return InferDepthToSpace(op, outputs);
+        case OperatorType::SPACE_TO_DEPTH:
+            return InferSpaceToDepth(op, outputs);
+        case OperatorType::BATCH_TO_SPACE_ND:
+        case OperatorType::SPACE_TO_BATCH_ND:
+            return InferSpaceBatchND(graph, op, outputs);
+        case OperatorType::ONE_HOT:
+            return InferOneHot(graph, op, outputs);
+        case OperatorType::TOPK_V2:
+            return InferTopK(graph, op, outputs);
+        case OperatorType::SHAPE:
+            return InferShape(op, outputs);
+        case OperatorType::WHERE:
+            // The number of true elements is only known at runtime.
+            outputs.dims[0]  = {unknown_dim, static_cast<int>(InputDims(op, 0).size())};
+            outputs.types[0] = DataType::INT64;
+            return true;
+        case OperatorType::UNIQUE:
+            outputs.dims[0] = {unknown_dim};
+            if (outputs.dims.size() > 1) {
+                outputs.dims[1] = InputDims(op, 0);
+            }
+            return true;
+        case OperatorType::UNIDIRECTIONAL_LSTM:
+        case OperatorType::UNIDIRECTIONAL_RNN:
+            return InferSequence(op, outputs);
+        default:
+            // BIDIRECTIONAL_LSTM and BIDIRECTIONAL_RNN have too many optional layouts to be inferred reliably.
+            return false;
+    }
+}
+
+Outputs InitOutputs(const Operator& op) {
+    Outputs outputs;
+    for (auto* blob : op.GetOutputBlobs()) {
+        outputs.dims.push_back(blob->GetShape().GetDims());
+        outputs.types.push_back(blob->GetDataType());
+    }
+    // Most operators produce the data type of their first input.
+    if (!op.GetInputIDs().empty() && !outputs.types.empty()) {
+        outputs.types[0] = InputType(op, 0);
+    }
+    return outputs;
+}
+
+uint32_t ApplyOutputs(const Operator& op, const Outputs& outputs) {
+    uint32_t changed_blobs = 0;
+    for (size_t index = 0; index < outputs.dims.size(); index++) {
+        auto* blob = op.GetOutputBlob(index);
+        if (blob->GetShape().GetDims() != outputs.dims[index] || blob->GetDataType() != outputs.types[index]) {
+            blob->SetShape(Shape(outputs.dims[index]));
+            blob->SetDataType(outputs.types[index]);
+            changed_blobs++;
+        }
+    }
+    return changed_blobs;
+}
+}  // namespace
+
+uint32_t ShapeInference::Run(Graph& graph) {
+    LOG(INFO) << "ShapeInference::Run Start.";
+    uint32_t changed_blobs  = 0;
+    uint32_t unresolved_ops = 0;
+    for (auto* op : graph.TopologicalSort()) {
+        auto outputs = InitOutputs(*op);
+        if (!Infer(graph, *op, outputs)) {
+            DLOG(INFO) << "Keep shapes of " << ToStr(op->GetOpType()) << " outputs, which are not inferable.";
+            unresolved_ops++;
+            continue;
+        }
+        changed_blobs += ApplyOutputs(*op, outputs);
+    }
+    LOG(INFO) << "ShapeInference::Run End. Updated " << changed_blobs << " blobs, " << unresolved_ops
+              << " operators are not inferable.";
+    return changed_blobs;
+}
+
+bool ShapeInference::InferOperator(const Graph& graph, const Operator& op) {
+    auto outputs = InitOutputs(op);
+    if (!Infer(graph, op, outputs)) {
+        return false;
+    }
+    ApplyOutputs(op, outputs);
+    return true;
+}
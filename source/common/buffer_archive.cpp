@@ -0,0 +1,327 @@
+#include "common/buffer_archive.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "common/logging.h"
+#include "common/parallel_utils.h"
+
+namespace common {
+namespace {
+constexpr char     archive_magic[4] = {'C', 'T', 'B', '1'};
+constexpr size_t   min_match        = 4;
+constexpr size_t   max_offset       = 65535;
+constexpr uint32_t hash_bits        = 12;
+// Misses before the search skips ahead, so incompressible data passes quickly.
+constexpr uint32_t skip_trigger = 6;
+
+// On-disk entries, without padding so that their layout doesn't depend on the compiler.
+constexpr size_t header_bytes = 16;
+constexpr size_t buffer_bytes = 24;
+constexpr size_t chunk_bytes  = 16;
+
+template <typename T> T load(const uint8_t* data) {
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+template <typename T> void store(uint8_t*& data, T value) {
+    memcpy(data, &value, sizeof(T));
+    data += sizeof(T);
+}
+
+uint32_t hash(uint32_t sequence) { return (sequence * 2654435761u) >> (32 - hash_bits); }
+
+void write_length(uint8_t*& output, size_t length) {
+    for (; length >= 255; length -= 255) {
+        *output++ = 255;
+    }
+    *output++ = static_cast<uint8_t>(length);
+}
+
+// Token of the literal and match lengths, literals, offset and the rest of the match length. A match length of 0
+// marks the last sequence, which has literals only.
+void write_sequence(uint8_t*& output, const uint8_t* literals, size_t num_literals, size_t offset, size_t match) {
+    size_t literal_code = std::min<size_t>(num_literals, 15);
+    size_t match_code   = match == 0 ? 0 : match - min_match;
+    *output++           = static_cast<uint8_t>(literal_code << 4 | std::min<size_t>(match_code, 15));
+    if (num_literals >= 15) {
+        write_length(output, num_literals - 15);
+    }
+    memcpy(output, literals, num_literals);
+    output += num_literals;
+    if (match == 0) {
+        return;
+    }
+    store<uint16_t>(output, static_cast<uint16_t>(offset));
+    if (match_code >= 15) {
+        write_length(output, match_code - 15);
+    }
+}
+
+size_t match_length(const uint8_t* src, size_t src_size, size_t reference, size_t position) {
+    size_t length = 0;
+    while (position + length + 8 <= src_size) {
+        uint64_t difference = load<uint64_t>(src + reference + length) ^ load<uint64_t>(src + position + length);
+        if (difference != 0) {
+            return length + __builtin_ctzll(difference) / 8;
+        }
+        length += 8;
+    }
+    while (position + length < src_size && src[reference + length] == src[position + length]) {
+        length++;
+    }
+    return length;
+}
+
+bool read_length(const uint8_t*& input, const uint8_t* input_end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (input == input_end) {
+            return false;
+        }
+        byte = *input++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+// Byte b of element i goes to plane b, so that planes of similar bytes compress well.
+void shuffle(const uint8_t* input, size_t size, uint32_t element_size, uint8_t* output) {
+    size_t num_elements = size / element_size;
+    for (size_t element = 0; element < num_elements; element++) {
+        for (uint32_t byte = 0; byte < element_size; byte++) {
+            output[byte * num_elements + element] = input[element * element_size + byte];
+        }
+    }
+    memcpy(output + num_elements * element_size, input + num_elements * element_size, size % element_size);
+}
+
+void unshuffle(const uint8_t* input, size_t size, uint32_t element_size, uint8_t* output) {
+    size_t num_elements = size / element_size;
+    for (size_t element = 0; element < num_elements; element++) {
+        for (uint32_t byte = 0; byte < element_size; byte++) {
+            output[element * element_size + byte] = input[byte * num_elements + element];
+        }
+    }
+    memcpy(output + num_elements * element_size, input + num_elements * element_size, size % element_size);
+}
+}  // namespace
+
+std::vector<uint8_t> lz_compress(const uint8_t* src, size_t src_size) {
+    std::vector<uint8_t>  compressed(src_size + src_size / 255 + 16);
+    std::vector<uint32_t> table(1 << hash_bits, 0);  // last position + 1 of every hashed sequence
+    uint8_t*              output   = compressed.data();
+    size_t                anchor   = 0;
+    size_t                position = 0;
+    uint32_t              misses   = 0;
+    while (position + min_match <= src_size) {
+        uint32_t  sequence  = load<uint32_t>(src + position);
+        uint32_t& slot      = table[hash(sequence)];
+        uint32_t  candidate = slot;
+        slot                = position + 1;
+        if (candidate == 0 || position - (candidate - 1) > max_offset ||
+            load<uint32_t>(src + candidate - 1) != sequence) {
+            position += 1 + (misses++ >> skip_trigger);
+            continue;
+        }
+        size_t reference = candidate - 1;
+        size_t match     = min_match + match_length(src, src_size, reference + min_match, position + min_match);
+        write_sequence(output, src + anchor, position - anchor, position - reference, match);
+        position += match;
+        anchor = position;
+        misses = 0;
+    }
+    write_sequence(output, src + anchor, src_size - anchor, 0, 0);
+    compressed.resize(output - compressed.data());
+    return compressed;
+}
+
+bool lz_decompress(const uint8_t* src, size_t src_size, uint8_t* dst, size_t dst_size) {
+    const uint8_t* input      = src;
+    const uint8_t* input_end  = src + src_size;
+    uint8_t*       output     = dst;
+    uint8_t*       output_end = dst + dst_size;
+    while (input < input_end) {
+        uint8_t token        = *input++;
+        size_t  num_literals = token >> 4;
+        if (num_literals == 15 && !read_length(input, input_end, num_literals)) {
+            return false;
+        }
+        if (num_literals > static_cast<size_t>(input_end - input) ||
+            num_literals > static_cast<size_t>(output_end - output)) {
+            return false;
+        }
+        memcpy(output, input, num_literals);
+        input += num_literals;
+        output += num_literals;
+        if (input == input_end) {
+            break;
+        }
+
+        if (input_end - input < 2) {
+            return false;
+        }
+        size_t offset = load<uint16_t>(input);
+        input += 2;
+        size_t match = token & 15;
+        if (match == 15 && !read_length(input, input_end, match)) {
+            return false;
+        }
+        match += min_match;
+        if (offset == 0 || offset > static_cast<size_t>(output - dst) ||
+            match > static_cast<size_t>(output_end - output)) {
+            return false;
+        }
+        // Overlapping matches repeat the last `offset` bytes, they are copied byte by byte.
+        const uint8_t* reference = output - offset;
+        if (offset >= match) {
+            memcpy(output, reference, match);
+        } else {
+            for (size_t index = 0; index < match; index++) {
+                output[index] = reference[index];
+            }
+        }
+        output += match;
+    }
+    return output == output_end;
+}
+
+BufferArchive::BufferArchive(const uint8_t* data, size_t size) {
+    REPORT_ERROR_IF(size < header_bytes || memcmp(data, archive_magic, sizeof(archive_magic)) != 0,
+                    "Not a buffer archive.");
+    chunk_size_      = load<uint32_t>(data + 4);
+    auto num_buffers = load<uint32_t>(data + 8);
+    auto num_chunks  = load<uint32_t>(data + 12);
+    auto index_bytes = header_bytes + static_cast<uint64_t>(num_buffers) * buffer_bytes +
+                       static_cast<uint64_t>(num_chunks) * chunk_bytes;
+    REPORT_ERROR_IF(chunk_size_ == 0 || index_bytes > size, "Buffer archive is truncated.");
+
+    const uint8_t* entry = data + header_bytes;
+    for (uint32_t index = 0; index < num_buffers; index++, entry += buffer_bytes) {
+        BufferEntry buffer {load<uint32_t>(entry), load<uint32_t>(entry + 4), load<uint64_t>(entry + 8),
+                            load<uint32_t>(entry + 16), load<uint32_t>(entry + 20)};
+        REPORT_ERROR_IF(buffer.element_size == 0 ||
+                            static_cast<uint64_t>(buffer.first_chunk) + buffer.num_chunks > num_chunks ||
+                            (buffer.size + chunk_size_ - 1) / chunk_size_ != buffer.num_chunks,
+                        "Invalid entry of buffer ", buffer.key, " in buffer archive.");
+        buffers_.push_back(buffer);
+    }
+    data_      = data + index_bytes;
+    data_size_ = size - index_bytes;
+    for (uint32_t index = 0; index < num_chunks; index++, entry += chunk_bytes) {
+        ChunkEntry chunk {load<uint64_t>(entry), load<uint32_t>(entry + 8), load<uint32_t>(entry + 12)};
+        REPORT_ERROR_IF(chunk.offset > data_size_ || chunk.stored_size > data_size_ - chunk.offset,
+                        "Chunk ", index, " is out of the buffer archive.");
+        chunks_.push_back(chunk);
+    }
+}
+
+void BufferArchive::unpack_chunk(size_t buffer, uint32_t chunk, uint8_t* output) const {
+    const auto& entry = buffers_.at(buffer);
+    REPORT_ERROR_IF(chunk >= entry.num_chunks, "Chunk ", chunk, " of buffer ", entry.key, " is out of range.");
+    const auto& stored   = chunks_[entry.first_chunk + chunk];
+    size_t      size     = std::min<uint64_t>(chunk_size_, entry.size - static_cast<uint64_t>(chunk) * chunk_size_);
+    const auto* input    = data_ + stored.offset;
+    bool        shuffled = entry.element_size > 1;
+
+    std::vector<uint8_t> planes(shuffled ? size : 0);
+    uint8_t*             target = shuffled ? planes.data() : output;
+    if (stored.compressed) {
+        REPORT_ERROR_IF(!lz_decompress(input, stored.stored_size, target, size), "Chunk ", chunk, " of buffer ",
+                        entry.key, " is corrupted.");
+    } else {
+        REPORT_ERROR_IF(stored.stored_size != size, "Chunk ", chunk, " of buffer ", entry.key, " is corrupted.");
+        memcpy(target, input, size);
+    }
+    if (shuffled) {
+        unshuffle(planes.data(), size, entry.element_size, output);
+    }
+}
+
+void BufferArchive::unpack(const std::vector<uint8_t*>& outputs, size_t num_threads) const {
+    REPORT_ERROR_IF(outputs.size() != buffers_.size(), "Expect ", buffers_.size(), " outputs, got ", outputs.size(),
+                    ".");
+    std::vector<std::pair<size_t, uint32_t>> tasks;
+    for (size_t buffer = 0; buffer < buffers_.size(); buffer++) {
+        for (uint32_t chunk = 0; outputs[buffer] != nullptr && chunk < buffers_[buffer].num_chunks; chunk++) {
+            tasks.emplace_back(buffer, chunk);
+        }
+    }
+    parallel_for(tasks.size(), num_threads == 0 ? default_num_threads() : num_threads, [&](size_t index) {
+        auto [buffer, chunk] = tasks[index];
+        unpack_chunk(buffer, chunk, outputs[buffer] + static_cast<uint64_t>(chunk) * chunk_size_);
+    });
+}
+
+std::vector<uint8_t> pack_buffers(const std::vector<ArchiveInput>& inputs, size_t num_threads, uint32_t chunk_size) {
+    REPORT_ERROR_IF(chunk_size == 0, "Chunk size should be positive.");
+    struct Chunk {
+        const ArchiveInput*  input;
+        size_t               begin;
+        size_t               size;
+        std::vector<uint8_t> stored;
+        bool                 compressed;
+    };
+    std::vector<Chunk> chunks;
+    for (const auto& input : inputs) {
+        REPORT_ERROR_IF(input.element_size == 0, "Element size of buffer ", input.key, " should be positive.");
+        for (size_t begin = 0; begin < input.size; begin += chunk_size) {
+            chunks.push_back({&input, begin, std::min<size_t>(chunk_size, input.size - begin), {}, false});
+        }
+    }
+    parallel_for(chunks.size(), num_threads == 0 ? default_num_threads() : num_threads, [&](size_t index) {
+        auto&                chunk = chunks[index];
+        const uint8_t*       raw   = chunk.input->data + chunk.begin;
+        std::vector<uint8_t> planes;
+        if (chunk.input->element_size > 1) {
+            planes.resize(chunk.size);
+            shuffle(raw, chunk.size, chunk.input->element_size, planes.data());
+            raw = planes.data();
+        }
+        chunk.stored     = lz_compress(raw, chunk.size);
+        chunk.compressed = chunk.stored.size() < chunk.size;
+        if (!chunk.compressed) {
+            chunk.stored.assign(raw, raw + chunk.size);
+        }
+    });
+
+    size_t data_bytes = 0;
+    for (const auto& chunk : chunks) {
+        data_bytes += chunk.stored.size();
+    }
+    std::vector<uint8_t> archive(header_bytes + inputs.size() * buffer_bytes + chunks.size() * chunk_bytes +
+                                 data_bytes);
+    uint8_t*             output = archive.data();
+    memcpy(output, archive_magic, sizeof(archive_magic));
+    output += sizeof(archive_magic);
+    store<uint32_t>(output, chunk_size);
+    store<uint32_t>(output, inputs.size());
+    store<uint32_t>(output, chunks.size());
+    uint32_t first_chunk = 0;
+    for (const auto& input : inputs) {
+        uint32_t num_chunks = (input.size + chunk_size - 1) / chunk_size;
+        store<uint32_t>(output, input.key);
+        store<uint32_t>(output, input.element_size);
+        store<uint64_t>(output, input.size);
+        store<uint32_t>(output, first_chunk);
+        store<uint32_t>(output, num_chunks);
+        first_chunk += num_chunks;
+    }
+    uint64_t offset = 0;
+    for (const auto& chunk : chunks) {
+        store<uint64_t>(output, offset);
+        store<uint32_t>(output, chunk.stored.size());
+        store<uint32_t>(output, chunk.compressed ? 1 : 0);
+        offset += chunk.stored.size();
+    }
+    for (const auto& chunk : chunks) {
+        memcpy(output, chunk.stored.data(), chunk.stored.size());
+        output += chunk.stored.size();
+    }
+    return archive;
+}
+
+}  // namespace common
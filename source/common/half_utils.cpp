@@ -0,0 +1,150 @@
+#include "common/half_utils.h"
+
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HALF_UTILS_X86
+#endif
+
+namespace common {
+namespace {
+uint32_t to_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float from_bits(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+#ifdef HALF_UTILS_X86
+enum class Isa { SCALAR, F16C, AVX512 };
+
+Isa detect_isa() {
+    if (__builtin_cpu_supports("avx512f")) {
+        return Isa::AVX512;
+    }
+    return __builtin_cpu_supports("f16c") && __builtin_cpu_supports("avx") ? Isa::F16C : Isa::SCALAR;
+}
+
+Isa get_isa() {
+    static const Isa isa = detect_isa();
+    return isa;
+}
+
+// Return the number of converted elements, the tail is left to the scalar routine. AVX-512 conversions take the
+// zero-masked forms, the plain ones trip -Wmaybe-uninitialized in some compilers' headers.
+__attribute__((target("avx512f"))) size_t float_to_half_avx512(const float* input, size_t size, uint16_t* output) {
+    size_t index = 0;
+    for (; index + 16 <= size; index += 16) {
+        auto half = _mm512_maskz_cvtps_ph(0xffff, _mm512_loadu_ps(input + index), _MM_FROUND_TO_NEAREST_INT);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + index), half);
+    }
+    return index;
+}
+
+__attribute__((target("avx512f"))) size_t half_to_float_avx512(const uint16_t* input, size_t size, float* output) {
+    size_t index = 0;
+    for (; index + 16 <= size; index += 16) {
+        auto half = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + index));
+        _mm512_storeu_ps(output + index, _mm512_maskz_cvtph_ps(0xffff, half));
+    }
+    return index;
+}
+
+__attribute__((target("avx,f16c"))) size_t float_to_half_f16c(const float* input, size_t size, uint16_t* output) {
+    size_t index = 0;
+    for (; index + 8 <= size; index += 8) {
+        auto half = _mm256_cvtps_ph(_mm256_loadu_ps(input + index), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + index), half);
+    }
+    return index;
+}
+
+__attribute__((target("avx,f16c"))) size_t half_to_float_f16c(const uint16_t* input, size_t size, float* output) {
+    size_t index = 0;
+    for (; index + 8 <= size; index += 8) {
+        auto half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + index));
+        _mm256_storeu_ps(output + index, _mm256_cvtph_ps(half));
+    }
+    return index;
+}
+#endif
+}  // namespace
+
+// Bit manipulations after F. Giesen's float_to_half_fast3_rtne and half_to_float_fast5.
+uint16_t float_to_half(float value) {
+    constexpr uint32_t infinity     = 255u << 23;
+    constexpr uint32_t half_max     = (127u + 16) << 23;  // 65536, the first value rounding to infinity for sure
+    constexpr uint32_t denorm_magic = ((127u - 15) + (23 - 10) + 1) << 23;
+
+    uint32_t bits = to_bits(value);
+    uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    uint16_t half;
+    if (bits >= half_max) {
+        // NaN is quieted and keeps the top bits of its payload, as F16C instructions do.
+        half = bits > infinity ? 0x7e00 | ((bits >> 13) & 0x3ff) : 0x7c00;
+    } else if (bits < (113u << 23)) {
+        // Subnormal or zero, the float addition aligns and rounds the mantissa.
+        half = to_bits(from_bits(bits) + from_bits(denorm_magic)) - denorm_magic;
+    } else {
+        uint32_t mantissa_odd = (bits >> 13) & 1;
+        bits += ((15u - 127) << 23) + 0xfff + mantissa_odd;
+        half = bits >> 13;
+    }
+    return half | (sign >> 16);
+}
+
+float half_to_float(uint16_t value) {
+    constexpr uint32_t shifted_exponent = 0x7c00u << 13;
+    constexpr uint32_t infinity         = 255u << 23;
+
+    uint32_t bits     = (value & 0x7fffu) << 13;
+    uint32_t exponent = bits & shifted_exponent;
+    bits += (127u - 15) << 23;
+    if (exponent == shifted_exponent) {
+        bits += (128u - 16) << 23;  // infinity or NaN
+        if (bits != infinity) {
+            bits |= 1u << 22;  // quiet NaN
+        }
+    } else if (exponent == 0) {
+        bits = to_bits(from_bits(bits + (1u << 23)) - from_bits(113u << 23));  // zero or subnormal
+    }
+    return from_bits(bits | (static_cast<uint32_t>(value & 0x8000u) << 16));
+}
+
+void float_to_half(const float* input, size_t size, uint16_t* output) {
+    size_t index = 0;
+#ifdef HALF_UTILS_X86
+    if (get_isa() == Isa::AVX512) {
+        index = float_to_half_avx512(input, size, output);
+    } else if (get_isa() == Isa::F16C) {
+        index = float_to_half_f16c(input, size, output);
+    }
+#endif
+    for (; index < size; index++) {
+        output[index] = float_to_half(input[index]);
+    }
+}
+
+void half_to_float(const uint16_t* input, size_t size, float* output) {
+    size_t index = 0;
+#ifdef HALF_UTILS_X86
+    if (get_isa() == Isa::AVX512) {
+        index = half_to_float_avx512(input, size, output);
+    } else if (get_isa() == Isa::F16C) {
+        index = half_to_float_f16c(input, size, output);
+    }
+#endif
+    for (; index < size; index++) {
+        output[index] = half_to_float(input[index]);
+    }
+}
+
+}  // namespace common
@@ -0,0 +1,40 @@
+#include "common/mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "common/logging.h"
+
+namespace common {
+
+MappedFile::MappedFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    REPORT_ERROR_IF(fd == -1, "Invalid path, cannot access file: ", path);
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == -1) {
+        close(fd);
+        report_error("Error happen in reading file: ", path);
+    }
+    size_ = file_stat.st_size;
+    // mmap rejects empty mappings, an empty file is an empty range.
+    if (size_ == 0) {
+        close(fd);
+        return;
+    }
+    void* address = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+    REPORT_ERROR_IF(address == MAP_FAILED, "Error happen in mapping file: ", path);
+    data_ = static_cast<const uint8_t*>(address);
+}
+
+MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+}
+
+}  // namespace common
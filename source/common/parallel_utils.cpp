@@ -0,0 +1,52 @@
+#include "common/parallel_utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace common {
+
+size_t default_num_threads() { return std::max<size_t>(1, std::thread::hardware_concurrency()); }
+
+void parallel_for(size_t count, size_t num_threads, const std::function<void(size_t)>& func) {
+    num_threads = std::min(std::max<size_t>(1, num_threads), count);
+    if (num_threads <= 1) {
+        for (size_t index = 0; index < count; index++) {
+            func(index);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next_index = 0;
+    std::exception_ptr  first_exception;
+    std::mutex          exception_mtx;
+    auto                worker = [&]() {
+        for (size_t index = next_index++; index < count; index = next_index++) {
+            try {
+                func(index);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(exception_mtx);
+                if (first_exception == nullptr) {
+                    first_exception = std::current_exception();
+                }
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    for (size_t thread_index = 1; thread_index < num_threads; thread_index++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (first_exception != nullptr) {
+        std::rethrow_exception(first_exception);
+    }
+}
+
+}  // namespace common
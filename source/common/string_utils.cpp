@@ -1,5 +1,9 @@
 #include "common/string_utils.h"
 
+#include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
+
 #include <algorithm>
 #include <unordered_set>
 #include <stdint.h>
@@ -67,4 +71,41 @@ std::string rstrip(const std::string& str) {
 
 std::string strip(const std::string& str) { return lstrip(rstrip(str)); }
 
+std::string replace_suffix(const std::string& str, const std::string& suffix, const std::string& replacement) {
+    bool has_suffix = str.size() > suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+    return (has_suffix ? str.substr(0, str.size() - suffix.size()) : str) + replacement;
+}
+
+bool parse_int(const std::string& str, int& value) {
+    if (str.empty() || isspace(static_cast<unsigned char>(str[0]))) {
+        return false;
+    }
+    char* end    = nullptr;
+    errno        = 0;
+    auto  parsed = strtoll(str.c_str(), &end, 10);
+    if (*end != '\0' || errno == ERANGE || parsed < INT32_MIN || parsed > INT32_MAX) {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+std::string escape_json(const std::string& str) {
+    static const char hex_digits[] = "0123456789abcdef";
+    std::string       escaped_str;
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            escaped_str += '\\';
+            escaped_str += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            escaped_str += "\\u00";
+            escaped_str += hex_digits[c >> 4];
+            escaped_str += hex_digits[c & 0xf];
+        } else {
+            escaped_str += c;
+        }
+    }
+    return escaped_str;
+}
+
 }  // namespace common
@@ -0,0 +1,200 @@
+#include "common/symmetric_eigen.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "common/logging.h"
+
+namespace common {
+namespace {
+// Householder reduction to a tridiagonal matrix of diagonal `d` and subdiagonal `e`, accumulating the transformations
+// (EISPACK tred2). `v` is the transpose of the matrix of tred2, so that its inner loops walk contiguous rows, and
+// symmetric input is its own transpose.
+void tridiagonalize(std::vector<double>& v, size_t n, std::vector<double>& d, std::vector<double>& e) {
+    auto at = [&](size_t row, size_t col) -> double& { return v[col * n + row]; };
+    for (size_t j = 0; j < n; j++) {
+        d[j] = at(n - 1, j);
+    }
+    for (size_t i = n - 1; i > 0; i--) {
+        double scale = 0.0;
+        double h     = 0.0;
+        for (size_t k = 0; k < i; k++) {
+            scale += std::fabs(d[k]);
+        }
+        if (scale == 0.0) {
+            e[i] = d[i - 1];
+            for (size_t j = 0; j < i; j++) {
+                d[j]     = at(i - 1, j);
+                at(i, j) = 0.0;
+                at(j, i) = 0.0;
+            }
+        } else {
+            for (size_t k = 0; k < i; k++) {
+                d[k] /= scale;
+                h += d[k] * d[k];
+            }
+            double f = d[i - 1];
+            double g = f > 0 ? -std::sqrt(h) : std::sqrt(h);
+            e[i]     = scale * g;
+            h        = h - f * g;
+            d[i - 1] = f - g;
+            std::fill(e.begin(), e.begin() + i, 0.0);
+            for (size_t j = 0; j < i; j++) {
+                f        = d[j];
+                at(j, i) = f;
+                g        = e[j] + at(j, j) * f;
+                for (size_t k = j + 1; k < i; k++) {
+                    g += at(k, j) * d[k];
+                    e[k] += at(k, j) * f;
+                }
+                e[j] = g;
+            }
+            f = 0.0;
+            for (size_t j = 0; j < i; j++) {
+                e[j] /= h;
+                f += e[j] * d[j];
+            }
+            double hh = f / (h + h);
+            for (size_t j = 0; j < i; j++) {
+                e[j] -= hh * d[j];
+            }
+            for (size_t j = 0; j < i; j++) {
+                f = d[j];
+                g = e[j];
+                for (size_t k = j; k < i; k++) {
+                    at(k, j) -= f * e[k] + g * d[k];
+                }
+                d[j]     = at(i - 1, j);
+                at(i, j) = 0.0;
+            }
+        }
+        d[i] = h;
+    }
+
+    for (size_t i = 0; i + 1 < n; i++) {
+        at(n - 1, i) = at(i, i);
+        at(i, i)     = 1.0;
+        double h     = d[i + 1];
+        if (h != 0.0) {
+            for (size_t k = 0; k <= i; k++) {
+                d[k] = at(k, i + 1) / h;
+            }
+            for (size_t j = 0; j <= i; j++) {
+                double g = 0.0;
+                for (size_t k = 0; k <= i; k++) {
+                    g += at(k, i + 1) * at(k, j);
+                }
+                for (size_t k = 0; k <= i; k++) {
+                    at(k, j) -= g * d[k];
+                }
+            }
+        }
+        for (size_t k = 0; k <= i; k++) {
+            at(k, i + 1) = 0.0;
+        }
+    }
+    for (size_t j = 0; j < n; j++) {
+        d[j]         = at(n - 1, j);
+        at(n - 1, j) = 0.0;
+    }
+    at(n - 1, n - 1) = 1.0;
+    e[0]             = 0.0;
+}
+
+// Implicit QL iterations on the tridiagonal matrix (EISPACK tql2). Rotations are applied to rows of the transposed
+// transformations `z`, so that eigenvector i ends up contiguous in row i.
+void diagonalize(std::vector<double>& z, size_t n, std::vector<double>& d, std::vector<double>& e) {
+    for (size_t i = 1; i < n; i++) {
+        e[i - 1] = e[i];
+    }
+    e[n - 1] = 0.0;
+
+    constexpr int max_iterations = 64;
+    double        f              = 0.0;
+    double        tst1           = 0.0;
+    double        eps            = std::ldexp(1.0, -52);
+    for (size_t l = 0; l < n; l++) {
+        tst1     = std::max(tst1, std::fabs(d[l]) + std::fabs(e[l]));
+        size_t m = l;
+        while (m < n - 1 && std::fabs(e[m]) > eps * tst1) {
+            m++;
+        }
+        int iterations = 0;
+        while (m > l && std::fabs(e[l]) > eps * tst1) {
+            REPORT_ERROR_IF(++iterations > max_iterations, "Eigen decomposition doesn't converge.");
+            double g   = d[l];
+            double p   = (d[l + 1] - g) / (2.0 * e[l]);
+            double r   = p < 0 ? -std::hypot(p, 1.0) : std::hypot(p, 1.0);
+            d[l]       = e[l] / (p + r);
+            d[l + 1]   = e[l] * (p + r);
+            double dl1 = d[l + 1];
+            double h   = g - d[l];
+            for (size_t i = l + 2; i < n; i++) {
+                d[i] -= h;
+            }
+            f += h;
+
+            p          = d[m];
+            double c   = 1.0;
+            double c2  = c;
+            double c3  = c;
+            double el1 = e[l + 1];
+            double s   = 0.0;
+            double s2  = 0.0;
+            for (size_t i = m; i-- > l;) {
+                c3       = c2;
+                c2       = c;
+                s2       = s;
+                g        = c * e[i];
+                h        = c * p;
+                r        = std::hypot(p, e[i]);
+                e[i + 1] = s * r;
+                s        = e[i] / r;
+                c        = p / r;
+                p        = c * d[i] - s * g;
+                d[i + 1] = h + s * (c * g + s * d[i]);
+
+                double* row      = z.data() + i * n;
+                double* next_row = row + n;
+                for (size_t k = 0; k < n; k++) {
+                    double next = next_row[k];
+                    next_row[k] = s * row[k] + c * next;
+                    row[k]      = c * row[k] - s * next;
+                }
+            }
+            p    = -s * s2 * c3 * el1 * e[l] / dl1;
+            e[l] = s * p;
+            d[l] = c * p;
+        }
+        d[l] += f;
+        e[l] = 0.0;
+    }
+}
+}  // namespace
+
+std::vector<double> symmetric_eigen(std::vector<double>& matrix, size_t n) {
+    REPORT_ERROR_IF(matrix.size() != n * n, "Expect a ", n, " x ", n, " matrix, got ", matrix.size(), " elements.");
+    if (n == 0) {
+        return {};
+    }
+    std::vector<double> d(n);
+    std::vector<double> e(n);
+    tridiagonalize(matrix, n, d, e);
+    diagonalize(matrix, n, d, e);
+
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) { return d[lhs] > d[rhs]; });
+    std::vector<double> eigenvalues(n);
+    std::vector<double> vectors(n * n);
+    for (size_t index = 0; index < n; index++) {
+        eigenvalues[index] = d[order[index]];
+        std::copy(matrix.begin() + order[index] * n, matrix.begin() + (order[index] + 1) * n,
+                  vectors.begin() + index * n);
+    }
+    matrix.swap(vectors);
+    return eigenvalues;
+}
+
+}  // namespace common
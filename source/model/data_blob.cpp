@@ -1,8 +1,77 @@
 #include "model/data_blob.h"
 
+#include <string.h>
+
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+
+#include "common/hash_utils.h"
 #include "common/logging.h"
 #include "model/graph.h"
 
+namespace {
+// Arrays are bucketed by the hash of their bytes. Entries expire with their last holder and are dropped when their
+// bucket is visited again. Buckets of arrays no one interns again are erased by a sweep whenever the number of buckets
+// doubled since the last sweep, so the pool stays proportional to the live arrays.
+template <typename T> class QuantValuesPool {
+ public:
+    std::shared_ptr<const std::vector<T>> Intern(const T* first, const T* last) {
+        size_t bytes = (last - first) * sizeof(T);
+        auto   hash  = common::hash_bytes(reinterpret_cast<const uint8_t*>(first), bytes);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Look up without inserting, a new key is only added together with its array.
+        auto bucket_it = arrays_.find(hash);
+        if (bucket_it != arrays_.end()) {
+            Prune(bucket_it->second);
+            for (const auto& entry : bucket_it->second) {
+                auto array = entry.lock();
+                if (array != nullptr && array->size() * sizeof(T) == bytes &&
+                    memcmp(array->data(), first, bytes) == 0) {
+                    return array;
+                }
+            }
+        } else if (arrays_.size() >= 2 * swept_size_) {
+            Sweep();
+        }
+        auto array = std::make_shared<const std::vector<T>>(first, last);
+        arrays_[hash].push_back(array);
+        return array;
+    }
+
+ private:
+    using Bucket = std::vector<std::weak_ptr<const std::vector<T>>>;
+
+    // Drop expired entries and return whether the bucket is empty.
+    static bool Prune(Bucket& bucket) {
+        bucket.erase(std::remove_if(bucket.begin(), bucket.end(), [](const auto& entry) { return entry.expired(); }),
+                     bucket.end());
+        return bucket.empty();
+    }
+
+    void Sweep() {
+        for (auto bucket_it = arrays_.begin(); bucket_it != arrays_.end();) {
+            bucket_it = Prune(bucket_it->second) ? arrays_.erase(bucket_it) : std::next(bucket_it);
+        }
+        swept_size_ = std::max<size_t>(arrays_.size(), 64);
+    }
+
+    std::mutex                           mutex_;
+    std::unordered_map<uint64_t, Bucket> arrays_;
+    size_t                               swept_size_ = 64;
+};
+}  // namespace
+
+template <typename T> std::shared_ptr<const std::vector<T>> InternQuantValues(const T* first, const T* last) {
+    static QuantValuesPool<T> pool;
+    return pool.Intern(first, last);
+}
+
+template std::shared_ptr<const std::vector<float>>   InternQuantValues(const float*, const float*);
+template std::shared_ptr<const std::vector<int64_t>> InternQuantValues(const int64_t*, const int64_t*);
+
 Operator* DataBlob::OperatorIterator::dereference() {
     auto* op = graph_.GetOperator(*base());
     REPORT_ERROR_IF(op == nullptr, "Fail to find operator in graph.");
@@ -15,6 +84,13 @@ Operator* DataBlob::GetProducer() const { return graph_.GetOperator(producer_);
 
 void DataBlob::AddConsumer(const Operator* op) { consumers_.push_back(op->GetID()); }
 
+void DataBlob::RemoveConsumer(const Operator* op) {
+    auto consumer_it = std::find(consumers_.begin(), consumers_.end(), op->GetID());
+    if (consumer_it != consumers_.end()) {
+        consumers_.erase(consumer_it);
+    }
+}
+
 Range<DataBlob::OperatorIterator> DataBlob::GetConsumers() const {
     return Range<DataBlob::OperatorIterator> {
         {graph_, consumers_.begin()},
@@ -23,11 +99,17 @@ Range<DataBlob::OperatorIterator> DataBlob::GetConsumers() const {
 }
 
 DataBlob::QuantParam& DataBlob::CreateQuantParam() {
-    REPORT_ERROR_IF(quantization_params_ != nullptr, "Already create quant param!");
-    quantization_params_ = std::make_unique<QuantParam>();
+    REPORT_ERROR_IF(quantization_params_.has_value(), "Already create quant param!");
+    quantization_params_.emplace();
     return *quantization_params_;
 }
 
+DataBlob::SparsityParam& DataBlob::CreateSparsityParam() {
+    REPORT_ERROR_IF(sparsity_params_ != nullptr, "Already create sparsity param!");
+    sparsity_params_ = std::make_unique<SparsityParam>();
+    return *sparsity_params_;
+}
+
 std::ostream& operator<<(std::ostream& os, const Shape& shape) {
     os << "Dim : [";
     for (auto dim : shape.GetDims()) {
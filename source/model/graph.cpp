@@ -1,5 +1,7 @@
 #include "model/graph.h"
 
+#include <queue>
+
 #include "common/stl_wrapper.h"
 
 Range<Graph::OperatorIterator> Graph::GetOperators() const {
@@ -38,12 +40,53 @@ std::vector<uint8_t>* Graph::GetBuffer(BLOBID_T blob_id) {
     return &(buffers_.at(blob_id));
 }
 
+namespace {
+template <typename T> std::vector<int64_t> ConvertToInt64(const std::vector<uint8_t>& buffer) {
+    std::vector<T> values(buffer.size() / sizeof(T));
+    memcpy(values.data(), buffer.data(), values.size() * sizeof(T));
+    return std::vector<int64_t>(values.begin(), values.end());
+}
+}  // namespace
+
+bool Graph::GetIntegerConstant(BLOBID_T blob_id, std::vector<int64_t>& values) const {
+    auto* blob   = GetDataBlob(blob_id);
+    auto* buffer = GetBuffer(blob_id);
+    if (blob == nullptr || buffer == nullptr) {
+        return false;
+    }
+    switch (blob->GetDataType()) {
+        case DataType::INT32:
+            values = ConvertToInt64<int32_t>(*buffer);
+            return true;
+        case DataType::INT64:
+            values = ConvertToInt64<int64_t>(*buffer);
+            return true;
+        default:
+            return false;
+    }
+}
+
 Operator* Graph::AddOperator(OperatorType op_type) {
     auto* new_operator                = new Operator(op_type, *this);
     operators_[new_operator->GetID()] = std::unique_ptr<Operator>(new_operator);
     return new_operator;
 }
 
+Operator* Graph::AddOperator(OperatorType                  op_type,
+                             const std::vector<DataBlob*>& inputs,
+                             const std::vector<DataBlob*>& outputs) {
+    auto* new_operator = AddOperator(op_type);
+    for (auto* input : inputs) {
+        new_operator->AddInputBlob(input);
+        input->AddConsumer(new_operator);
+    }
+    for (auto* output : outputs) {
+        new_operator->AddOutputBlob(output);
+        output->SetProducer(new_operator);
+    }
+    return new_operator;
+}
+
 DataBlob* Graph::AddDataBlob(std::string name) {
     auto* new_data_blob                 = new DataBlob(name, *this);
     data_blobs_[new_data_blob->GetID()] = std::unique_ptr<DataBlob>(new_data_blob);
@@ -60,12 +103,100 @@ void Graph::EraseOperator(std::function<bool(const Operator*)> erase_cond) {
     }
 }
 
+void Graph::EraseBlob(DataBlob* blob) {
+    buffers_.erase(blob->GetID());
+    data_blobs_.erase(blob->GetID());
+}
+
 void Graph::EraseBlob(std::function<bool(const DataBlob*)> erase_cond) {
     for (auto blob_it = data_blobs_.begin(); blob_it != data_blobs_.end();) {
         if (erase_cond(blob_it->second.get())) {
+            buffers_.erase(blob_it->first);
             blob_it = data_blobs_.erase(blob_it);
             continue;
         }
         blob_it++;
     }
 }
+
+void Graph::RemoveOperator(Operator* op) {
+    for (auto blob_id : op->GetInputIDs()) {
+        if (auto* blob = GetDataBlob(blob_id)) {
+            blob->RemoveConsumer(op);
+        }
+    }
+    for (auto blob_id : op->GetOutputIDs()) {
+        auto* blob = GetDataBlob(blob_id);
+        if (blob != nullptr && blob->GetProducer() == op) {
+            blob->ResetProducer();
+        }
+    }
+    EraseOperator(op);
+}
+
+void Graph::RedirectConsumers(DataBlob* from, DataBlob* to) {
+    std::vector<Operator*> consumers;
+    common::copy(from->GetConsumers(), std::back_inserter(consumers));
+    for (auto* consumer : consumers) {
+        const auto& input_ids = consumer->GetInputIDs();
+        for (size_t index = 0; index < input_ids.size(); index++) {
+            if (input_ids[index] == from->GetID()) {
+                consumer->SetInputBlob(index, to);
+                from->RemoveConsumer(consumer);
+                to->AddConsumer(consumer);
+            }
+        }
+    }
+}
+
+std::vector<Operator*> Graph::TopologicalSort() const {
+    // Kahn's algorithm. Edges are collected from inputs of operators rather than consumer lists of blobs, so stale
+    // consumers left by erased operators don't matter.
+    std::unordered_map<NODEID_T, uint32_t>               in_degrees;
+    std::unordered_map<NODEID_T, std::vector<Operator*>> successors;
+    in_degrees.reserve(operators_.size());
+    successors.reserve(operators_.size());
+    for (const auto& [op_id, op] : operators_) {
+        auto& in_degree = in_degrees[op_id];
+        for (auto blob_id : op->GetInputIDs()) {
+            auto* blob     = GetDataBlob(blob_id);
+            auto* producer = blob == nullptr ? nullptr : blob->GetProducer();
+            if (producer == nullptr) {
+                continue;
+            }
+            in_degree++;
+            successors[producer->GetID()].push_back(op.get());
+        }
+    }
+
+    auto later_id = [](const Operator* op1, const Operator* op2) { return op1->GetID() > op2->GetID(); };
+    std::priority_queue<Operator*, std::vector<Operator*>, decltype(later_id)> ready_ops(later_id);
+    for (const auto& [op_id, op] : operators_) {
+        if (in_degrees.at(op_id) == 0) {
+            ready_ops.push(op.get());
+        }
+    }
+
+    std::vector<Operator*> sorted_ops;
+    sorted_ops.reserve(operators_.size());
+    while (!ready_ops.empty()) {
+        auto* op = ready_ops.top();
+        ready_ops.pop();
+        sorted_ops.push_back(op);
+        auto successor_it = successors.find(op->GetID());
+        if (successor_it == successors.end()) {
+            continue;
+        }
+        for (auto* successor : successor_it->second) {
+            if (--in_degrees.at(successor->GetID()) == 0) {
+                ready_ops.push(successor);
+            }
+        }
+    }
+    REPORT_ERROR_IF(sorted_ops.size() != operators_.size(), "Graph contains a cycle, cannot sort operators.");
+    return sorted_ops;
+}
+
+bool Graph::IsGraphInput(BLOBID_T blob_id) const { return common::contains(graph_inputs_, blob_id); }
+
+bool Graph::IsGraphOutput(BLOBID_T blob_id) const { return common::contains(graph_outputs_, blob_id); }
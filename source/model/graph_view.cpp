@@ -0,0 +1,41 @@
+#include "model/graph_view.h"
+
+#include <unordered_set>
+
+GraphView::GraphView(const Graph& graph)
+    : graph_(graph), inputs_(graph.GetGraphInputs()), outputs_(graph.GetGraphOutputs()) {
+    auto sorted_ops = graph.TopologicalSort();
+    sorted_ops_.assign(sorted_ops.begin(), sorted_ops.end());
+    for (const auto* blob : graph.GetDataBlobs()) {
+        data_blobs_.push_back(blob);
+    }
+}
+
+GraphView::GraphView(const Graph&                 graph,
+                     std::vector<const Operator*> sorted_ops,
+                     std::vector<BLOBID_T>        inputs,
+                     std::vector<BLOBID_T>        outputs)
+    : graph_(graph), sorted_ops_(std::move(sorted_ops)), inputs_(std::move(inputs)), outputs_(std::move(outputs)) {
+    std::unordered_set<BLOBID_T> visited_blobs;
+    auto                         add_blob = [&](BLOBID_T blob_id) {
+        if (visited_blobs.insert(blob_id).second) {
+            auto* blob = graph_.GetDataBlob(blob_id);
+            REPORT_ERROR_IF(blob == nullptr, "Blob ", blob_id, " of graph view doesn't exist.");
+            data_blobs_.push_back(blob);
+        }
+    };
+    for (auto blob_id : inputs_) {
+        add_blob(blob_id);
+    }
+    for (const auto* op : sorted_ops_) {
+        for (auto blob_id : op->GetInputIDs()) {
+            add_blob(blob_id);
+        }
+        for (auto blob_id : op->GetOutputIDs()) {
+            add_blob(blob_id);
+        }
+    }
+    for (auto blob_id : outputs_) {
+        add_blob(blob_id);
+    }
+}
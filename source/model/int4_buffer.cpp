@@ -0,0 +1,19 @@
+#include "model/int4_buffer.h"
+
+std::vector<uint8_t> Int4Buffer::Pack(const std::vector<int8_t>& values) {
+    std::vector<uint8_t> packed((values.size() + 1) / 2, 0);
+    for (size_t index = 0; index < values.size(); index++) {
+        uint8_t nibble = static_cast<uint8_t>(values[index]) & 0x0f;
+        packed[index >> 1] |= (index & 1) ? nibble << 4 : nibble;
+    }
+    return packed;
+}
+
+std::vector<int8_t> Int4Buffer::Unpack(const uint8_t* data, size_t size) {
+    Int4Buffer          buffer(data, size);
+    std::vector<int8_t> values(size);
+    for (size_t index = 0; index < size; index++) {
+        values[index] = buffer[index];
+    }
+    return values;
+}
@@ -11,6 +11,26 @@ DataBlob* Operator::DataBlobIterator::dereference() {
 void Operator::AddInputBlob(const DataBlob* blob) { inputs_.push_back(blob->GetID()); }
 void Operator::AddOutputBlob(const DataBlob* blob) { outputs_.push_back(blob->GetID()); }
 
+void Operator::SetInputBlob(size_t index, const DataBlob* blob) {
+    REPORT_ERROR_IF(index >= inputs_.size(), "Input index ", index, " is out of range.");
+    inputs_[index] = blob->GetID();
+}
+
+void Operator::SetOutputBlob(size_t index, const DataBlob* blob) {
+    REPORT_ERROR_IF(index >= outputs_.size(), "Output index ", index, " is out of range.");
+    outputs_[index] = blob->GetID();
+}
+
+DataBlob* Operator::GetInputBlob(size_t index) const {
+    REPORT_ERROR_IF(index >= inputs_.size(), "Input index ", index, " is out of range.");
+    return graph_.GetDataBlob(inputs_[index]);
+}
+
+DataBlob* Operator::GetOutputBlob(size_t index) const {
+    REPORT_ERROR_IF(index >= outputs_.size(), "Output index ", index, " is out of range.");
+    return graph_.GetDataBlob(outputs_[index]);
+}
+
 Range<Operator::DataBlobIterator> Operator::GetInputBlobs() const {
     return Range<Operator::DataBlobIterator> {
         {graph_, inputs_.begin()},
@@ -98,6 +98,7 @@ std::string ToStr(OperatorType op_type) {
         ENUM_PRINT(OperatorType, REDUCE_ANY);
         ENUM_PRINT(OperatorType, REDUCE_ALL);
         ENUM_PRINT(OperatorType, WHERE);
+        ENUM_PRINT(OperatorType, SHAPE);
 
         ENUM_DEFAULT_PRINT(NONE);
     }
@@ -126,3 +127,28 @@ std::string ToStr(DataType data_type) {
 }
 
 #undef ENUM_PRINT
+
+uint32_t GetBitWidth(DataType data_type) {
+    switch (data_type) {
+        case DataType::INT4:
+            return 4;
+        case DataType::UINT8:
+        case DataType::INT8:
+        case DataType::BOOL:
+            return 8;
+        case DataType::UINT16:
+        case DataType::INT16:
+        case DataType::FLOAT16:
+            return 16;
+        case DataType::UINT32:
+        case DataType::INT32:
+        case DataType::FLOAT32:
+            return 32;
+        case DataType::UINT64:
+        case DataType::INT64:
+        case DataType::FLOAT64:
+            return 64;
+        default:
+            return 0;
+    }
+}
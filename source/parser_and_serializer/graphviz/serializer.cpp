@@ -65,7 +65,7 @@ std::string GraphvizSerializer::ExportBlob(const DataBlob* data_blob, std::ostre
     output_stream << R"(<TR><TD ALIGN="CENTER"><FONT POINT-SIZE="14">)" << data_blob->GetShape()
                   << R"(</FONT></TD></TR>)";
     if (data_blob->HasQuantParam()) {
-        auto quant_param = data_blob->GetQuantParam();
+        const auto& quant_param = data_blob->GetQuantParam();
         output_stream << R"(<TR><TD ALIGN="CENTER"><FONT POINT-SIZE="14"> SCALE: )" << quant_param.scales[0]
                       << "  ZERO_POINT: " << quant_param.zero_points[0] << R"(</FONT></TD></TR>)";
     }
@@ -20,7 +20,7 @@ class DummyOptionResolver : public BaseOptionResolver {
 
 class Conv2DOptionResolver : public TfLiteOptionResolver<::tflite::Conv2DOptions, Conv2DOption> {
     void ParseOptionImpl(BaseOptionT& option, const TfLiteOptionT& tflite_option) const final {
-        option.stride_h        = tflite_option.stride_w();
+        option.stride_h        = tflite_option.stride_h();
         option.stride_w        = tflite_option.stride_w();
         option.dilation_w      = tflite_option.dilation_w_factor();
         option.dilation_h      = tflite_option.dilation_h_factor();
@@ -40,7 +40,7 @@ class Conv2DOptionResolver : public TfLiteOptionResolver<::tflite::Conv2DOptions
 class DepthwiseConv2DOptionResolver
     : public TfLiteOptionResolver<::tflite::DepthwiseConv2DOptions, DepthwiseConv2DOption> {
     void ParseOptionImpl(BaseOptionT& option, const TfLiteOptionT& tflite_option) const final {
-        option.stride_h         = tflite_option.stride_w();
+        option.stride_h         = tflite_option.stride_h();
         option.stride_w         = tflite_option.stride_w();
         option.dilation_w       = tflite_option.dilation_w_factor();
         option.dilation_h       = tflite_option.dilation_h_factor();
@@ -62,7 +62,7 @@ class DepthwiseConv2DOptionResolver
 class TransposeConv2DOptionResolver
     : public TfLiteOptionResolver<::tflite::TransposeConvOptions, TransposeConv2DOption> {
     void ParseOptionImpl(BaseOptionT& option, const TfLiteOptionT& tflite_option) const final {
-        option.stride_h        = tflite_option.stride_w();
+        option.stride_h        = tflite_option.stride_h();
         option.stride_w        = tflite_option.stride_w();
         option.pad_type        = utils::GetMappedPaddingOf(tflite_option.padding());
         option.activation_type = utils::GetMappedActTypeOf(tflite_option.fused_activation_function());
@@ -101,7 +101,9 @@ class Conv3DOptionResolver : public TfLiteOptionResolver<::tflite::Conv3DOptions
 
 class ReshapeOptionResolver : public TfLiteOptionResolver<::tflite::ReshapeOptions, ReshapeOption> {
     void ParseOptionImpl(BaseOptionT& option, const TfLiteOptionT& tflite_option) const final {
-        option.new_shape = utils::GetVecData<int>(tflite_option.new_shape());
+        if (tflite_option.new_shape() != nullptr) {
+            option.new_shape = utils::GetVecData<int>(tflite_option.new_shape());
+        }
     }
 
     flatbuffers::Offset<TfLiteOptionT> SerializeOptionImpl(const BaseOptionT&                option,
@@ -442,6 +444,30 @@ class BatchMatmulOptionResolver : public TfLiteOptionResolver<::tflite::BatchMat
     }
 };
 
+class ReducerOptionResolver : public TfLiteOptionResolver<::tflite::ReducerOptions, ReducerOption> {
+    void ParseOptionImpl(BaseOptionT& option, const TfLiteOptionT& tflite_option) const final {
+        option.keep_dims = tflite_option.keep_dims();
+    }
+
+    flatbuffers::Offset<TfLiteOptionT> SerializeOptionImpl(const BaseOptionT&                option,
+                                                           ::flatbuffers::FlatBufferBuilder* builder) const final {
+        return tflite::CreateReducerOptions(*builder, option.keep_dims);
+    }
+};
+
+class SqueezeOptionResolver : public TfLiteOptionResolver<::tflite::SqueezeOptions, SqueezeOption> {
+    void ParseOptionImpl(BaseOptionT& option, const TfLiteOptionT& tflite_option) const final {
+        if (tflite_option.squeeze_dims() != nullptr) {
+            option.squeeze_dims = utils::GetVecData<int>(tflite_option.squeeze_dims());
+        }
+    }
+
+    flatbuffers::Offset<TfLiteOptionT> SerializeOptionImpl(const BaseOptionT&                option,
+                                                           ::flatbuffers::FlatBufferBuilder* builder) const final {
+        return tflite::CreateSqueezeOptions(*builder, builder->CreateVector(option.squeeze_dims));
+    }
+};
+
 /**
  * OperatorResolver provides option parsers for each type of operator.
  * Create each parser in OperatorResolver's constructor, please add new type below.
@@ -486,8 +512,8 @@ OperatorResolver::OperatorResolver() {
                                                 ::tflite::BuiltinOptions_FullyConnectedOptions);
     AddOpResolver<DummyOptionResolver>(OperatorType::EXP, ::tflite::BuiltinOperator_EXP,
                                        ::tflite::BuiltinOptions_ExpOptions);
-    AddOpResolver<DummyOptionResolver>(OperatorType::MEAN, ::tflite::BuiltinOperator_MEAN,
-                                       ::tflite::BuiltinOptions_NONE);
+    AddOpResolver<ReducerOptionResolver>(OperatorType::MEAN, ::tflite::BuiltinOperator_MEAN,
+                                         ::tflite::BuiltinOptions_ReducerOptions);
     AddOpResolver<DummyOptionResolver>(OperatorType::TRANSPOSE, ::tflite::BuiltinOperator_TRANSPOSE,
                                        ::tflite::BuiltinOptions_TransposeOptions);
     AddOpResolver<DummyOptionResolver>(OperatorType::DEQUANTIZE, ::tflite::BuiltinOperator_DEQUANTIZE,
@@ -521,7 +547,8 @@ OperatorResolver::OperatorResolver() {
                                        ::tflite::BuiltinOptions_LogSoftmaxOptions);
     AddOpResolver<DummyOptionResolver>(OperatorType::NEG, ::tflite::BuiltinOperator_NEG,
                                        ::tflite::BuiltinOptions_NegOptions);
-    AddOpResolver<DummyOptionResolver>(OperatorType::SUM, ::tflite::BuiltinOperator_SUM, ::tflite::BuiltinOptions_NONE);
+    AddOpResolver<ReducerOptionResolver>(OperatorType::SUM, ::tflite::BuiltinOperator_SUM,
+                                         ::tflite::BuiltinOptions_ReducerOptions);
     AddOpResolver<DummyOptionResolver>(OperatorType::SIN, ::tflite::BuiltinOperator_SIN, ::tflite::BuiltinOptions_NONE);
     AddOpResolver<DummyOptionResolver>(OperatorType::COSINE, ::tflite::BuiltinOperator_COS,
                                        ::tflite::BuiltinOptions_NONE);
@@ -575,14 +602,47 @@ OperatorResolver::OperatorResolver() {
                                        ::tflite::BuiltinOptions_MaximumMinimumOptions);
     AddOpResolver<DummyOptionResolver>(OperatorType::MINIMUM, ::tflite::BuiltinOperator_MINIMUM,
                                        ::tflite::BuiltinOptions_MaximumMinimumOptions);
-    AddOpResolver<DummyOptionResolver>(OperatorType::ARGMIN, ::tflite::BuiltinOperator_ARG_MIN,
-                                       ::tflite::BuiltinOptions_ArgMinOptions);
-    AddOpResolver<DummyOptionResolver>(OperatorType::ARGMAX, ::tflite::BuiltinOperator_ARG_MAX,
-                                       ::tflite::BuiltinOptions_ArgMaxOptions);
+    AddOpResolver<ArgMinOptionResolver>(OperatorType::ARGMIN, ::tflite::BuiltinOperator_ARG_MIN,
+                                        ::tflite::BuiltinOptions_ArgMinOptions);
+    AddOpResolver<ArgMaxOptionResolver>(OperatorType::ARGMAX, ::tflite::BuiltinOperator_ARG_MAX,
+                                        ::tflite::BuiltinOptions_ArgMaxOptions);
     AddOpResolver<DummyOptionResolver>(OperatorType::BROADCAST_TO, ::tflite::BuiltinOperator_BROADCAST_TO,
                                        ::tflite::BuiltinOptions_BroadcastToOptions);
     AddOpResolver<DummyOptionResolver>(OperatorType::GATHER_ND, ::tflite::BuiltinOperator_GATHER_ND,
                                        ::tflite::BuiltinOptions_GatherNdOptions);
     AddOpResolver<DummyOptionResolver>(OperatorType::SELECT_V2, ::tflite::BuiltinOperator_SELECT_V2,
                                        ::tflite::BuiltinOptions_SelectV2Options);
+
+    AddOpResolver<ReducerOptionResolver>(OperatorType::REDUCE_MAX, ::tflite::BuiltinOperator_REDUCE_MAX,
+                                         ::tflite::BuiltinOptions_ReducerOptions);
+    AddOpResolver<ReducerOptionResolver>(OperatorType::REDUCE_MIN, ::tflite::BuiltinOperator_REDUCE_MIN,
+                                         ::tflite::BuiltinOptions_ReducerOptions);
+    AddOpResolver<ReducerOptionResolver>(OperatorType::REDUCE_PROD, ::tflite::BuiltinOperator_REDUCE_PROD,
+                                         ::tflite::BuiltinOptions_ReducerOptions);
+    AddOpResolver<ReducerOptionResolver>(OperatorType::REDUCE_ANY, ::tflite::BuiltinOperator_REDUCE_ANY,
+                                         ::tflite::BuiltinOptions_ReducerOptions);
+    AddOpResolver<ReducerOptionResolver>(OperatorType::REDUCE_ALL, ::tflite::BuiltinOperator_REDUCE_ALL,
+                                         ::tflite::BuiltinOptions_ReducerOptions);
+    AddOpResolver<SqueezeOptionResolver>(OperatorType::SQUEEZE, ::tflite::BuiltinOperator_SQUEEZE,
+                                         ::tflite::BuiltinOptions_SqueezeOptions);
+    AddOpResolver<DummyOptionResolver>(OperatorType::EXPAND_DIMS, ::tflite::BuiltinOperator_EXPAND_DIMS,
+                                       ::tflite::BuiltinOptions_ExpandDimsOptions);
+    AddOpResolver<ShapeOptionResolver>(OperatorType::SHAPE, ::tflite::BuiltinOperator_SHAPE,
+                                       ::tflite::BuiltinOptions_ShapeOptions);
+    AddOpResolver<DummyOptionResolver>(OperatorType::ReLU1, ::tflite::BuiltinOperator_RELU_N1_TO_1,
+                                       ::tflite::BuiltinOptions_NONE);
+    AddOpResolver<Pool2DOptionOptionResolver>(OperatorType::L2_POOL, ::tflite::BuiltinOperator_L2_POOL_2D,
+                                              ::tflite::BuiltinOptions_Pool2DOptions);
+    AddOpResolver<DummyOptionResolver>(OperatorType::L2_NORMALIZATION, ::tflite::BuiltinOperator_L2_NORMALIZATION,
+                                       ::tflite::BuiltinOptions_L2NormOptions);
+    AddOpResolver<DummyOptionResolver>(OperatorType::EQUAL, ::tflite::BuiltinOperator_EQUAL,
+                                       ::tflite::BuiltinOptions_EqualOptions);
+    AddOpResolver<DummyOptionResolver>(OperatorType::NOT_EQUAL, ::tflite::BuiltinOperator_NOT_EQUAL,
+                                       ::tflite::BuiltinOptions_NotEqualOptions);
+    AddOpResolver<DummyOptionResolver>(OperatorType::SELECT, ::tflite::BuiltinOperator_SELECT,
+                                       ::tflite::BuiltinOptions_SelectOptions);
+    AddOpResolver<DummyOptionResolver>(OperatorType::REVERSEV2, ::tflite::BuiltinOperator_REVERSE_V2,
+                                       ::tflite::BuiltinOptions_ReverseV2Options);
+    AddOpResolver<DummyOptionResolver>(OperatorType::WHERE, ::tflite::BuiltinOperator_WHERE,
+                                       ::tflite::BuiltinOptions_WhereOptions);
 }
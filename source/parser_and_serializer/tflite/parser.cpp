@@ -2,7 +2,9 @@
 
 #include <string.h>
 
+#include <chrono>
 #include <map>
+#include <unordered_map>
 
 #include "common/stl_wrapper.h"
 #include "parser_and_serializer/tflite/utils.h"
@@ -16,12 +18,15 @@ std::unique_ptr<Model> TfLiteParser::ImportModel(const std::string& tflite_file_
     std::unique_ptr<Model> model = std::make_unique<Model>();
     // load tensors
     LoadTensors(*input_model, model.get());
+    LoadCompressedBuffers(*input_model, model.get());
     // operator table
     LoadOperatorsTable(*input_model);
     // load operators
     LoadOperators(*input_model, model.get());
 
     LoadInputsOutputs(*input_model, model.get());
+
+    LoadMetadata(*input_model, model.get());
     LOG(INFO) << "TfLiteParser::ImportModel End.";
     return model;
 }
@@ -43,8 +48,8 @@ void TfLiteParser::LoadTensors(const tflite::Model& input_model, Model* model) {
         int   buffer_index = tensor->buffer();
         auto* src_buffer   = buffers->Get(buffer_index)->data();
         if (src_buffer != nullptr) {
-            std::vector<uint8_t> src_data(src_buffer->data(), src_buffer->data() + src_buffer->size());
-            main_graph.SetBuffer(data_blob->GetID(), src_data);
+            main_graph.SetBuffer(data_blob->GetID(),
+                                 std::vector<uint8_t>(src_buffer->data(), src_buffer->data() + src_buffer->size()));
         }
         // Get blob shape
         auto shape = tensor->shape();
@@ -64,16 +69,102 @@ void TfLiteParser::LoadTensors(const tflite::Model& input_model, Model* model) {
                 quantization_param.min = quantization->min()->Get(0);
                 quantization_param.max = quantization->max()->Get(0);
             }
+            // Read in place from the flatbuffer, per-channel arrays are copied once into the shared pool.
             if (quantization->scale() != nullptr && quantization->zero_point() != nullptr) {
-                std::vector<float>   q_scales;
-                std::vector<int64_t> q_zero_points;
-                quantization_param.scales      = utils::GetVecData(quantization->scale());
-                quantization_param.zero_points = utils::GetVecData(quantization->zero_point());
+                auto* scales      = quantization->scale();
+                auto* zero_points = quantization->zero_point();
+                quantization_param.scales.assign(scales->data(), scales->data() + scales->size());
+                quantization_param.zero_points.assign(zero_points->data(), zero_points->data() + zero_points->size());
             }
+            quantization_param.quantized_dimension = quantization->quantized_dimension();
+        }
+        // Sparse constants are kept compressed, the buffer only holds the non-zero values.
+        if (tensor->sparsity() != nullptr) {
+            LoadSparsity(*tensor->sparsity(), data_blob);
         }
     }
 }
 
+void TfLiteParser::LoadSparsity(const tflite::SparsityParameters& sparsity, DataBlob* data_blob) {
+    auto& sparsity_param = data_blob->CreateSparsityParam();
+    if (sparsity.traversal_order() != nullptr) {
+        sparsity_param.traversal_order = utils::GetVecData(sparsity.traversal_order());
+    }
+    if (sparsity.block_map() != nullptr) {
+        sparsity_param.block_map = utils::GetVecData(sparsity.block_map());
+    }
+    if (sparsity.dim_metadata() == nullptr) {
+        return;
+    }
+    for (const auto* metadata : *sparsity.dim_metadata()) {
+        DataBlob::SparsityParam::DimensionMetadata dimension;
+        dimension.sparse         = metadata->format() == tflite::DimensionType_SPARSE_CSR;
+        dimension.dense_size     = metadata->dense_size();
+        dimension.array_segments = utils::GetSparseIndices(metadata->array_segments_type(), metadata->array_segments());
+        dimension.array_indices  = utils::GetSparseIndices(metadata->array_indices_type(), metadata->array_indices());
+        sparsity_param.dim_metadata.push_back(std::move(dimension));
+    }
+}
+
+void TfLiteParser::LoadCompressedBuffers(const tflite::Model& input_model, Model* model) {
+    compression_stats_ = common::CompressionStats();
+    auto* metadatas    = input_model.metadata();
+    auto* buffers      = input_model.buffers();
+    if (metadatas == nullptr || buffers == nullptr) {
+        return;
+    }
+    const flatbuffers::Vector<uint8_t>* archive_data = nullptr;
+    for (const auto* metadata : *metadatas) {
+        if (metadata->name() != nullptr && metadata->name()->str() == utils::compressed_buffers_name &&
+            metadata->buffer() < buffers->size()) {
+            archive_data = buffers->Get(metadata->buffer())->data();
+        }
+    }
+    if (archive_data == nullptr) {
+        return;
+    }
+    DLOG(INFO) << "TfLiteParser::LoadCompressedBuffers Start.";
+    common::BufferArchive archive(archive_data->data(), archive_data->size());
+
+    // Archive keys are buffer indices, a buffer may back several tensors of the main subgraph or none of them.
+    std::unordered_map<uint32_t, std::vector<DataBlob*>> buffer_blobs;
+    auto tensors = (*input_model.subgraphs())[0]->tensors();
+    for (uint32_t index = 0; tensors != nullptr && index < tensors->size(); index++) {
+        buffer_blobs[tensors->Get(index)->buffer()].push_back(data_blob_table_.at(index));
+    }
+    // Chunks are decompressed straight into the buffers of the graph.
+    auto&                 main_graph = model->GetMainGraph();
+    std::vector<uint8_t*> outputs(archive.num_buffers(), nullptr);
+    for (size_t buffer = 0; buffer < archive.num_buffers(); buffer++) {
+        auto blobs = buffer_blobs.find(archive.key(buffer));
+        if (blobs == buffer_blobs.end()) {
+            continue;
+        }
+        auto blob_id = blobs->second.front()->GetID();
+        main_graph.SetBuffer(blob_id, std::vector<uint8_t>(archive.raw_size(buffer)));
+        outputs[buffer] = main_graph.GetBuffer(blob_id)->data();
+        compression_stats_.raw_bytes += archive.raw_size(buffer);
+    }
+    auto start = std::chrono::steady_clock::now();
+    archive.unpack(outputs, num_threads_);
+    auto end = std::chrono::steady_clock::now();
+
+    for (size_t buffer = 0; buffer < archive.num_buffers(); buffer++) {
+        if (outputs[buffer] == nullptr) {
+            continue;
+        }
+        const auto& blobs = buffer_blobs.at(archive.key(buffer));
+        for (size_t index = 1; index < blobs.size(); index++) {
+            main_graph.SetBuffer(blobs[index]->GetID(),
+                                 std::vector<uint8_t>(outputs[buffer], outputs[buffer] + archive.raw_size(buffer)));
+        }
+    }
+    compression_stats_.compressed_bytes = archive_data->size();
+    compression_stats_.seconds          = std::chrono::duration<double>(end - start).count();
+    LOG(INFO) << "Decompressed " << compression_stats_.raw_bytes << " bytes of buffers at "
+              << compression_stats_.raw_bytes / std::max(compression_stats_.seconds, 1e-9) / 1e9 << " GB/s.";
+}
+
 void TfLiteParser::LoadOperatorsTable(const tflite::Model& input_model) {
     DLOG(INFO) << "TfLiteParser::LoadOperatorsTable Start.";
     auto opcodes = input_model.operator_codes();
@@ -142,3 +233,25 @@ void TfLiteParser::LoadInputsOutputs(const tflite::Model& input_model, Model* mo
     main_graph.SetGraphInputs(graph_inputs);
     main_graph.SetGraphOutputs(graph_outputs);
 }
+
+void TfLiteParser::LoadMetadata(const tflite::Model& input_model, Model* model) {
+    DLOG(INFO) << "TfLiteParser::LoadMetadata Start.";
+    auto* metadatas = input_model.metadata();
+    auto* buffers   = input_model.buffers();
+    if (metadatas == nullptr || buffers == nullptr) {
+        return;
+    }
+    for (const auto* metadata : *metadatas) {
+        // Skip dangling entries instead of failing, older exports of this repo referred a buffer out of range.
+        if (metadata->name() == nullptr || metadata->buffer() >= buffers->size()) {
+            continue;
+        }
+        // Compressed buffers are restored into tensors, re-exporting decides whether to pack them again.
+        if (metadata->name()->str() == utils::compressed_buffers_name) {
+            continue;
+        }
+        auto* data = buffers->Get(metadata->buffer())->data();
+        model->SetMetadata(metadata->name()->str(),
+                           data == nullptr ? std::vector<uint8_t>() : std::vector<uint8_t>(data->begin(), data->end()));
+    }
+}
@@ -1,32 +1,100 @@
 #include "parser_and_serializer/tflite/serializer.h"
 
+#include <chrono>
 #include <fstream>
 #include <set>
+#include <unordered_map>
 
+#include "common/hash_utils.h"
 #include "common/stl_wrapper.h"
 #include "parser_and_serializer/tflite/utils.h"
 
 #define TFLITE_SCHEMA_VERSION 3
 
 void TfLiteSerializer::ExportToTfLite(const Model& model, std::string output_path) {
+    ExportToTfLite(model, GraphView(model.GetMainGraph()), output_path);
+}
+
+void TfLiteSerializer::ExportToTfLite(const Model& model, const GraphView& main_graph, std::string output_path) {
+    ExportModel({&main_graph}, {}, model.GetMetadata(), output_path);
+}
+
+void TfLiteSerializer::ExportToTfLite(const std::vector<Signature>& signatures, std::string output_path) {
+    REPORT_ERROR_IF(signatures.empty(), "No graphs to export.");
+    std::vector<const GraphView*> graphs;
+    std::vector<std::string>      signature_keys;
+    for (const auto& signature : signatures) {
+        REPORT_ERROR_IF(common::contains(signature_keys, signature.key), "Signature `", signature.key,
+                        "` is duplicated.");
+        graphs.push_back(&signature.graph);
+        signature_keys.push_back(signature.key);
+    }
+    ExportModel(graphs, signature_keys, {}, output_path);
+}
+
+void TfLiteSerializer::EnableCompression(uint64_t min_buffer_bytes, size_t num_threads) {
+    compression_enabled_   = true;
+    compression_min_bytes_ = min_buffer_bytes;
+    compression_threads_   = num_threads;
+}
+
+void TfLiteSerializer::ExportModel(const std::vector<const GraphView*>& graphs,
+                                   const std::vector<std::string>&      signature_keys,
+                                   const Model::MetadataMap&            metadata,
+                                   std::string                          output_path) {
     LOG(INFO) << "TfLiteSerializer::ExportToTfLite Start.";
     flatbuffers::FlatBufferBuilder builder(10240);
 
     // Export op codes
-    auto op_codes = ExportOpCodes(model, &builder);
+    auto op_codes = ExportOpCodes(graphs, &builder);
     // Export buffers
-    auto buffers = ExportBuffers(model, &builder);
-    // Export SubGraphs
-    auto subgraphs = ExportSubGraphs(model, &builder);
+    auto buffers = ExportBuffers(graphs, &builder);
+    // Export SubGraphs, tensor indices of a subgraph are valid until the next subgraph is exported.
+    std::vector<Offset<tflite::SubGraph>>     subgraphs;
+    std::vector<Offset<tflite::SignatureDef>> signature_defs;
+    for (uint32_t index = 0; index < graphs.size(); index++) {
+        auto name = signature_keys.empty() ? std::string() : signature_keys[index];
+        subgraphs.push_back(ExportSubGraph(*graphs[index], name, &builder));
+        if (!signature_keys.empty()) {
+            signature_defs.push_back(ExportSignatureDef(*graphs[index], name, index, &builder));
+        }
+    }
     // Export description
     auto description = builder.CreateString("custom_tflite repo export");
-    // Export meta data
-    Offset<tflite::Metadata> metadata =
-        tflite::CreateMetadata(builder, builder.CreateString("metadata"), buffers.size());
-    std::vector<Offset<tflite::Metadata>> metadatas = {metadata};
+    // Export meta data, each entry owns a buffer appended after tensor buffers.
+    std::vector<Offset<tflite::Metadata>> metadatas;
+    for (const auto& [name, data] : metadata) {
+        buffers.push_back(tflite::CreateBuffer(builder, builder.CreateVector(data)));
+        metadatas.push_back(tflite::CreateMetadata(builder, builder.CreateString(name), buffers.size() - 1));
+    }
+    if (compression_enabled_) {
+        auto start   = std::chrono::steady_clock::now();
+        auto archive = common::pack_buffers(archive_inputs_, compression_threads_);
+        auto end     = std::chrono::steady_clock::now();
+
+        compression_stats_ = common::CompressionStats();
+        for (const auto& input : archive_inputs_) {
+            compression_stats_.raw_bytes += input.size;
+        }
+        compression_stats_.compressed_bytes = archive.size();
+        compression_stats_.seconds          = std::chrono::duration<double>(end - start).count();
+        LOG(INFO) << "Compressed " << archive_inputs_.size() << " buffers of " << compression_stats_.raw_bytes
+                  << " bytes into " << archive.size() << " bytes at "
+                  << compression_stats_.raw_bytes / std::max(compression_stats_.seconds, 1e-9) / 1e9 << " GB/s.";
+
+        buffers.push_back(tflite::CreateBuffer(builder, builder.CreateVector(archive)));
+        metadatas.push_back(tflite::CreateMetadata(builder, builder.CreateString(utils::compressed_buffers_name),
+                                                   buffers.size() - 1));
+    }
+
+    Offset<Vector<Offset<tflite::SignatureDef>>> signatures;
+    if (!signature_defs.empty()) {
+        signatures = builder.CreateVector(signature_defs);
+    }
 
-    auto tflite_model = CreateModel(builder, TFLITE_SCHEMA_VERSION, op_codes, subgraphs, description,
-                                    builder.CreateVector(buffers), 0, builder.CreateVector(metadatas));
+    auto tflite_model = CreateModel(builder, TFLITE_SCHEMA_VERSION, op_codes, builder.CreateVector(subgraphs),
+                                    description, builder.CreateVector(buffers), 0, builder.CreateVector(metadatas),
+                                    signatures);
     ::tflite::FinishModelBuffer(builder, tflite_model);
     // Export to file
     const uint8_t* buffer = builder.GetBufferPointer();
@@ -42,34 +110,54 @@ void TfLiteSerializer::ExportToTfLite(const Model& model, std::string output_pat
     LOG(INFO) << "TfLiteSerializer::ExportToTfLite End.";
 }
 
-Offset<Vector<Offset<tflite::SubGraph>>> TfLiteSerializer::ExportSubGraphs(const Model&                    model,
-                                                                           flatbuffers::FlatBufferBuilder* builder) {
-    const auto& main_graph = model.GetMainGraph();
-
-    auto tensors   = ExportTensors(main_graph, builder);
-    auto operators = ExportOperators(main_graph, builder);
+Offset<tflite::SubGraph> TfLiteSerializer::ExportSubGraph(const GraphView&                subgraph,
+                                                          const std::string&              name,
+                                                          flatbuffers::FlatBufferBuilder* builder) {
+    auto tensors   = ExportTensors(subgraph, builder);
+    auto operators = ExportOperators(subgraph, builder);
 
     std::vector<int32_t> graph_inputs;
-    for (auto input : main_graph.GetGraphInputs()) {
+    for (auto input : subgraph.GetGraphInputs()) {
         graph_inputs.push_back(data_blob_index_map_.at(input));
     }
     std::vector<int32_t> graph_outputs;
-    for (auto output : main_graph.GetGraphOutputs()) {
+    for (auto output : subgraph.GetGraphOutputs()) {
         graph_outputs.push_back(data_blob_index_map_.at(output));
     }
 
-    auto subgraph = tflite::CreateSubGraph(*builder, tensors, builder->CreateVector(graph_inputs),
-                                           builder->CreateVector(graph_outputs), operators, 0);
-    std::vector<Offset<tflite::SubGraph>> subgraphs = {subgraph};
-    return builder->CreateVector(subgraphs);
+    Offset<flatbuffers::String> subgraph_name;
+    if (!name.empty()) {
+        subgraph_name = builder->CreateString(name);
+    }
+    return tflite::CreateSubGraph(*builder, tensors, builder->CreateVector(graph_inputs),
+                                  builder->CreateVector(graph_outputs), operators, subgraph_name);
 }
 
-Offset<Vector<Offset<tflite::OperatorCode>>> TfLiteSerializer::ExportOpCodes(const Model&                    model,
-                                                                             flatbuffers::FlatBufferBuilder* builder) {
+Offset<tflite::SignatureDef> TfLiteSerializer::ExportSignatureDef(const GraphView&                subgraph,
+                                                                  const std::string&              key,
+                                                                  uint32_t                        subgraph_index,
+                                                                  flatbuffers::FlatBufferBuilder* builder) {
+    // Inputs and outputs are named after their tensors.
+    auto export_tensor_maps = [&](const std::vector<BLOBID_T>& blob_ids) {
+        std::vector<Offset<tflite::TensorMap>> tensor_maps;
+        for (auto blob_id : blob_ids) {
+            auto name = builder->CreateString(subgraph.GetGraph().GetDataBlob(blob_id)->GetName());
+            tensor_maps.push_back(tflite::CreateTensorMap(*builder, name, data_blob_index_map_.at(blob_id)));
+        }
+        return builder->CreateVector(tensor_maps);
+    };
+    auto inputs  = export_tensor_maps(subgraph.GetGraphInputs());
+    auto outputs = export_tensor_maps(subgraph.GetGraphOutputs());
+    return tflite::CreateSignatureDef(*builder, inputs, outputs, builder->CreateString(key), subgraph_index);
+}
+
+Offset<Vector<Offset<tflite::OperatorCode>>> TfLiteSerializer::ExportOpCodes(
+    const std::vector<const GraphView*>& graphs, flatbuffers::FlatBufferBuilder* builder) {
     std::set<OperatorType> op_type_set;
-    const auto&            main_graph = model.GetMainGraph();
-    for (const auto* op : main_graph.GetOperators()) {
-        op_type_set.insert(op->GetOpType());
+    for (const auto* graph : graphs) {
+        for (const auto* op : graph->GetOperators()) {
+            op_type_set.insert(op->GetOpType());
+        }
     }
     common::copy(op_type_set, std::back_inserter(op_type_table_));
 
@@ -86,37 +174,71 @@ Offset<Vector<Offset<tflite::OperatorCode>>> TfLiteSerializer::ExportOpCodes(con
     return builder->CreateVector(op_codes_vec);
 }
 
-std::vector<Offset<tflite::Buffer>> TfLiteSerializer::ExportBuffers(const Model&                    model,
-                                                                    flatbuffers::FlatBufferBuilder* builder) {
+std::vector<Offset<tflite::Buffer>> TfLiteSerializer::ExportBuffers(const std::vector<const GraphView*>& graphs,
+                                                                    flatbuffers::FlatBufferBuilder*      builder) {
     std::vector<Offset<tflite::Buffer>> buffers;
     // Insert an empty buffer to the beginning of the list.
     buffers.push_back(tflite::CreateBuffer(*builder, 0));
+    archive_inputs_.clear();
 
-    const auto& main_graph = model.GetMainGraph();
-    auto        data_blobs = main_graph.GetDataBlobs();
-    buffers.reserve(buffers.size() + data_blobs.size());
-    for (const auto* blob : data_blobs) {
-        const auto* buffer_ptr = main_graph.GetBuffer(blob->GetID());
-        if (buffer_ptr == nullptr) {
-            buffers.push_back(tflite::CreateBuffer(*builder, 0));
-        } else {
-            buffers.push_back(tflite::CreateBuffer(*builder, builder->CreateVector(*buffer_ptr)));
+    // Constants are bucketed by the hash of their content, a constant equal to an exported one refers its buffer.
+    using ExportedBuffer = std::pair<const std::vector<uint8_t>*, uint32_t>;
+    std::unordered_map<uint64_t, std::vector<ExportedBuffer>> exported_buffers;
+    for (const auto* graph : graphs) {
+        for (const auto* blob : graph->GetDataBlobs()) {
+            const auto* buffer_ptr = graph->GetGraph().GetBuffer(blob->GetID());
+            if (buffer_ptr == nullptr) {
+                buffers.push_back(tflite::CreateBuffer(*builder, 0));
+                buffer_index_map_[blob->GetID()] = buffers.size() - 1;
+                continue;
+            }
+            auto& bucket   = exported_buffers[common::hash_bytes(buffer_ptr->data(), buffer_ptr->size())];
+            auto  exported = std::find_if(bucket.begin(), bucket.end(),
+                                          [&](const ExportedBuffer& buffer) { return *buffer.first == *buffer_ptr; });
+            if (exported != bucket.end()) {
+                buffer_index_map_[blob->GetID()] = exported->second;
+                continue;
+            }
+            // Compressed buffers stay empty in the model, the archive is keyed by their buffer index.
+            if (compression_enabled_ && buffer_ptr->size() >= compression_min_bytes_ && !buffer_ptr->empty()) {
+                uint32_t element_size = std::max<uint32_t>(GetBitWidth(blob->GetDataType()) / 8, 1);
+                archive_inputs_.push_back({static_cast<uint32_t>(buffers.size()), buffer_ptr->data(),
+                                           buffer_ptr->size(), element_size});
+                buffers.push_back(tflite::CreateBuffer(*builder, 0));
+            } else {
+                buffers.push_back(tflite::CreateBuffer(*builder, builder->CreateVector(*buffer_ptr)));
+            }
+            buffer_index_map_[blob->GetID()] = buffers.size() - 1;
+            bucket.emplace_back(buffer_ptr, buffers.size() - 1);
         }
-        buffer_index_map_[blob->GetID()] = buffers.size() - 1;
     }
     return buffers;
 }
 
-Offset<Vector<Offset<tflite::Tensor>>> TfLiteSerializer::ExportTensors(const Graph&                    subgraph,
-                                                                       flatbuffers::FlatBufferBuilder* builder) {
-    data_blob_index_map_.clear();
-    std::vector<DataBlob*> data_blobs(subgraph.GetDataBlobs().size());
-    common::transform(subgraph.GetDataBlobs(), data_blobs.begin(), [](DataBlob* blob) { return blob; });
-    std::sort(data_blobs.begin(), data_blobs.end(),
-              [](const DataBlob* blob1, const DataBlob* blob2) { return blob1->GetName() < blob2->GetName(); });
+std::map<BLOBID_T, uint32_t> TfLiteSerializer::GetTensorIndices(const Graph& graph) {
+    return GetTensorIndices(GraphView(graph));
+}
 
+std::map<BLOBID_T, uint32_t> TfLiteSerializer::GetTensorIndices(const GraphView& graph) {
+    auto data_blobs = graph.GetDataBlobs();
+    // Blob id breaks ties of duplicated names, so that indices are the same every time.
+    std::sort(data_blobs.begin(), data_blobs.end(), [](const DataBlob* blob1, const DataBlob* blob2) {
+        return std::make_pair(blob1->GetName(), blob1->GetID()) < std::make_pair(blob2->GetName(), blob2->GetID());
+    });
+
+    std::map<BLOBID_T, uint32_t> tensor_indices;
     for (uint32_t index = 0; index < data_blobs.size(); index++) {
-        data_blob_index_map_[data_blobs.at(index)->GetID()] = index;
+        tensor_indices[data_blobs.at(index)->GetID()] = index;
+    }
+    return tensor_indices;
+}
+
+Offset<Vector<Offset<tflite::Tensor>>> TfLiteSerializer::ExportTensors(const GraphView&                subgraph,
+                                                                       flatbuffers::FlatBufferBuilder* builder) {
+    data_blob_index_map_ = GetTensorIndices(subgraph);
+    std::vector<const DataBlob*> data_blobs(data_blob_index_map_.size());
+    for (const auto& [blob_id, index] : data_blob_index_map_) {
+        data_blobs[index] = subgraph.GetGraph().GetDataBlob(blob_id);
     }
 
     std::vector<Offset<tflite::Tensor>> tensors;
@@ -124,36 +246,64 @@ Offset<Vector<Offset<tflite::Tensor>>> TfLiteSerializer::ExportTensors(const Gra
     for (const auto* data_blob : data_blobs) {
         Offset<tflite::QuantizationParameters> quant_param = tflite::CreateQuantizationParameters(*builder);
         if (data_blob->HasQuantParam()) {
-            auto                    quantization = data_blob->GetQuantParam();
+            const auto&             quantization = data_blob->GetQuantParam();
             Offset<Vector<float>>   min;
             Offset<Vector<float>>   max;
             Offset<Vector<float>>   scale;
             Offset<Vector<int64_t>> zero_point;
             min         = builder->CreateVector(std::vector<float> {quantization.min});
             max         = builder->CreateVector(std::vector<float> {quantization.max});
-            scale       = builder->CreateVector(quantization.scales);
-            zero_point  = builder->CreateVector(quantization.zero_points);
-            quant_param = tflite::CreateQuantizationParameters(*builder, min, max, scale, zero_point);
+            scale       = builder->CreateVector(quantization.scales.data(), quantization.scales.size());
+            zero_point  = builder->CreateVector(quantization.zero_points.data(), quantization.zero_points.size());
+            quant_param = tflite::CreateQuantizationParameters(*builder, min, max, scale, zero_point,
+                                                               tflite::QuantizationDetails_NONE, 0,
+                                                               quantization.quantized_dimension);
+        }
+
+        Offset<tflite::SparsityParameters> sparsity;
+        if (data_blob->HasSparsityParam()) {
+            sparsity = ExportSparsity(data_blob->GetSparsityParam(), builder);
         }
 
         auto tensor_type = utils::GetMappedDataTypeOf(data_blob->GetDataType());
         auto shape       = data_blob->GetShape().GetDims();
         auto tensor      = tflite::CreateTensor(*builder, builder->CreateVector(shape), tensor_type,
                                                 buffer_index_map_.at(data_blob->GetID()),
-                                                builder->CreateString(data_blob->GetName()), quant_param, false);
+                                                builder->CreateString(data_blob->GetName()), quant_param, false,
+                                                sparsity);
         tensors.push_back(tensor);
     }
 
     return builder->CreateVector(tensors);
 }
 
-Offset<Vector<Offset<tflite::Operator>>> TfLiteSerializer::ExportOperators(const Graph&                    subgraph,
+Offset<tflite::SparsityParameters> TfLiteSerializer::ExportSparsity(const DataBlob::SparsityParam&  sparsity,
+                                                                  flatbuffers::FlatBufferBuilder* builder) {
+    std::vector<Offset<tflite::DimensionMetadata>> dim_metadata;
+    for (const auto& dimension : sparsity.dim_metadata) {
+        auto format = dimension.sparse ? tflite::DimensionType_SPARSE_CSR : tflite::DimensionType_DENSE;
+        if (!dimension.sparse) {
+            dim_metadata.push_back(tflite::CreateDimensionMetadata(*builder, format, dimension.dense_size));
+            continue;
+        }
+        auto [segments_type, segments] = utils::CreateSparseIndices(*builder, dimension.array_segments);
+        auto [indices_type, indices]   = utils::CreateSparseIndices(*builder, dimension.array_indices);
+        dim_metadata.push_back(tflite::CreateDimensionMetadata(*builder, format, dimension.dense_size, segments_type,
+                                                               segments, indices_type, indices));
+    }
+    auto traversal_order = builder->CreateVector(sparsity.traversal_order);
+    auto block_map       = builder->CreateVector(sparsity.block_map);
+    return tflite::CreateSparsityParameters(*builder, traversal_order, block_map, builder->CreateVector(dim_metadata));
+}
+
+Offset<Vector<Offset<tflite::Operator>>> TfLiteSerializer::ExportOperators(const GraphView&                subgraph,
                                                                            flatbuffers::FlatBufferBuilder* builder) {
-    auto ops = subgraph.GetOperators();
+    // Operators are serialized in execution order, which the view keeps.
+    const auto& ops = subgraph.GetOperators();
 
     std::vector<Offset<tflite::Operator>> tflite_ops;
     tflite_ops.reserve(ops.size());
-    for (auto* op : ops) {
+    for (const auto* op : ops) {
         uint32_t op_index = common::get_first_index(op_type_table_, op->GetOpType());
         REPORT_ERROR_IF(op_index >= op_type_table_.size(), "Op type is not registered when export");
 
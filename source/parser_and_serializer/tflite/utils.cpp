@@ -2,6 +2,8 @@
 
 #include <fcntl.h>
 
+#include <algorithm>
+#include <limits>
 #include <map>
 #include <string>
 
@@ -36,6 +38,8 @@ std::string GetContents(const std::string& model_path) {
 
 DataType GetMappedDataTypeOf(tflite::TensorType tensor_type) {
     switch (tensor_type) {
+        case tflite::TensorType_INT4:
+            return DataType::INT4;
         case tflite::TensorType_INT8:
             return DataType::INT8;
         case tflite::TensorType_UINT8:
@@ -62,6 +66,8 @@ DataType GetMappedDataTypeOf(tflite::TensorType tensor_type) {
 
 tflite::TensorType GetMappedDataTypeOf(DataType data_type) {
     switch (data_type) {
+        case DataType::INT4:
+            return tflite::TensorType_INT4;
         case DataType::INT8:
             return tflite::TensorType_INT8;
         case DataType::UINT8:
@@ -128,4 +134,46 @@ Padding GetMappedPaddingOf(::tflite::Padding padding) {
     }
 }
 
+std::vector<int32_t> GetSparseIndices(::tflite::SparseIndexVector type, const void* indices) {
+    if (indices == nullptr) {
+        return {};
+    }
+    switch (type) {
+        case ::tflite::SparseIndexVector_Int32Vector: {
+            const auto* values = static_cast<const ::tflite::Int32Vector*>(indices)->values();
+            return values != nullptr ? GetVecData(values) : std::vector<int32_t> {};
+        }
+        case ::tflite::SparseIndexVector_Uint16Vector: {
+            const auto* values = static_cast<const ::tflite::Uint16Vector*>(indices)->values();
+            return values != nullptr ? std::vector<int32_t>(values->begin(), values->end()) : std::vector<int32_t> {};
+        }
+        case ::tflite::SparseIndexVector_Uint8Vector: {
+            const auto* values = static_cast<const ::tflite::Uint8Vector*>(indices)->values();
+            return values != nullptr ? std::vector<int32_t>(values->begin(), values->end()) : std::vector<int32_t> {};
+        }
+        default:
+            return {};
+    }
+}
+
+std::pair<::tflite::SparseIndexVector, ::flatbuffers::Offset<void>>
+CreateSparseIndices(::flatbuffers::FlatBufferBuilder& builder, const std::vector<int32_t>& indices) {
+    int32_t max_index = 0;
+    for (auto index : indices) {
+        max_index = std::max(max_index, index);
+    }
+    if (max_index <= std::numeric_limits<uint8_t>::max()) {
+        std::vector<uint8_t> values(indices.begin(), indices.end());
+        return {::tflite::SparseIndexVector_Uint8Vector,
+                ::tflite::CreateUint8Vector(builder, builder.CreateVector(values)).Union()};
+    }
+    if (max_index <= std::numeric_limits<uint16_t>::max()) {
+        std::vector<uint16_t> values(indices.begin(), indices.end());
+        return {::tflite::SparseIndexVector_Uint16Vector,
+                ::tflite::CreateUint16Vector(builder, builder.CreateVector(values)).Union()};
+    }
+    return {::tflite::SparseIndexVector_Int32Vector,
+            ::tflite::CreateInt32Vector(builder, builder.CreateVector(indices)).Union()};
+}
+
 }  // namespace utils
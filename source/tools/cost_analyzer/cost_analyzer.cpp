@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include "analysis/cost_model.h"
+#include "analysis/repeated_block_detector.h"
+#include "common/command_line_parser.h"
+#include "common/string_utils.h"
+#include "model/model.h"
+#include "parser_and_serializer/tflite/parser.h"
+
+struct AnalyzerOptions {
+    Option<std::string> input_tflite_file;
+    Option<int32_t>     top;
+    Option<double>      peak_gflops;
+    Option<double>      peak_gbps;
+    Option<std::string> output_json_file;
+    Option<bool>        blocks;
+};
+
+namespace {
+using OperatorCost = CostModel::OperatorCost;
+
+// Operators have no names, they are named after their first output.
+std::string GetOperatorName(const Operator& op) {
+    return op.GetOutputIDs().empty() ? std::string() : op.GetOutputBlob(0)->GetName();
+}
+
+void PrintTable(std::ostream&                    out,
+                const std::vector<OperatorCost>& hotspots,
+                const CostModel::Roofline&       roofline,
+                double                           total_seconds) {
+    out << std::left << std::setw(5) << "rank" << std::setw(20) << "op_type" << std::setw(40) << "output"
+        << std::right << std::setw(16) << "MACs" << std::setw(16) << "FLOPs" << std::setw(14) << "weight_bytes"
+        << std::setw(14) << "act_bytes" << std::setw(10) << "FLOP/B" << std::setw(9) << "bound" << std::setw(12)
+        << "time_us" << std::setw(8) << "share" << "\n";
+    for (size_t rank = 0; rank < hotspots.size(); rank++) {
+        const auto& cost    = hotspots[rank];
+        auto        seconds = roofline.EstimateSeconds(cost);
+        auto        name    = GetOperatorName(*cost.op);
+        if (name.size() > 38) {
+            name = "..." + name.substr(name.size() - 35);
+        }
+        out << std::left << std::setw(5) << rank + 1 << std::setw(20) << ToStr(cost.op->GetOpType()) << std::setw(40)
+            << name << std::right << std::setw(16) << cost.macs << std::setw(16) << cost.flops << std::setw(14)
+            << cost.weight_bytes << std::setw(14) << cost.input_bytes + cost.output_bytes << std::setw(10)
+            << std::fixed << std::setprecision(2) << cost.ArithmeticIntensity() << std::setw(9)
+            << (roofline.IsComputeBound(cost) ? "compute" : "memory") << std::setw(12) << seconds * 1e6
+            << std::setw(7) << (total_seconds > 0 ? 100.0 * seconds / total_seconds : 0.0) << "%\n";
+    }
+}
+
+// Repeated blocks are estimated once from their first instance.
+void PrintBlocks(std::ostream& out, const Graph& graph, const CostModel::Roofline& roofline) {
+    for (const auto& family : RepeatedBlockDetector::Run(graph)) {
+        OperatorCost block {nullptr, 0, 0, 0, 0, 0};
+        double       block_seconds = 0.0;
+        for (const auto* op : family.instances[0]) {
+            auto cost = CostModel::EstimateOperator(graph, *op);
+            block.macs += cost.macs;
+            block.weight_bytes += cost.weight_bytes;
+            block_seconds += roofline.EstimateSeconds(cost);
+        }
+        out << family.instances.size() << " x block of " << family.num_ops << " operators from `"
+            << GetOperatorName(*family.instances[0][0]) << "`, " << block.macs << " MACs, " << block.weight_bytes
+            << " weight bytes, " << std::fixed << std::setprecision(2) << block_seconds * 1e6 << " us each.\n";
+    }
+}
+
+void WriteJson(std::ostream&                    out,
+               const std::vector<OperatorCost>& costs,
+               const std::vector<OperatorCost>& hotspots,
+               const CostModel::Roofline&       roofline) {
+    auto write_cost = [&](const OperatorCost& cost) {
+        out << "{\"op_id\": " << cost.op->GetID() << ", \"op_type\": \"" << ToStr(cost.op->GetOpType())
+            << "\", \"output\": \"" << common::escape_json(GetOperatorName(*cost.op))
+            << "\", \"macs\": " << cost.macs << ", \"flops\": " << cost.flops
+            << ", \"weight_bytes\": " << cost.weight_bytes << ", \"input_bytes\": " << cost.input_bytes
+            << ", \"output_bytes\": " << cost.output_bytes
+            << ", \"arithmetic_intensity\": " << cost.ArithmeticIntensity() << ", \"bound\": \""
+            << (roofline.IsComputeBound(cost) ? "compute" : "memory")
+            << "\", \"estimated_seconds\": " << roofline.EstimateSeconds(cost) << "}";
+    };
+
+    OperatorCost total {nullptr, 0, 0, 0, 0, 0};
+    double       total_seconds = 0.0;
+    for (const auto& cost : costs) {
+        total.macs += cost.macs;
+        total.flops += cost.flops;
+        total.weight_bytes += cost.weight_bytes;
+        total.input_bytes += cost.input_bytes;
+        total.output_bytes += cost.output_bytes;
+        total_seconds += roofline.EstimateSeconds(cost);
+    }
+    out << std::setprecision(9) << "{\n  \"roofline\": {\"peak_gflops\": " << roofline.peak_gflops
+        << ", \"peak_gbps\": " << roofline.peak_gbps << "},\n  \"total\": {\"operators\": " << costs.size()
+        << ", \"macs\": " << total.macs << ", \"flops\": " << total.flops << ", \"weight_bytes\": "
+        << total.weight_bytes << ", \"activation_bytes\": " << total.input_bytes + total.output_bytes
+        << ", \"estimated_seconds\": " << total_seconds << "},\n  \"hotspots\": [";
+    for (size_t index = 0; index < hotspots.size(); index++) {
+        out << (index == 0 ? "\n    " : ",\n    ");
+        write_cost(hotspots[index]);
+    }
+    out << "\n  ],\n  \"operators\": [";
+    for (size_t index = 0; index < costs.size(); index++) {
+        out << (index == 0 ? "\n    " : ",\n    ");
+        write_cost(costs[index]);
+    }
+    out << "\n  ]\n}\n";
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    AnalyzerOptions   analyzer_options;
+    std::vector<Flag> flags = {
+        Flag("--input_tflite", "-i", analyzer_options.input_tflite_file, REQUIRED::YES,
+             "The path of input tflite model, the target file whose operators are analyzed."),
+        Flag("--top", "-n", analyzer_options.top, REQUIRED::NO,
+             "The number of hotspots printed, ranked by estimated time. 10 by default, 0 prints all operators."),
+        Flag("--peak_gflops", analyzer_options.peak_gflops, REQUIRED::NO,
+             "The peak compute throughput of the target in GFLOP/s, 100 by default."),
+        Flag("--peak_gbps", analyzer_options.peak_gbps, REQUIRED::NO,
+             "The peak memory bandwidth of the target in GB/s, 25 by default."),
+        Flag("--output_json", "-o", analyzer_options.output_json_file, REQUIRED::NO,
+             "The output path of the JSON report with totals, hotspots and all operators in execution order."),
+        Flag("--blocks", analyzer_options.blocks, REQUIRED::NO,
+             "Whether to print repeated blocks, e.g. transformer layers, with the cost of one block."),
+    };
+    CommandLineParser::Parse(argc, argv, flags);
+
+    CostModel::Roofline roofline;
+    if (analyzer_options.peak_gflops.HasValue()) {
+        roofline.peak_gflops = analyzer_options.peak_gflops.GetValue();
+    }
+    if (analyzer_options.peak_gbps.HasValue()) {
+        roofline.peak_gbps = analyzer_options.peak_gbps.GetValue();
+    }
+    REPORT_ERROR_IF(roofline.peak_gflops <= 0 || roofline.peak_gbps <= 0,
+                    "Peak compute and bandwidth should be positive. Please check arguments.");
+    REPORT_ERROR_IF(analyzer_options.top.HasValue() && analyzer_options.top.GetValue() < 0,
+                    "Number of hotspots should not be negative. Please check arguments.");
+
+    auto model = TfLiteParser().ImportModel(analyzer_options.input_tflite_file.GetValue());
+    auto costs = CostModel::EstimateGraph(model->GetMainGraph());
+
+    double total_seconds = 0.0;
+    for (const auto& cost : costs) {
+        total_seconds += roofline.EstimateSeconds(cost);
+    }
+    auto hotspots = costs;
+    std::stable_sort(hotspots.begin(), hotspots.end(), [&](const OperatorCost& lhs, const OperatorCost& rhs) {
+        return roofline.EstimateSeconds(lhs) > roofline.EstimateSeconds(rhs);
+    });
+    size_t top = analyzer_options.top.HasValue() ? analyzer_options.top.GetValue() : 10;
+    if (top != 0 && top < hotspots.size()) {
+        hotspots.resize(top);
+    }
+
+    PrintTable(std::cout, hotspots, roofline, total_seconds);
+    std::cout << "Ridge point " << std::fixed << std::setprecision(2) << roofline.peak_gflops / roofline.peak_gbps
+              << " FLOP/B, " << costs.size() << " operators take " << total_seconds * 1e6 << " us at least.\n";
+    if (analyzer_options.blocks.HasValue() && analyzer_options.blocks.GetValue()) {
+        PrintBlocks(std::cout, model->GetMainGraph(), roofline);
+    }
+
+    if (analyzer_options.output_json_file.HasValue()) {
+        std::ofstream json_file(analyzer_options.output_json_file.GetValue());
+        REPORT_ERROR_IF(!json_file, "Cannot open `", analyzer_options.output_json_file.GetValue(), "` to write.");
+        WriteJson(json_file, costs, hotspots, roofline);
+    }
+
+    return 0;
+}
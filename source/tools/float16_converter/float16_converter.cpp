@@ -0,0 +1,60 @@
+#include <iomanip>
+#include <iostream>
+
+#include "common/command_line_parser.h"
+#include "common/string_utils.h"
+#include "model/model.h"
+#include "parser_and_serializer/tflite/parser.h"
+#include "parser_and_serializer/tflite/serializer.h"
+#include "transforms/float16_conversion.h"
+
+struct ConverterOptions {
+    Option<std::string> input_tflite_file;
+    Option<std::string> output_tflite_file;
+    Option<std::string> tensor_names;
+    Option<int64_t>     min_elements;
+    Option<int32_t>     num_threads;
+};
+
+int main(int argc, char** argv) {
+    ConverterOptions  converter_options;
+    std::vector<Flag> flags = {
+        Flag("--input_tflite", "-i", converter_options.input_tflite_file, REQUIRED::YES,
+             "The path of input tflite model, the target file whose float32 constants are converted."),
+        Flag("--output_tflite", "-o", converter_options.output_tflite_file, REQUIRED::YES,
+             "The output path of the model with float16 constants."),
+        Flag("--tensors", converter_options.tensor_names, REQUIRED::NO,
+             "The constant tensors to convert, separated by ','. All float32 constants with at least --min_elements "
+             "elements by default."),
+        Flag("--min_elements", converter_options.min_elements, REQUIRED::NO,
+             "The least number of elements of converted constants without --tensors, 1024 by default."),
+        Flag("--num_threads", "-j", converter_options.num_threads, REQUIRED::NO,
+             "The number of threads converting constants, all hardware threads by default."),
+    };
+    CommandLineParser::Parse(argc, argv, flags);
+
+    std::vector<std::string> tensor_names;
+    if (converter_options.tensor_names.HasValue()) {
+        tensor_names = common::split(converter_options.tensor_names.GetValue(), ',');
+    }
+    int64_t min_elements = converter_options.min_elements.HasValue() ? converter_options.min_elements.GetValue() : 1024;
+    int32_t num_threads  = converter_options.num_threads.HasValue() ? converter_options.num_threads.GetValue() : 0;
+    REPORT_ERROR_IF(min_elements < 0 || num_threads < 0, "Negative number in arguments. Please check arguments.");
+
+    auto model             = TfLiteParser().ImportModel(converter_options.input_tflite_file.GetValue());
+    auto converted_tensors = Float16Conversion::Run(model->GetMainGraph(), tensor_names, min_elements, num_threads);
+
+    uint64_t elements = 0;
+    std::cout << std::left << std::setw(60) << "tensor" << std::right << std::setw(14) << "elements" << std::setw(14)
+              << "max_error" << std::setw(14) << "mean_error" << "\n";
+    for (const auto& converted_tensor : converted_tensors) {
+        std::cout << std::left << std::setw(60) << converted_tensor.name << std::right << std::setw(14)
+                  << converted_tensor.elements << std::setw(14) << std::setprecision(6) << converted_tensor.max_error
+                  << std::setw(14) << converted_tensor.mean_error << "\n";
+        elements += converted_tensor.elements;
+    }
+    std::cout << converted_tensors.size() << " tensors converted, " << elements * 2 << " bytes saved.\n";
+
+    TfLiteSerializer().ExportToTfLite(*model.get(), converter_options.output_tflite_file.GetValue());
+    return 0;
+}
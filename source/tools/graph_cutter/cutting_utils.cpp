@@ -1,121 +1,180 @@
 #include "tools/graph_cutter/cutting_utils.h"
 
-#include <queue>
+#include <sstream>
+#include <unordered_set>
 
 #include "common/stl_wrapper.h"
+#include "common/string_utils.h"
 
-void CuttingUtils::CutGraphImpl(Model&                          model,
-                                const std::vector<std::string>& input_tensors,
-                                const std::vector<std::string>& output_tensors) {
-    auto& main_graph = model.GetMainGraph();
+CuttingUtils::OperatorIndex CuttingUtils::BuildOperatorIndex(const Graph& graph) {
+    OperatorIndex index;
+    index.sorted_ops = graph.TopologicalSort();
+    auto num_ops     = index.sorted_ops.size();
+    index.op_indices.reserve(num_ops);
+    for (uint32_t op_index = 0; op_index < num_ops; op_index++) {
+        index.op_indices[index.sorted_ops[op_index]->GetID()] = op_index;
+    }
 
-    std::vector<BLOBID_T> sub_inputs(input_tensors.size(), INVALID_ID);
-    std::vector<BLOBID_T> sub_outputs(output_tensors.size(), INVALID_ID);
-    for (const auto* blob : main_graph.GetDataBlobs()) {
-        if (common::contains(input_tensors, blob->GetName())) {
-            auto location        = common::get_first_index(input_tensors, blob->GetName());
-            sub_inputs[location] = blob->GetID();
-        }
-        if (common::contains(output_tensors, blob->GetName())) {
-            auto location         = common::get_first_index(output_tensors, blob->GetName());
-            sub_outputs[location] = blob->GetID();
+    // Edges are collected from inputs of operators like TopologicalSort does, then transposed for successors.
+    index.predecessor_offsets.assign(num_ops + 1, 0);
+    index.successor_offsets.assign(num_ops + 1, 0);
+    for (uint32_t op_index = 0; op_index < num_ops; op_index++) {
+        for (auto blob_id : index.sorted_ops[op_index]->GetInputIDs()) {
+            auto* blob     = graph.GetDataBlob(blob_id);
+            auto* producer = blob == nullptr ? nullptr : blob->GetProducer();
+            if (producer == nullptr) {
+                continue;
+            }
+            auto producer_index = index.op_indices.at(producer->GetID());
+            index.predecessors.push_back(producer_index);
+            index.successor_offsets[producer_index + 1]++;
         }
+        index.predecessor_offsets[op_index + 1] = index.predecessors.size();
     }
-    if (common::contains(sub_inputs, INVALID_ID)) {
-        auto input_tensor_name = input_tensors.at(common::get_first_index(sub_inputs, INVALID_ID));
-        REPORT_ERROR_IF(std::count(input_tensors.begin(), input_tensors.end(), input_tensor_name) > 1, "`",
-                        input_tensor_name, "` is duplicated. Please check arguments.");
-        report_error("`", input_tensor_name, "` doesn't exist. Please check tensor's name.")
+    for (uint32_t op_index = 0; op_index < num_ops; op_index++) {
+        index.successor_offsets[op_index + 1] += index.successor_offsets[op_index];
     }
-    if (common::contains(sub_outputs, INVALID_ID)) {
-        auto output_tensor_name = input_tensors.at(common::get_first_index(sub_outputs, INVALID_ID));
-        REPORT_ERROR_IF(std::count(output_tensors.begin(), output_tensors.end(), output_tensor_name) > 1, "`",
-                        output_tensor_name, "` is duplicated. Please check arguments.");
-        report_error("`", output_tensor_name, "` doesn't exist. Please check tensor's name.")
+    index.successors.resize(index.predecessors.size());
+    auto insert_positions = index.successor_offsets;
+    for (uint32_t op_index = 0; op_index < num_ops; op_index++) {
+        for (auto edge = index.predecessor_offsets[op_index]; edge < index.predecessor_offsets[op_index + 1]; edge++) {
+            index.successors[insert_positions[index.predecessors[edge]]++] = op_index;
+        }
     }
-    auto forward_op_set  = CollectOpsForward(main_graph, sub_inputs);
-    auto backward_op_set = CollectOpsBackward(main_graph, sub_outputs);
+    return index;
+}
 
-    std::set<const Operator*> ops_to_keep;
-    for (const auto* op : forward_op_set) {
-        if (common::contains(backward_op_set, op)) {
-            ops_to_keep.insert(op);
+std::vector<CuttingUtils::CutJob> CuttingUtils::ParseJobs(std::istream& jobs, const std::string& source) {
+    std::vector<CutJob> parsed_jobs;
+    std::string         line;
+    for (size_t line_number = 1; std::getline(jobs, line); line_number++) {
+        line = common::strip(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
         }
+        std::istringstream fields(line);
+        std::string        input_tensors, output_tensors, output_path, extra;
+        fields >> input_tensors >> output_tensors >> output_path;
+        REPORT_ERROR_IF(output_path.empty() || (fields >> extra), "Line ", line_number, " of `", source,
+                        "` should be `<from> <to> <output_tflite>`.");
+        parsed_jobs.push_back({common::split(input_tensors, ','), common::split(output_tensors, ','), output_path});
     }
-    REPORT_ERROR_IF(ops_to_keep.empty(), "No operators or blobs will be kept, please check inputs and outputs.");
-    RemoveUnnecessaryOpsAndBlobs(main_graph, ops_to_keep);
+    REPORT_ERROR_IF(parsed_jobs.empty(), "No jobs in `", source, "`.");
+    return parsed_jobs;
+}
+
+void CuttingUtils::CutGraphImpl(Model&                          model,
+                                const std::vector<std::string>& input_tensors,
+                                const std::vector<std::string>& output_tensors) {
+    auto& main_graph  = model.GetMainGraph();
+    auto  sub_inputs  = FindBlobs(main_graph, input_tensors);
+    auto  sub_outputs = FindBlobs(main_graph, output_tensors);
+    auto  index       = BuildOperatorIndex(main_graph);
+    auto  ops_to_keep = CollectOpsBetween(main_graph, index, sub_inputs, sub_outputs);
+    RemoveUnnecessaryOpsAndBlobs(main_graph, index, ops_to_keep);
     main_graph.SetGraphInputs(sub_inputs);
     main_graph.SetGraphOutputs(sub_outputs);
 }
 
-std::set<const Operator*> CuttingUtils::CollectOpsForward(const Graph& graph, const std::vector<BLOBID_T>& blob_ids) {
-    std::queue<const Operator*> ops_queue;
-    std::set<const Operator*>   ops_traverse;
-    for (auto blob_id : blob_ids) {
-        auto* blob = graph.GetDataBlob(blob_id);
-        for (auto* op : blob->GetConsumers()) {
-            if (common::contains(ops_traverse, op)) {
-                continue;
-            }
-            ops_traverse.insert(op);
-            ops_queue.push(op);
+GraphView CuttingUtils::CutGraphView(const Graph&                    graph,
+                                     const OperatorIndex&            index,
+                                     const std::vector<std::string>& input_tensors,
+                                     const std::vector<std::string>& output_tensors) {
+    auto sub_inputs  = FindBlobs(graph, input_tensors);
+    auto sub_outputs = FindBlobs(graph, output_tensors);
+    auto ops_to_keep = CollectOpsBetween(graph, index, sub_inputs, sub_outputs);
+
+    std::vector<const Operator*> sub_ops;
+    sub_ops.reserve(ops_to_keep.count());
+    ops_to_keep.for_each([&](size_t op_index) { sub_ops.push_back(index.sorted_ops[op_index]); });
+    return GraphView(graph, std::move(sub_ops), std::move(sub_inputs), std::move(sub_outputs));
+}
+
+GraphView CuttingUtils::CutStageView(const Graph&          graph,
+                                     const OperatorIndex&  index,
+                                     uint32_t              begin,
+                                     uint32_t              end,
+                                     std::vector<BLOBID_T> inputs,
+                                     std::vector<BLOBID_T> outputs) {
+    REPORT_ERROR_IF(begin >= end || end > index.sorted_ops.size(), "Operator range [", begin, ", ", end,
+                    ") is invalid, the model has ", index.sorted_ops.size(), " operators.");
+    std::vector<const Operator*> sub_ops(index.sorted_ops.begin() + begin, index.sorted_ops.begin() + end);
+    return GraphView(graph, std::move(sub_ops), std::move(inputs), std::move(outputs));
+}
+
+std::vector<BLOBID_T> CuttingUtils::FindBlobs(const Graph& graph, const std::vector<std::string>& tensors) {
+    std::vector<BLOBID_T> blob_ids(tensors.size(), INVALID_ID);
+    for (const auto* blob : graph.GetDataBlobs()) {
+        if (common::contains(tensors, blob->GetName())) {
+            auto location      = common::get_first_index(tensors, blob->GetName());
+            blob_ids[location] = blob->GetID();
         }
     }
+    if (common::contains(blob_ids, INVALID_ID)) {
+        auto tensor_name = tensors.at(common::get_first_index(blob_ids, INVALID_ID));
+        REPORT_ERROR_IF(std::count(tensors.begin(), tensors.end(), tensor_name) > 1, "`", tensor_name,
+                        "` is duplicated. Please check arguments.");
+        report_error("`", tensor_name, "` doesn't exist. Please check tensor's name.")
+    }
+    return blob_ids;
+}
 
-    while (!ops_queue.empty()) {
-        const auto* op = ops_queue.front();
-        ops_queue.pop();
-        for (auto* blob : op->GetOutputBlobs()) {
-            for (auto* op_successor : blob->GetConsumers()) {
-                if (common::contains(ops_traverse, op_successor)) {
-                    continue;
-                }
-                ops_traverse.insert(op_successor);
-                ops_queue.push(op_successor);
-            }
+common::DynamicBitset CuttingUtils::CollectOpsBetween(const Graph&                 graph,
+                                                      const OperatorIndex&         index,
+                                                      const std::vector<BLOBID_T>& inputs,
+                                                      const std::vector<BLOBID_T>& outputs) {
+    std::vector<uint32_t> forward_seeds;
+    for (auto blob_id : inputs) {
+        for (const auto* op : graph.GetDataBlob(blob_id)->GetConsumers()) {
+            forward_seeds.push_back(index.op_indices.at(op->GetID()));
         }
     }
-    return ops_traverse;
+    std::vector<uint32_t> backward_seeds;
+    for (auto blob_id : outputs) {
+        const auto* op = graph.GetDataBlob(blob_id)->GetProducer();
+        if (op != nullptr) {
+            backward_seeds.push_back(index.op_indices.at(op->GetID()));
+        }
+    }
+
+    auto ops_to_keep = CollectReachableOps(index.successor_offsets, index.successors, forward_seeds);
+    ops_to_keep &= CollectReachableOps(index.predecessor_offsets, index.predecessors, backward_seeds);
+    REPORT_ERROR_IF(ops_to_keep.count() == 0, "No operators or blobs will be kept, please check inputs and outputs.");
+    return ops_to_keep;
 }
 
-std::set<const Operator*> CuttingUtils::CollectOpsBackward(const Graph& graph, const std::vector<BLOBID_T>& blob_ids) {
-    std::queue<const Operator*> ops_queue;
-    std::set<const Operator*>   ops_traverse;
-    for (auto blob_id : blob_ids) {
-        auto* blob = graph.GetDataBlob(blob_id);
-        auto* op   = blob->GetProducer();
-        if (op == nullptr) {
-            continue;
+common::DynamicBitset CuttingUtils::CollectReachableOps(const std::vector<uint32_t>& offsets,
+                                                        const std::vector<uint32_t>& adjacency,
+                                                        const std::vector<uint32_t>& seeds) {
+    common::DynamicBitset ops_traverse(offsets.size() - 1);
+    // Every operator is queued at most once, so a flat vector with a moving head works as the queue.
+    std::vector<uint32_t> ops_queue;
+    for (auto op_index : seeds) {
+        if (ops_traverse.test_and_set(op_index)) {
+            ops_queue.push_back(op_index);
         }
-        ops_traverse.insert(op);
-        ops_queue.push(op);
     }
-    while (!ops_queue.empty()) {
-        const auto* op = ops_queue.front();
-        ops_queue.pop();
-        for (auto* blob : op->GetInputBlobs()) {
-            auto* op_predecessor = blob->GetProducer();
-            if (op_predecessor == nullptr) {
-                continue;
+    for (size_t head = 0; head < ops_queue.size(); head++) {
+        auto op_index = ops_queue[head];
+        for (auto edge = offsets[op_index]; edge < offsets[op_index + 1]; edge++) {
+            if (ops_traverse.test_and_set(adjacency[edge])) {
+                ops_queue.push_back(adjacency[edge]);
             }
-            ops_traverse.insert(op_predecessor);
-            ops_queue.push(op_predecessor);
         }
     }
     return ops_traverse;
 }
 
-void CuttingUtils::RemoveUnnecessaryOpsAndBlobs(Graph& graph, const std::set<const Operator*>& ops_to_keep) {
-    std::set<const DataBlob*> blobs_to_keep;
-    for (const auto* op : ops_to_keep) {
-        for (const auto* input_blob : op->GetInputBlobs()) {
-            blobs_to_keep.insert(input_blob);
-        }
-        for (const auto* output_blob : op->GetOutputBlobs()) {
-            blobs_to_keep.insert(output_blob);
-        }
-    }
+void CuttingUtils::RemoveUnnecessaryOpsAndBlobs(Graph&                       graph,
+                                                const OperatorIndex&         index,
+                                                const common::DynamicBitset& ops_to_keep) {
+    std::unordered_set<BLOBID_T> blobs_to_keep;
+    ops_to_keep.for_each([&](size_t op_index) {
+        const auto* op = index.sorted_ops[op_index];
+        blobs_to_keep.insert(op->GetInputIDs().begin(), op->GetInputIDs().end());
+        blobs_to_keep.insert(op->GetOutputIDs().begin(), op->GetOutputIDs().end());
+    });
     // Remove
-    graph.EraseBlob([&](const DataBlob* blob) { return !common::contains(blobs_to_keep, blob); });
-    graph.EraseOperator([&](const Operator* op) { return !common::contains(ops_to_keep, op); });
+    graph.EraseBlob([&](const DataBlob* blob) { return !common::contains(blobs_to_keep, blob->GetID()); });
+    graph.EraseOperator([&](const Operator* op) { return !ops_to_keep.test(index.op_indices.at(op->GetID())); });
 }
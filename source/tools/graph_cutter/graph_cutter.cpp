@@ -1,4 +1,9 @@
+#include <fstream>
+#include <map>
+
+#include "analysis/pipeline_partitioner.h"
 #include "common/command_line_parser.h"
+#include "common/parallel_utils.h"
 #include "common/string_utils.h"
 #include "model/model.h"
 #include "parser_and_serializer/tflite/parser.h"
@@ -10,24 +15,196 @@ struct CutterOptions {
     Option<std::string> output_tflite_file;
     Option<std::string> input_tensors;
     Option<std::string> output_tensors;
+    Option<int32_t>     num_stages;
+    Option<double>      tolerance;
+    Option<std::string> jobs_file;
+    Option<int32_t>     num_threads;
 };
 
+namespace {
+// The manifest lists every stage with its file and boundary tensors. An input comes from `"model"` or the index of the
+// stage producing it, an output goes to the indices of the stages reading it.
+void WriteManifest(std::ostream&                         out,
+                   const Graph&                          graph,
+                   const PipelinePartitioner::Partition& partition,
+                   const std::vector<std::string>&       stage_paths) {
+    std::map<BLOBID_T, size_t>              producer_stages;
+    std::map<BLOBID_T, std::vector<size_t>> consumer_stages;
+    for (size_t index = 0; index < partition.stages.size(); index++) {
+        for (auto blob_id : partition.stages[index].outputs) {
+            producer_stages[blob_id] = index;
+        }
+        for (auto blob_id : partition.stages[index].inputs) {
+            consumer_stages[blob_id].push_back(index);
+        }
+    }
+    auto write_tensor = [&](BLOBID_T blob_id) {
+        const auto* blob = graph.GetDataBlob(blob_id);
+        out << "{\"name\": \"" << common::escape_json(blob->GetName()) << "\", \"shape\": [";
+        const auto& dims = blob->GetShape().GetDims();
+        for (size_t index = 0; index < dims.size(); index++) {
+            out << (index == 0 ? "" : ", ") << dims[index];
+        }
+        out << "], \"data_type\": \"" << ToStr(blob->GetDataType()) << "\"";
+    };
+
+    out << "{\n  \"stages\": [";
+    for (size_t index = 0; index < partition.stages.size(); index++) {
+        const auto& stage = partition.stages[index];
+        out << (index == 0 ? "\n" : ",\n") << "    {\"index\": " << index << ", \"file\": \""
+            << common::escape_json(stage_paths[index]) << "\", \"operators\": [" << stage.begin << ", " << stage.end
+            << "], \"estimated_seconds\": " << stage.seconds << ",\n     \"inputs\": [";
+        for (size_t input = 0; input < stage.inputs.size(); input++) {
+            auto producer = producer_stages.find(stage.inputs[input]);
+            out << (input == 0 ? "\n      " : ",\n      ");
+            write_tensor(stage.inputs[input]);
+            out << ", \"from\": ";
+            if (producer == producer_stages.end()) {
+                out << "\"model\"}";
+            } else {
+                out << producer->second << "}";
+            }
+        }
+        out << "],\n     \"outputs\": [";
+        for (size_t output = 0; output < stage.outputs.size(); output++) {
+            auto blob_id = stage.outputs[output];
+            out << (output == 0 ? "\n      " : ",\n      ");
+            write_tensor(blob_id);
+            out << ", \"to\": [";
+            const auto& consumers = consumer_stages[blob_id];
+            for (size_t consumer = 0; consumer < consumers.size(); consumer++) {
+                out << (consumer == 0 ? "" : ", ") << consumers[consumer];
+            }
+            out << "], \"model_output\": " << (graph.IsGraphOutput(blob_id) ? "true" : "false") << "}";
+        }
+        out << "]}";
+    }
+    out << "\n  ],\n  \"boundary_bytes\": [";
+    for (size_t index = 0; index < partition.boundary_bytes.size(); index++) {
+        out << (index == 0 ? "" : ", ") << partition.boundary_bytes[index];
+    }
+    out << "]\n}\n";
+}
+
+void PartitionPipeline(const CutterOptions& cutter_options) {
+    const auto& input_path  = cutter_options.input_tflite_file.GetValue();
+    const auto& output_path = cutter_options.output_tflite_file.GetValue();
+    REPORT_ERROR_IF(cutter_options.num_stages.GetValue() <= 0, "Number of stages should be positive.");
+    double tolerance = cutter_options.tolerance.HasValue() ? cutter_options.tolerance.GetValue() : 0.1;
+
+    auto model     = TfLiteParser().ImportModel(input_path);
+    auto partition = PipelinePartitioner::Run(model->GetMainGraph(), cutter_options.num_stages.GetValue(),
+                                              CostModel::Roofline(), tolerance);
+
+    // Stages are views of the one import. The index sorts the same graph the partitioner sorted, so operator ranges
+    // match.
+    const auto&              main_graph = model->GetMainGraph();
+    auto                     op_index   = CuttingUtils::BuildOperatorIndex(main_graph);
+    std::vector<std::string> stage_paths;
+    for (size_t index = 0; index < partition.stages.size(); index++) {
+        const auto& stage = partition.stages[index];
+        stage_paths.push_back(
+            common::replace_suffix(output_path, ".tflite", "_stage" + std::to_string(index) + ".tflite"));
+        auto view = CuttingUtils::CutStageView(main_graph, op_index, stage.begin, stage.end, stage.inputs,
+                                               stage.outputs);
+        TfLiteSerializer().ExportToTfLite(*model.get(), view, stage_paths.back());
+        LOG(INFO) << "Stage " << index << " takes operators [" << stage.begin << ", " << stage.end << "), "
+                  << stage.seconds * 1e6 << " us estimated, saved to " << stage_paths.back();
+    }
+
+    auto          manifest_path = common::replace_suffix(output_path, ".tflite", "_manifest.json");
+    std::ofstream manifest_file(manifest_path);
+    REPORT_ERROR_IF(!manifest_file, "Cannot open `", manifest_path, "` to write.");
+    WriteManifest(manifest_file, main_graph, partition, stage_paths);
+}
+
+std::vector<CuttingUtils::CutJob> LoadJobs(const std::string& jobs_path) {
+    std::ifstream jobs_file(jobs_path);
+    REPORT_ERROR_IF(!jobs_file, "Cannot open jobs file `", jobs_path, "`.");
+    return CuttingUtils::ParseJobs(jobs_file, jobs_path);
+}
+
+// Import and index once, then cut and export every job concurrently. Cuts are views sharing the imported graph and its
+// buffers, so a job costs only its own traversal and export.
+void RunJobs(const CutterOptions& cutter_options) {
+    auto   jobs        = LoadJobs(cutter_options.jobs_file.GetValue());
+    size_t num_threads = cutter_options.num_threads.HasValue() ? cutter_options.num_threads.GetValue()
+                                                                : common::default_num_threads();
+    REPORT_ERROR_IF(cutter_options.num_threads.HasValue() && cutter_options.num_threads.GetValue() <= 0,
+                    "Number of threads should be positive. Please check arguments.");
+
+    auto        model      = TfLiteParser().ImportModel(cutter_options.input_tflite_file.GetValue());
+    const auto& main_graph = model->GetMainGraph();
+    auto        op_index   = CuttingUtils::BuildOperatorIndex(main_graph);
+
+    // Every job writes only its own flag, a failure is reported by the job and doesn't stop the others.
+    std::vector<uint8_t> failed(jobs.size(), 0);
+    common::parallel_for(jobs.size(), num_threads, [&](size_t index) {
+        const auto& job = jobs[index];
+        try {
+            auto view = CuttingUtils::CutGraphView(main_graph, op_index, job.input_tensors, job.output_tensors);
+            TfLiteSerializer().ExportToTfLite(*model.get(), view, job.output_path);
+        } catch (const std::exception&) {
+            failed[index] = 1;
+        }
+    });
+
+    std::vector<std::string> failed_outputs;
+    for (size_t index = 0; index < jobs.size(); index++) {
+        if (failed[index] != 0) {
+            failed_outputs.push_back(jobs[index].output_path);
+        }
+    }
+    REPORT_ERROR_IF(!failed_outputs.empty(), failed_outputs.size(), " of ", jobs.size(),
+                    " jobs failed: ", common::join(failed_outputs, ", "));
+    LOG(INFO) << "All " << jobs.size() << " jobs are done with " << std::min(num_threads, jobs.size()) << " threads.";
+}
+}  // namespace
+
 int main(int argc, char** argv) {
     CutterOptions     cutter_options;
     std::vector<Flag> flags = {
         Flag("--input_tflite", "-i", cutter_options.input_tflite_file, REQUIRED::YES,
              "The path of input tflite model, the target file which is going to be cut."),
-        Flag("--output_tflite", "-o", cutter_options.output_tflite_file, REQUIRED::YES,
-             "The output path of tflite model which is processed. Specify the file path to save cut model."),
-        Flag("--from", "-f", cutter_options.input_tensors, REQUIRED::YES,
+        Flag("--output_tflite", "-o", cutter_options.output_tflite_file, REQUIRED::NO,
+             "The output path of tflite model which is processed. Specify the file path to save cut model. With "
+             "--stages, stages are saved to <output>_stage<i>.tflite with a manifest <output>_manifest.json."),
+        Flag("--from", "-f", cutter_options.input_tensors, REQUIRED::NO,
              "The start tensors of cutting graph, as new inputs of processed model. If there are multiple tensors,"
              "use \',\' to seperate tensors name."),
-        Flag("--to", "-t", cutter_options.output_tensors, REQUIRED::YES,
+        Flag("--to", "-t", cutter_options.output_tensors, REQUIRED::NO,
              "The end tensors of cutting graph, as new outputs of processed model. If there are multiple tensors,"
              "use \',\' to seperate tensors name."),
+        Flag("--stages", "-n", cutter_options.num_stages, REQUIRED::NO,
+             "Split the whole model into this many sequential pipeline stages instead of cutting between --from and "
+             "--to. Stages are balanced by estimated cost with the fewest bytes crossing stage boundaries."),
+        Flag("--tolerance", cutter_options.tolerance, REQUIRED::NO,
+             "How much slower than the best balanced partition a stage may be in exchange for fewer boundary bytes, "
+             "0.1 (10%) by default."),
+        Flag("--jobs", "-j", cutter_options.jobs_file, REQUIRED::NO,
+             "Run many cuts of the same model, listed in a file with one `<from> <to> <output_tflite>` per line, "
+             "instead of a single cut. The model is imported once and cuts are exported concurrently."),
+        Flag("--threads", cutter_options.num_threads, REQUIRED::NO,
+             "The number of threads running --jobs, the number of hardware threads by default."),
     };
     CommandLineParser::Parse(argc, argv, flags);
 
+    bool has_cut = cutter_options.input_tensors.HasValue() || cutter_options.output_tensors.HasValue();
+    REPORT_ERROR_IF(cutter_options.jobs_file.HasValue() + cutter_options.num_stages.HasValue() + has_cut > 1,
+                    "Only one of --jobs, --stages and --from/--to can be used at a time. Please check arguments.");
+    if (cutter_options.jobs_file.HasValue()) {
+        RunJobs(cutter_options);
+        return 0;
+    }
+    REPORT_ERROR_IF(!cutter_options.output_tflite_file.HasValue(),
+                    "--output_tflite is required unless --jobs is given. Please check arguments.");
+    if (cutter_options.num_stages.HasValue()) {
+        PartitionPipeline(cutter_options);
+        return 0;
+    }
+    REPORT_ERROR_IF(!cutter_options.input_tensors.HasValue() || !cutter_options.output_tensors.HasValue(),
+                    "Both --from and --to are required unless --stages or --jobs is given. Please check arguments.");
+
     auto model          = TfLiteParser().ImportModel(cutter_options.input_tflite_file.GetValue());
     auto input_tensors  = common::split(cutter_options.input_tensors.GetValue(), ',');
     auto output_tensors = common::split(cutter_options.output_tensors.GetValue(), ',');
@@ -0,0 +1,63 @@
+#include <functional>
+#include <utility>
+
+#include "analysis/shape_inference.h"
+#include "common/command_line_parser.h"
+#include "common/string_utils.h"
+#include "model/model.h"
+#include "parser_and_serializer/tflite/parser.h"
+#include "parser_and_serializer/tflite/serializer.h"
+#include "transforms/common_subexpression_elimination.h"
+#include "transforms/pad_folding.h"
+#include "transforms/pattern_fusion.h"
+
+struct OptimizerOptions {
+    Option<std::string> input_tflite_file;
+    Option<std::string> output_tflite_file;
+    Option<std::string> passes;
+};
+
+using GraphPass = std::function<uint32_t(Graph&)>;
+
+// Passes are applied in the order of this table if user doesn't specify `--passes`.
+static const std::vector<std::pair<std::string, GraphPass>> pass_table = {
+    {"cse", CommonSubexpressionElimination::Run},
+    {"fold_pad", PadFolding::Run},
+    {"fuse_patterns", PatternFusion::Run},
+    {"infer_shapes", ShapeInference::Run},
+};
+
+int main(int argc, char** argv) {
+    OptimizerOptions  optimizer_options;
+    std::vector<Flag> flags = {
+        Flag("--input_tflite", "-i", optimizer_options.input_tflite_file, REQUIRED::YES,
+             "The path of input tflite model, the target file which is going to be optimized."),
+        Flag("--output_tflite", "-o", optimizer_options.output_tflite_file, REQUIRED::YES,
+             "The output path of tflite model which is processed. Specify the file path to save optimized model."),
+        Flag("--passes", "-p", optimizer_options.passes, REQUIRED::NO,
+             "The graph passes applied to model in the given order. If there are multiple passes, use \',\' to "
+             "seperate names. All passes are applied by default.\nAvailable passes: cse, fold_pad, fuse_patterns, "
+             "infer_shapes."),
+    };
+    CommandLineParser::Parse(argc, argv, flags);
+
+    std::vector<std::string> pass_names;
+    if (optimizer_options.passes.HasValue()) {
+        pass_names = common::split(optimizer_options.passes.GetValue(), ',');
+    } else {
+        common::transform(pass_table, std::back_inserter(pass_names), [](const auto& pass) { return pass.first; });
+    }
+
+    auto  model      = TfLiteParser().ImportModel(optimizer_options.input_tflite_file.GetValue());
+    auto& main_graph = model->GetMainGraph();
+    for (const auto& pass_name : pass_names) {
+        auto name = common::strip(pass_name);
+        auto pass = common::find_if(pass_table, [&](const auto& item) { return item.first == name; });
+        REPORT_ERROR_IF(pass == pass_table.end(), "Unknown pass `", name, "`. Please check arguments.");
+        auto changes = pass->second(main_graph);
+        LOG(INFO) << "Pass `" << pass->first << "` makes " << changes << " changes.";
+    }
+    TfLiteSerializer().ExportToTfLite(*model.get(), optimizer_options.output_tflite_file.GetValue());
+
+    return 0;
+}
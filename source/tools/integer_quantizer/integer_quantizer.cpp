@@ -0,0 +1,74 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "common/command_line_parser.h"
+#include "common/string_utils.h"
+#include "model/model.h"
+#include "parser_and_serializer/tflite/parser.h"
+#include "parser_and_serializer/tflite/serializer.h"
+#include "transforms/full_integer_quantization.h"
+
+struct QuantizerOptions {
+    Option<std::string> input_tflite_file;
+    Option<std::string> output_tflite_file;
+    Option<std::string> ranges_file;
+    Option<int32_t>     num_threads;
+};
+
+namespace {
+using Range = FullIntegerQuantization::Range;
+
+// One tensor per line as `<tensor> <min> <max>`. Blank lines and lines starting with '#' are skipped.
+std::unordered_map<std::string, Range> LoadRanges(const std::string& ranges_path) {
+    std::ifstream ranges_file(ranges_path);
+    REPORT_ERROR_IF(!ranges_file, "Cannot open ranges file `", ranges_path, "`.");
+    std::unordered_map<std::string, Range> ranges;
+    std::string                            line;
+    for (size_t line_number = 1; std::getline(ranges_file, line); line_number++) {
+        line = common::strip(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string        tensor, extra;
+        Range              range {};
+        fields >> tensor >> range.min >> range.max;
+        REPORT_ERROR_IF(!fields || (fields >> extra), "Line ", line_number, " of `", ranges_path,
+                        "` should be `<tensor> <min> <max>`.");
+        REPORT_ERROR_IF(!ranges.emplace(tensor, range).second, "`", tensor, "` is listed twice in `", ranges_path,
+                        "`.");
+    }
+    REPORT_ERROR_IF(ranges.empty(), "No ranges in `", ranges_path, "`.");
+    return ranges;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    QuantizerOptions  quantizer_options;
+    std::vector<Flag> flags = {
+        Flag("--input_tflite", "-i", quantizer_options.input_tflite_file, REQUIRED::YES,
+             "The path of input tflite model, the float32 model to convert."),
+        Flag("--output_tflite", "-o", quantizer_options.output_tflite_file, REQUIRED::YES,
+             "The output path of the int8 model, which keeps float32 inputs and outputs."),
+        Flag("--ranges", "-r", quantizer_options.ranges_file, REQUIRED::YES,
+             "The calibration ranges of activations, one `<tensor> <min> <max>` per line. Tensors whose kernels fix "
+             "their parameters, or share them with their neighbours, may be left out."),
+        Flag("--num_threads", "-j", quantizer_options.num_threads, REQUIRED::NO,
+             "The number of threads quantizing weights, all hardware threads by default."),
+    };
+    CommandLineParser::Parse(argc, argv, flags);
+
+    int32_t num_threads = quantizer_options.num_threads.HasValue() ? quantizer_options.num_threads.GetValue() : 0;
+    REPORT_ERROR_IF(num_threads < 0, "Negative number in arguments. Please check arguments.");
+    auto ranges = LoadRanges(quantizer_options.ranges_file.GetValue());
+
+    auto model   = TfLiteParser().ImportModel(quantizer_options.input_tflite_file.GetValue());
+    auto summary = FullIntegerQuantization::Run(model->GetMainGraph(), ranges, num_threads);
+    std::cout << summary.activations << " activations, " << summary.weights << " weights and " << summary.constants
+              << " other constants quantized, " << summary.quantize_ops << " QUANTIZE and " << summary.dequantize_ops
+              << " DEQUANTIZE inserted at graph inputs and outputs.\n";
+
+    TfLiteSerializer().ExportToTfLite(*model.get(), quantizer_options.output_tflite_file.GetValue());
+    return 0;
+}
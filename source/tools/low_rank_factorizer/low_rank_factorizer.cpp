@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+#include "common/command_line_parser.h"
+#include "common/string_utils.h"
+#include "model/model.h"
+#include "parser_and_serializer/tflite/parser.h"
+#include "parser_and_serializer/tflite/serializer.h"
+#include "transforms/low_rank_factorization.h"
+
+struct FactorizerOptions {
+    Option<std::string> input_tflite_file;
+    Option<std::string> output_tflite_file;
+    Option<double>      energy;
+    Option<std::string> op_outputs;
+    Option<int64_t>     min_elements;
+    Option<int32_t>     num_threads;
+};
+
+int main(int argc, char** argv) {
+    FactorizerOptions factorizer_options;
+    std::vector<Flag> flags = {
+        Flag("--input_tflite", "-i", factorizer_options.input_tflite_file, REQUIRED::YES,
+             "The path of input tflite model, the target file whose weights are factorized."),
+        Flag("--output_tflite", "-o", factorizer_options.output_tflite_file, REQUIRED::YES,
+             "The output path of the model with factorized weights."),
+        Flag("--energy", "-e", factorizer_options.energy, REQUIRED::NO,
+             "The share of the energy (sum of squared singular values) of weights kept by the rank, 0.99 by default."),
+        Flag("--ops", factorizer_options.op_outputs, REQUIRED::NO,
+             "The output tensors of FULLY_CONNECTED and BATCH_MATMUL operators to factorize, separated by ','. All "
+             "such operators with at least --min_elements of float32 weights by default."),
+        Flag("--min_elements", factorizer_options.min_elements, REQUIRED::NO,
+             "The least number of weight elements of an operator factorized without --ops, 65536 by default."),
+        Flag("--num_threads", "-j", factorizer_options.num_threads, REQUIRED::NO,
+             "The number of threads decomposing weights, all hardware threads by default."),
+    };
+    CommandLineParser::Parse(argc, argv, flags);
+
+    double  energy       = factorizer_options.energy.HasValue() ? factorizer_options.energy.GetValue() : 0.99;
+    int64_t min_elements = factorizer_options.min_elements.HasValue() ? factorizer_options.min_elements.GetValue()
+                                                                      : 1 << 16;
+    int32_t num_threads  = factorizer_options.num_threads.HasValue() ? factorizer_options.num_threads.GetValue() : 0;
+    REPORT_ERROR_IF(min_elements < 0 || num_threads < 0, "Negative number in arguments. Please check arguments.");
+
+    auto  model      = TfLiteParser().ImportModel(factorizer_options.input_tflite_file.GetValue());
+    auto& graph      = model->GetMainGraph();
+    auto  op_outputs = factorizer_options.op_outputs.HasValue()
+                           ? common::split(factorizer_options.op_outputs.GetValue(), ',')
+                           : LowRankFactorization::FindCandidates(graph, min_elements);
+    REPORT_ERROR_IF(op_outputs.empty(), "No operators to factorize. Please check arguments.");
+    auto layers = LowRankFactorization::Run(graph, op_outputs, energy, num_threads);
+
+    uint64_t original_params   = 0;
+    uint64_t factorized_params = 0;
+    uint64_t original_macs     = 0;
+    uint64_t factorized_macs   = 0;
+    size_t   factorized        = 0;
+    std::cout << std::left << std::setw(40) << "output" << std::setw(18) << "op_type" << std::right << std::setw(12)
+              << "shape" << std::setw(8) << "rank" << std::setw(10) << "energy" << std::setw(14) << "params"
+              << std::setw(14) << "new_params" << std::setw(14) << "macs" << std::setw(14) << "new_macs" << "\n";
+    for (const auto& layer : layers) {
+        auto name = layer.op_output;
+        if (name.size() > 38) {
+            name = "..." + name.substr(name.size() - 35);
+        }
+        auto shape = std::to_string(layer.output_channels) + "x" + std::to_string(layer.input_channels);
+        std::cout << std::left << std::setw(40) << name << std::setw(18) << ToStr(layer.op_type) << std::right
+                  << std::setw(12) << shape << std::setw(8) << layer.rank << std::fixed << std::setprecision(4)
+                  << std::setw(10) << layer.retained_energy << std::setw(14) << layer.original_params
+                  << std::setw(14) << layer.factorized_params << std::setw(14) << layer.original_macs << std::setw(14)
+                  << layer.factorized_macs << (layer.factorized ? "" : "  (kept, rank saves no MACs)") << "\n";
+        original_params += layer.original_params;
+        factorized_params += layer.factorized_params;
+        original_macs += layer.original_macs;
+        factorized_macs += layer.factorized_macs;
+        factorized += layer.factorized;
+    }
+    std::cout << factorized << " of " << layers.size() << " operators factorized, weight parameters from "
+              << original_params << " to " << factorized_params << ", MACs from " << original_macs << " to "
+              << factorized_macs << ".\n";
+
+    TfLiteSerializer().ExportToTfLite(*model.get(), factorizer_options.output_tflite_file.GetValue());
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include <iomanip>
+
+#include "analysis/memory_planner.h"
+#include "common/command_line_parser.h"
+#include "model/model.h"
+#include "parser_and_serializer/tflite/parser.h"
+#include "parser_and_serializer/tflite/serializer.h"
+
+struct PlannerOptions {
+    Option<std::string> input_tflite_file;
+    Option<std::string> output_tflite_file;
+    Option<std::string> strategy;
+    Option<int32_t>     alignment;
+    Option<bool>        enable_alias;
+};
+
+static const std::vector<std::pair<std::string, MemoryPlanner::Strategy>> strategy_table = {
+    {"greedy_by_size", MemoryPlanner::Strategy::GREEDY_BY_SIZE},
+    {"best_fit", MemoryPlanner::Strategy::BEST_FIT},
+};
+
+int main(int argc, char** argv) {
+    PlannerOptions    planner_options;
+    std::vector<Flag> flags = {
+        Flag("--input_tflite", "-i", planner_options.input_tflite_file, REQUIRED::YES,
+             "The path of input tflite model, the target file whose activation memory is planned."),
+        Flag("--output_tflite", "-o", planner_options.output_tflite_file, REQUIRED::NO,
+             "The output path of tflite model which embeds the plan in metadata `activation_memory_plan`. Only the "
+             "report is printed if it isn't specified."),
+        Flag("--strategy", "-s", planner_options.strategy, REQUIRED::NO,
+             "The strategy of assigning offsets, greedy_by_size or best_fit. All strategies are tried and the one "
+             "with the smallest arena is kept by default."),
+        Flag("--alignment", "-a", planner_options.alignment, REQUIRED::NO,
+             "The alignment in bytes of tensor offsets, 64 by default."),
+        Flag("--enable_alias", planner_options.enable_alias, REQUIRED::NO,
+             "Whether reshaped, in-place and concat/split slice tensors share memory with the tensor they alias. It's "
+             "enabled by default."),
+    };
+    CommandLineParser::Parse(argc, argv, flags);
+
+    auto   model     = TfLiteParser().ImportModel(planner_options.input_tflite_file.GetValue());
+    size_t alignment = planner_options.alignment.HasValue() ? planner_options.alignment.GetValue() : 64;
+    REPORT_ERROR_IF(planner_options.alignment.HasValue() && planner_options.alignment.GetValue() <= 0,
+                    "Alignment should be positive. Please check arguments.");
+
+    std::vector<AliasAnalysis::Alias> aliases;
+    if (!planner_options.enable_alias.HasValue() || planner_options.enable_alias.GetValue()) {
+        aliases = AliasAnalysis::Analyze(model->GetMainGraph());
+    }
+
+    std::unique_ptr<MemoryPlanner::MemoryPlan> best_plan;
+    for (const auto& [name, strategy] : strategy_table) {
+        if (planner_options.strategy.HasValue() && planner_options.strategy.GetValue() != name) {
+            continue;
+        }
+        auto plan = MemoryPlanner::Plan(model->GetMainGraph(), strategy, alignment, aliases);
+        REPORT_ERROR_IF(!MemoryPlanner::Verify(plan), "Plan of ", name, " has overlapped tensors.");
+        double saving = plan.naive_bytes == 0 ? 0.0 : 100.0 * (1.0 - double(plan.arena_bytes) / plan.naive_bytes);
+        LOG(INFO) << std::left << std::setw(16) << name << " peak " << plan.arena_bytes << " bytes, naive "
+                  << plan.naive_bytes << " bytes, saving " << std::fixed << std::setprecision(1) << saving << "%.";
+        if (best_plan == nullptr || plan.arena_bytes < best_plan->arena_bytes) {
+            best_plan = std::make_unique<MemoryPlanner::MemoryPlan>(std::move(plan));
+        }
+    }
+    REPORT_ERROR_IF(best_plan == nullptr, "Unknown strategy `", planner_options.strategy.GetValue(),
+                    "`. Please check arguments.");
+
+    if (planner_options.output_tflite_file.HasValue()) {
+        auto tensor_indices = TfLiteSerializer::GetTensorIndices(model->GetMainGraph());
+        model->SetMetadata(MemoryPlanner::metadata_name, MemoryPlanner::Encode(*best_plan, tensor_indices));
+        TfLiteSerializer().ExportToTfLite(*model.get(), planner_options.output_tflite_file.GetValue());
+    }
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include "common/command_line_parser.h"
+#include "model/model.h"
+#include "parser_and_serializer/tflite/parser.h"
+#include "parser_and_serializer/tflite/serializer.h"
+
+struct CompressorOptions {
+    Option<std::string> input_tflite_file;
+    Option<std::string> output_tflite_file;
+    Option<int64_t>     min_bytes;
+    Option<bool>        decompress;
+    Option<int32_t>     num_threads;
+};
+
+namespace {
+uint64_t GetFileSize(const std::string& path) {
+    std::ifstream file(path, std::ios_base::binary | std::ios_base::ate);
+    REPORT_ERROR_IF(!file.is_open(), "Cannot access or open file : ", path);
+    return static_cast<uint64_t>(file.tellg());
+}
+
+double GetThroughput(const common::CompressionStats& stats) {
+    return stats.raw_bytes / std::max(stats.seconds, 1e-9) / 1e9;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    CompressorOptions compressor_options;
+    std::vector<Flag> flags = {
+        Flag("--input_tflite", "-i", compressor_options.input_tflite_file, REQUIRED::YES,
+             "The path of input tflite model, compressed or not."),
+        Flag("--output_tflite", "-o", compressor_options.output_tflite_file, REQUIRED::YES,
+             "The output path of the compressed model, or of the plain model with --decompress."),
+        Flag("--min_bytes", compressor_options.min_bytes, REQUIRED::NO,
+             "The least size of compressed constant buffers, 65536 by default."),
+        Flag("--decompress", "-d", compressor_options.decompress, REQUIRED::NO,
+             "Write the constants of a compressed model back as plain tflite buffers, false by default."),
+        Flag("--num_threads", "-j", compressor_options.num_threads, REQUIRED::NO,
+             "The number of threads compressing and decompressing buffers, all hardware threads by default."),
+    };
+    CommandLineParser::Parse(argc, argv, flags);
+
+    int64_t min_bytes   = compressor_options.min_bytes.HasValue() ? compressor_options.min_bytes.GetValue() : 1 << 16;
+    bool    decompress  = compressor_options.decompress.HasValue() && compressor_options.decompress.GetValue();
+    int32_t num_threads = compressor_options.num_threads.HasValue() ? compressor_options.num_threads.GetValue() : 0;
+    REPORT_ERROR_IF(min_bytes < 0 || num_threads < 0, "Negative number in arguments. Please check arguments.");
+    const auto& input_path  = compressor_options.input_tflite_file.GetValue();
+    const auto& output_path = compressor_options.output_tflite_file.GetValue();
+
+    TfLiteParser parser;
+    parser.SetNumThreads(num_threads);
+    auto model = parser.ImportModel(input_path);
+    if (decompress) {
+        TfLiteSerializer().ExportToTfLite(*model.get(), output_path);
+        std::cout << input_path << ": " << GetFileSize(input_path) << " bytes, decompressed "
+                  << parser.GetCompressionStats().raw_bytes << " bytes at " << std::setprecision(3)
+                  << GetThroughput(parser.GetCompressionStats()) << " GB/s into " << GetFileSize(output_path)
+                  << " bytes.\n";
+        return 0;
+    }
+
+    TfLiteSerializer serializer;
+    serializer.EnableCompression(min_bytes, num_threads);
+    serializer.ExportToTfLite(*model.get(), output_path);
+
+    // Import the output again, which both checks the archive and measures decompression.
+    TfLiteParser verifier;
+    verifier.SetNumThreads(num_threads);
+    auto restored = verifier.ImportModel(output_path);
+
+    // Blobs are matched by tensor index rather than by name, which may be duplicated.
+    const auto& graph            = model->GetMainGraph();
+    const auto& restored_graph   = restored->GetMainGraph();
+    auto        tensor_indices   = TfLiteSerializer::GetTensorIndices(graph);
+    auto        restored_indices = TfLiteSerializer::GetTensorIndices(restored_graph);
+    REPORT_ERROR_IF(tensor_indices.size() != restored_indices.size(), "Tensors differ after decompression.");
+    std::vector<BLOBID_T> restored_ids(restored_indices.size());
+    for (const auto& [blob_id, index] : restored_indices) {
+        restored_ids[index] = blob_id;
+    }
+    for (const auto& [blob_id, index] : tensor_indices) {
+        const auto* buffer        = graph.GetBuffer(blob_id);
+        const auto* restored_data = restored_graph.GetBuffer(restored_ids[index]);
+        REPORT_ERROR_IF((buffer == nullptr) != (restored_data == nullptr) ||
+                            (buffer != nullptr && *buffer != *restored_data),
+                        "Buffer of ", graph.GetDataBlob(blob_id)->GetName(), " differs after decompression.");
+    }
+
+    const auto& packed   = serializer.GetCompressionStats();
+    const auto& unpacked = verifier.GetCompressionStats();
+    std::cout << std::left << std::setw(40) << "model" << std::right << std::setw(14) << "file_bytes" << std::setw(14)
+              << "output_bytes" << std::setw(14) << "raw_bytes" << std::setw(14) << "packed_bytes" << std::setw(10)
+              << "ratio" << std::setw(14) << "pack_GB/s" << std::setw(14) << "unpack_GB/s" << "\n";
+    std::cout << std::left << std::setw(40) << input_path << std::right << std::setw(14) << GetFileSize(input_path)
+              << std::setw(14) << GetFileSize(output_path) << std::setw(14) << packed.raw_bytes << std::setw(14)
+              << packed.compressed_bytes << std::fixed << std::setprecision(3) << std::setw(10)
+              << static_cast<double>(packed.raw_bytes) / std::max<uint64_t>(packed.compressed_bytes, 1)
+              << std::setw(14) << GetThroughput(packed) << std::setw(14) << GetThroughput(unpacked) << "\n";
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include <fstream>
+
+#include "common/command_line_parser.h"
+#include "common/string_utils.h"
+#include "model/graph_view.h"
+#include "model/model.h"
+#include "parser_and_serializer/tflite/parser.h"
+#include "parser_and_serializer/tflite/serializer.h"
+
+struct MergerOptions {
+    Option<std::string> input_tflite_files;
+    Option<std::string> signature_keys;
+    Option<std::string> output_tflite_file;
+};
+
+namespace {
+// `path/to/model_b1.tflite` is signed as `model_b1`.
+std::string GetFileStem(const std::string& path) {
+    auto name      = path.substr(path.find_last_of('/') + 1);
+    auto extension = name.find_last_of('.');
+    return extension == std::string::npos || extension == 0 ? name : name.substr(0, extension);
+}
+
+uint64_t GetFileBytes(const std::string& path) {
+    std::ifstream file(path, std::ios_base::binary | std::ios_base::ate);
+    REPORT_ERROR_IF(!file, "Cannot open `", path, "`.");
+    return file.tellg();
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    MergerOptions     merger_options;
+    std::vector<Flag> flags = {
+        Flag("--input_tflites", "-i", merger_options.input_tflite_files, REQUIRED::YES,
+             "The paths of model variants to merge, separated by ','. Every variant becomes one subgraph."),
+        Flag("--signatures", "-s", merger_options.signature_keys, REQUIRED::NO,
+             "The signature keys of variants in the same order, separated by ','. File names without extension by "
+             "default."),
+        Flag("--output_tflite", "-o", merger_options.output_tflite_file, REQUIRED::YES,
+             "The output path of merged model, whose constant buffers are shared between variants with identical "
+             "content."),
+    };
+    CommandLineParser::Parse(argc, argv, flags);
+
+    auto                     input_paths = common::split(merger_options.input_tflite_files.GetValue(), ',');
+    std::vector<std::string> signature_keys;
+    if (merger_options.signature_keys.HasValue()) {
+        signature_keys = common::split(merger_options.signature_keys.GetValue(), ',');
+        REPORT_ERROR_IF(signature_keys.size() != input_paths.size(), "Got ", signature_keys.size(),
+                        " signatures for ", input_paths.size(), " models. Please check arguments.");
+    } else {
+        for (const auto& input_path : input_paths) {
+            signature_keys.push_back(GetFileStem(input_path));
+        }
+    }
+
+    // Models own the graphs seen by signatures, keep them until the merged model is exported.
+    std::vector<std::unique_ptr<Model>>      models;
+    std::vector<TfLiteSerializer::Signature> signatures;
+    uint64_t                                 input_bytes = 0;
+    for (size_t index = 0; index < input_paths.size(); index++) {
+        models.push_back(TfLiteParser().ImportModel(input_paths[index]));
+        if (!models.back()->GetMetadata().empty()) {
+            LOG(WARN) << "Metadata of `" << input_paths[index] << "` describes a single graph, it isn't merged.";
+        }
+        signatures.push_back({signature_keys[index], GraphView(models.back()->GetMainGraph())});
+        input_bytes += GetFileBytes(input_paths[index]);
+    }
+    TfLiteSerializer().ExportToTfLite(signatures, merger_options.output_tflite_file.GetValue());
+
+    LOG(INFO) << "Merged " << models.size() << " models of " << input_bytes << " bytes into "
+              << GetFileBytes(merger_options.output_tflite_file.GetValue()) << " bytes with signatures "
+              << common::join(signature_keys, ", ") << ".";
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "common/command_line_parser.h"
+#include "common/string_utils.h"
+#include "tools/model_stats/stats_utils.h"
+
+struct StatsOptions {
+    Option<std::string> input_tflite_files;
+    Option<std::string> output_json_file;
+};
+
+namespace {
+using ModelStats = StatsUtils::ModelStats;
+
+double GetPercent(uint64_t part, uint64_t total) { return total == 0 ? 0.0 : 100.0 * part / total; }
+
+void PrintStats(std::ostream& out, const std::string& path, const ModelStats& stats, double milliseconds) {
+    out << std::fixed << std::setprecision(1) << path << ": " << stats.file_bytes << " bytes, " << stats.subgraphs
+        << " subgraphs, " << stats.operators << " operators, " << stats.tensors << " tensors, read in "
+        << milliseconds << " ms\n";
+    out << "  parameters: " << stats.parameters << " in " << stats.constant_tensors << " constant tensors\n";
+    for (const auto& [type, type_stats] : stats.constants) {
+        out << "    " << std::left << std::setw(10) << type << std::right << std::setw(8) << type_stats.tensors
+            << " tensors" << std::setw(14) << type_stats.parameters << " parameters" << std::setw(14)
+            << type_stats.bytes << " bytes\n";
+    }
+    out << "  quantized: " << GetPercent(stats.quantized_parameters, stats.parameters) << "% of parameters, "
+        << stats.quantized_constant_tensors << " of " << stats.constant_tensors << " constant tensors ("
+        << stats.per_channel_tensors << " per-channel), " << stats.quantized_activation_tensors << " of "
+        << stats.activation_tensors << " activation tensors, " << stats.quantized_operators << " of "
+        << stats.operators << " operators\n";
+
+    std::vector<std::pair<std::string, uint64_t>> op_counts(stats.op_counts.begin(), stats.op_counts.end());
+    std::stable_sort(op_counts.begin(), op_counts.end(),
+                     [](const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; });
+    out << "  operators:";
+    for (const auto& [op_name, count] : op_counts) {
+        out << " " << op_name << " " << count << ",";
+    }
+    out << "\n";
+}
+
+// One JSON object per line, so that reports of many runs can simply be concatenated.
+void WriteJsonLine(std::ostream& out, const std::string& path, const ModelStats& stats) {
+    out << "{\"path\": \"" << common::escape_json(path) << "\", \"file_bytes\": " << stats.file_bytes
+        << ", \"subgraphs\": " << stats.subgraphs << ", \"operators\": " << stats.operators
+        << ", \"tensors\": " << stats.tensors << ", \"parameters\": " << stats.parameters
+        << ", \"quantized_parameters\": " << stats.quantized_parameters
+        << ", \"constant_tensors\": " << stats.constant_tensors
+        << ", \"quantized_constant_tensors\": " << stats.quantized_constant_tensors
+        << ", \"per_channel_tensors\": " << stats.per_channel_tensors
+        << ", \"activation_tensors\": " << stats.activation_tensors
+        << ", \"quantized_activation_tensors\": " << stats.quantized_activation_tensors
+        << ", \"quantized_operators\": " << stats.quantized_operators << ", \"constants\": {";
+    const char* separator = "";
+    for (const auto& [type, type_stats] : stats.constants) {
+        out << separator << "\"" << type << "\": {\"tensors\": " << type_stats.tensors
+            << ", \"parameters\": " << type_stats.parameters << ", \"bytes\": " << type_stats.bytes << "}";
+        separator = ", ";
+    }
+    out << "}, \"op_counts\": {";
+    separator = "";
+    for (const auto& [op_name, count] : stats.op_counts) {
+        out << separator << "\"" << common::escape_json(op_name) << "\": " << count;
+        separator = ", ";
+    }
+    out << "}}\n";
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    StatsOptions      stats_options;
+    std::vector<Flag> flags = {
+        Flag("--input_tflites", "-i", stats_options.input_tflite_files, REQUIRED::YES,
+             "The paths of tflite models to inspect, separated by ','. Models are memory mapped and never parsed into "
+             "the IR."),
+        Flag("--output_json", "-o", stats_options.output_json_file, REQUIRED::NO,
+             "The output path of the report, one JSON object per model and line."),
+    };
+    CommandLineParser::Parse(argc, argv, flags);
+
+    std::ofstream json_file;
+    if (stats_options.output_json_file.HasValue()) {
+        json_file.open(stats_options.output_json_file.GetValue());
+        REPORT_ERROR_IF(!json_file, "Cannot open `", stats_options.output_json_file.GetValue(), "` to write.");
+    }
+
+    int num_failures = 0;
+    for (const auto& path : common::split(stats_options.input_tflite_files.GetValue(), ',')) {
+        // A broken model is reported and skipped, so that a scan over many models runs to the end.
+        try {
+            auto               start = std::chrono::steady_clock::now();
+            common::MappedFile file(path);
+            auto               stats = StatsUtils::CollectStats(file);
+            auto               end   = std::chrono::steady_clock::now();
+            PrintStats(std::cout, path, stats, std::chrono::duration<double, std::milli>(end - start).count());
+            if (json_file.is_open()) {
+                WriteJsonLine(json_file, path, stats);
+            }
+        } catch (const std::exception& error) {
+            LOG(WARN) << "Skip `" << path << "`: " << error.what();
+            num_failures++;
+        }
+    }
+    return num_failures == 0 ? 0 : 1;
+}
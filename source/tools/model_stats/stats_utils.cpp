@@ -0,0 +1,130 @@
+#include "tools/model_stats/stats_utils.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "common/dynamic_bitset.h"
+#include "common/logging.h"
+#include "schema_generated.h"
+
+namespace {
+bool IsQuantized(const tflite::Tensor& tensor) {
+    const auto* quantization = tensor.quantization();
+    return quantization != nullptr && quantization->scale() != nullptr && quantization->scale()->size() > 0;
+}
+
+bool IsFloat(tflite::TensorType type) {
+    return type == tflite::TensorType_FLOAT32 || type == tflite::TensorType_FLOAT16 ||
+           type == tflite::TensorType_FLOAT64;
+}
+
+uint64_t GetNumElements(const tflite::Tensor& tensor) {
+    uint64_t num_elements = 1;
+    if (tensor.shape() != nullptr) {
+        for (auto dim : *tensor.shape()) {
+            num_elements *= std::max(dim, 0);
+        }
+    }
+    return num_elements;
+}
+
+std::vector<std::string> GetOperatorNames(const tflite::Model& model) {
+    std::vector<std::string> names;
+    if (model.operator_codes() == nullptr) {
+        return names;
+    }
+    for (const auto* opcode : *model.operator_codes()) {
+        auto builtin_code =
+            std::max(opcode->builtin_code(), static_cast<tflite::BuiltinOperator>(opcode->deprecated_builtin_code()));
+        if (builtin_code == tflite::BuiltinOperator_CUSTOM) {
+            names.push_back("CUSTOM:" + (opcode->custom_code() != nullptr ? opcode->custom_code()->str() : ""));
+        } else {
+            names.push_back(tflite::EnumNameBuiltinOperator(builtin_code));
+        }
+    }
+    return names;
+}
+
+void CollectTensors(const tflite::Model&    model,
+                    const tflite::SubGraph& subgraph,
+                    common::DynamicBitset&  counted_buffers,
+                    StatsUtils::ModelStats& stats) {
+    const auto* buffers = model.buffers();
+    for (const auto* tensor : *subgraph.tensors()) {
+        stats.tensors++;
+        auto        buffer_index = tensor->buffer();
+        const auto* data         = buffer_index < buffers->size() ? buffers->Get(buffer_index)->data() : nullptr;
+        if (data == nullptr || data->size() == 0) {
+            stats.activation_tensors++;
+            stats.quantized_activation_tensors += IsQuantized(*tensor);
+            continue;
+        }
+        // Constants sharing a buffer hold the same weights, e.g. in different subgraphs.
+        if (!counted_buffers.test_and_set(buffer_index)) {
+            continue;
+        }
+        auto  num_elements = GetNumElements(*tensor);
+        auto& type_stats   = stats.constants[tflite::EnumNameTensorType(tensor->type())];
+        type_stats.tensors++;
+        type_stats.parameters += num_elements;
+        type_stats.bytes += data->size();
+        stats.parameters += num_elements;
+        stats.constant_tensors++;
+        if (IsQuantized(*tensor)) {
+            stats.quantized_parameters += num_elements;
+            stats.quantized_constant_tensors++;
+            stats.per_channel_tensors += tensor->quantization()->scale()->size() > 1;
+        }
+    }
+}
+
+void CollectOperators(const tflite::SubGraph&         subgraph,
+                      const std::vector<std::string>& op_names,
+                      StatsUtils::ModelStats&         stats) {
+    const auto* tensors         = subgraph.tensors();
+    auto        is_float_tensor = [&](int32_t index) {
+        // Optional inputs are -1.
+        return index >= 0 && IsFloat(tensors->Get(index)->type());
+    };
+    for (const auto* op : *subgraph.operators()) {
+        REPORT_ERROR_IF(op->opcode_index() >= op_names.size(), "Operator code ", op->opcode_index(), " out of range.");
+        stats.operators++;
+        stats.op_counts[op_names[op->opcode_index()]]++;
+
+        bool has_float = false;
+        for (const auto* indices : {op->inputs(), op->outputs()}) {
+            if (indices == nullptr) {
+                continue;
+            }
+            for (auto index : *indices) {
+                REPORT_ERROR_IF(index >= static_cast<int32_t>(tensors->size()), "Tensor ", index, " out of range.");
+                has_float = has_float || is_float_tensor(index);
+            }
+        }
+        stats.quantized_operators += !has_float;
+    }
+}
+}  // namespace
+
+StatsUtils::ModelStats StatsUtils::CollectStats(const common::MappedFile& file) {
+    flatbuffers::Verifier verifier(file.data(), file.size());
+    REPORT_ERROR_IF(!tflite::VerifyModelBuffer(verifier), "Not a valid tflite model.");
+    const auto* model = tflite::GetModel(file.data());
+    REPORT_ERROR_IF(model->subgraphs() == nullptr || model->buffers() == nullptr, "Model without subgraphs.");
+
+    ModelStats stats;
+    stats.file_bytes = file.size();
+    stats.subgraphs  = model->subgraphs()->size();
+
+    auto                  op_names = GetOperatorNames(*model);
+    common::DynamicBitset counted_buffers(model->buffers()->size());
+    for (const auto* subgraph : *model->subgraphs()) {
+        if (subgraph->tensors() != nullptr) {
+            CollectTensors(*model, *subgraph, counted_buffers, stats);
+            if (subgraph->operators() != nullptr) {
+                CollectOperators(*subgraph, op_names, stats);
+            }
+        }
+    }
+    return stats;
+}
@@ -0,0 +1,116 @@
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+#include "common/command_line_parser.h"
+#include "model/model.h"
+#include "parser_and_serializer/tflite/parser.h"
+#include "parser_and_serializer/tflite/serializer.h"
+#include "transforms/mixed_precision.h"
+
+struct PlannerOptions {
+    Option<std::string> input_tflite_file;
+    Option<std::string> output_tflite_file;
+    Option<double>      max_mb;
+    Option<double>      max_ms;
+    Option<double>      min_snr;
+    Option<double>      peak_gflops;
+    Option<double>      peak_gbps;
+    Option<int64_t>     min_elements;
+    Option<int32_t>     num_threads;
+};
+
+int main(int argc, char** argv) {
+    PlannerOptions    planner_options;
+    std::vector<Flag> flags = {
+        Flag("--input_tflite", "-i", planner_options.input_tflite_file, REQUIRED::YES,
+             "The path of input tflite model, the target file whose float32 weights are planned."),
+        Flag("--output_tflite", "-o", planner_options.output_tflite_file, REQUIRED::NO,
+             "The output path of the model with weights converted as planned. Only the plan is printed without it."),
+        Flag("--max_mb", planner_options.max_mb, REQUIRED::NO,
+             "The budget of the planned weights in MB (10^6 bytes), no limit by default."),
+        Flag("--max_ms", planner_options.max_ms, REQUIRED::NO,
+             "The budget of the roofline time of the planned operators in milliseconds, no limit by default."),
+        Flag("--min_snr", planner_options.min_snr, REQUIRED::NO,
+             "The least SNR in dB of the rounded weights of any layer, 0 by default. Without budgets, every layer "
+             "takes its smallest precision above it."),
+        Flag("--peak_gflops", planner_options.peak_gflops, REQUIRED::NO,
+             "The peak compute throughput of the target in GFLOP/s, 100 by default."),
+        Flag("--peak_gbps", planner_options.peak_gbps, REQUIRED::NO,
+             "The peak memory bandwidth of the target in GB/s, 25 by default."),
+        Flag("--min_elements", planner_options.min_elements, REQUIRED::NO,
+             "The least number of elements of planned weights, 1024 by default."),
+        Flag("--num_threads", "-j", planner_options.num_threads, REQUIRED::NO,
+             "The number of threads measuring and converting weights, all hardware threads by default."),
+    };
+    CommandLineParser::Parse(argc, argv, flags);
+
+    MixedPrecision::Budget budget;
+    if (planner_options.max_mb.HasValue()) {
+        REPORT_ERROR_IF(planner_options.max_mb.GetValue() <= 0, "Size budget should be positive.");
+        budget.max_weight_bytes = static_cast<uint64_t>(planner_options.max_mb.GetValue() * 1e6);
+    }
+    if (planner_options.max_ms.HasValue()) {
+        REPORT_ERROR_IF(planner_options.max_ms.GetValue() <= 0, "Time budget should be positive.");
+        budget.max_seconds = planner_options.max_ms.GetValue() / 1e3;
+    }
+    if (planner_options.min_snr.HasValue()) {
+        budget.min_snr_db = planner_options.min_snr.GetValue();
+    }
+    CostModel::Roofline roofline;
+    if (planner_options.peak_gflops.HasValue()) {
+        roofline.peak_gflops = planner_options.peak_gflops.GetValue();
+    }
+    if (planner_options.peak_gbps.HasValue()) {
+        roofline.peak_gbps = planner_options.peak_gbps.GetValue();
+    }
+    REPORT_ERROR_IF(roofline.peak_gflops <= 0 || roofline.peak_gbps <= 0,
+                    "Peak compute and bandwidth should be positive. Please check arguments.");
+    int64_t min_elements = planner_options.min_elements.HasValue() ? planner_options.min_elements.GetValue() : 1024;
+    int32_t num_threads  = planner_options.num_threads.HasValue() ? planner_options.num_threads.GetValue() : 0;
+    REPORT_ERROR_IF(min_elements < 0 || num_threads < 0, "Negative number in arguments. Please check arguments.");
+
+    auto  model = TfLiteParser().ImportModel(planner_options.input_tflite_file.GetValue());
+    auto& graph = model->GetMainGraph();
+    auto  plan  = planner_options.output_tflite_file.HasValue()
+                      ? MixedPrecision::Run(graph, budget, roofline, min_elements, num_threads)
+                      : MixedPrecision::Analyze(graph, budget, roofline, min_elements, num_threads);
+
+    uint64_t float32_bytes   = 0;
+    uint64_t planned_bytes   = 0;
+    double   float32_seconds = 0.0;
+    double   planned_seconds = 0.0;
+    std::cout << std::left << std::setw(40) << "output" << std::setw(18) << "op_type" << std::setw(10) << "precision"
+              << std::right << std::setw(14) << "f32_bytes" << std::setw(14) << "bytes" << std::setw(12)
+              << "f32_us" << std::setw(12) << "us" << std::setw(10) << "snr_db" << "\n";
+    for (const auto& layer : plan.layers) {
+        const auto& float32 = layer.choices.front();
+        const auto& chosen  = layer.choices[layer.chosen];
+        auto        name    = layer.op_output;
+        if (name.size() > 38) {
+            name = "..." + name.substr(name.size() - 35);
+        }
+        std::cout << std::left << std::setw(40) << name << std::setw(18) << ToStr(layer.op_type) << std::setw(10)
+                  << MixedPrecision::GetPrecisionName(chosen.precision) << std::right << std::setw(14)
+                  << float32.weight_bytes << std::setw(14) << chosen.weight_bytes << std::fixed
+                  << std::setprecision(2) << std::setw(12) << float32.seconds * 1e6 << std::setw(12)
+                  << chosen.seconds * 1e6 << std::setw(10);
+        if (std::isinf(chosen.snr_db)) {
+            std::cout << "inf" << "\n";
+        } else {
+            std::cout << chosen.snr_db << "\n";
+        }
+        float32_bytes += float32.weight_bytes;
+        planned_bytes += chosen.weight_bytes;
+        float32_seconds += float32.seconds;
+        planned_seconds += chosen.seconds;
+    }
+    std::cout << plan.layers.size() << " layers, weights from " << float32_bytes << " to " << planned_bytes
+              << " bytes, roofline time from " << float32_seconds * 1e6 << " to " << planned_seconds * 1e6
+              << " us. The budget is " << (plan.budget_met ? "met" : "NOT met") << ".\n";
+
+    if (planner_options.output_tflite_file.HasValue()) {
+        TfLiteSerializer().ExportToTfLite(*model.get(), planner_options.output_tflite_file.GetValue());
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include "common/command_line_parser.h"
+#include "common/string_utils.h"
+#include "model/model.h"
+#include "parser_and_serializer/tflite/parser.h"
+#include "parser_and_serializer/tflite/serializer.h"
+#include "transforms/shape_specialization.h"
+
+struct SpecializerOptions {
+    Option<std::string> input_tflite_file;
+    Option<std::string> output_tflite_file;
+    Option<std::string> input_shapes;
+};
+
+// Parse `name:d0,d1,...;name:d0,...`. Names may contain ':', so the last one separates name and dims.
+ShapeSpecialization::InputShapes ParseInputShapes(const std::string& input_shapes_str) {
+    ShapeSpecialization::InputShapes input_shapes;
+    for (const auto& item : common::split(input_shapes_str, ';')) {
+        auto item_str = common::strip(item);
+        if (item_str.empty()) {
+            continue;
+        }
+        auto separator = item_str.rfind(':');
+        REPORT_ERROR_IF(separator == std::string::npos, "Shape `", item_str,
+                        "` should be in format of `name:d0,d1,...`. Please check arguments.");
+        std::vector<int> dims;
+        for (const auto& dim : common::split(item_str.substr(separator + 1), ',')) {
+            int dim_value = 0;
+            REPORT_ERROR_IF(!common::parse_int(common::strip(dim), dim_value) || dim_value <= 0, "Dims of `", item_str,
+                            "` should be positive integers for a static model.");
+            dims.push_back(dim_value);
+        }
+        input_shapes[item_str.substr(0, separator)] = dims;
+    }
+    return input_shapes;
+}
+
+int main(int argc, char** argv) {
+    SpecializerOptions specializer_options;
+    std::vector<Flag>  flags = {
+        Flag("--input_tflite", "-i", specializer_options.input_tflite_file, REQUIRED::YES,
+             "The path of input tflite model, the target file which is going to be specialized."),
+        Flag("--output_tflite", "-o", specializer_options.output_tflite_file, REQUIRED::YES,
+             "The output path of tflite model which is processed. Specify the file path to save static model."),
+        Flag("--input_shapes", "-s", specializer_options.input_shapes, REQUIRED::YES,
+             "The concrete shapes of graph inputs, e.g. `image:8,224,224,3;mask:8,128`. Use \';\' to seperate "
+             "inputs and \',\' to seperate dims. Inputs which are not listed keep their shapes."),
+    };
+    CommandLineParser::Parse(argc, argv, flags);
+
+    auto model        = TfLiteParser().ImportModel(specializer_options.input_tflite_file.GetValue());
+    auto input_shapes = ParseInputShapes(specializer_options.input_shapes.GetValue());
+    ShapeSpecialization::Run(model->GetMainGraph(), input_shapes);
+    TfLiteSerializer().ExportToTfLite(*model.get(), specializer_options.output_tflite_file.GetValue());
+
+    return 0;
+}
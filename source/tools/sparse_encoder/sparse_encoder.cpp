@@ -0,0 +1,67 @@
+#include <iomanip>
+#include <iostream>
+
+#include "common/command_line_parser.h"
+#include "common/string_utils.h"
+#include "model/model.h"
+#include "parser_and_serializer/tflite/parser.h"
+#include "parser_and_serializer/tflite/serializer.h"
+#include "transforms/sparse_encoding.h"
+
+struct EncoderOptions {
+    Option<std::string> input_tflite_file;
+    Option<std::string> output_tflite_file;
+    Option<double>      min_sparsity;
+    Option<std::string> block;
+    Option<int64_t>     min_elements;
+};
+
+int main(int argc, char** argv) {
+    EncoderOptions    encoder_options;
+    std::vector<Flag> flags = {
+        Flag("--input_tflite", "-i", encoder_options.input_tflite_file, REQUIRED::YES,
+             "The path of input tflite model, the target file whose pruned FULLY_CONNECTED weights are encoded."),
+        Flag("--output_tflite", "-o", encoder_options.output_tflite_file, REQUIRED::YES,
+             "The output path of the model with sparse weights."),
+        Flag("--min_sparsity", "-s", encoder_options.min_sparsity, REQUIRED::NO,
+             "The least fraction of zero blocks of encoded weights, 0.5 by default."),
+        Flag("--block", "-b", encoder_options.block, REQUIRED::NO,
+             "The block of <rows>x<columns> elements which are zero or stored together, 1x4 by default as the "
+             "sparse FULLY_CONNECTED kernels of TFLite expect."),
+        Flag("--min_elements", encoder_options.min_elements, REQUIRED::NO,
+             "The least number of elements of encoded weights, 1024 by default."),
+    };
+    CommandLineParser::Parse(argc, argv, flags);
+
+    double      min_sparsity = encoder_options.min_sparsity.HasValue() ? encoder_options.min_sparsity.GetValue() : 0.5;
+    int64_t     min_elements = encoder_options.min_elements.HasValue() ? encoder_options.min_elements.GetValue() : 1024;
+    std::string block_shape  = encoder_options.block.HasValue() ? encoder_options.block.GetValue() : "1x4";
+    auto        block        = common::split(block_shape, 'x');
+    int         block_rows   = 0;
+    int         block_cols   = 0;
+    REPORT_ERROR_IF(block.size() != 2 || !common::parse_int(block[0], block_rows) ||
+                        !common::parse_int(block[1], block_cols) || block_rows <= 0 || block_cols <= 0,
+                    "Block should be <rows>x<columns> of positive integers, e.g. 1x4.");
+    REPORT_ERROR_IF(min_sparsity < 0 || min_sparsity > 1, "Sparsity should be within [0, 1].");
+    REPORT_ERROR_IF(min_elements < 0, "Negative number in arguments. Please check arguments.");
+
+    auto model           = TfLiteParser().ImportModel(encoder_options.input_tflite_file.GetValue());
+    auto encoded_tensors =
+        SparseEncoding::Run(model->GetMainGraph(), min_sparsity, block_rows, block_cols, min_elements);
+
+    uint64_t dense_bytes  = 0;
+    uint64_t sparse_bytes = 0;
+    std::cout << std::left << std::setw(60) << "tensor" << std::right << std::setw(10) << "sparsity" << std::setw(14)
+              << "dense_bytes" << std::setw(14) << "sparse_bytes" << "\n";
+    for (const auto& encoded_tensor : encoded_tensors) {
+        std::cout << std::left << std::setw(60) << encoded_tensor.name << std::right << std::setw(10) << std::fixed
+                  << std::setprecision(3) << encoded_tensor.sparsity << std::setw(14) << encoded_tensor.dense_bytes
+                  << std::setw(14) << encoded_tensor.sparse_bytes << "\n";
+        dense_bytes += encoded_tensor.dense_bytes;
+        sparse_bytes += encoded_tensor.sparse_bytes;
+    }
+    std::cout << encoded_tensors.size() << " tensors encoded, " << dense_bytes - sparse_bytes << " bytes saved.\n";
+
+    TfLiteSerializer().ExportToTfLite(*model.get(), encoder_options.output_tflite_file.GetValue());
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+#include "common/command_line_parser.h"
+#include "common/string_utils.h"
+#include "model/model.h"
+#include "parser_and_serializer/tflite/parser.h"
+#include "parser_and_serializer/tflite/serializer.h"
+#include "transforms/weight_clustering.h"
+
+struct ClustererOptions {
+    Option<std::string> input_tflite_file;
+    Option<std::string> output_tflite_file;
+    Option<std::string> tensor_names;
+    Option<int32_t>     num_clusters;
+    Option<bool>        per_channel;
+    Option<std::string> reconstruction;
+    Option<int64_t>     min_elements;
+    Option<int32_t>     num_threads;
+};
+
+int main(int argc, char** argv) {
+    ClustererOptions  clusterer_options;
+    std::vector<Flag> flags = {
+        Flag("--input_tflite", "-i", clusterer_options.input_tflite_file, REQUIRED::YES,
+             "The path of input tflite model, the target file whose float32 constants are clustered."),
+        Flag("--output_tflite", "-o", clusterer_options.output_tflite_file, REQUIRED::YES,
+             "The output path of the model with clustered constants."),
+        Flag("--tensors", clusterer_options.tensor_names, REQUIRED::NO,
+             "The constant tensors to cluster, separated by ','. All float32 constants with at least --min_elements "
+             "elements by default."),
+        Flag("--clusters", "-k", clusterer_options.num_clusters, REQUIRED::NO,
+             "The number of codebook values within [2, 256], 16 by default."),
+        Flag("--per_channel", clusterer_options.per_channel, REQUIRED::NO,
+             "Whether every slice along the first axis gets its own codebook, true by default."),
+        Flag("--reconstruction", "-r", clusterer_options.reconstruction, REQUIRED::NO,
+             "gather: store uint8 indices rebuilt by GATHER from the codebook. in_place: keep float32 constants "
+             "holding the codebook values. gather by default."),
+        Flag("--min_elements", clusterer_options.min_elements, REQUIRED::NO,
+             "The least number of elements of clustered constants without --tensors, 1024 by default."),
+        Flag("--num_threads", "-j", clusterer_options.num_threads, REQUIRED::NO,
+             "The number of threads clustering constants, all hardware threads by default."),
+    };
+    CommandLineParser::Parse(argc, argv, flags);
+
+    std::vector<std::string> tensor_names;
+    if (clusterer_options.tensor_names.HasValue()) {
+        tensor_names = common::split(clusterer_options.tensor_names.GetValue(), ',');
+    }
+    int32_t num_clusters = clusterer_options.num_clusters.HasValue() ? clusterer_options.num_clusters.GetValue() : 16;
+    bool    per_channel  = !clusterer_options.per_channel.HasValue() || clusterer_options.per_channel.GetValue();
+    int64_t min_elements = clusterer_options.min_elements.HasValue() ? clusterer_options.min_elements.GetValue() : 1024;
+    int32_t num_threads  = clusterer_options.num_threads.HasValue() ? clusterer_options.num_threads.GetValue() : 0;
+    REPORT_ERROR_IF(num_clusters < 0 || min_elements < 0 || num_threads < 0,
+                    "Negative number in arguments. Please check arguments.");
+    auto mode_name =
+        clusterer_options.reconstruction.HasValue() ? clusterer_options.reconstruction.GetValue() : "gather";
+    REPORT_ERROR_IF(mode_name != "gather" && mode_name != "in_place", "Reconstruction `", mode_name,
+                    "` is not supported, it should be gather or in_place.");
+    auto reconstruction = mode_name == "gather" ? WeightClustering::Reconstruction::GATHER
+                                                : WeightClustering::Reconstruction::IN_PLACE;
+
+    auto model             = TfLiteParser().ImportModel(clusterer_options.input_tflite_file.GetValue());
+    auto clustered_tensors = WeightClustering::Run(model->GetMainGraph(), tensor_names, num_clusters, per_channel,
+                                                   reconstruction, min_elements, num_threads);
+
+    // Palettized size: the codebooks and log2(K) bits per index, as stored by a palettizing runtime.
+    uint32_t index_bits      = static_cast<uint32_t>(std::ceil(std::log2(num_clusters)));
+    uint64_t original_bytes  = 0;
+    uint64_t clustered_bytes = 0;
+    std::cout << std::left << std::setw(60) << "tensor" << std::right << std::setw(10) << "channels" << std::setw(14)
+              << "original" << std::setw(14) << "stored" << std::setw(14) << "palettized" << std::setw(14)
+              << "max_error" << std::setw(14) << "mean_error" << "\n";
+    for (const auto& clustered_tensor : clustered_tensors) {
+        uint64_t palettized_bytes =
+            clustered_tensor.channels * num_clusters * sizeof(float) + (clustered_tensor.elements * index_bits + 7) / 8;
+        std::cout << std::left << std::setw(60) << clustered_tensor.name << std::right << std::setw(10)
+                  << clustered_tensor.channels << std::setw(14) << clustered_tensor.original_bytes << std::setw(14)
+                  << clustered_tensor.clustered_bytes << std::setw(14) << palettized_bytes << std::setw(14)
+                  << std::setprecision(6) << clustered_tensor.max_error << std::setw(14)
+                  << clustered_tensor.mean_error << "\n";
+        original_bytes += clustered_tensor.original_bytes;
+        clustered_bytes += clustered_tensor.clustered_bytes;
+    }
+    std::cout << clustered_tensors.size() << " tensors clustered, " << original_bytes << " bytes stored in "
+              << clustered_bytes << " bytes.\n";
+
+    TfLiteSerializer().ExportToTfLite(*model.get(), clusterer_options.output_tflite_file.GetValue());
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <iomanip>
+#include <iostream>
+
+#include "common/command_line_parser.h"
+#include "common/string_utils.h"
+#include "model/model.h"
+#include "parser_and_serializer/tflite/parser.h"
+#include "parser_and_serializer/tflite/serializer.h"
+#include "transforms/weight_quantization.h"
+
+struct QuantizerOptions {
+    Option<std::string> input_tflite_file;
+    Option<std::string> output_tflite_file;
+    Option<std::string> op_outputs;
+    Option<std::string> weight_type;
+    Option<int64_t>     min_elements;
+    Option<int32_t>     num_threads;
+};
+
+int main(int argc, char** argv) {
+    QuantizerOptions  quantizer_options;
+    std::vector<Flag> flags = {
+        Flag("--input_tflite", "-i", quantizer_options.input_tflite_file, REQUIRED::YES,
+             "The path of input tflite model, the target file whose weights are quantized."),
+        Flag("--output_tflite", "-o", quantizer_options.output_tflite_file, REQUIRED::YES,
+             "The output path of the model with quantized weights."),
+        Flag("--ops", quantizer_options.op_outputs, REQUIRED::NO,
+             "The output tensors of CONV2D, DEPTHWISE_CONV2D, FULLY_CONNECTED, TRANSPOSE_CONV2D and BATCH_MATMUL "
+             "operators to quantize, separated by ','. All such operators by default."),
+        Flag("--type", "-t", quantizer_options.weight_type, REQUIRED::NO,
+             "`int8` (default) or `int4`. Int8 weights of the input model can be quantized further to int4."),
+        Flag("--min_elements", quantizer_options.min_elements, REQUIRED::NO,
+             "The least number of elements of quantized weights, 1024 by default."),
+        Flag("--num_threads", "-j", quantizer_options.num_threads, REQUIRED::NO,
+             "The number of threads quantizing weights, all hardware threads by default."),
+    };
+    CommandLineParser::Parse(argc, argv, flags);
+
+    std::vector<std::string> op_outputs;
+    if (quantizer_options.op_outputs.HasValue()) {
+        op_outputs = common::split(quantizer_options.op_outputs.GetValue(), ',');
+    }
+    int64_t min_elements = quantizer_options.min_elements.HasValue() ? quantizer_options.min_elements.GetValue() : 1024;
+    int32_t num_threads  = quantizer_options.num_threads.HasValue() ? quantizer_options.num_threads.GetValue() : 0;
+    REPORT_ERROR_IF(min_elements < 0 || num_threads < 0, "Negative number in arguments. Please check arguments.");
+    auto type_name = quantizer_options.weight_type.HasValue() ? quantizer_options.weight_type.GetValue() : "int8";
+    REPORT_ERROR_IF(type_name != "int8" && type_name != "int4", "Type `", type_name,
+                    "` is unknown, use `int8` or `int4`.");
+    auto weight_type = type_name == "int8" ? DataType::INT8 : DataType::INT4;
+
+    auto model             = TfLiteParser().ImportModel(quantizer_options.input_tflite_file.GetValue());
+    auto quantized_weights =
+        WeightQuantization::Run(model->GetMainGraph(), op_outputs, weight_type, min_elements, num_threads);
+
+    uint64_t original_bytes  = 0;
+    uint64_t quantized_bytes = 0;
+    for (const auto& quantized_weight : quantized_weights) {
+        std::cout << std::left << std::setw(20) << ToStr(quantized_weight.op_type) << std::setw(60)
+                  << quantized_weight.weights << std::right << std::setw(8) << quantized_weight.channels
+                  << " scales" << std::setw(14) << quantized_weight.original_bytes << " -> " << std::setw(12)
+                  << quantized_weight.quantized_bytes << " bytes"
+                  << (quantized_weight.bias_quantized ? ", int32 bias" : "") << "\n";
+        original_bytes += quantized_weight.original_bytes;
+        quantized_bytes += quantized_weight.quantized_bytes;
+    }
+    std::cout << quantized_weights.size() << " weights quantized from " << original_bytes << " to " << quantized_bytes
+              << " bytes.\n";
+
+    TfLiteSerializer().ExportToTfLite(*model.get(), quantizer_options.output_tflite_file.GetValue());
+    return 0;
+}
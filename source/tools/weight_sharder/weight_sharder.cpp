@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <fstream>
+
+#include "common/command_line_parser.h"
+#include "common/string_utils.h"
+#include "model/model.h"
+#include "parser_and_serializer/tflite/parser.h"
+#include "parser_and_serializer/tflite/serializer.h"
+#include "transforms/weight_sharding.h"
+
+struct SharderOptions {
+    Option<std::string> input_tflite_file;
+    Option<std::string> output_tflite_file;
+    Option<int32_t>     num_shards;
+    Option<std::string> axis;
+    Option<std::string> op_outputs;
+    Option<int64_t>     min_weight_bytes;
+};
+
+namespace {
+using ShardedOperator = WeightSharding::ShardedOperator;
+
+uint64_t GetWeightBytes(const Graph& graph) {
+    uint64_t weight_bytes = 0;
+    for (const auto* blob : graph.GetDataBlobs()) {
+        if (const auto* buffer = graph.GetBuffer(blob->GetID())) {
+            weight_bytes += buffer->size();
+        }
+    }
+    return weight_bytes;
+}
+
+// The manifest lists every shard with its file, and every sharded operator with the channel slice of each shard. A
+// shard file holds one signature per stage, `stage<s>`, run in order. The shard owning a slice produces its tensor as
+// an output of the operator's stage, the other shards read it as an input of the next stage, where the original output
+// is rebuilt by `combine` in shard order.
+void WriteManifest(std::ostream&                       out,
+                   WeightSharding::Axis                axis,
+                   size_t                              num_stages,
+                   const std::vector<std::string>&     shard_paths,
+                   const std::vector<uint64_t>&        weight_bytes,
+                   const std::vector<ShardedOperator>& sharded_ops) {
+    auto num_shards = shard_paths.size();
+    out << "{\n  \"num_shards\": " << num_shards << ",\n  \"num_stages\": " << num_stages << ",\n  \"axis\": \""
+        << (axis == WeightSharding::Axis::OUTPUT_CHANNEL ? "output_channel" : "input_channel")
+        << "\",\n  \"shards\": [";
+    for (size_t shard = 0; shard < num_shards; shard++) {
+        out << (shard == 0 ? "\n" : ",\n") << "    {\"index\": " << shard << ", \"file\": \""
+            << common::escape_json(shard_paths[shard]) << "\", \"weight_bytes\": " << weight_bytes[shard] << "}";
+    }
+    out << "\n  ],\n  \"operators\": [";
+    for (size_t index = 0; index < sharded_ops.size(); index++) {
+        const auto& sharded_op = sharded_ops[index];
+        out << (index == 0 ? "\n" : ",\n") << "    {\"output\": \"" << common::escape_json(sharded_op.output)
+            << "\", \"op_type\": \"" << ToStr(sharded_op.op_type) << "\", \"combine\": \""
+            << ToStr(sharded_op.combine_type) << "\", \"channels\": " << sharded_op.channels
+            << ", \"stage\": " << sharded_op.stage << ",\n     \"slices\": [";
+        auto slice_channels = sharded_op.channels / num_shards;
+        for (size_t shard = 0; shard < num_shards; shard++) {
+            out << (shard == 0 ? "\n      " : ",\n      ") << "{\"shard\": " << shard << ", \"tensor\": \""
+                << common::escape_json(sharded_op.partials[shard]) << "\", \"channels\": [" << shard * slice_channels
+                << ", " << (shard + 1) * slice_channels << "]}";
+        }
+        out << "]}";
+    }
+    out << "\n  ]\n}\n";
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    SharderOptions    sharder_options;
+    std::vector<Flag> flags = {
+        Flag("--input_tflite", "-i", sharder_options.input_tflite_file, REQUIRED::YES,
+             "The path of input tflite model, the target file whose weights are sharded."),
+        Flag("--output_tflite", "-o", sharder_options.output_tflite_file, REQUIRED::YES,
+             "The output path of sharded models. Shards are saved to <output>_shard<i>.tflite with a manifest "
+             "<output>_manifest.json."),
+        Flag("--shards", "-n", sharder_options.num_shards, REQUIRED::YES,
+             "The number of shards, i.e. processes serving the model tensor-parallel. Sharded channels should be "
+             "divisible by it."),
+        Flag("--axis", sharder_options.axis, REQUIRED::NO,
+             "`output` (default) splits output channels and concatenates the slices, `input` splits input channels "
+             "and adds the partial sums."),
+        Flag("--ops", sharder_options.op_outputs, REQUIRED::NO,
+             "The output tensors of FULLY_CONNECTED, CONV2D and BATCH_MATMUL operators to shard, separated by ','. "
+             "By default, all such operators with at least --min_weight_bytes of weights are picked."),
+        Flag("--min_weight_bytes", sharder_options.min_weight_bytes, REQUIRED::NO,
+             "The least weight bytes of an operator sharded without --ops, 1 MiB by default."),
+    };
+    CommandLineParser::Parse(argc, argv, flags);
+
+    const auto& input_path  = sharder_options.input_tflite_file.GetValue();
+    const auto& output_path = sharder_options.output_tflite_file.GetValue();
+    REPORT_ERROR_IF(sharder_options.num_shards.GetValue() < 2, "At least 2 shards are needed. Please check arguments.");
+    uint32_t num_shards = sharder_options.num_shards.GetValue();
+    auto     axis_name  = sharder_options.axis.HasValue() ? sharder_options.axis.GetValue() : "output";
+    REPORT_ERROR_IF(axis_name != "output" && axis_name != "input", "Axis `", axis_name,
+                    "` is unknown, use `output` or `input`.");
+    auto axis = axis_name == "output" ? WeightSharding::Axis::OUTPUT_CHANNEL : WeightSharding::Axis::INPUT_CHANNEL;
+
+    std::vector<std::string> op_outputs;
+    if (sharder_options.op_outputs.HasValue()) {
+        op_outputs = common::split(sharder_options.op_outputs.GetValue(), ',');
+    } else {
+        int64_t min_weight_bytes =
+            sharder_options.min_weight_bytes.HasValue() ? sharder_options.min_weight_bytes.GetValue() : 1 << 20;
+        auto model = TfLiteParser().ImportModel(input_path);
+        op_outputs = WeightSharding::FindCandidates(model->GetMainGraph(), std::max<int64_t>(min_weight_bytes, 0));
+    }
+    REPORT_ERROR_IF(op_outputs.empty(), "No operators to shard. Please check arguments.");
+
+    // Every shard is rewritten from a fresh import, so it holds only its own slices.
+    size_t                       num_stages = 0;
+    std::vector<std::string>     shard_paths;
+    std::vector<uint64_t>        weight_bytes;
+    std::vector<ShardedOperator> sharded_ops;
+    for (uint32_t shard = 0; shard < num_shards; shard++) {
+        shard_paths.push_back(
+            common::replace_suffix(output_path, ".tflite", "_shard" + std::to_string(shard) + ".tflite"));
+        auto shard_model = TfLiteParser().ImportModel(input_path);
+        sharded_ops      = WeightSharding::Run(shard_model->GetMainGraph(), op_outputs, axis, num_shards, shard);
+        weight_bytes.push_back(GetWeightBytes(shard_model->GetMainGraph()));
+
+        std::vector<TfLiteSerializer::Signature> signatures;
+        for (auto& stage : WeightSharding::SplitStages(shard_model->GetMainGraph(), sharded_ops)) {
+            signatures.push_back({"stage" + std::to_string(signatures.size()), std::move(stage)});
+        }
+        num_stages = signatures.size();
+        TfLiteSerializer().ExportToTfLite(signatures, shard_paths.back());
+        LOG(INFO) << "Shard " << shard << " holds " << weight_bytes.back() << " bytes of weights in " << num_stages
+                  << " stages, saved to " << shard_paths.back();
+    }
+
+    auto          manifest_path = common::replace_suffix(output_path, ".tflite", "_manifest.json");
+    std::ofstream manifest_file(manifest_path);
+    REPORT_ERROR_IF(!manifest_file, "Cannot open `", manifest_path, "` to write.");
+    WriteManifest(manifest_file, axis, num_stages, shard_paths, weight_bytes, sharded_ops);
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include "transforms/common_subexpression_elimination.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "common/hash_utils.h"
+#include "common/stl_wrapper.h"
+#include "transforms/transform_utils.h"
+
+namespace {
+// Operators holding state between invocations must not be merged even if their inputs are the same.
+bool IsStateful(OperatorType op_type) {
+    static const std::vector<OperatorType> stateful_types = {
+        OperatorType::UNIDIRECTIONAL_LSTM, OperatorType::BIDIRECTIONAL_LSTM, OperatorType::UNIDIRECTIONAL_RNN,
+        OperatorType::BIDIRECTIONAL_RNN};
+    return common::contains(stateful_types, op_type);
+}
+
+size_t HashOperator(const Operator& op) {
+    size_t seed = common::hash_value(static_cast<int>(op.GetOpType()));
+    common::hash_combine(seed, common::hash_value(op.GetInputIDs()));
+    common::hash_combine(seed, op.GetOutputIDs().size());
+    if (op.HasOption()) {
+        common::hash_combine(seed, op.GetBaseOption()->Hash());
+    }
+    return seed;
+}
+}  // namespace
+
+uint32_t CommonSubexpressionElimination::Run(Graph& graph) {
+    LOG(INFO) << "CommonSubexpressionElimination::Run Start.";
+    auto merged_constants = MergeDuplicatedConstants(graph);
+
+    uint32_t                                           eliminated_ops = 0;
+    std::unordered_map<size_t, std::vector<Operator*>> visited_ops;
+    for (auto* op : graph.TopologicalSort()) {
+        if (IsStateful(op->GetOpType())) {
+            continue;
+        }
+        auto& candidates = visited_ops[HashOperator(*op)];
+        auto  target     = common::find_if(candidates, [&](const Operator* candidate) {
+            return IsEquivalent(*candidate, *op);
+        });
+        if (target == candidates.end()) {
+            candidates.push_back(op);
+            continue;
+        }
+        // Keep names of graph outputs stable, the duplicate is left as it is.
+        if (common::any_of(op->GetOutputIDs(), [&](BLOBID_T blob_id) { return graph.IsGraphOutput(blob_id); })) {
+            continue;
+        }
+
+        std::vector<DataBlob*> duplicated_outputs;
+        common::copy(op->GetOutputBlobs(), std::back_inserter(duplicated_outputs));
+        for (size_t index = 0; index < duplicated_outputs.size(); index++) {
+            graph.RedirectConsumers(duplicated_outputs[index], (*target)->GetOutputBlob(index));
+        }
+        graph.RemoveOperator(op);
+        for (auto* blob : duplicated_outputs) {
+            graph.EraseBlob(blob);
+        }
+        eliminated_ops++;
+    }
+    LOG(INFO) << "CommonSubexpressionElimination::Run End. Merged " << merged_constants << " constants and eliminated "
+              << eliminated_ops << " operators.";
+    return eliminated_ops;
+}
+
+uint32_t CommonSubexpressionElimination::MergeDuplicatedConstants(Graph& graph) {
+    // Visit constants by id so that the earliest blob of a group survives, which keeps the result deterministic.
+    std::vector<DataBlob*> constants;
+    for (auto* blob : graph.GetDataBlobs()) {
+        // Sparse buffers of different layouts may hold the same bytes, so they are never merged.
+        if (graph.GetBuffer(blob->GetID()) != nullptr && blob->GetProducer() == nullptr &&
+            !blob->HasSparsityParam() && !graph.IsGraphInput(blob->GetID()) && !graph.IsGraphOutput(blob->GetID())) {
+            constants.push_back(blob);
+        }
+    }
+    std::sort(constants.begin(), constants.end(),
+              [](const DataBlob* blob1, const DataBlob* blob2) { return blob1->GetID() < blob2->GetID(); });
+
+    uint32_t                                             merged_constants = 0;
+    std::unordered_map<uint64_t, std::vector<DataBlob*>> visited_constants;
+    for (auto* blob : constants) {
+        const auto* buffer = graph.GetBuffer(blob->GetID());
+        uint64_t    hash   = common::hash_bytes(buffer->data(), buffer->size());
+        common::hash_combine(hash, static_cast<size_t>(blob->GetDataType()));
+        common::hash_combine(hash, common::hash_value(blob->GetShape().GetDims()));
+
+        auto& candidates = visited_constants[hash];
+        auto  target     = common::find_if(candidates, [&](const DataBlob* candidate) {
+            const auto* candidate_buffer = graph.GetBuffer(candidate->GetID());
+            return candidate->GetDataType() == blob->GetDataType() && candidate->GetShape() == blob->GetShape() &&
+                   candidate_buffer->size() == buffer->size() && transforms::IsSameQuantParam(*candidate, *blob) &&
+                   memcmp(candidate_buffer->data(), buffer->data(), buffer->size()) == 0;
+        });
+        if (target == candidates.end()) {
+            candidates.push_back(blob);
+            continue;
+        }
+        graph.RedirectConsumers(blob, *target);
+        graph.EraseBlob(blob);
+        merged_constants++;
+    }
+    return merged_constants;
+}
+
+bool CommonSubexpressionElimination::IsEquivalent(const Operator& op1, const Operator& op2) {
+    if (op1.GetOpType() != op2.GetOpType() || op1.GetInputIDs() != op2.GetInputIDs() ||
+        op1.GetOutputIDs().size() != op2.GetOutputIDs().size() || op1.HasOption() != op2.HasOption()) {
+        return false;
+    }
+    return !op1.HasOption() || op1.GetBaseOption()->Equals(*op2.GetBaseOption());
+}
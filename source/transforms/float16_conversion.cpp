@@ -0,0 +1,125 @@
+#include "transforms/float16_conversion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+#include "common/half_utils.h"
+#include "common/parallel_utils.h"
+
+namespace {
+using ConvertedTensor = Float16Conversion::ConvertedTensor;
+
+// Elements per task, a large tensor is split into tasks of about this size.
+constexpr size_t task_elements = 1 << 20;
+// Elements converted back at once to measure the error.
+constexpr size_t error_block = 4096;
+constexpr float  float16_max = 65504.0f;
+
+struct ConversionJob {
+    DataBlob*             blob;
+    const float*          values;
+    size_t                size;
+    std::vector<uint16_t> halves;
+};
+
+// Elements [begin, end) of one job with the error statistics of its range.
+struct Task {
+    size_t job;
+    size_t begin;
+    size_t end;
+    float  abs_max   = 0.0f;
+    float  max_error = 0.0f;
+    double sum_error = 0.0;
+};
+
+void RunTask(ConversionJob& job, Task& task) {
+    common::float_to_half(job.values + task.begin, task.end - task.begin, job.halves.data() + task.begin);
+
+    float restored[error_block];
+    for (size_t begin = task.begin; begin < task.end; begin += error_block) {
+        size_t size = std::min(error_block, task.end - begin);
+        common::half_to_float(job.halves.data() + begin, size, restored);
+        for (size_t index = 0; index < size; index++) {
+            float error    = std::fabs(restored[index] - job.values[begin + index]);
+            task.abs_max   = std::max(task.abs_max, std::fabs(job.values[begin + index]));
+            task.max_error = std::max(task.max_error, error);
+            task.sum_error += error;
+        }
+    }
+}
+
+bool IsConvertible(const Graph& graph, const DataBlob& blob, uint64_t min_elements) {
+    const auto* buffer = graph.GetBuffer(blob.GetID());
+    return buffer != nullptr && blob.GetDataType() == DataType::FLOAT32 && !blob.HasSparsityParam() &&
+           buffer->size() / sizeof(float) >= min_elements && !graph.IsGraphOutput(blob.GetID());
+}
+
+void InsertDequantize(Graph& graph, DataBlob* blob, std::vector<uint16_t>& halves) {
+    auto* dequantized = graph.AddDataBlob(blob->GetName() + "_dequantized");
+    dequantized->SetDataType(DataType::FLOAT32);
+    dequantized->SetShape(blob->GetShape());
+    graph.RedirectConsumers(blob, dequantized);
+    graph.AddOperator(OperatorType::DEQUANTIZE, {blob}, {dequantized});
+
+    graph.SetBuffer(blob->GetID(), halves);
+    blob->SetDataType(DataType::FLOAT16);
+}
+}  // namespace
+
+std::vector<ConvertedTensor> Float16Conversion::Run(Graph&                          graph,
+                                                    const std::vector<std::string>& tensor_names,
+                                                    uint64_t                        min_elements,
+                                                    size_t                          num_threads) {
+    LOG(INFO) << "Float16Conversion::Run Start.";
+    std::unordered_set<std::string> selected(tensor_names.begin(), tensor_names.end());
+    std::vector<ConversionJob>      jobs;
+    for (auto* blob : graph.GetDataBlobs()) {
+        if (!selected.empty() && !selected.erase(blob->GetName())) {
+            continue;
+        }
+        if (IsConvertible(graph, *blob, tensor_names.empty() ? min_elements : 0)) {
+            const auto* buffer = graph.GetBuffer(blob->GetID());
+            jobs.push_back({blob, reinterpret_cast<const float*>(buffer->data()), buffer->size() / sizeof(float), {}});
+        }
+    }
+    REPORT_ERROR_IF(!selected.empty(), "Tensor `", *selected.begin(), "` is not found.");
+    // Blobs are stored in a hash map, sort them so that names of inserted blobs don't depend on it.
+    std::sort(jobs.begin(), jobs.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.blob->GetID() < rhs.blob->GetID(); });
+
+    std::vector<Task> tasks;
+    for (size_t index = 0; index < jobs.size(); index++) {
+        jobs[index].halves.resize(jobs[index].size);
+        for (size_t begin = 0; begin < jobs[index].size; begin += task_elements) {
+            tasks.push_back({index, begin, std::min(jobs[index].size, begin + task_elements)});
+        }
+    }
+    common::parallel_for(tasks.size(), num_threads == 0 ? common::default_num_threads() : num_threads,
+                         [&](size_t index) { RunTask(jobs[tasks[index].job], tasks[index]); });
+
+    // Tasks of one job are contiguous.
+    std::vector<ConvertedTensor> converted_tensors;
+    auto                         task = tasks.begin();
+    for (size_t index = 0; index < jobs.size(); index++) {
+        auto&  job       = jobs[index];
+        float  abs_max   = 0.0f;
+        float  max_error = 0.0f;
+        double sum_error = 0.0;
+        for (; task != tasks.end() && task->job == index; task++) {
+            abs_max   = std::max(abs_max, task->abs_max);
+            max_error = std::max(max_error, task->max_error);
+            sum_error += task->sum_error;
+        }
+        if (abs_max > float16_max) {
+            LOG(WARN) << "Keep `" << job.blob->GetName() << "` in float32, its values reach " << abs_max << ".";
+            continue;
+        }
+        converted_tensors.push_back({job.blob->GetName(), job.size, max_error,
+                                     job.size == 0 ? 0.0f : static_cast<float>(sum_error / job.size)});
+        InsertDequantize(graph, job.blob, job.halves);
+    }
+    LOG(INFO) << "Float16Conversion::Run End. Converted " << converted_tensors.size() << " of " << jobs.size()
+              << " tensors.";
+    return converted_tensors;
+}
@@ -0,0 +1,508 @@
+#include "transforms/full_integer_quantization.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+#include <utility>
+
+#include "transforms/transform_utils.h"
+#include "transforms/weight_quantization.h"
+
+namespace {
+using Range   = FullIntegerQuantization::Range;
+using Summary = FullIntegerQuantization::Summary;
+
+constexpr float int8_min = -128.0f;
+constexpr float int8_max = 127.0f;
+
+// How the int8 kernel of an operator constrains the parameters of its float32 tensors.
+enum class Rule {
+    UNSUPPORTED,  // no int8 kernel
+    CALIBRATED,   // outputs take their own ranges
+    SHARED,       // float32 inputs and outputs share one set of parameters, integer outputs just read them
+    FIXED,        // outputs take the parameters the kernel is written for
+};
+
+Rule GetRule(OperatorType op_type) {
+    switch (op_type) {
+        case OperatorType::ABS:
+        case OperatorType::ADD:
+        case OperatorType::BATCH_MATMUL:
+        case OperatorType::CONV2D:
+        case OperatorType::DEPTHWISE_CONV2D:
+        case OperatorType::ELU:
+        case OperatorType::EXP:
+        case OperatorType::FULLY_CONNECTED:
+        case OperatorType::GELU:
+        case OperatorType::HARDSWISH:
+        case OperatorType::LEAKY_RELU:
+        case OperatorType::MEAN:
+        case OperatorType::MUL:
+        case OperatorType::NEG:
+        case OperatorType::PReLU:
+        case OperatorType::REDUCE_PROD:
+        case OperatorType::ReLU:
+        case OperatorType::ReLU1:
+        case OperatorType::ReLU6:
+        case OperatorType::RSQRT:
+        case OperatorType::SQUARED_DIFFERENCE:
+        case OperatorType::SUB:
+        case OperatorType::SUM:
+        case OperatorType::TRANSPOSE_CONV2D:
+            return Rule::CALIBRATED;
+        case OperatorType::ARGMAX:
+        case OperatorType::ARGMIN:
+        case OperatorType::AVERAGE_POOL:
+        case OperatorType::BATCH_TO_SPACE_ND:
+        case OperatorType::BROADCAST_TO:
+        case OperatorType::CONCAT:
+        case OperatorType::DEPTH_TO_SPACE:
+        case OperatorType::EXPAND_DIMS:
+        case OperatorType::GATHER:
+        case OperatorType::GATHER_ND:
+        case OperatorType::MAX_POOL:
+        case OperatorType::MAXIMUM:
+        case OperatorType::MINIMUM:
+        case OperatorType::MIRROR_PAD:
+        case OperatorType::PACK:
+        case OperatorType::PAD:
+        case OperatorType::PADV2:
+        case OperatorType::REDUCE_MAX:
+        case OperatorType::REDUCE_MIN:
+        case OperatorType::RESHAPE:
+        case OperatorType::RESIZE_BILINEAR:
+        case OperatorType::RESIZE_NEAREST_NEIGHBOR:
+        case OperatorType::REVERSEV2:
+        case OperatorType::SHAPE:
+        case OperatorType::SLICE:
+        case OperatorType::SPACE_TO_BATCH_ND:
+        case OperatorType::SPACE_TO_DEPTH:
+        case OperatorType::SPLIT:
+        case OperatorType::SPLITV:
+        case OperatorType::SQUEEZE:
+        case OperatorType::STRIDED_SLICE:
+        case OperatorType::TILE:
+        case OperatorType::TRANSPOSE:
+        case OperatorType::UNPACK:
+            return Rule::SHARED;
+        case OperatorType::L2_NORMALIZATION:
+        case OperatorType::LOG_SOFTMAX:
+        case OperatorType::LOGISTIC:
+        case OperatorType::SOFTMAX:
+        case OperatorType::TANH:
+            return Rule::FIXED;
+        default:
+            return Rule::UNSUPPORTED;
+    }
+}
+
+// Asymmetric int8 parameters, `min` and `max` being the float values of -128 and 127.
+struct Param {
+    float   scale;
+    int64_t zero_point;
+    float   min;
+    float   max;
+};
+
+// The range is widened to hold 0, so that zero padding and ReLU thresholds are exact.
+Param GetParam(float min, float max) {
+    min                = std::min(min, 0.0f);
+    max                = std::max(max, 0.0f);
+    float   scale      = max > min ? (max - min) / (int8_max - int8_min) : 1.0f;
+    int64_t zero_point = static_cast<int64_t>(std::round(int8_min - min / scale));
+    zero_point         = std::min<int64_t>(std::max<int64_t>(zero_point, -128), 127);
+    return {scale, zero_point, (int8_min - zero_point) * scale, (int8_max - zero_point) * scale};
+}
+
+// Output parameters of kernels written for a fixed output range.
+Param GetFixedParam(OperatorType op_type) {
+    switch (op_type) {
+        // [0, 1)
+        case OperatorType::LOGISTIC:
+        case OperatorType::SOFTMAX:
+            return {1.0f / 256, -128, 0.0f, 255.0f / 256};
+        // [-16, 0]
+        case OperatorType::LOG_SOFTMAX:
+            return {16.0f / 256, 127, -255.0f * 16 / 256, 0.0f};
+        // [-1, 1)
+        default:
+            return {1.0f / 128, 0, -1.0f, 127.0f / 128};
+    }
+}
+
+void SetQuantParam(DataBlob& blob, const Param& param) {
+    auto& quant_param       = blob.HasQuantParam() ? blob.GetQuantParam() : blob.CreateQuantParam();
+    quant_param             = DataBlob::QuantParam();
+    quant_param.min         = param.min;
+    quant_param.max         = param.max;
+    quant_param.scales      = {param.scale};
+    quant_param.zero_points = {param.zero_point};
+}
+
+bool IsFloat32(const DataBlob* blob) { return blob != nullptr && blob->GetDataType() == DataType::FLOAT32; }
+
+bool IsConstant(const Graph& graph, const DataBlob& blob) { return graph.GetBuffer(blob.GetID()) != nullptr; }
+
+std::vector<float> ReadFloats(const Graph& graph, const DataBlob& blob) {
+    REPORT_ERROR_IF(blob.HasSparsityParam(), "`", blob.GetName(), "` is sparse, it can't be quantized.");
+    const auto*        buffer = graph.GetBuffer(blob.GetID());
+    std::vector<float> values(buffer->size() / sizeof(float));
+    memcpy(values.data(), buffer->data(), values.size() * sizeof(float));
+    return values;
+}
+
+Range GetDataRange(const std::vector<float>& values) {
+    if (values.empty()) {
+        return {0.0f, 0.0f};
+    }
+    auto [min, max] = std::minmax_element(values.begin(), values.end());
+    return {*min, *max};
+}
+
+void QuantizeConstant(Graph& graph, DataBlob& blob, const Param& param) {
+    auto                values = ReadFloats(graph, blob);
+    std::vector<int8_t> quantized(values.size());
+    for (size_t index = 0; index < values.size(); index++) {
+        float value      = std::round(values[index] / param.scale) + param.zero_point;
+        quantized[index] = static_cast<int8_t>(std::min(std::max(value, int8_min), int8_max));
+    }
+    graph.SetBuffer(blob.GetID(), quantized);
+    blob.SetDataType(DataType::INT8);
+    SetQuantParam(blob, param);
+}
+
+// Tensors sharing quantization parameters, merged by union-find over blob ids.
+class TensorGroups {
+ public:
+    BLOBID_T Find(BLOBID_T blob_id) {
+        auto parent = parents_.try_emplace(blob_id, blob_id).first->second;
+        if (parent == blob_id) {
+            return blob_id;
+        }
+        auto root         = Find(parent);
+        parents_[blob_id] = root;
+        return root;
+    }
+
+    void Merge(BLOBID_T from, BLOBID_T to) {
+        auto root            = Find(to);
+        parents_[Find(from)] = root;
+    }
+
+ private:
+    std::unordered_map<BLOBID_T, BLOBID_T> parents_;
+};
+
+// Calibrated range of a group, or the fixed parameters of the kernel producing it.
+struct GroupParam {
+    bool        has_range = false;
+    bool        fixed     = false;
+    float       min       = 0.0f;
+    float       max       = 0.0f;
+    std::string unranged;      // a member without range, reported if no member has one
+    std::string fixed_output;  // the member whose kernel fixes the parameters
+    Param       param;
+
+    void Widen(const std::string& name, const Range& range) {
+        REPORT_ERROR_IF(!std::isfinite(range.min) || !std::isfinite(range.max) || range.min > range.max, "Range [",
+                        range.min, ", ", range.max, "] of `", name, "` is invalid.");
+        min       = has_range ? std::min(min, range.min) : range.min;
+        max       = has_range ? std::max(max, range.max) : range.max;
+        has_range = true;
+    }
+};
+
+std::string GetOutputName(const Operator& op) {
+    return op.GetOutputIDs().empty() || op.GetOutputBlob(0) == nullptr ? "" : op.GetOutputBlob(0)->GetName();
+}
+
+bool IsWeightsInput(OperatorType op_type, size_t index) {
+    return index == 1 && (op_type == OperatorType::CONV2D || op_type == OperatorType::DEPTHWISE_CONV2D ||
+                          op_type == OperatorType::FULLY_CONNECTED || op_type == OperatorType::TRANSPOSE_CONV2D ||
+                          op_type == OperatorType::BATCH_MATMUL);
+}
+
+bool IsBiasInput(OperatorType op_type, size_t index) {
+    return (index == 2 && (op_type == OperatorType::CONV2D || op_type == OperatorType::DEPTHWISE_CONV2D ||
+                           op_type == OperatorType::FULLY_CONNECTED)) ||
+           (index == 3 && op_type == OperatorType::TRANSPOSE_CONV2D);
+}
+
+// Biases hold one value per output channel, i.e. per channel of the weights.
+void CheckBias(const Graph& graph, const Operator& op, const DataBlob& bias) {
+    const auto& dims     = op.GetInputBlob(1)->GetShape().GetDims();
+    size_t      values   = graph.GetBuffer(bias.GetID())->size() / sizeof(float);
+    bool        is_dw    = op.GetOpType() == OperatorType::DEPTHWISE_CONV2D;
+    size_t      channels = dims.empty() ? 0 : static_cast<size_t>(is_dw ? dims.back() : dims[0]);
+    REPORT_ERROR_IF(values != channels, "Bias `", bias.GetName(), "` of `", GetOutputName(op), "` has ", values,
+                    " values for ", channels, " output channels.");
+}
+
+// A bias read by several operators, e.g. merged by CSE, is copied for `op`, its scales follow the input of `op`.
+void CopyBias(Graph& graph, Operator& op, size_t index) {
+    auto* bias = op.GetInputBlob(index);
+    auto* copy = graph.AddDataBlob(bias->GetName() + "_" + GetOutputName(op));
+    copy->SetDataType(DataType::FLOAT32);
+    copy->SetShape(bias->GetShape());
+    graph.SetBuffer(copy->GetID(), std::vector<uint8_t>(*graph.GetBuffer(bias->GetID())));
+    op.SetInputBlob(index, copy);
+    bias->RemoveConsumer(&op);
+    copy->AddConsumer(&op);
+    transforms::EraseBlobIfUnused(graph, bias);
+}
+
+// Bias of weights left to this pass, i.e. shared ones quantized per tensor, with scales input_scale * weight_scale.
+void QuantizeBias(Graph& graph, Operator& op, DataBlob& bias) {
+    const auto* input   = op.GetInputBlob(op.GetOpType() == OperatorType::TRANSPOSE_CONV2D ? 2 : 0);
+    const auto* weights = op.GetInputBlob(1);
+    REPORT_ERROR_IF(bias.GetConsumers().size() != 1 || !input->HasQuantParam() || !weights->HasQuantParam(),
+                    "Bias `", bias.GetName(), "` of `", GetOutputName(op),
+                    "` can't be quantized, it's shared between operators or its weights aren't quantized.");
+    auto        values        = ReadFloats(graph, bias);
+    const auto& weight_scales = weights->GetQuantParam().scales;
+    auto        input_scale   = input->GetQuantParam().scales[0];
+    bool        per_tensor    = weight_scales.size() == 1;
+    REPORT_ERROR_IF(!per_tensor && weight_scales.size() != values.size(), "Bias `", bias.GetName(),
+                    "` doesn't match the channels of its weights.");
+
+    std::vector<float>   scales(values.size());
+    std::vector<int32_t> quantized(values.size());
+    for (size_t index = 0; index < values.size(); index++) {
+        scales[index]    = input_scale * weight_scales[per_tensor ? 0 : index];
+        quantized[index] = static_cast<int32_t>(std::round(values[index] / scales[index]));
+    }
+    graph.SetBuffer(bias.GetID(), quantized);
+    bias.SetDataType(DataType::INT32);
+    auto& quant_param       = bias.HasQuantParam() ? bias.GetQuantParam() : bias.CreateQuantParam();
+    quant_param             = DataBlob::QuantParam();
+    quant_param.scales      = scales;
+    quant_param.zero_points = std::vector<int64_t>(values.size(), 0);
+}
+
+// Float32 constants WeightQuantization left alone: shared weights become symmetric per tensor, their biases int32,
+// and operands like PReLU alpha or MUL factors asymmetric per tensor from their own values.
+uint32_t QuantizeConstants(Graph& graph, const std::vector<Operator*>& ops) {
+    uint32_t constants = 0;
+    for (auto* op : ops) {
+        for (size_t index = 0; index < op->GetInputIDs().size(); index++) {
+            auto* blob = op->GetInputBlob(index);
+            if (!IsFloat32(blob) || !IsConstant(graph, *blob)) {
+                continue;
+            }
+            if (IsBiasInput(op->GetOpType(), index)) {
+                QuantizeBias(graph, *op, *blob);
+            } else if (IsWeightsInput(op->GetOpType(), index)) {
+                auto  range   = GetDataRange(ReadFloats(graph, *blob));
+                float abs_max = std::max(std::fabs(range.min), std::fabs(range.max));
+                float scale   = abs_max > 0.0f ? abs_max / int8_max : 1.0f;
+                QuantizeConstant(graph, *blob, {scale, 0, -int8_max * scale, int8_max * scale});
+            } else {
+                auto range = GetDataRange(ReadFloats(graph, *blob));
+                QuantizeConstant(graph, *blob, GetParam(range.min, range.max));
+            }
+            constants++;
+        }
+    }
+    return constants;
+}
+
+// Internal int8 twin of a graph input or output, which keeps its name and float32 type.
+DataBlob* AddTwin(Graph& graph, const DataBlob& blob) {
+    auto* twin = graph.AddDataBlob(blob.GetName() + "_int8");
+    twin->SetDataType(DataType::FLOAT32);
+    twin->SetShape(blob.GetShape());
+    return twin;
+}
+
+void FixOptions(const std::vector<Operator*>& ops) {
+    for (auto* op : ops) {
+        switch (op->GetOpType()) {
+            // Power-of-two scales are an int16 kernel path, int8 kernels take any scales.
+            case OperatorType::ADD:
+                op->GetOption<AddOption>()->pot_scale_int16 = false;
+                break;
+            case OperatorType::SUB:
+                op->GetOption<SubOption>()->pot_scale_int16 = false;
+                break;
+            // Only hybrid kernels quantize float inputs on the fly.
+            case OperatorType::FULLY_CONNECTED:
+                op->GetOption<FullyConnectedOption>()->asym_quantize_inputs = false;
+                break;
+            case OperatorType::BATCH_MATMUL:
+                op->GetOption<BatchMatmulOption>()->asym_quantize_inputs = false;
+                break;
+            default:
+                break;
+        }
+    }
+}
+}  // namespace
+
+Summary FullIntegerQuantization::Run(Graph&                                        graph,
+                                     const std::unordered_map<std::string, Range>& ranges,
+                                     size_t                                        num_threads) {
+    LOG(INFO) << "FullIntegerQuantization::Run Start.";
+    auto ops = graph.TopologicalSort();
+
+    // Check kernels and group tensors sharing parameters before anything changes.
+    TensorGroups                              groups;
+    std::vector<DataBlob*>                    activations;
+    std::vector<DataBlob*>                    shared_constants;
+    std::unordered_set<BLOBID_T>              seen;
+    std::vector<std::pair<BLOBID_T, Param>>   fixed_outputs;
+    std::vector<std::pair<Operator*, size_t>> shared_biases;  // bias inputs read by other operators too
+    for (auto* op : ops) {
+        std::vector<DataBlob*> floats;
+        for (auto* blob : op->GetInputBlobs()) {
+            if (IsFloat32(blob)) {
+                floats.push_back(blob);
+            }
+        }
+        size_t num_inputs = floats.size();
+        for (auto* blob : op->GetOutputBlobs()) {
+            if (IsFloat32(blob)) {
+                floats.push_back(blob);
+            }
+        }
+        if (floats.empty()) {
+            continue;
+        }
+        auto rule = GetRule(op->GetOpType());
+        REPORT_ERROR_IF(rule == Rule::UNSUPPORTED, ToStr(op->GetOpType()), " producing `", GetOutputName(*op),
+                        "` has no int8 kernel, the graph can't be fully quantized.");
+        for (size_t index = 0; index < op->GetInputIDs().size(); index++) {
+            auto* bias = op->GetInputBlob(index);
+            if (IsBiasInput(op->GetOpType(), index) && IsFloat32(bias) && IsConstant(graph, *bias)) {
+                CheckBias(graph, *op, *bias);
+                if (bias->GetConsumers().size() > 1) {
+                    shared_biases.emplace_back(op, index);
+                }
+            }
+        }
+        for (size_t index = 0; index < floats.size(); index++) {
+            auto* blob     = floats[index];
+            bool  constant = IsConstant(graph, *blob);
+            if (constant && rule != Rule::SHARED) {
+                continue;
+            }
+            if (seen.insert(blob->GetID()).second) {
+                (constant ? shared_constants : activations).push_back(blob);
+            }
+            if (rule == Rule::SHARED) {
+                groups.Merge(blob->GetID(), floats[0]->GetID());
+            } else if (rule == Rule::FIXED && index >= num_inputs) {
+                fixed_outputs.emplace_back(blob->GetID(), GetFixedParam(op->GetOpType()));
+            }
+        }
+    }
+
+    // Fixed parameters are kept only for tensors computed from fixed outputs alike, e.g. a LOGISTIC output reshaped or
+    // pooled. A calibrated tensor in the group, or fixed outputs of other parameters, would need requantizing.
+    std::unordered_map<BLOBID_T, GroupParam> group_params;
+    for (const auto& [blob_id, param] : fixed_outputs) {
+        auto&       group_param = group_params[groups.Find(blob_id)];
+        const auto& name        = graph.GetDataBlob(blob_id)->GetName();
+        REPORT_ERROR_IF(group_param.fixed && (group_param.param.scale != param.scale ||
+                                              group_param.param.zero_point != param.zero_point),
+                        "`", group_param.fixed_output, "` and `", name,
+                        "` share parameters, but their kernels fix different ones.");
+        group_param.fixed        = true;
+        group_param.fixed_output = name;
+        group_param.param        = param;
+    }
+    for (auto* blob : activations) {
+        auto& group_param = group_params[groups.Find(blob->GetID())];
+        auto* producer    = blob->GetProducer();
+        REPORT_ERROR_IF(group_param.fixed &&
+                            (producer == nullptr || GetRule(producer->GetOpType()) == Rule::CALIBRATED),
+                        "`", blob->GetName(), "` shares parameters with `", group_param.fixed_output,
+                        "`, which are fixed by its kernel.");
+        auto range = ranges.find(blob->GetName());
+        if (range != ranges.end()) {
+            group_param.Widen(blob->GetName(), range->second);
+        } else if (group_param.unranged.empty()) {
+            group_param.unranged = blob->GetName();
+        }
+    }
+    for (auto* blob : shared_constants) {
+        auto& group_param = group_params[groups.Find(blob->GetID())];
+        auto  range       = GetDataRange(ReadFloats(graph, *blob));
+        // A step of tolerance, so that e.g. 1 fits into [0, 255 / 256].
+        const auto& param = group_param.param;
+        REPORT_ERROR_IF(group_param.fixed &&
+                            (range.min < param.min - param.scale || range.max > param.max + param.scale),
+                        "Values of `", blob->GetName(), "` don't fit into the parameters of `",
+                        group_param.fixed_output, "`, which are fixed by its kernel.");
+        group_param.Widen(blob->GetName(), range);
+    }
+    for (auto& [root, group_param] : group_params) {
+        if (!group_param.fixed) {
+            REPORT_ERROR_IF(!group_param.has_range, "No calibration range for `", group_param.unranged, "`.");
+            group_param.param = GetParam(group_param.min, group_param.max);
+        }
+    }
+
+    for (const auto& [op, index] : shared_biases) {
+        CopyBias(graph, *op, index);
+    }
+
+    // Graph inputs and outputs stay float32, their consumers and producers move to int8 twins.
+    Summary                      summary {};
+    std::unordered_set<BLOBID_T> boundaries;
+    for (auto blob_id : graph.GetGraphInputs()) {
+        auto* input = graph.GetDataBlob(blob_id);
+        if (input == nullptr || !IsFloat32(input) || IsConstant(graph, *input) || !seen.count(blob_id)) {
+            continue;
+        }
+        auto* quantized = AddTwin(graph, *input);
+        graph.RedirectConsumers(input, quantized);
+        graph.AddOperator(OperatorType::QUANTIZE, {input}, {quantized});
+        groups.Merge(quantized->GetID(), blob_id);
+        activations.push_back(quantized);
+        boundaries.insert(blob_id);
+        summary.quantize_ops++;
+    }
+    for (auto blob_id : graph.GetGraphOutputs()) {
+        auto* output   = graph.GetDataBlob(blob_id);
+        auto* producer = output == nullptr ? nullptr : output->GetProducer();
+        if (producer == nullptr || !IsFloat32(output) || !seen.count(blob_id) || boundaries.count(blob_id)) {
+            continue;
+        }
+        auto*       quantized  = AddTwin(graph, *output);
+        const auto& output_ids = producer->GetOutputIDs();
+        producer->SetOutputBlob(std::find(output_ids.begin(), output_ids.end(), blob_id) - output_ids.begin(),
+                                quantized);
+        quantized->SetProducer(producer);
+        output->ResetProducer();
+        graph.RedirectConsumers(output, quantized);
+        graph.AddOperator(OperatorType::DEQUANTIZE, {quantized}, {output});
+        groups.Merge(quantized->GetID(), blob_id);
+        activations.push_back(quantized);
+        boundaries.insert(blob_id);
+        summary.dequantize_ops++;
+    }
+
+    for (auto* blob : activations) {
+        if (!boundaries.count(blob->GetID())) {
+            blob->SetDataType(DataType::INT8);
+            SetQuantParam(*blob, group_params.at(groups.Find(blob->GetID())).param);
+            summary.activations++;
+        }
+    }
+    for (auto* blob : shared_constants) {
+        QuantizeConstant(graph, *blob, group_params.at(groups.Find(blob->GetID())).param);
+        summary.constants++;
+    }
+
+    // Inputs are quantized per tensor now, so WeightQuantization turns biases into int32 along with the weights.
+    summary.weights = WeightQuantization::Run(graph, {}, DataType::INT8, 0, num_threads).size();
+    summary.constants += QuantizeConstants(graph, ops);
+    FixOptions(ops);
+
+    LOG(INFO) << "FullIntegerQuantization::Run End. Quantized " << summary.activations << " activations, "
+              << summary.weights << " weights and " << summary.constants << " other constants, inserted "
+              << summary.quantize_ops << " QUANTIZE and " << summary.dequantize_ops << " DEQUANTIZE.";
+    return summary;
+}
@@ -0,0 +1,325 @@
+#include "transforms/low_rank_factorization.h"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+
+#include "analysis/cost_model.h"
+#include "common/parallel_utils.h"
+#include "common/symmetric_eigen.h"
+#include "transforms/transform_utils.h"
+
+namespace {
+using FactorizedLayer = LowRankFactorization::FactorizedLayer;
+
+// Rows of the Gram matrix computed by one task.
+constexpr size_t gram_block = 16;
+// Bytes of the copies of W and Gram matrices held by one batch of layers, a larger layer forms a batch of its own.
+constexpr size_t batch_bytes = size_t(256) << 20;
+
+// Weights of an operator as W [m, n], and M, the orientation of W with the shorter side first.
+struct Layer {
+    Operator*           op;
+    DataBlob*           weights;
+    size_t              m;
+    size_t              n;
+    bool                shorter_rows;  // whether M is W rather than W^T
+    std::vector<float>  matrix;        // M [short_side, long_side]
+    std::vector<double> gram;          // M M^T, overwritten with its eigenvectors
+    std::vector<double> eigenvalues;   // squared singular values of W in descending order
+    FactorizedLayer     report;
+};
+
+bool IsFloat32(const DataBlob* blob) { return blob != nullptr && blob->GetDataType() == DataType::FLOAT32; }
+
+// The weights are an owned dense float32 constant of rank 2, read as W [m, n] directly or, for BATCH_MATMUL without
+// adj_y, transposed. BATCH_MATMUL with adj_x multiplies the transposed activation, which a FULLY_CONNECTED can't.
+bool IsFactorizable(const Graph& graph, const Operator& op, bool& transposed) {
+    auto op_type = op.GetOpType();
+    if ((op_type != OperatorType::FULLY_CONNECTED && op_type != OperatorType::BATCH_MATMUL) ||
+        op.GetInputIDs().size() < 2 || op.GetOutputIDs().empty()) {
+        return false;
+    }
+    const auto* input   = op.GetInputBlob(0);
+    const auto* weights = op.GetInputBlob(1);
+    const auto* output  = op.GetOutputBlob(0);
+    if (!IsFloat32(input) || !IsFloat32(weights) || !IsFloat32(output) || output->GetShape().GetDims().empty() ||
+        weights->HasSparsityParam() || weights->GetConsumers().size() != 1) {
+        return false;
+    }
+    const auto& dims   = weights->GetShape().GetDims();
+    const auto* buffer = graph.GetBuffer(weights->GetID());
+    if (buffer == nullptr || dims.size() != 2 || dims[0] <= 0 || dims[1] <= 0 ||
+        buffer->size() != static_cast<size_t>(dims[0]) * dims[1] * sizeof(float)) {
+        return false;
+    }
+    transposed = false;
+    if (op_type == OperatorType::BATCH_MATMUL) {
+        const auto* option = op.GetOption<BatchMatmulOption>();
+        if (option->adj_x || op.GetInputIDs().size() != 2) {
+            return false;
+        }
+        transposed = !option->adj_y;
+    }
+    return true;
+}
+
+Operator* FindFactorizableOperator(const Graph& graph, const std::string& op_output, bool& transposed) {
+    const DataBlob* output = nullptr;
+    for (const auto* blob : graph.GetDataBlobs()) {
+        if (blob->GetName() == op_output) {
+            output = blob;
+            break;
+        }
+    }
+    REPORT_ERROR_IF(output == nullptr, "`", op_output, "` doesn't exist. Please check tensor's name.");
+    auto* op = output->GetProducer();
+    REPORT_ERROR_IF(op == nullptr || op->GetOutputBlob(0) != output || !IsFactorizable(graph, *op, transposed), "`",
+                    op_output,
+                    "` isn't the float32 output of a FULLY_CONNECTED or BATCH_MATMUL operator with 2-D float32 "
+                    "constant weights read by it only.");
+    return op;
+}
+
+// M as float32 and M M^T as double.
+size_t GetLayerBytes(const Operator& op) {
+    const auto& dims = op.GetInputBlob(1)->GetShape().GetDims();
+    size_t      d    = std::min(dims[0], dims[1]);
+    return static_cast<size_t>(dims[0]) * dims[1] * sizeof(float) + d * d * sizeof(double);
+}
+
+Layer CreateLayer(const Graph& graph, Operator* op, bool transposed) {
+    Layer layer;
+    layer.op           = op;
+    layer.weights      = op->GetInputBlob(1);
+    const auto& dims   = layer.weights->GetShape().GetDims();
+    layer.m            = transposed ? dims[1] : dims[0];
+    layer.n            = transposed ? dims[0] : dims[1];
+    layer.shorter_rows = layer.m <= layer.n;
+
+    // The buffer holds W, or W^T if transposed; M is copied as is when it's the same orientation.
+    const auto* values = reinterpret_cast<const float*>(graph.GetBuffer(layer.weights->GetID())->data());
+    size_t      rows   = dims[0];
+    size_t      cols   = dims[1];
+    layer.matrix.resize(rows * cols);
+    if (layer.shorter_rows != transposed) {
+        std::copy(values, values + rows * cols, layer.matrix.begin());
+    } else {
+        for (size_t row = 0; row < rows; row++) {
+            for (size_t col = 0; col < cols; col++) {
+                layer.matrix[col * rows + row] = values[row * cols + col];
+            }
+        }
+    }
+
+    auto& report           = layer.report;
+    report.op_output       = op->GetOutputBlob(0)->GetName();
+    report.op_type         = op->GetOpType();
+    report.output_channels = layer.m;
+    report.input_channels  = layer.n;
+    report.original_params = layer.m * layer.n;
+    report.original_macs   = CostModel::EstimateOperator(graph, *op).macs;
+    return layer;
+}
+
+// Upper triangle by blocks of rows on the threads, then mirrored.
+void ComputeGram(Layer& layer, size_t num_threads) {
+    size_t d = std::min(layer.m, layer.n);
+    size_t l = std::max(layer.m, layer.n);
+    layer.gram.assign(d * d, 0.0);
+    common::parallel_for((d + gram_block - 1) / gram_block, num_threads, [&](size_t block) {
+        for (size_t i = block * gram_block; i < std::min(d, (block + 1) * gram_block); i++) {
+            const float* row_i = layer.matrix.data() + i * l;
+            for (size_t j = i; j < d; j++) {
+                const float* row_j = layer.matrix.data() + j * l;
+                double       dot   = 0.0;
+                for (size_t k = 0; k < l; k++) {
+                    dot += static_cast<double>(row_i[k]) * row_j[k];
+                }
+                layer.gram[i * d + j] = dot;
+            }
+        }
+    });
+    for (size_t i = 0; i < d; i++) {
+        for (size_t j = 0; j < i; j++) {
+            layer.gram[i * d + j] = layer.gram[j * d + i];
+        }
+    }
+}
+
+// Least rank keeping `energy_threshold` of the energy, at least 1.
+void ChooseRank(Layer& layer, double energy_threshold) {
+    double total = 0.0;
+    for (auto eigenvalue : layer.eigenvalues) {
+        total += std::max(eigenvalue, 0.0);
+    }
+    size_t rank     = 0;
+    double retained = 0.0;
+    while (rank < layer.eigenvalues.size() && (rank == 0 || retained < energy_threshold * total)) {
+        retained += std::max(layer.eigenvalues[rank++], 0.0);
+    }
+
+    // MACs of a matmul are rows x m x n, the factorized pair takes rows x r x (m + n).
+    auto&    report          = layer.report;
+    uint64_t params          = rank * (layer.m + layer.n);
+    report.rank              = rank;
+    report.retained_energy   = total > 0.0 ? retained / total : 1.0;
+    report.factorized        = params < report.original_params;
+    report.factorized_params = report.factorized ? params : report.original_params;
+    report.factorized_macs =
+        report.factorized ? report.original_macs / report.original_params * params : report.original_macs;
+}
+
+DataBlob* AddFloatBlob(Graph& graph, const std::string& name, const std::vector<int>& dims) {
+    auto* blob = graph.AddDataBlob(name);
+    blob->SetDataType(DataType::FLOAT32);
+    blob->SetShape(Shape(dims));
+    return blob;
+}
+
+// P = U_r^T M by rows on the threads, then W = U_r P if M is W, or W = P^T U_r^T if M is W^T.
+void Factorize(Graph& graph, Layer& layer, size_t num_threads) {
+    size_t              d    = std::min(layer.m, layer.n);
+    size_t              l    = std::max(layer.m, layer.n);
+    size_t              rank = layer.report.rank;
+    std::vector<double> projection(rank * l, 0.0);
+    common::parallel_for(rank, num_threads, [&](size_t k) {
+        double* row = projection.data() + k * l;
+        for (size_t i = 0; i < d; i++) {
+            double       u      = layer.gram[k * d + i];
+            const float* values = layer.matrix.data() + i * l;
+            for (size_t index = 0; index < l; index++) {
+                row[index] += u * values[index];
+            }
+        }
+    });
+
+    // A [m, r] feeds the second operator, B [r, n] the first one.
+    std::vector<float> a(layer.m * rank);
+    std::vector<float> b(rank * layer.n);
+    for (size_t k = 0; k < rank; k++) {
+        for (size_t i = 0; i < layer.m; i++) {
+            a[i * rank + k] = layer.shorter_rows ? layer.gram[k * d + i] : projection[k * l + i];
+        }
+        for (size_t j = 0; j < layer.n; j++) {
+            b[k * layer.n + j] = layer.shorter_rows ? projection[k * l + j] : layer.gram[k * d + j];
+        }
+    }
+
+    auto* op     = layer.op;
+    auto* input  = op->GetInputBlob(0);
+    auto* output = op->GetOutputBlob(0);
+    auto  name   = layer.weights->GetName();
+    auto* first  = AddFloatBlob(graph, name + "_lowrank0", {static_cast<int>(rank), static_cast<int>(layer.n)});
+    auto* second = AddFloatBlob(graph, name + "_lowrank1", {static_cast<int>(layer.m), static_cast<int>(rank)});
+    auto  dims   = output->GetShape().GetDims();
+    dims.back()  = rank;
+    auto* hidden = AddFloatBlob(graph, output->GetName() + "_lowrank", dims);
+    graph.SetBuffer(first->GetID(), b);
+    graph.SetBuffer(second->GetID(), a);
+
+    // BATCH_MATMUL keeps the batch dims of its activation, FULLY_CONNECTED keeps its own option.
+    bool                   is_fc         = op->GetOpType() == OperatorType::FULLY_CONNECTED;
+    bool                   keep_num_dims = !is_fc || op->GetOption<FullyConnectedOption>()->keep_num_dims;
+    auto                   option        = is_fc ? op->GetBaseOption()->Clone() : nullptr;
+    std::vector<DataBlob*> second_inputs = {hidden, second};
+    if (is_fc && op->GetInputIDs().size() > 2 && op->GetInputBlob(2) != nullptr) {
+        second_inputs.push_back(op->GetInputBlob(2));
+    }
+    graph.RemoveOperator(op);
+
+    auto* first_op                = graph.AddOperator(OperatorType::FULLY_CONNECTED, {input, first}, {hidden});
+    auto* first_option            = first_op->GetOption<FullyConnectedOption>();
+    first_option->keep_num_dims   = keep_num_dims;
+    first_option->activation_type = OperatorType::NONE;
+    auto* second_op               = graph.AddOperator(OperatorType::FULLY_CONNECTED, second_inputs, {output});
+    if (option != nullptr) {
+        second_op->SetOption(std::move(option));
+    } else {
+        auto* second_option            = second_op->GetOption<FullyConnectedOption>();
+        second_option->keep_num_dims   = keep_num_dims;
+        second_option->activation_type = OperatorType::NONE;
+    }
+    transforms::EraseBlobIfUnused(graph, layer.weights);
+}
+}  // namespace
+
+std::vector<LowRankFactorization::FactorizedLayer> LowRankFactorization::Run(Graph&                          graph,
+                                                                             const std::vector<std::string>& op_outputs,
+                                                                             double energy_threshold,
+                                                                             size_t num_threads) {
+    LOG(INFO) << "LowRankFactorization::Run Start.";
+    REPORT_ERROR_IF(!(energy_threshold > 0.0 && energy_threshold <= 1.0), "Energy threshold ", energy_threshold,
+                    " should be in (0, 1].");
+    num_threads = num_threads == 0 ? common::default_num_threads() : num_threads;
+
+    // Every selection is checked before the graph changes.
+    std::vector<std::pair<Operator*, bool>> selected_ops;
+    std::set<std::string>                   selected;
+    for (const auto& op_output : op_outputs) {
+        REPORT_ERROR_IF(!selected.insert(op_output).second, "`", op_output, "` is selected twice.");
+        bool  transposed = false;
+        auto* op         = FindFactorizableOperator(graph, op_output, transposed);
+        selected_ops.emplace_back(op, transposed);
+    }
+
+    // Layers are decomposed in batches of at most `num_threads` layers and `batch_bytes` of copies, so that memory
+    // doesn't grow with the number of layers. Gram matrices use all threads each, eigen decompositions are serial and
+    // run side by side.
+    std::vector<FactorizedLayer> reports;
+    uint64_t                     original_macs   = 0;
+    uint64_t                     factorized_macs = 0;
+    size_t                       factorized      = 0;
+    for (size_t begin = 0; begin < selected_ops.size();) {
+        std::vector<Layer> layers;
+        size_t             bytes = 0;
+        for (; begin < selected_ops.size() && layers.size() < num_threads; begin++) {
+            auto [op, transposed] = selected_ops[begin];
+            auto layer_bytes      = GetLayerBytes(*op);
+            if (!layers.empty() && bytes + layer_bytes > batch_bytes) {
+                break;
+            }
+            bytes += layer_bytes;
+            layers.push_back(CreateLayer(graph, op, transposed));
+        }
+        for (auto& layer : layers) {
+            ComputeGram(layer, num_threads);
+        }
+        common::parallel_for(layers.size(), num_threads, [&](size_t index) {
+            auto& layer       = layers[index];
+            layer.eigenvalues = common::symmetric_eigen(layer.gram, std::min(layer.m, layer.n));
+        });
+
+        for (auto& layer : layers) {
+            ChooseRank(layer, energy_threshold);
+            if (layer.report.factorized) {
+                Factorize(graph, layer, num_threads);
+                factorized++;
+            }
+            original_macs += layer.report.original_macs;
+            factorized_macs += layer.report.factorized_macs;
+            reports.push_back(layer.report);
+            // Release the copies right away rather than with the batch.
+            std::vector<float>().swap(layer.matrix);
+            std::vector<double>().swap(layer.gram);
+        }
+    }
+    LOG(INFO) << "LowRankFactorization::Run End. Factorized " << factorized << " of " << reports.size()
+              << " operators, MACs from " << original_macs << " to " << factorized_macs << ".";
+    return reports;
+}
+
+std::vector<std::string> LowRankFactorization::FindCandidates(const Graph& graph, uint64_t min_elements) {
+    std::vector<std::string> op_outputs;
+    for (const auto* op : graph.TopologicalSort()) {
+        bool transposed = false;
+        if (!IsFactorizable(graph, *op, transposed)) {
+            continue;
+        }
+        const auto& dims = op->GetInputBlob(1)->GetShape().GetDims();
+        if (static_cast<uint64_t>(dims[0]) * dims[1] >= min_elements) {
+            op_outputs.push_back(op->GetOutputBlob(0)->GetName());
+        }
+    }
+    return op_outputs;
+}
@@ -0,0 +1,340 @@
+#include "transforms/mixed_precision.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "common/half_utils.h"
+#include "common/parallel_utils.h"
+#include "transforms/float16_conversion.h"
+#include "transforms/weight_quantization.h"
+
+namespace {
+using Precision = MixedPrecision::Precision;
+using Choice    = MixedPrecision::Choice;
+using LayerPlan = MixedPrecision::LayerPlan;
+
+// Elements rounded to float16 at once.
+constexpr size_t error_block  = 4096;
+constexpr float  float16_max  = 65504.0f;
+constexpr double infinite_snr = std::numeric_limits<double>::infinity();
+
+// Weights of an operator viewed as [outer, channels, inner], every channel gets its own scale when quantized.
+struct Layer {
+    Operator*    op;
+    DataBlob*    weights;
+    const float* values;
+    size_t       outer;
+    size_t       channels;
+    size_t       inner;
+    bool         int4;  // whether kernels take int4 weights
+};
+
+// A precision of a layer, whose SNR is measured.
+struct Candidate {
+    size_t    layer;
+    Precision precision;
+    bool      feasible = true;
+    double    snr_db   = infinite_snr;
+};
+
+bool GetLayer(Graph& graph, Operator& op, uint64_t min_elements, Layer& layer) {
+    int   channel_axis = -1;
+    auto* weights      = WeightQuantization::GetFloatWeights(graph, op, DataType::INT8, channel_axis);
+    if (weights == nullptr) {
+        return false;
+    }
+    const auto& dims     = weights->GetShape().GetDims();
+    const auto* buffer   = graph.GetBuffer(weights->GetID());
+    size_t      elements = buffer->size() / sizeof(float);
+    if (elements == 0 || elements < min_elements || channel_axis >= static_cast<int>(dims.size())) {
+        return false;
+    }
+    int int4_axis  = -1;
+    layer.op       = &op;
+    layer.weights  = weights;
+    layer.values   = reinterpret_cast<const float*>(buffer->data());
+    layer.outer    = 1;
+    layer.channels = 1;
+    layer.inner    = elements;
+    layer.int4     = WeightQuantization::GetFloatWeights(graph, op, DataType::INT4, int4_axis) != nullptr;
+    if (channel_axis >= 0) {
+        layer.channels = dims[channel_axis];
+        for (int axis = 0; axis < channel_axis; axis++) {
+            layer.outer *= dims[axis];
+        }
+        layer.inner = elements / std::max<size_t>(1, layer.outer * layer.channels);
+    }
+    return layer.outer * layer.channels * layer.inner == elements;
+}
+
+double GetSnr(double signal, double noise) { return noise > 0.0 ? 10.0 * std::log10(signal / noise) : infinite_snr; }
+
+// Values beyond the float16 range make the choice infeasible, Float16Conversion leaves such weights alone.
+void MeasureFloat16(const Layer& layer, Candidate& candidate) {
+    size_t   size   = layer.outer * layer.channels * layer.inner;
+    double   signal = 0.0;
+    double   noise  = 0.0;
+    uint16_t halves[error_block];
+    float    restored[error_block];
+    for (size_t begin = 0; begin < size; begin += error_block) {
+        size_t       block  = std::min(error_block, size - begin);
+        const float* values = layer.values + begin;
+        common::float_to_half(values, block, halves);
+        common::half_to_float(halves, block, restored);
+        for (size_t index = 0; index < block; index++) {
+            if (!(std::fabs(values[index]) <= float16_max)) {
+                candidate.feasible = false;
+                return;
+            }
+            double error = static_cast<double>(restored[index]) - values[index];
+            signal += static_cast<double>(values[index]) * values[index];
+            noise += error * error;
+        }
+    }
+    candidate.snr_db = GetSnr(signal, noise);
+}
+
+// Symmetric quantization to [-quantized_max, quantized_max] with one scale per channel, rounded like
+// WeightQuantization.
+void MeasureInteger(const Layer& layer, float quantized_max, Candidate& candidate) {
+    double signal = 0.0;
+    double noise  = 0.0;
+    for (size_t channel = 0; channel < layer.channels; channel++) {
+        float abs_max = 0.0f;
+        for (size_t outer = 0; outer < layer.outer; outer++) {
+            const float* values = layer.values + (outer * layer.channels + channel) * layer.inner;
+            for (size_t index = 0; index < layer.inner; index++) {
+                abs_max = std::max(abs_max, std::fabs(values[index]));
+            }
+        }
+        float scale         = abs_max > 0.0f ? abs_max / quantized_max : 1.0f;
+        float inverse_scale = 1.0f / scale;
+        for (size_t outer = 0; outer < layer.outer; outer++) {
+            const float* values = layer.values + (outer * layer.channels + channel) * layer.inner;
+            for (size_t index = 0; index < layer.inner; index++) {
+                float  scaled = std::min(std::max(values[index] * inverse_scale, -quantized_max), quantized_max);
+                double error  = static_cast<double>(std::round(scaled)) * scale - values[index];
+                signal += static_cast<double>(values[index]) * values[index];
+                noise += error * error;
+            }
+        }
+    }
+    candidate.snr_db = GetSnr(signal, noise);
+}
+
+// Weight bytes of a choice, scales and zero points of quantized weights included.
+uint64_t GetWeightBytes(const Layer& layer, Precision precision) {
+    uint64_t elements     = layer.outer * layer.channels * layer.inner;
+    uint64_t scales_bytes = layer.channels * (sizeof(float) + sizeof(int64_t));
+    switch (precision) {
+        case Precision::FLOAT16:
+            return elements * 2;
+        case Precision::INT8:
+            return elements + scales_bytes;
+        case Precision::INT4:
+            return (elements + 1) / 2 + scales_bytes;
+        default:
+            return elements * sizeof(float);
+    }
+}
+
+// Roofline time of the operator reading weights of the choice. Integer kernels read int8 and int4 weights as they
+// are, but float16 weights are rebuilt by a DEQUANTIZE whose float32 output the operator reads, so float16 costs the
+// float32 operator plus the DEQUANTIZE.
+double GetSeconds(const Graph&               graph,
+                  const Layer&               layer,
+                  const CostModel::Roofline& roofline,
+                  Precision                  precision) {
+    auto cost = CostModel::EstimateOperator(graph, *layer.op);
+    if (precision == Precision::FLOAT16) {
+        uint64_t                elements = layer.outer * layer.channels * layer.inner;
+        CostModel::OperatorCost dequantize {nullptr, 0, elements, 0, elements * 2, elements * sizeof(float)};
+        return roofline.EstimateSeconds(cost) + roofline.EstimateSeconds(dequantize);
+    }
+    cost.weight_bytes += GetWeightBytes(layer, precision);
+    cost.weight_bytes -= std::min(cost.weight_bytes, GetWeightBytes(layer, Precision::FLOAT32));
+    return roofline.EstimateSeconds(cost);
+}
+
+// Rounding error power relative to the signal, 0 for float32.
+double GetNoise(const Choice& choice) {
+    return std::isinf(choice.snr_db) ? 0.0 : std::pow(10.0, -choice.snr_db / 10.0);
+}
+
+// From float32, step to smaller choices until the exceeded budgets are met. Every step saves weight bytes, so the
+// search ends.
+bool MeetBudget(std::vector<LayerPlan>& layers, const MixedPrecision::Budget& budget) {
+    while (true) {
+        uint64_t total_bytes   = 0;
+        double   total_seconds = 0.0;
+        for (const auto& layer : layers) {
+            total_bytes += layer.choices[layer.chosen].weight_bytes;
+            total_seconds += layer.choices[layer.chosen].seconds;
+        }
+        bool bytes_exceeded   = budget.max_weight_bytes > 0 && total_bytes > budget.max_weight_bytes;
+        bool seconds_exceeded = budget.max_seconds > 0.0 && total_seconds > budget.max_seconds;
+        if (!bytes_exceeded && !seconds_exceeded) {
+            return true;
+        }
+
+        double best_cost   = std::numeric_limits<double>::infinity();
+        size_t best_layer  = layers.size();
+        size_t best_choice = 0;
+        for (size_t index = 0; index < layers.size(); index++) {
+            const auto& layer   = layers[index];
+            const auto& current = layer.choices[layer.chosen];
+            for (size_t choice = 0; choice < layer.choices.size(); choice++) {
+                const auto& next = layer.choices[choice];
+                if (next.weight_bytes >= current.weight_bytes) {
+                    continue;
+                }
+                // Share of the exceeded budgets saved by the step.
+                double gain = 0.0;
+                if (bytes_exceeded) {
+                    gain += static_cast<double>(current.weight_bytes - next.weight_bytes) / budget.max_weight_bytes;
+                }
+                if (seconds_exceeded) {
+                    gain += (current.seconds - next.seconds) / budget.max_seconds;
+                }
+                if (gain <= 0.0) {
+                    continue;
+                }
+                double cost = (GetNoise(next) - GetNoise(current)) / gain;
+                if (cost < best_cost) {
+                    best_cost   = cost;
+                    best_layer  = index;
+                    best_choice = choice;
+                }
+            }
+        }
+        if (best_layer == layers.size()) {
+            return false;
+        }
+        layers[best_layer].chosen = best_choice;
+    }
+}
+}  // namespace
+
+const char* MixedPrecision::GetPrecisionName(Precision precision) {
+    switch (precision) {
+        case Precision::FLOAT16:
+            return "float16";
+        case Precision::INT8:
+            return "int8";
+        case Precision::INT4:
+            return "int4";
+        default:
+            return "float32";
+    }
+}
+
+MixedPrecision::Plan MixedPrecision::Analyze(Graph&                     graph,
+                                             const Budget&              budget,
+                                             const CostModel::Roofline& roofline,
+                                             uint64_t                   min_elements,
+                                             size_t                     num_threads) {
+    std::vector<Layer>     layers;
+    std::vector<Candidate> candidates;
+    // Layers are reported in execution order.
+    for (auto* op : graph.TopologicalSort()) {
+        Layer layer;
+        if (op->GetOutputIDs().empty() || !GetLayer(graph, *op, min_elements, layer)) {
+            continue;
+        }
+        candidates.push_back({layers.size(), Precision::FLOAT16});
+        candidates.push_back({layers.size(), Precision::INT8});
+        if (layer.int4) {
+            candidates.push_back({layers.size(), Precision::INT4});
+        }
+        layers.push_back(layer);
+    }
+
+    // Every candidate rounds a whole buffer, buffers are measured in parallel.
+    common::parallel_for(candidates.size(), num_threads == 0 ? common::default_num_threads() : num_threads,
+                         [&](size_t index) {
+                             auto&       candidate = candidates[index];
+                             const auto& layer     = layers[candidate.layer];
+                             if (candidate.precision == Precision::FLOAT16) {
+                                 MeasureFloat16(layer, candidate);
+                             } else {
+                                 MeasureInteger(layer, candidate.precision == Precision::INT4 ? 7.0f : 127.0f,
+                                                candidate);
+                             }
+                         });
+
+    Plan plan {{}, true};
+    for (const auto& layer : layers) {
+        plan.layers.push_back({layer.op->GetOutputBlob(0)->GetName(), layer.op->GetOpType(), layer.weights->GetName(),
+                               layer.outer * layer.channels * layer.inner, {}, 0});
+        plan.layers.back().choices.push_back({Precision::FLOAT32, GetWeightBytes(layer, Precision::FLOAT32),
+                                              GetSeconds(graph, layer, roofline, Precision::FLOAT32), infinite_snr});
+    }
+    for (const auto& candidate : candidates) {
+        if (!candidate.feasible || candidate.snr_db < budget.min_snr_db) {
+            continue;
+        }
+        const auto& layer = layers[candidate.layer];
+        plan.layers[candidate.layer].choices.push_back({candidate.precision,
+                                                        GetWeightBytes(layer, candidate.precision),
+                                                        GetSeconds(graph, layer, roofline, candidate.precision),
+                                                        candidate.snr_db});
+    }
+
+    if (budget.max_weight_bytes == 0 && budget.max_seconds <= 0.0) {
+        for (auto& layer : plan.layers) {
+            auto smallest = std::min_element(layer.choices.begin(), layer.choices.end(),
+                                             [](const Choice& lhs, const Choice& rhs) {
+                                                 return lhs.weight_bytes < rhs.weight_bytes;
+                                             });
+            layer.chosen  = smallest - layer.choices.begin();
+        }
+    } else {
+        plan.budget_met = MeetBudget(plan.layers, budget);
+    }
+    return plan;
+}
+
+MixedPrecision::Plan MixedPrecision::Run(Graph&                     graph,
+                                         const Budget&              budget,
+                                         const CostModel::Roofline& roofline,
+                                         uint64_t                   min_elements,
+                                         size_t                     num_threads) {
+    LOG(INFO) << "MixedPrecision::Run Start.";
+    auto plan = Analyze(graph, budget, roofline, min_elements, num_threads);
+    if (!plan.budget_met) {
+        LOG(WARN) << "The budget can't be met, apply the smallest plan found.";
+    }
+
+    std::vector<std::string> float16_weights;
+    std::vector<std::string> int8_ops;
+    std::vector<std::string> int4_ops;
+    uint64_t                 original_bytes = 0;
+    uint64_t                 planned_bytes  = 0;
+    for (const auto& layer : plan.layers) {
+        const auto& choice = layer.choices[layer.chosen];
+        original_bytes += layer.choices.front().weight_bytes;
+        planned_bytes += choice.weight_bytes;
+        if (choice.precision == Precision::FLOAT16) {
+            float16_weights.push_back(layer.weights);
+        } else if (choice.precision == Precision::INT8) {
+            int8_ops.push_back(layer.op_output);
+        } else if (choice.precision == Precision::INT4) {
+            int4_ops.push_back(layer.op_output);
+        }
+    }
+    // Empty selections would convert every candidate, so they are skipped. Float16 weights are read through a
+    // DEQUANTIZE afterwards, which keeps WeightQuantization away from them.
+    if (!float16_weights.empty()) {
+        Float16Conversion::Run(graph, float16_weights, 0, num_threads);
+    }
+    if (!int8_ops.empty()) {
+        WeightQuantization::Run(graph, int8_ops, DataType::INT8, 0, num_threads);
+    }
+    if (!int4_ops.empty()) {
+        WeightQuantization::Run(graph, int4_ops, DataType::INT4, 0, num_threads);
+    }
+    LOG(INFO) << "MixedPrecision::Run End. Planned " << plan.layers.size() << " operators, weights from "
+              << original_bytes << " to " << planned_bytes << " bytes.";
+    return plan;
+}
@@ -0,0 +1,256 @@
+#include "transforms/pad_folding.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "common/stl_wrapper.h"
+#include "transforms/transform_utils.h"
+
+namespace {
+enum class PadValue { ZERO, LOWEST, REFLECT, SYMMETRIC, OTHER };
+
+struct SpatialPadding {
+    int top;
+    int bottom;
+    int left;
+    int right;
+};
+
+// Sliding window of the consumer along H and W. `pad_type` points into the option of consumer.
+struct Window {
+    int      stride_h;
+    int      stride_w;
+    int      filter_h;
+    int      filter_w;
+    int      dilation_h;
+    int      dilation_w;
+    Padding* pad_type;
+};
+
+// SAME padding as TfLite kernels compute it, the extra pixel of an odd padding goes to the end.
+std::pair<int, int> ComputeSamePadding(int in_size, int stride, int filter, int dilation) {
+    int effective_filter = (filter - 1) * dilation + 1;
+    int out_size         = (in_size + stride - 1) / stride;
+    int total            = std::max((out_size - 1) * stride + effective_filter - in_size, 0);
+    return {total / 2, total - total / 2};
+}
+
+bool GetSpatialPadding(const Graph& graph, const Operator& pad, SpatialPadding& padding) {
+    std::vector<int64_t> paddings;
+    if (pad.GetInputIDs().size() < 2 || !graph.GetIntegerConstant(pad.GetInputIDs()[1], paddings) ||
+        paddings.size() != 8) {
+        return false;
+    }
+    // Only NHWC activations padded along H and W are candidates.
+    if (paddings[0] != 0 || paddings[1] != 0 || paddings[6] != 0 || paddings[7] != 0) {
+        return false;
+    }
+    padding = {static_cast<int>(paddings[2]), static_cast<int>(paddings[3]), static_cast<int>(paddings[4]),
+               static_cast<int>(paddings[5])};
+    return true;
+}
+
+template <typename T> T ReadScalar(const std::vector<uint8_t>& buffer) {
+    T value;
+    memcpy(&value, buffer.data(), sizeof(T));
+    return value;
+}
+
+int64_t GetZeroPoint(const DataBlob& blob) {
+    if (!blob.HasQuantParam() || blob.GetQuantParam().zero_points.empty()) {
+        return 0;
+    }
+    return blob.GetQuantParam().zero_points[0];
+}
+
+template <typename T> PadValue ClassifyQuantizedValue(const std::vector<uint8_t>& buffer, int64_t zero_point) {
+    if (buffer.size() != sizeof(T)) {
+        return PadValue::OTHER;
+    }
+    auto pad_value = ReadScalar<T>(buffer);
+    if (pad_value == zero_point) {
+        return PadValue::ZERO;
+    }
+    return pad_value == std::numeric_limits<T>::lowest() ? PadValue::LOWEST : PadValue::OTHER;
+}
+
+PadValue ClassifyConstantValue(const Graph& graph, const DataBlob& input, const DataBlob& constant_value) {
+    const auto* buffer = graph.GetBuffer(constant_value.GetID());
+    if (buffer == nullptr || constant_value.GetDataType() != input.GetDataType()) {
+        return PadValue::OTHER;
+    }
+    switch (input.GetDataType()) {
+        case DataType::FLOAT32: {
+            if (buffer->size() != sizeof(float)) {
+                return PadValue::OTHER;
+            }
+            auto pad_value = ReadScalar<float>(*buffer);
+            if (pad_value == 0.0F) {
+                return PadValue::ZERO;
+            }
+            // -inf is lower than lowest finite value, it's the common padding of TensorFlow max pooling.
+            return pad_value <= std::numeric_limits<float>::lowest() ? PadValue::LOWEST : PadValue::OTHER;
+        }
+        case DataType::INT8:
+            return ClassifyQuantizedValue<int8_t>(*buffer, GetZeroPoint(input));
+        case DataType::UINT8:
+            return ClassifyQuantizedValue<uint8_t>(*buffer, GetZeroPoint(input));
+        case DataType::INT16:
+            return ClassifyQuantizedValue<int16_t>(*buffer, GetZeroPoint(input));
+        default:
+            return PadValue::OTHER;
+    }
+}
+
+PadValue ClassifyPadValue(const Graph& graph, const Operator& pad, const DataBlob& input) {
+    switch (pad.GetOpType()) {
+        case OperatorType::PAD:
+            return PadValue::ZERO;
+        case OperatorType::PADV2:
+            if (pad.GetInputIDs().size() < 3) {
+                return PadValue::ZERO;
+            }
+            return ClassifyConstantValue(graph, input, *pad.GetInputBlob(2));
+        case OperatorType::MIRROR_PAD:
+            if (!pad.HasOption()) {
+                return PadValue::OTHER;
+            }
+            return pad.GetOption<MirrorPadOption>()->mirror_pad_type == MirrorPadType::REFLECT ? PadValue::REFLECT
+                                                                                                : PadValue::SYMMETRIC;
+        default:
+            return PadValue::OTHER;
+    }
+}
+
+template <typename OptionT> bool GetConvWindow(Operator& consumer, Window& window) {
+    const auto& filter_dims = consumer.GetInputBlob(1)->GetShape().GetDims();
+    if (filter_dims.size() != 4) {
+        return false;
+    }
+    // Both OHWI filters of CONV2D and 1HWO filters of DEPTHWISE_CONV2D keep H and W in the middle.
+    auto* option = consumer.GetOption<OptionT>();
+    window       = {option->stride_h,   option->stride_w,   filter_dims[1],   filter_dims[2],
+                    option->dilation_h, option->dilation_w, &option->pad_type};
+    return true;
+}
+
+bool GetWindow(Operator& consumer, Window& window) {
+    if (!consumer.HasOption()) {
+        return false;
+    }
+    switch (consumer.GetOpType()) {
+        case OperatorType::CONV2D:
+            return GetConvWindow<Conv2DOption>(consumer, window);
+        case OperatorType::DEPTHWISE_CONV2D:
+            return GetConvWindow<DepthwiseConv2DOption>(consumer, window);
+        case OperatorType::MAX_POOL: {
+            auto* option = consumer.GetOption<Pool2DOption>();
+            window = {option->stride_h, option->stride_w, option->filter_h, option->filter_w, 1, 1, &option->pad_type};
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+// Outputs of ReLU/ReLU6 and quantized tensors whose zero point is the lowest value hold no negative values.
+bool IsNonNegative(const DataBlob& blob) {
+    auto* producer = blob.GetProducer();
+    if (producer != nullptr &&
+        (producer->GetOpType() == OperatorType::ReLU || producer->GetOpType() == OperatorType::ReLU6)) {
+        return true;
+    }
+    if (!blob.HasQuantParam() || blob.GetQuantParam().zero_points.size() != 1) {
+        return false;
+    }
+    auto zero_point = blob.GetQuantParam().zero_points[0];
+    return (blob.GetDataType() == DataType::INT8 && zero_point == std::numeric_limits<int8_t>::lowest()) ||
+           (blob.GetDataType() == DataType::UINT8 && zero_point == 0);
+}
+
+bool IsFoldable(PadValue pad_value, const Operator& consumer, const Window& window, const SpatialPadding& padding,
+                const DataBlob& input) {
+    bool is_max_pool = consumer.GetOpType() == OperatorType::MAX_POOL;
+    switch (pad_value) {
+        case PadValue::ZERO:
+            return !is_max_pool || IsNonNegative(input);
+        case PadValue::LOWEST:
+            return is_max_pool;
+        case PadValue::REFLECT:
+        case PadValue::SYMMETRIC: {
+            // A mirrored pixel p away from the border replaces a real pixel p (REFLECT) or p - 1 (SYMMETRIC) away from
+            // it, the first window covering the padded pixel must cover the real one as well.
+            int offset = pad_value == PadValue::REFLECT ? 1 : 0;
+            return is_max_pool && 2 * std::max(padding.top, padding.bottom) <= window.filter_h - offset &&
+                   2 * std::max(padding.left, padding.right) <= window.filter_w - offset;
+        }
+        default:
+            return false;
+    }
+}
+}  // namespace
+
+uint32_t PadFolding::Run(Graph& graph) {
+    LOG(INFO) << "PadFolding::Run Start.";
+    static const std::vector<OperatorType> pad_types = {OperatorType::PAD, OperatorType::PADV2,
+                                                        OperatorType::MIRROR_PAD};
+
+    uint32_t folded_consumers = 0;
+    uint32_t removed_pads     = 0;
+    for (auto* pad : graph.TopologicalSort()) {
+        SpatialPadding padding;
+        if (!common::contains(pad_types, pad->GetOpType()) || !GetSpatialPadding(graph, *pad, padding)) {
+            continue;
+        }
+        auto*       input  = pad->GetInputBlob(0);
+        auto*       output = pad->GetOutputBlob(0);
+        const auto& dims   = input->GetShape().GetDims();
+        if (dims.size() != 4 || dims[1] <= 0 || dims[2] <= 0 || !transforms::IsSameQuantParam(*input, *output)) {
+            continue;
+        }
+        auto pad_value = ClassifyPadValue(graph, *pad, *input);
+
+        std::vector<Operator*> consumers;
+        common::copy(output->GetConsumers(), std::back_inserter(consumers));
+        for (auto* consumer : consumers) {
+            Window window;
+            if (consumer->GetInputIDs()[0] != output->GetID() || !GetWindow(*consumer, window) ||
+                *window.pad_type != Padding::VALID) {
+                continue;
+            }
+            auto same_h = ComputeSamePadding(dims[1], window.stride_h, window.filter_h, window.dilation_h);
+            auto same_w = ComputeSamePadding(dims[2], window.stride_w, window.filter_w, window.dilation_w);
+            if (same_h != std::make_pair(padding.top, padding.bottom) ||
+                same_w != std::make_pair(padding.left, padding.right) ||
+                !IsFoldable(pad_value, *consumer, window, padding, *input)) {
+                continue;
+            }
+            consumer->SetInputBlob(0, input);
+            output->RemoveConsumer(consumer);
+            input->AddConsumer(consumer);
+            *window.pad_type = Padding::SAME;
+            folded_consumers++;
+        }
+
+        // PAD stays alive as long as someone else reads the padded tensor.
+        if (!output->GetConsumers().empty() || graph.IsGraphOutput(output->GetID())) {
+            continue;
+        }
+        std::vector<DataBlob*> pad_params;
+        for (size_t index = 1; index < pad->GetInputIDs().size(); index++) {
+            pad_params.push_back(pad->GetInputBlob(index));
+        }
+        graph.RemoveOperator(pad);
+        graph.EraseBlob(output);
+        for (auto* blob : pad_params) {
+            transforms::EraseBlobIfUnused(graph, blob);
+        }
+        removed_pads++;
+    }
+    LOG(INFO) << "PadFolding::Run End. Folded padding into " << folded_consumers << " operators and removed "
+              << removed_pads << " pads.";
+    return folded_consumers;
+}
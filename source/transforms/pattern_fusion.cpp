@@ -0,0 +1,355 @@
+#include "transforms/pattern_fusion.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+#include <set>
+
+#include "common/stl_wrapper.h"
+#include "transforms/transform_utils.h"
+
+namespace {
+// A matched subgraph computing `output` from `input`, `ops` are replaced by a single operator.
+struct Match {
+    DataBlob*              input  = nullptr;
+    DataBlob*              output = nullptr;
+    std::vector<Operator*> ops;
+};
+
+bool GetScalar(const Graph& graph, const DataBlob* blob, float& value) {
+    const auto* buffer = graph.GetBuffer(blob->GetID());
+    if (buffer == nullptr || blob->GetDataType() != DataType::FLOAT32 || buffer->size() != sizeof(float)) {
+        return false;
+    }
+    memcpy(&value, buffer->data(), sizeof(float));
+    return true;
+}
+
+// Exported coefficients are rounded differently by frameworks, e.g. sqrt(2 / pi) is often written as 0.7978846.
+bool IsClose(float value, float expected) {
+    return fabsf(value - expected) <= 1e-4F * std::max(1.0F, fabsf(expected));
+}
+
+bool HasNoFusedActivation(const Operator& op) {
+    if (!op.HasOption()) {
+        return true;
+    }
+    switch (op.GetOpType()) {
+        case OperatorType::ADD:
+            return op.GetOption<AddOption>()->activation_type == OperatorType::NONE;
+        case OperatorType::MUL:
+            return op.GetOption<MulOption>()->activation_type == OperatorType::NONE;
+        case OperatorType::DIV:
+            return op.GetOption<DivOption>()->activation_type == OperatorType::NONE;
+        default:
+            return true;
+    }
+}
+
+// The only consumer of an intermediate blob, nullptr if the blob is read by several operators or is a graph output.
+Operator* GetSoleConsumer(const Graph& graph, const DataBlob* blob) {
+    auto consumers = blob->GetConsumers();
+    if (consumers.size() != 1 || graph.IsGraphOutput(blob->GetID())) {
+        return nullptr;
+    }
+    return *consumers.begin();
+}
+
+// The producer of an intermediate blob if it has type `op_type` and nobody else reads the blob.
+Operator* GetSoleProducer(const Graph& graph, const DataBlob* blob, OperatorType op_type) {
+    auto* producer = blob->GetProducer();
+    if (producer == nullptr || producer->GetOpType() != op_type || GetSoleConsumer(graph, blob) == nullptr) {
+        return nullptr;
+    }
+    return producer;
+}
+
+// Split a binary operator into its tensor operand and its scalar constant operand. Only ADD and MUL accept the scalar
+// on the left side.
+bool SplitScalarOperand(const Graph& graph, const Operator* op, OperatorType op_type, DataBlob*& operand,
+                        float& scalar) {
+    if (op == nullptr || op->GetOpType() != op_type || op->GetInputIDs().size() != 2 || !HasNoFusedActivation(*op)) {
+        return false;
+    }
+    bool commutative = op_type == OperatorType::ADD || op_type == OperatorType::MUL;
+    if (GetScalar(graph, op->GetInputBlob(1), scalar)) {
+        operand = op->GetInputBlob(0);
+        return true;
+    }
+    if (commutative && GetScalar(graph, op->GetInputBlob(0), scalar)) {
+        operand = op->GetInputBlob(1);
+        return true;
+    }
+    return false;
+}
+
+// Return the operand of `op` which computes `operand op scalar` with the expected scalar, nullptr otherwise.
+DataBlob* GetOperandBesideScalar(const Graph& graph, const Operator* op, OperatorType op_type, float expected) {
+    DataBlob* operand = nullptr;
+    float     scalar  = 0.0F;
+    if (!SplitScalarOperand(graph, op, op_type, operand, scalar) || !IsClose(scalar, expected)) {
+        return nullptr;
+    }
+    return operand;
+}
+
+// Check `op` scales `input` by `scale`, either MUL(input, scale) or DIV(input, 1 / scale).
+bool IsScaleOf(const Graph& graph, const Operator* op, const DataBlob* input, float scale) {
+    return (GetOperandBesideScalar(graph, op, OperatorType::MUL, scale) == input) ||
+           (GetOperandBesideScalar(graph, op, OperatorType::DIV, 1.0F / scale) == input);
+}
+
+// The other input of a binary operator.
+DataBlob* GetOtherOperand(const Operator* op, const DataBlob* operand) {
+    if (op->GetInputIDs().size() != 2) {
+        return nullptr;
+    }
+    return op->GetInputIDs()[0] == operand->GetID() ? op->GetInputBlob(1) : op->GetInputBlob(0);
+}
+
+bool IsProductOf(const Operator* op, const DataBlob* lhs, const DataBlob* rhs) {
+    if (op == nullptr || op->GetOpType() != OperatorType::MUL || !HasNoFusedActivation(*op) ||
+        op->GetInputIDs().size() != 2) {
+        return false;
+    }
+    const auto& inputs = op->GetInputIDs();
+    return (inputs[0] == lhs->GetID() && inputs[1] == rhs->GetID()) ||
+           (inputs[0] == rhs->GetID() && inputs[1] == lhs->GetID());
+}
+
+// Match `scale * x * factor` starting from `factor`, in any of (x * factor) * scale, (factor * scale) * x and
+// (x * scale) * factor.
+bool MatchScaledProduct(const Graph& graph, DataBlob* x, DataBlob* factor, float scale, Match& match) {
+    auto* consumer = GetSoleConsumer(graph, factor);
+    if (consumer == nullptr) {
+        return false;
+    }
+    if (IsScaleOf(graph, consumer, factor, scale)) {
+        auto* scaled_factor = consumer->GetOutputBlob(0);
+        auto* product       = GetSoleConsumer(graph, scaled_factor);
+        if (!IsProductOf(product, scaled_factor, x)) {
+            return false;
+        }
+        match.ops.insert(match.ops.end(), {consumer, product});
+        match.output = product->GetOutputBlob(0);
+        return true;
+    }
+    if (consumer->GetOpType() != OperatorType::MUL || !HasNoFusedActivation(*consumer)) {
+        return false;
+    }
+    auto* other = GetOtherOperand(consumer, factor);
+    if (other == x) {
+        auto* product = consumer->GetOutputBlob(0);
+        auto* scaling = GetSoleConsumer(graph, product);
+        if (!IsScaleOf(graph, scaling, product, scale)) {
+            return false;
+        }
+        match.ops.insert(match.ops.end(), {consumer, scaling});
+        match.output = scaling->GetOutputBlob(0);
+        return true;
+    }
+    auto* scaling = other == nullptr ? nullptr : GetSoleProducer(graph, other, OperatorType::MUL);
+    if (scaling == nullptr) {
+        scaling = other == nullptr ? nullptr : GetSoleProducer(graph, other, OperatorType::DIV);
+    }
+    if (scaling == nullptr || !IsScaleOf(graph, scaling, x, scale)) {
+        return false;
+    }
+    match.ops.insert(match.ops.end(), {scaling, consumer});
+    match.output = consumer->GetOutputBlob(0);
+    return true;
+}
+
+// x^3 as POW(x, 3), (x * x) * x or x * (x * x).
+bool MatchCube(const Graph& graph, DataBlob* cube, const DataBlob* x, Match& match) {
+    if (auto* pow = GetSoleProducer(graph, cube, OperatorType::POW)) {
+        float exponent = 0.0F;
+        if (pow->GetInputIDs().size() == 2 && pow->GetInputBlob(0) == x &&
+            GetScalar(graph, pow->GetInputBlob(1), exponent) && IsClose(exponent, 3.0F)) {
+            match.ops.push_back(pow);
+            return true;
+        }
+        return false;
+    }
+    auto* outer = GetSoleProducer(graph, cube, OperatorType::MUL);
+    if (outer == nullptr || !HasNoFusedActivation(*outer) || outer->GetInputIDs().size() != 2) {
+        return false;
+    }
+    for (size_t index = 0; index < 2; index++) {
+        auto* square     = outer->GetInputBlob(index);
+        auto* square_op  = GetSoleProducer(graph, square, OperatorType::MUL);
+        bool  other_is_x = outer->GetInputBlob(1 - index) == x;
+        if (other_is_x && square_op != nullptr && IsProductOf(square_op, x, x)) {
+            match.ops.insert(match.ops.end(), {square_op, outer});
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MatchGELU(const Graph& graph, Operator* tanh, Match& match) {
+    constexpr float sqrt_2_over_pi = 0.7978845608F;
+    auto*           scaling        = GetSoleProducer(graph, tanh->GetInputBlob(0), OperatorType::MUL);
+    auto*           inner          = GetOperandBesideScalar(graph, scaling, OperatorType::MUL, sqrt_2_over_pi);
+    auto*           add            = inner == nullptr ? nullptr : GetSoleProducer(graph, inner, OperatorType::ADD);
+    if (add == nullptr || !HasNoFusedActivation(*add) || add->GetInputIDs().size() != 2) {
+        return false;
+    }
+    for (size_t index = 0; index < 2; index++) {
+        Match candidate;
+        auto* x           = add->GetInputBlob(index);
+        auto* cubic_term  = add->GetInputBlob(1 - index);
+        auto* cubic_scale = GetSoleProducer(graph, cubic_term, OperatorType::MUL);
+        auto* cube        = GetOperandBesideScalar(graph, cubic_scale, OperatorType::MUL, 0.044715F);
+        if (cube == nullptr || !MatchCube(graph, cube, x, candidate)) {
+            continue;
+        }
+        auto* add_one = GetSoleConsumer(graph, tanh->GetOutputBlob(0));
+        if (GetOperandBesideScalar(graph, add_one, OperatorType::ADD, 1.0F) != tanh->GetOutputBlob(0)) {
+            return false;
+        }
+        candidate.ops.insert(candidate.ops.end(), {cubic_scale, add, scaling, tanh, add_one});
+        if (!MatchScaledProduct(graph, x, add_one->GetOutputBlob(0), 0.5F, candidate)) {
+            return false;
+        }
+        candidate.input = x;
+        match           = candidate;
+        return true;
+    }
+    return false;
+}
+
+// Anchored on the operator computing ReLU6(x + 3), i.e. ReLU6 or ADD with fused ReLU6.
+bool MatchHardSwish(const Graph& graph, Operator* relu6, Match& match) {
+    DataBlob* x      = nullptr;
+    float     offset = 0.0F;
+    if (relu6->GetOpType() == OperatorType::ReLU6) {
+        auto* add = GetSoleProducer(graph, relu6->GetInputBlob(0), OperatorType::ADD);
+        x         = GetOperandBesideScalar(graph, add, OperatorType::ADD, 3.0F);
+        if (x == nullptr) {
+            return false;
+        }
+        match.ops = {add, relu6};
+    } else {
+        if (relu6->GetOpType() != OperatorType::ADD || !relu6->HasOption() || relu6->GetInputIDs().size() != 2 ||
+            relu6->GetOption<AddOption>()->activation_type != OperatorType::ReLU6) {
+            return false;
+        }
+        size_t scalar_index = GetScalar(graph, relu6->GetInputBlob(1), offset) ? 1 : 0;
+        if ((scalar_index == 0 && !GetScalar(graph, relu6->GetInputBlob(0), offset)) || !IsClose(offset, 3.0F)) {
+            return false;
+        }
+        x         = relu6->GetInputBlob(1 - scalar_index);
+        match.ops = {relu6};
+    }
+    match.input = x;
+    return MatchScaledProduct(graph, x, relu6->GetOutputBlob(0), 1.0F / 6.0F, match);
+}
+
+bool MatchLogSoftmax(const Graph& graph, Operator* softmax, Match& match) {
+    if (!softmax->HasOption() || softmax->GetOption<SoftmaxOption>()->beta != 1.0F) {
+        return false;
+    }
+    auto* log = GetSoleConsumer(graph, softmax->GetOutputBlob(0));
+    if (log == nullptr || log->GetOpType() != OperatorType::LOG) {
+        return false;
+    }
+    match.input  = softmax->GetInputBlob(0);
+    match.output = log->GetOutputBlob(0);
+    match.ops    = {softmax, log};
+    return true;
+}
+
+bool MatchLeakyReLU(const Graph& graph, Operator* maximum, Match& match, float& alpha) {
+    if (maximum->GetInputIDs().size() != 2) {
+        return false;
+    }
+    for (size_t index = 0; index < 2; index++) {
+        auto*     x       = maximum->GetInputBlob(index);
+        auto*     scaling = GetSoleProducer(graph, maximum->GetInputBlob(1 - index), OperatorType::MUL);
+        DataBlob* operand = nullptr;
+        if (SplitScalarOperand(graph, scaling, OperatorType::MUL, operand, alpha) && operand == x && alpha >= 0.0F &&
+            alpha < 1.0F) {
+            match.input  = x;
+            match.output = maximum->GetOutputBlob(0);
+            match.ops    = {scaling, maximum};
+            return true;
+        }
+    }
+    return false;
+}
+
+Operator* ReplaceMatch(Graph& graph, const Match& match, OperatorType op_type) {
+    std::set<BLOBID_T> intermediates;
+    std::set<BLOBID_T> parameters;
+    for (auto* op : match.ops) {
+        common::copy(op->GetOutputIDs(), std::inserter(intermediates, intermediates.end()));
+        common::copy(op->GetInputIDs(), std::inserter(parameters, parameters.end()));
+    }
+    intermediates.erase(match.output->GetID());
+    parameters.erase(match.input->GetID());
+
+    for (auto* op : match.ops) {
+        graph.RemoveOperator(op);
+    }
+    for (auto blob_id : intermediates) {
+        parameters.erase(blob_id);
+        graph.EraseBlob(graph.GetDataBlob(blob_id));
+    }
+    for (auto blob_id : parameters) {
+        transforms::EraseBlobIfUnused(graph, graph.GetDataBlob(blob_id));
+    }
+    return graph.AddOperator(op_type, {match.input}, {match.output});
+}
+}  // namespace
+
+uint32_t PatternFusion::Run(Graph& graph) {
+    LOG(INFO) << "PatternFusion::Run Start.";
+    std::vector<NODEID_T> op_ids;
+    common::transform(graph.TopologicalSort(), std::back_inserter(op_ids), [](const Operator* op) {
+        return op->GetID();
+    });
+
+    uint32_t fused_patterns = 0;
+    for (auto op_id : op_ids) {
+        // The operator may have been removed as a part of an earlier match.
+        auto* op = graph.GetOperator(op_id);
+        if (op == nullptr || op->GetInputIDs().empty() || op->GetInputBlob(0)->GetDataType() != DataType::FLOAT32) {
+            continue;
+        }
+        Match match;
+        float alpha = 0.0F;
+        switch (op->GetOpType()) {
+            case OperatorType::TANH:
+                if (MatchGELU(graph, op, match)) {
+                    ReplaceMatch(graph, match, OperatorType::GELU)->GetOption<GELUOption>()->approximate = true;
+                    fused_patterns++;
+                }
+                break;
+            case OperatorType::ReLU6:
+            case OperatorType::ADD:
+                if (MatchHardSwish(graph, op, match)) {
+                    ReplaceMatch(graph, match, OperatorType::HARDSWISH);
+                    fused_patterns++;
+                }
+                break;
+            case OperatorType::SOFTMAX:
+                if (MatchLogSoftmax(graph, op, match)) {
+                    ReplaceMatch(graph, match, OperatorType::LOG_SOFTMAX);
+                    fused_patterns++;
+                }
+                break;
+            case OperatorType::MAXIMUM:
+                if (MatchLeakyReLU(graph, op, match, alpha)) {
+                    ReplaceMatch(graph, match, OperatorType::LEAKY_RELU)->GetOption<LeakyReLUOption>()->alpha = alpha;
+                    fused_patterns++;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    LOG(INFO) << "PatternFusion::Run End. Fused " << fused_patterns << " patterns.";
+    return fused_patterns;
+}
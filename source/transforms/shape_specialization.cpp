@@ -0,0 +1,287 @@
+#include "transforms/shape_specialization.h"
+
+#include <algorithm>
+
+#include "analysis/shape_inference.h"
+#include "common/stl_wrapper.h"
+#include "transforms/transform_utils.h"
+
+namespace {
+using Values = std::vector<int64_t>;
+
+bool IsStatic(const DataBlob& blob) {
+    return common::all_of(blob.GetShape().GetDims(), [](int dim) { return dim >= 0; });
+}
+
+bool IsIntegerType(DataType data_type) { return data_type == DataType::INT32 || data_type == DataType::INT64; }
+
+size_t NumElements(const DataBlob& blob) {
+    size_t num_elements = 1;
+    for (auto dim : blob.GetShape().GetDims()) {
+        num_elements *= static_cast<size_t>(dim);
+    }
+    return num_elements;
+}
+
+void SetIntegerBuffer(Graph& graph, const DataBlob& blob, const Values& values) {
+    if (blob.GetDataType() == DataType::INT32) {
+        graph.SetBuffer(blob.GetID(), std::vector<int32_t>(values.begin(), values.end()));
+    } else {
+        graph.SetBuffer(blob.GetID(), values);
+    }
+}
+
+// Shape arithmetic only mixes a vector with scalars or with another vector of the same length.
+bool EvaluateBinary(OperatorType op_type, const Values& lhs, const Values& rhs, Values& result) {
+    if (lhs.size() != rhs.size() && lhs.size() != 1 && rhs.size() != 1) {
+        return false;
+    }
+    size_t size = std::max(lhs.size(), rhs.size());
+    result.resize(size);
+    for (size_t index = 0; index < size; index++) {
+        int64_t x = lhs[lhs.size() == 1 ? 0 : index];
+        int64_t y = rhs[rhs.size() == 1 ? 0 : index];
+        switch (op_type) {
+            case OperatorType::ADD:
+                result[index] = x + y;
+                break;
+            case OperatorType::SUB:
+                result[index] = x - y;
+                break;
+            case OperatorType::MUL:
+                result[index] = x * y;
+                break;
+            case OperatorType::DIV:
+                if (y == 0) {
+                    return false;
+                }
+                result[index] = x / y;
+                break;
+            case OperatorType::MAXIMUM:
+                result[index] = std::max(x, y);
+                break;
+            case OperatorType::MINIMUM:
+                result[index] = std::min(x, y);
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+bool EvaluateStridedSlice(const Operator& op, const std::vector<Values>& inputs, size_t num_outputs, Values& result) {
+    const auto& input  = inputs[0];
+    auto        dim    = static_cast<int64_t>(input.size());
+    int64_t     stride = inputs[3][0];
+    int64_t     start  = inputs[1][0];
+    if (stride == 0 || !op.HasOption()) {
+        return false;
+    }
+    const auto* option = op.GetOption<StridedSliceOption>();
+    if (option->ellipsis_mask != 0 || option->new_axis_mask != 0) {
+        return false;
+    }
+    if (option->begin_mask & 1) {
+        start = stride > 0 ? 0 : dim - 1;
+    } else if (start < 0) {
+        start += dim;
+    }
+    for (size_t index = 0; index < num_outputs; index++) {
+        int64_t position = start + static_cast<int64_t>(index) * stride;
+        if (position < 0 || position >= dim) {
+            return false;
+        }
+        result.push_back(input[position]);
+    }
+    return true;
+}
+
+// Packing scalars or packing vectors along the outer axis only appends values.
+bool IsOuterPack(const Operator& op) {
+    int axis = op.HasOption() ? op.GetOption<PackOption>()->axis : 0;
+    return op.GetInputBlob(0)->GetShape().GetDims().empty() || axis == 0 || axis == -2;
+}
+
+// Evaluate an operator over integer constants, only 1-D shape vectors and scalars are handled.
+bool Evaluate(const Graph& graph, const Operator& op, size_t num_outputs, Values& result) {
+    if (op.GetOpType() == OperatorType::SHAPE) {
+        const auto* input = op.GetInputBlob(0);
+        if (!IsStatic(*input)) {
+            return false;
+        }
+        result.assign(input->GetShape().GetDims().begin(), input->GetShape().GetDims().end());
+        return true;
+    }
+    std::vector<Values> inputs(op.GetInputIDs().size());
+    for (size_t index = 0; index < inputs.size(); index++) {
+        if (!graph.GetIntegerConstant(op.GetInputIDs()[index], inputs[index]) || inputs[index].empty()) {
+            return false;
+        }
+    }
+    if (inputs.empty() || op.GetInputBlob(0)->GetShape().GetDims().size() > 1) {
+        return false;
+    }
+    switch (op.GetOpType()) {
+        case OperatorType::CAST:
+        case OperatorType::EXPAND_DIMS:
+        case OperatorType::RESHAPE:
+        case OperatorType::SQUEEZE:
+            result = inputs[0];
+            return true;
+        case OperatorType::ADD:
+        case OperatorType::DIV:
+        case OperatorType::MAXIMUM:
+        case OperatorType::MINIMUM:
+        case OperatorType::MUL:
+        case OperatorType::SUB:
+            return inputs.size() == 2 && EvaluateBinary(op.GetOpType(), inputs[0], inputs[1], result);
+        case OperatorType::PACK:
+            if (!IsOuterPack(op)) {
+                return false;
+            }
+            [[fallthrough]];
+        case OperatorType::CONCAT:
+            for (const auto& input : inputs) {
+                result.insert(result.end(), input.begin(), input.end());
+            }
+            return true;
+        case OperatorType::GATHER:
+            for (auto index : inputs[1]) {
+                if (index < 0 || index >= static_cast<int64_t>(inputs[0].size())) {
+                    return false;
+                }
+                result.push_back(inputs[0][index]);
+            }
+            return true;
+        case OperatorType::SLICE: {
+            int64_t begin = inputs[1][0];
+            if (begin < 0 || begin + static_cast<int64_t>(num_outputs) > static_cast<int64_t>(inputs[0].size())) {
+                return false;
+            }
+            result.assign(inputs[0].begin() + begin, inputs[0].begin() + begin + num_outputs);
+            return true;
+        }
+        case OperatorType::STRIDED_SLICE:
+            return inputs.size() == 4 && EvaluateStridedSlice(op, inputs, num_outputs, result);
+        case OperatorType::REDUCE_PROD:
+            result = {1};
+            for (auto value : inputs[0]) {
+                result[0] *= value;
+            }
+            return true;
+        case OperatorType::SUM:
+            result = {0};
+            for (auto value : inputs[0]) {
+                result[0] += value;
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+void ApplyInputShapes(Graph& graph, const ShapeSpecialization::InputShapes& input_shapes) {
+    for (const auto& [name, dims] : input_shapes) {
+        auto input_id = common::find_if(graph.GetGraphInputs(), [&](BLOBID_T blob_id) {
+            return graph.GetDataBlob(blob_id)->GetName() == name;
+        });
+        REPORT_ERROR_IF(input_id == graph.GetGraphInputs().end(), "`", name,
+                        "` isn't an input of graph. Please check tensor's name.");
+        auto* input = graph.GetDataBlob(*input_id);
+        if (input->GetShape().GetDims().size() != dims.size()) {
+            LOG(WARN) << "Rank of input `" << name << "` changes from " << input->GetShape().GetDims().size() << " to "
+                      << dims.size() << ".";
+        }
+        input->SetShape(Shape(dims));
+    }
+}
+
+uint32_t FoldShapeComputations(Graph& graph) {
+    uint32_t folded_ops = 0;
+    // In execution order, a folded output is already constant when its consumers are visited.
+    for (auto* op : graph.TopologicalSort()) {
+        if (op->GetOutputIDs().size() != 1) {
+            continue;
+        }
+        auto* output = op->GetOutputBlob(0);
+        if (!IsIntegerType(output->GetDataType()) || !IsStatic(*output) || output->HasQuantParam() ||
+            graph.IsGraphOutput(output->GetID()) || graph.GetBuffer(output->GetID()) != nullptr) {
+            continue;
+        }
+        Values values;
+        if (!Evaluate(graph, *op, NumElements(*output), values) || values.size() != NumElements(*output)) {
+            continue;
+        }
+        SetIntegerBuffer(graph, *output, values);
+        auto input_ids = op->GetInputIDs();
+        graph.RemoveOperator(op);
+        for (auto blob_id : input_ids) {
+            if (auto* blob = graph.GetDataBlob(blob_id)) {
+                transforms::EraseBlobIfUnused(graph, blob);
+            }
+        }
+        folded_ops++;
+    }
+    return folded_ops;
+}
+
+uint32_t RewriteReshapes(Graph& graph) {
+    uint32_t rewritten_ops = 0;
+    for (auto* op : graph.GetOperators()) {
+        if (op->GetOpType() != OperatorType::RESHAPE || op->GetOutputIDs().empty()) {
+            continue;
+        }
+        auto* output = op->GetOutputBlob(0);
+        if (!IsStatic(*output)) {
+            continue;
+        }
+        const auto& dims     = output->GetShape().GetDims();
+        auto*       option   = op->GetOption<ReshapeOption>();
+        bool        modified = option->new_shape != std::vector<int32_t>(dims.begin(), dims.end());
+        option->new_shape.assign(dims.begin(), dims.end());
+
+        Values current_shape;
+        if (op->GetInputIDs().size() > 1 && !(graph.GetIntegerConstant(op->GetInputIDs()[1], current_shape) &&
+                                              current_shape == Values(dims.begin(), dims.end()))) {
+            auto* old_shape = op->GetInputBlob(1);
+            auto* new_shape = graph.AddDataBlob(output->GetName() + "_shape");
+            new_shape->SetDataType(DataType::INT32);
+            new_shape->SetShape(Shape({static_cast<int>(dims.size())}));
+            graph.SetBuffer(new_shape->GetID(), std::vector<int32_t>(dims.begin(), dims.end()));
+            op->SetInputBlob(1, new_shape);
+            old_shape->RemoveConsumer(op);
+            new_shape->AddConsumer(op);
+            transforms::EraseBlobIfUnused(graph, old_shape);
+            modified = true;
+        }
+        rewritten_ops += modified ? 1 : 0;
+    }
+    return rewritten_ops;
+}
+}  // namespace
+
+uint32_t ShapeSpecialization::Run(Graph& graph, const InputShapes& input_shapes) {
+    LOG(INFO) << "ShapeSpecialization::Run Start.";
+    ApplyInputShapes(graph, input_shapes);
+    uint32_t folded_ops = 0;
+    for (;;) {
+        ShapeInference::Run(graph);
+        auto folded_this_round = FoldShapeComputations(graph);
+        if (folded_this_round == 0) {
+            break;
+        }
+        folded_ops += folded_this_round;
+    }
+    auto rewritten_ops = RewriteReshapes(graph);
+    auto removed_ops   = transforms::RemoveDeadOperators(graph);
+
+    auto dynamic_blobs = std::count_if(graph.GetDataBlobs().begin(), graph.GetDataBlobs().end(),
+                                       [](const DataBlob* blob) { return !IsStatic(*blob); });
+    if (dynamic_blobs > 0) {
+        LOG(WARN) << dynamic_blobs << " blobs still have unknown dims, the model isn't fully static.";
+    }
+    LOG(INFO) << "ShapeSpecialization::Run End. Folded " << folded_ops << " operators, rewrote " << rewritten_ops
+              << " reshapes, removed " << removed_ops << " dead operators.";
+    return folded_ops + rewritten_ops + removed_ops;
+}
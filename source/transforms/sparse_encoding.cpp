@@ -0,0 +1,247 @@
+#include "transforms/sparse_encoding.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "common/stl_wrapper.h"
+
+namespace {
+using EncodedTensor = SparseEncoding::EncodedTensor;
+using SparsityParam = DataBlob::SparsityParam;
+
+// Constant weights of FULLY_CONNECTED operators only, which have sparse kernels.
+bool IsEncodable(const Graph& graph, const DataBlob& blob, uint64_t min_elements) {
+    const auto* buffer = graph.GetBuffer(blob.GetID());
+    auto        width  = GetBitWidth(blob.GetDataType());
+    if (buffer == nullptr || blob.HasSparsityParam() || blob.GetShape().GetDims().size() != 2 || width % 8 != 0 ||
+        buffer->size() / (width / 8) < min_elements || graph.IsGraphOutput(blob.GetID()) ||
+        blob.GetConsumers().empty()) {
+        return false;
+    }
+    return common::all_of(blob.GetConsumers(), [&](const Operator* op) {
+        return op->GetOpType() == OperatorType::FULLY_CONNECTED &&
+               common::get_first_index(op->GetInputIDs(), blob.GetID()) == 1;
+    });
+}
+
+// Bytes of the indices as the serializer writes them, in the narrowest type holding all values.
+uint64_t GetIndicesBytes(const std::vector<int32_t>& indices) {
+    int32_t max_index = 0;
+    for (auto index : indices) {
+        max_index = std::max(max_index, index);
+    }
+    size_t width = max_index <= std::numeric_limits<uint8_t>::max()    ? 1
+                   : max_index <= std::numeric_limits<uint16_t>::max() ? 2
+                                                                        : 4;
+    return indices.size() * width;
+}
+
+bool IsZeroBlock(const uint8_t* data, size_t row_bytes, int32_t block_rows, size_t block_bytes) {
+    for (int32_t row = 0; row < block_rows; row++) {
+        const auto* begin = data + row * row_bytes;
+        if (std::any_of(begin, begin + block_bytes, [](uint8_t byte) { return byte != 0; })) {
+            return false;
+        }
+    }
+    return true;
+}
+
+SparsityParam CreateLayout(int32_t block_rows, int32_t block_cols) {
+    SparsityParam layout;
+    layout.traversal_order = {0, 1};
+    for (auto [dim, block_size] : {std::pair<int32_t, int32_t> {0, block_rows}, {1, block_cols}}) {
+        if (block_size > 1) {
+            layout.traversal_order.push_back(layout.traversal_order.size());
+            layout.block_map.push_back(dim);
+        }
+    }
+    return layout;
+}
+
+// Returns false and leaves the blob alone if the blocks aren't sparse enough or the encoding isn't smaller.
+bool Encode(Graph&         graph,
+            DataBlob&      blob,
+            float          min_sparsity,
+            int32_t        block_rows,
+            int32_t        block_cols,
+            EncodedTensor& encoded) {
+    const auto& buffer       = *graph.GetBuffer(blob.GetID());
+    const auto& dims         = blob.GetShape().GetDims();
+    size_t      element_size = GetBitWidth(blob.GetDataType()) / 8;
+    if (dims[0] % block_rows != 0 || dims[1] % block_cols != 0) {
+        return false;
+    }
+    int32_t row_blocks  = dims[0] / block_rows;
+    int32_t col_blocks  = dims[1] / block_cols;
+    size_t  row_bytes   = dims[1] * element_size;
+    size_t  block_bytes = block_cols * element_size;
+
+    SparsityParam::DimensionMetadata rows {false, row_blocks, {}, {}};
+    SparsityParam::DimensionMetadata cols {true, col_blocks, {0}, {}};
+    for (int32_t row = 0; row < row_blocks; row++) {
+        for (int32_t col = 0; col < col_blocks; col++) {
+            if (!IsZeroBlock(buffer.data() + row * block_rows * row_bytes + col * block_bytes, row_bytes, block_rows,
+                             block_bytes)) {
+                cols.array_indices.push_back(col);
+            }
+        }
+        cols.array_segments.push_back(cols.array_indices.size());
+    }
+
+    uint64_t total_blocks = static_cast<uint64_t>(row_blocks) * col_blocks;
+    uint64_t value_bytes  = cols.array_indices.size() * block_rows * block_bytes;
+    encoded.sparsity      = 1.0f - static_cast<float>(cols.array_indices.size()) / total_blocks;
+    encoded.dense_bytes   = buffer.size();
+    encoded.sparse_bytes  = value_bytes + GetIndicesBytes(cols.array_segments) + GetIndicesBytes(cols.array_indices);
+    if (encoded.sparsity < min_sparsity || encoded.sparse_bytes >= encoded.dense_bytes) {
+        return false;
+    }
+
+    std::vector<uint8_t> values;
+    values.reserve(value_bytes);
+    for (int32_t row = 0; row < row_blocks; row++) {
+        for (int32_t index = cols.array_segments[row]; index < cols.array_segments[row + 1]; index++) {
+            const auto* block = buffer.data() + row * block_rows * row_bytes + cols.array_indices[index] * block_bytes;
+            for (int32_t block_row = 0; block_row < block_rows; block_row++) {
+                values.insert(values.end(), block + block_row * row_bytes, block + block_row * row_bytes + block_bytes);
+            }
+        }
+    }
+
+    auto& sparsity = blob.CreateSparsityParam();
+    sparsity       = CreateLayout(block_rows, block_cols);
+    sparsity.dim_metadata.push_back(std::move(rows));
+    sparsity.dim_metadata.push_back(std::move(cols));
+    for (auto block_size : {block_rows, block_cols}) {
+        if (block_size > 1) {
+            sparsity.dim_metadata.push_back({false, block_size, {}, {}});
+        }
+    }
+    graph.SetBuffer(blob.GetID(), values);
+    return true;
+}
+
+// Walks the levels of the traversal order like the FormatConverter of TFLite, the values are stored in this order.
+class Densifier {
+ public:
+    Densifier(const DataBlob& blob, const std::vector<uint8_t>& values)
+        : sparsity_(blob.GetSparsityParam()),
+          dims_(blob.GetShape().GetDims()),
+          element_size_(GetBitWidth(blob.GetDataType()) / 8),
+          values_(values),
+          levels_(sparsity_.traversal_order.size()) {
+        REPORT_ERROR_IF(element_size_ == 0, "Sparse tensors of sub-byte types are not supported.");
+        REPORT_ERROR_IF(sparsity_.dim_metadata.size() != levels_.size() ||
+                            levels_.size() != dims_.size() + sparsity_.block_map.size(),
+                        "Invalid sparsity parameters of `", blob.GetName(), "`.");
+        // Position of every tensor dim and block dim in the traversal order.
+        for (size_t level = 0; level < levels_.size(); level++) {
+            auto dim = sparsity_.traversal_order[level];
+            REPORT_ERROR_IF(dim < 0 || dim >= static_cast<int32_t>(levels_.size()), "Invalid traversal order of `",
+                            blob.GetName(), "`.");
+            levels_[dim] = level;
+        }
+        size_t elements = 1;
+        for (auto dim : dims_) {
+            elements *= dim;
+        }
+        dense_.resize(elements * element_size_);
+    }
+
+    std::vector<uint8_t> Run() {
+        std::vector<int32_t> coordinates(levels_.size());
+        Visit(0, 0, coordinates);
+        REPORT_ERROR_IF(next_value_ != values_.size(), "Sparse buffer doesn't match its sparsity parameters.");
+        return std::move(dense_);
+    }
+
+ private:
+    void Visit(size_t level, size_t segment, std::vector<int32_t>& coordinates) {
+        if (level == levels_.size()) {
+            Store(coordinates);
+            return;
+        }
+        const auto& metadata = sparsity_.dim_metadata[level];
+        if (!metadata.sparse) {
+            for (int32_t index = 0; index < metadata.dense_size; index++) {
+                coordinates[level] = index;
+                Visit(level + 1, segment * metadata.dense_size + index, coordinates);
+            }
+            return;
+        }
+        REPORT_ERROR_IF(segment + 1 >= metadata.array_segments.size(), "Invalid array segments.");
+        for (auto index = metadata.array_segments[segment]; index < metadata.array_segments[segment + 1]; index++) {
+            REPORT_ERROR_IF(index < 0 || index >= static_cast<int32_t>(metadata.array_indices.size()),
+                            "Invalid array indices.");
+            coordinates[level] = metadata.array_indices[index];
+            Visit(level + 1, index, coordinates);
+        }
+    }
+
+    void Store(const std::vector<int32_t>& coordinates) {
+        size_t offset = 0;
+        for (size_t dim = 0; dim < dims_.size(); dim++) {
+            int32_t coordinate = coordinates[levels_[dim]];
+            size_t  block      = common::get_first_index(sparsity_.block_map, static_cast<int32_t>(dim));
+            if (block < sparsity_.block_map.size()) {
+                auto block_level = levels_[dims_.size() + block];
+                coordinate = coordinate * sparsity_.dim_metadata[block_level].dense_size + coordinates[block_level];
+            }
+            REPORT_ERROR_IF(coordinate < 0 || coordinate >= dims_[dim], "Sparse index out of range.");
+            offset = offset * dims_[dim] + coordinate;
+        }
+        REPORT_ERROR_IF(next_value_ + element_size_ > values_.size(), "Sparse buffer is too short.");
+        memcpy(dense_.data() + offset * element_size_, values_.data() + next_value_, element_size_);
+        next_value_ += element_size_;
+    }
+
+    const SparsityParam&        sparsity_;
+    const std::vector<int>&     dims_;
+    size_t                      element_size_;
+    const std::vector<uint8_t>& values_;
+    std::vector<size_t>         levels_;
+    std::vector<uint8_t>        dense_;
+    size_t                      next_value_ = 0;
+};
+}  // namespace
+
+std::vector<EncodedTensor> SparseEncoding::Run(Graph&   graph,
+                                               float    min_sparsity,
+                                               int32_t  block_rows,
+                                               int32_t  block_cols,
+                                               uint64_t min_elements) {
+    LOG(INFO) << "SparseEncoding::Run Start.";
+    REPORT_ERROR_IF(block_rows <= 0 || block_cols <= 0, "Invalid block ", block_rows, "x", block_cols, ".");
+    std::vector<EncodedTensor> encoded_tensors;
+    uint64_t                   saved_bytes = 0;
+    std::vector<DataBlob*>     candidates;
+    for (auto* blob : graph.GetDataBlobs()) {
+        if (IsEncodable(graph, *blob, min_elements)) {
+            candidates.push_back(blob);
+        }
+    }
+    // Blobs are stored in a hash map, sort them so that the order of encoded tensors doesn't depend on it.
+    std::sort(candidates.begin(), candidates.end(),
+              [](const DataBlob* lhs, const DataBlob* rhs) { return lhs->GetID() < rhs->GetID(); });
+    for (auto* blob : candidates) {
+        EncodedTensor encoded {blob->GetName(), 0.0f, 0, 0};
+        if (Encode(graph, *blob, min_sparsity, block_rows, block_cols, encoded)) {
+            saved_bytes += encoded.dense_bytes - encoded.sparse_bytes;
+            encoded_tensors.push_back(std::move(encoded));
+        }
+    }
+    LOG(INFO) << "SparseEncoding::Run End. Encoded " << encoded_tensors.size() << " tensors, saved " << saved_bytes
+              << " bytes.";
+    return encoded_tensors;
+}
+
+std::vector<uint8_t> SparseEncoding::Densify(const Graph& graph, const DataBlob& blob) {
+    const auto* buffer = graph.GetBuffer(blob.GetID());
+    REPORT_ERROR_IF(buffer == nullptr, "`", blob.GetName(), "` isn't a constant.");
+    if (!blob.HasSparsityParam()) {
+        return *buffer;
+    }
+    return Densifier(blob, *buffer).Run();
+}
@@ -0,0 +1,56 @@
+#include "transforms/transform_utils.h"
+
+#include "common/stl_wrapper.h"
+
+namespace transforms {
+
+bool IsSameQuantParam(const DataBlob& blob1, const DataBlob& blob2) {
+    if (blob1.HasQuantParam() != blob2.HasQuantParam()) {
+        return false;
+    }
+    if (!blob1.HasQuantParam()) {
+        return true;
+    }
+    const auto& quant_param1 = blob1.GetQuantParam();
+    const auto& quant_param2 = blob2.GetQuantParam();
+    return quant_param1.scales == quant_param2.scales && quant_param1.zero_points == quant_param2.zero_points &&
+           quant_param1.quantized_dimension == quant_param2.quantized_dimension;
+}
+
+bool EraseBlobIfUnused(Graph& graph, DataBlob* blob) {
+    if (!blob->GetConsumers().empty() || blob->GetProducer() != nullptr || graph.IsGraphInput(blob->GetID()) ||
+        graph.IsGraphOutput(blob->GetID())) {
+        return false;
+    }
+    graph.EraseBlob(blob);
+    return true;
+}
+
+uint32_t RemoveDeadOperators(Graph& graph) {
+    uint32_t removed_ops = 0;
+    auto     sorted_ops  = graph.TopologicalSort();
+    // Visit consumers before producers, so a dead chain is removed in one go.
+    for (auto op_it = sorted_ops.rbegin(); op_it != sorted_ops.rend(); op_it++) {
+        auto* op         = *op_it;
+        bool  is_useless = common::all_of(op->GetOutputBlobs(), [&](const DataBlob* blob) {
+            return blob->GetConsumers().empty() && !graph.IsGraphOutput(blob->GetID());
+        });
+        // Operators without outputs, e.g. ASSIGN_VARIABLE, are kept for their side effects.
+        if (!is_useless || op->GetOutputIDs().empty()) {
+            continue;
+        }
+        // Look blobs up by id, an operator may read the same blob more than once.
+        std::vector<BLOBID_T> blob_ids = op->GetInputIDs();
+        blob_ids.insert(blob_ids.end(), op->GetOutputIDs().begin(), op->GetOutputIDs().end());
+        graph.RemoveOperator(op);
+        for (auto blob_id : blob_ids) {
+            if (auto* blob = graph.GetDataBlob(blob_id)) {
+                EraseBlobIfUnused(graph, blob);
+            }
+        }
+        removed_ops++;
+    }
+    return removed_ops;
+}
+
+}  // namespace transforms
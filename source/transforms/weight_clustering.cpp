@@ -0,0 +1,245 @@
+#include "transforms/weight_clustering.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+#include "common/parallel_utils.h"
+
+namespace {
+using ClusteredTensor = WeightClustering::ClusteredTensor;
+using Reconstruction  = WeightClustering::Reconstruction;
+
+// Elements per task, a large tensor is split into tasks of about this size.
+constexpr size_t task_elements = 1 << 20;
+// Values a codebook is fitted on at most, larger channels are sampled with a stride.
+constexpr size_t max_samples    = 1 << 18;
+constexpr int    max_iterations = 64;
+
+struct ClusteringJob {
+    DataBlob*            blob;
+    const float*         values;
+    size_t               size;
+    size_t               channels;
+    size_t               channel_size;
+    std::vector<float>   codebooks;  // [channels, num_clusters], every codebook sorted
+    std::vector<uint8_t> indices;    // GATHER only
+    std::vector<float>   clustered;  // IN_PLACE only
+};
+
+// Channels [begin, end) to fit, or elements [begin, end) to assign with the error statistics of the range.
+struct Task {
+    size_t job;
+    size_t begin;
+    size_t end;
+    float  max_error = 0.0f;
+    double sum_error = 0.0;
+};
+
+bool IsClusterable(const Graph& graph, const DataBlob& blob, uint64_t min_elements) {
+    const auto* buffer = graph.GetBuffer(blob.GetID());
+    return buffer != nullptr && blob.GetDataType() == DataType::FLOAT32 && !blob.HasSparsityParam() &&
+           buffer->size() / sizeof(float) >= min_elements && !graph.IsGraphOutput(blob.GetID());
+}
+
+// Lloyd iterations over sorted values, cluster i takes sorted[splits[i], splits[i + 1]).
+void FitCodebook(const float* values, size_t size, uint32_t num_clusters, float* codebook) {
+    size_t             stride = (size + max_samples - 1) / max_samples;
+    std::vector<float> sorted;
+    sorted.reserve(size / stride + 1);
+    for (size_t index = 0; index < size; index += stride) {
+        if (std::isfinite(values[index])) {
+            sorted.push_back(values[index]);
+        }
+    }
+    if (sorted.empty()) {
+        std::fill(codebook, codebook + num_clusters, 0.0f);
+        return;
+    }
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<double> prefix_sums(sorted.size() + 1, 0.0);
+    for (size_t index = 0; index < sorted.size(); index++) {
+        prefix_sums[index + 1] = prefix_sums[index] + sorted[index];
+    }
+
+    for (uint32_t cluster = 0; cluster < num_clusters; cluster++) {
+        codebook[cluster] = sorted[(2 * cluster + 1) * sorted.size() / (2 * num_clusters)];
+    }
+    std::vector<size_t> splits(num_clusters + 1, 0);
+    splits[num_clusters] = sorted.size();
+    for (int iteration = 0; iteration < max_iterations; iteration++) {
+        bool moved = false;
+        for (uint32_t cluster = 1; cluster < num_clusters; cluster++) {
+            float  boundary = codebook[cluster - 1] / 2 + codebook[cluster] / 2;
+            size_t split =
+                std::lower_bound(sorted.begin() + splits[cluster - 1], sorted.end(), boundary) - sorted.begin();
+            moved           = moved || split != splits[cluster];
+            splits[cluster] = split;
+        }
+        if (iteration > 0 && !moved) {
+            break;
+        }
+        // An empty cluster keeps its centroid.
+        for (uint32_t cluster = 0; cluster < num_clusters; cluster++) {
+            if (splits[cluster + 1] > splits[cluster]) {
+                codebook[cluster] = (prefix_sums[splits[cluster + 1]] - prefix_sums[splits[cluster]]) /
+                                    (splits[cluster + 1] - splits[cluster]);
+            }
+        }
+        std::sort(codebook, codebook + num_clusters);
+    }
+}
+
+void RunFitTask(ClusteringJob& job, uint32_t num_clusters, const Task& task) {
+    for (size_t channel = task.begin; channel < task.end; channel++) {
+        FitCodebook(job.values + channel * job.channel_size, job.channel_size, num_clusters,
+                    job.codebooks.data() + channel * num_clusters);
+    }
+}
+
+// A value takes the centroid whose boundaries enclose it, values on a boundary the upper one as in FitCodebook.
+void RunAssignTask(ClusteringJob& job, uint32_t num_clusters, Task& task) {
+    std::vector<float> boundaries(num_clusters - 1);
+    for (size_t begin = task.begin; begin < task.end;) {
+        size_t       channel  = begin / job.channel_size;
+        size_t       end      = std::min(task.end, (channel + 1) * job.channel_size);
+        const float* codebook = job.codebooks.data() + channel * num_clusters;
+        for (uint32_t cluster = 1; cluster < num_clusters; cluster++) {
+            boundaries[cluster - 1] = codebook[cluster - 1] / 2 + codebook[cluster] / 2;
+        }
+        for (size_t index = begin; index < end; index++) {
+            float value    = job.values[index];
+            auto  cluster  = std::upper_bound(boundaries.begin(), boundaries.end(), value) - boundaries.begin();
+            float error    = std::fabs(codebook[cluster] - value);
+            task.max_error = std::max(task.max_error, error);
+            task.sum_error += error;
+            if (job.indices.empty()) {
+                job.clustered[index] = codebook[cluster];
+            } else {
+                job.indices[index] = cluster;
+            }
+        }
+        begin = end;
+    }
+}
+
+void InsertGather(Graph& graph, ClusteringJob& job, uint32_t num_clusters) {
+    auto* blob     = job.blob;
+    auto* codebook = graph.AddDataBlob(blob->GetName() + "_codebook");
+    codebook->SetDataType(DataType::FLOAT32);
+    codebook->SetShape(job.channels > 1 ? Shape({static_cast<int>(job.channels), static_cast<int>(num_clusters)})
+                                        : Shape({static_cast<int>(num_clusters)}));
+    graph.SetBuffer(codebook->GetID(), job.codebooks);
+
+    auto* clustered = graph.AddDataBlob(blob->GetName() + "_clustered");
+    clustered->SetDataType(DataType::FLOAT32);
+    clustered->SetShape(blob->GetShape());
+    graph.RedirectConsumers(blob, clustered);
+
+    // The model stores one byte per index. TFLite gathers with int16 positions at the least, so a CAST widens them.
+    auto* positions = graph.AddDataBlob(blob->GetName() + "_positions");
+    positions->SetDataType(DataType::INT16);
+    positions->SetShape(blob->GetShape());
+    auto* cast                 = graph.AddOperator(OperatorType::CAST, {blob}, {positions});
+    auto* cast_option          = cast->GetOption<CastOption>();
+    cast_option->in_data_type  = DataType::UINT8;
+    cast_option->out_data_type = DataType::INT16;
+
+    // Per-channel codebooks [C, K] with indices [C, ...] give [C, ...].
+    auto* gather       = graph.AddOperator(OperatorType::GATHER, {codebook, positions}, {clustered});
+    auto* option       = gather->GetOption<GatherOption>();
+    option->axis       = job.channels > 1 ? 1 : 0;
+    option->batch_dims = job.channels > 1 ? 1 : 0;
+
+    graph.SetBuffer(blob->GetID(), job.indices);
+    blob->SetDataType(DataType::UINT8);
+}
+}  // namespace
+
+std::vector<ClusteredTensor> WeightClustering::Run(Graph&                          graph,
+                                                   const std::vector<std::string>& tensor_names,
+                                                   uint32_t                        num_clusters,
+                                                   bool                            per_channel,
+                                                   Reconstruction                  reconstruction,
+                                                   uint64_t                        min_elements,
+                                                   size_t                          num_threads) {
+    LOG(INFO) << "WeightClustering::Run Start.";
+    REPORT_ERROR_IF(num_clusters < 2 || num_clusters > 256, "Number of clusters should be within [2, 256].");
+    std::unordered_set<std::string> selected(tensor_names.begin(), tensor_names.end());
+    std::vector<ClusteringJob>      jobs;
+    for (auto* blob : graph.GetDataBlobs()) {
+        if (!selected.empty() && !selected.erase(blob->GetName())) {
+            continue;
+        }
+        if (!IsClusterable(graph, *blob, tensor_names.empty() ? min_elements : 0)) {
+            continue;
+        }
+        const auto& dims     = blob->GetShape().GetDims();
+        const auto* buffer   = graph.GetBuffer(blob->GetID());
+        size_t      size     = buffer->size() / sizeof(float);
+        size_t      channels = per_channel && dims.size() >= 2 && dims[0] > 0 ? dims[0] : 1;
+        if (size == 0 || size % channels != 0) {
+            continue;
+        }
+        jobs.push_back({blob, reinterpret_cast<const float*>(buffer->data()), size, channels, size / channels, {}, {},
+                        {}});
+    }
+    REPORT_ERROR_IF(!selected.empty(), "Tensor `", *selected.begin(), "` is not found.");
+    // Blobs are stored in a hash map, sort them so that names of inserted blobs don't depend on it.
+    std::sort(jobs.begin(), jobs.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.blob->GetID() < rhs.blob->GetID(); });
+
+    std::vector<Task> fit_tasks;
+    std::vector<Task> assign_tasks;
+    for (size_t index = 0; index < jobs.size(); index++) {
+        auto& job = jobs[index];
+        job.codebooks.resize(job.channels * num_clusters);
+        if (reconstruction == Reconstruction::GATHER) {
+            job.indices.resize(job.size);
+        } else {
+            job.clustered.resize(job.size);
+        }
+        size_t task_channels = std::max<size_t>(1, task_elements / job.channel_size);
+        for (size_t begin = 0; begin < job.channels; begin += task_channels) {
+            fit_tasks.push_back({index, begin, std::min(job.channels, begin + task_channels)});
+        }
+        for (size_t begin = 0; begin < job.size; begin += task_elements) {
+            assign_tasks.push_back({index, begin, std::min(job.size, begin + task_elements)});
+        }
+    }
+    num_threads = num_threads == 0 ? common::default_num_threads() : num_threads;
+    common::parallel_for(fit_tasks.size(), num_threads, [&](size_t index) {
+        RunFitTask(jobs[fit_tasks[index].job], num_clusters, fit_tasks[index]);
+    });
+    common::parallel_for(assign_tasks.size(), num_threads, [&](size_t index) {
+        RunAssignTask(jobs[assign_tasks[index].job], num_clusters, assign_tasks[index]);
+    });
+
+    // Tasks of one job are contiguous.
+    std::vector<ClusteredTensor> clustered_tensors;
+    auto                         task = assign_tasks.begin();
+    for (size_t index = 0; index < jobs.size(); index++) {
+        auto&  job       = jobs[index];
+        float  max_error = 0.0f;
+        double sum_error = 0.0;
+        for (; task != assign_tasks.end() && task->job == index; task++) {
+            max_error = std::max(max_error, task->max_error);
+            sum_error += task->sum_error;
+        }
+        uint64_t original_bytes = job.size * sizeof(float);
+        if (reconstruction == Reconstruction::GATHER) {
+            InsertGather(graph, job, num_clusters);
+        } else {
+            graph.SetBuffer(job.blob->GetID(), job.clustered);
+        }
+        uint64_t clustered_bytes = graph.GetBuffer(job.blob->GetID())->size();
+        if (reconstruction == Reconstruction::GATHER) {
+            clustered_bytes += job.codebooks.size() * sizeof(float);
+        }
+        clustered_tensors.push_back({job.blob->GetName(), static_cast<uint32_t>(job.channels), job.size,
+                                     original_bytes, clustered_bytes, max_error,
+                                     static_cast<float>(sum_error / job.size)});
+    }
+    LOG(INFO) << "WeightClustering::Run End. Clustered " << clustered_tensors.size() << " tensors.";
+    return clustered_tensors;
+}
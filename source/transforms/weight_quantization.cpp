@@ -0,0 +1,331 @@
+#include "transforms/weight_quantization.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+#include "common/parallel_utils.h"
+#include "model/int4_buffer.h"
+
+namespace {
+using QuantizedWeight = WeightQuantization::QuantizedWeight;
+
+// Elements per task, channels of a large tensor are split into tasks of about this size.
+constexpr size_t task_elements = 1 << 20;
+
+// Where the weights of an operator live and how their channels are laid out.
+struct WeightLayout {
+    int weights_index;  // input index of the weights
+    int bias_index;     // input index of the bias, -1 without bias
+    int input_index;    // input index of the activation
+    int channel_axis;   // axis of the output channels in the weights, -1 for per-tensor scales
+};
+
+// Symmetric range of quantized values, i.e. [-QuantizedMax, QuantizedMax].
+float QuantizedMax(DataType weight_type) { return weight_type == DataType::INT4 ? 7.0f : 127.0f; }
+
+bool GetWeightLayout(const Operator& op, DataType weight_type, WeightLayout& layout) {
+    // Kernels take int4 filters for these operators only.
+    if (weight_type == DataType::INT4 && op.GetOpType() != OperatorType::CONV2D &&
+        op.GetOpType() != OperatorType::DEPTHWISE_CONV2D && op.GetOpType() != OperatorType::FULLY_CONNECTED) {
+        return false;
+    }
+    switch (op.GetOpType()) {
+        // Filters are OHWI and weights [output_channels, input_channels].
+        case OperatorType::CONV2D:
+        case OperatorType::FULLY_CONNECTED:
+            layout = {1, 2, 0, 0};
+            return true;
+        // Filter is [1, H, W, output_channels].
+        case OperatorType::DEPTHWISE_CONV2D:
+            layout = {1, 2, 0, 3};
+            return true;
+        // Inputs are output_shape, filter in OHWI, activation and bias.
+        case OperatorType::TRANSPOSE_CONV2D:
+            layout = {1, 3, 2, 0};
+            return true;
+        case OperatorType::BATCH_MATMUL:
+            layout = {1, -1, 0, -1};
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Weights viewed as [outer, channels, inner], channels are quantized independently.
+struct WeightJob {
+    Operator*           op;
+    DataBlob*           weights;
+    DataBlob*           bias;
+    const DataBlob*     input;
+    int                 channel_axis;
+    size_t              outer;
+    size_t              channels;
+    size_t              inner;
+    std::vector<float>  dequantized;  // float values of int8 weights
+    const float*        source;       // float values to quantize
+    std::vector<float>  scales;
+    std::vector<int8_t> values;
+};
+
+// Channels [begin, end) of one job.
+struct Task {
+    size_t job;
+    size_t begin;
+    size_t end;
+};
+
+// Input `index` if it's a dense constant of `data_type` read by `op` only.
+DataBlob* GetOwnedConstant(Graph& graph, Operator& op, int index, DataType data_type) {
+    if (index < 0 || index >= static_cast<int>(op.GetInputIDs().size())) {
+        return nullptr;
+    }
+    auto* blob = op.GetInputBlob(index);
+    if (blob == nullptr || graph.GetBuffer(blob->GetID()) == nullptr || blob->GetDataType() != data_type ||
+        blob->HasSparsityParam() || blob->GetConsumers().size() != 1) {
+        return nullptr;
+    }
+    return blob;
+}
+
+// Float values of quantized integers, whose scales and zero points are per tensor or along the quantized dimension.
+template <typename T> std::vector<float> Dequantize(const Graph& graph, const DataBlob& blob) {
+    const auto& buffer      = *graph.GetBuffer(blob.GetID());
+    const auto& quant_param = blob.GetQuantParam();
+    const auto& dims        = blob.GetShape().GetDims();
+    const auto* values      = reinterpret_cast<const T*>(buffer.data());
+    size_t      channels    = quant_param.scales.size();
+    size_t      inner       = 1;
+    for (size_t axis = quant_param.quantized_dimension + 1; channels > 1 && axis < dims.size(); axis++) {
+        inner *= dims[axis];
+    }
+
+    std::vector<float> dequantized(buffer.size() / sizeof(T));
+    for (size_t index = 0; index < dequantized.size(); index++) {
+        size_t channel     = channels > 1 ? index / inner % channels : 0;
+        auto   zero_point  = channel < quant_param.zero_points.size() ? quant_param.zero_points[channel] : 0;
+        dequantized[index] = (values[index] - zero_point) * quant_param.scales[channel];
+    }
+    return dequantized;
+}
+
+// Fresh quantization parameters, replacing those of int8 weights or int32 bias.
+DataBlob::QuantParam& ResetQuantParam(DataBlob& blob) {
+    auto& quant_param = blob.HasQuantParam() ? blob.GetQuantParam() : blob.CreateQuantParam();
+    quant_param       = DataBlob::QuantParam();
+    return quant_param;
+}
+
+bool HasScales(const DataBlob& blob) { return blob.HasQuantParam() && !blob.GetQuantParam().scales.empty(); }
+
+// Float32 weights, or int8 weights requantized to int4.
+DataBlob* GetWeights(Graph& graph, Operator& op, int index, DataType weight_type) {
+    if (auto* weights = GetOwnedConstant(graph, op, index, DataType::FLOAT32)) {
+        return weights;
+    }
+    auto* weights = weight_type == DataType::INT4 ? GetOwnedConstant(graph, op, index, DataType::INT8) : nullptr;
+    return weights != nullptr && HasScales(*weights) ? weights : nullptr;
+}
+
+// Float32 bias, or int32 bias whose scales follow the old weight scales.
+DataBlob* GetBias(Graph& graph, Operator& op, int index) {
+    if (auto* bias = GetOwnedConstant(graph, op, index, DataType::FLOAT32)) {
+        return bias;
+    }
+    auto* bias = GetOwnedConstant(graph, op, index, DataType::INT32);
+    return bias != nullptr && HasScales(*bias) ? bias : nullptr;
+}
+
+bool CreateJob(Graph& graph, Operator& op, DataType weight_type, uint64_t min_elements, WeightJob& job) {
+    WeightLayout layout;
+    if (!GetWeightLayout(op, weight_type, layout)) {
+        return false;
+    }
+    auto* weights = GetWeights(graph, op, layout.weights_index, weight_type);
+    if (weights == nullptr) {
+        return false;
+    }
+    const auto& dims     = weights->GetShape().GetDims();
+    size_t      elements = graph.GetBuffer(weights->GetID())->size() / (GetBitWidth(weights->GetDataType()) / 8);
+    if (elements < min_elements || layout.channel_axis >= static_cast<int>(dims.size())) {
+        return false;
+    }
+    if (weights->GetDataType() == DataType::INT8) {
+        job.dequantized = Dequantize<int8_t>(graph, *weights);
+    }
+
+    job.op           = &op;
+    job.weights      = weights;
+    job.bias         = GetBias(graph, op, layout.bias_index);
+    job.input        = op.GetInputBlob(layout.input_index);
+    job.channel_axis = layout.channel_axis;
+    job.outer        = 1;
+    job.channels     = 1;
+    job.inner        = elements;
+    if (layout.channel_axis >= 0) {
+        job.channels = dims[layout.channel_axis];
+        for (int axis = 0; axis < layout.channel_axis; axis++) {
+            job.outer *= dims[axis];
+        }
+        job.inner = elements / job.outer / job.channels;
+    }
+    return job.outer * job.channels * job.inner == elements;
+}
+
+// Kept in 8 independent lanes, so that the compiler vectorizes the reduction without relaxing float semantics.
+float AbsMax(const float* values, size_t size) {
+    float  lanes[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    size_t index    = 0;
+    for (; index + 8 <= size; index += 8) {
+        for (size_t lane = 0; lane < 8; lane++) {
+            lanes[lane] = std::max(lanes[lane], std::fabs(values[index + lane]));
+        }
+    }
+    for (; index < size; index++) {
+        lanes[0] = std::max(lanes[0], std::fabs(values[index]));
+    }
+    return *std::max_element(lanes, lanes + 8);
+}
+
+void QuantizeValues(const float* __restrict values,
+                    size_t                  size,
+                    float                   inverse_scale,
+                    float                   quantized_max,
+                    int8_t* __restrict      quantized) {
+    for (size_t index = 0; index < size; index++) {
+        float scaled     = std::min(std::max(values[index] * inverse_scale, -quantized_max), quantized_max);
+        quantized[index] = static_cast<int8_t>(std::round(scaled));
+    }
+}
+
+void RunTask(WeightJob& job, float quantized_max, size_t begin, size_t end) {
+    for (size_t channel = begin; channel < end; channel++) {
+        float abs_max = 0.0f;
+        for (size_t outer = 0; outer < job.outer; outer++) {
+            abs_max = std::max(abs_max, AbsMax(job.source + (outer * job.channels + channel) * job.inner, job.inner));
+        }
+        // All zeros quantize to zeros with any scale.
+        job.scales[channel] = abs_max > 0.0f ? abs_max / quantized_max : 1.0f;
+        for (size_t outer = 0; outer < job.outer; outer++) {
+            size_t offset = (outer * job.channels + channel) * job.inner;
+            QuantizeValues(job.source + offset, job.inner, 1.0f / job.scales[channel], quantized_max,
+                           job.values.data() + offset);
+        }
+    }
+}
+
+// Bias scales follow from the products of input and weight scales, so only a per-tensor input scale gives them.
+bool QuantizeBias(Graph& graph, const WeightJob& job) {
+    if (job.bias == nullptr || job.input == nullptr || !job.input->HasQuantParam() ||
+        job.input->GetQuantParam().scales.size() != 1) {
+        return false;
+    }
+    std::vector<float> values;
+    if (job.bias->GetDataType() == DataType::INT32) {
+        values = Dequantize<int32_t>(graph, *job.bias);
+    } else {
+        const auto* buffer = graph.GetBuffer(job.bias->GetID());
+        values.resize(buffer->size() / sizeof(float));
+        memcpy(values.data(), buffer->data(), buffer->size());
+    }
+    size_t size = values.size();
+    if (size != job.scales.size() && job.scales.size() != 1) {
+        return false;
+    }
+
+    auto                 input_scale = job.input->GetQuantParam().scales[0];
+    std::vector<float>   scales(size);
+    std::vector<int32_t> quantized(size);
+    for (size_t index = 0; index < size; index++) {
+        scales[index]    = input_scale * job.scales[job.scales.size() == 1 ? 0 : index];
+        quantized[index] = static_cast<int32_t>(std::round(values[index] / scales[index]));
+    }
+    graph.SetBuffer(job.bias->GetID(), quantized);
+    job.bias->SetDataType(DataType::INT32);
+    auto& quant_param       = ResetQuantParam(*job.bias);
+    quant_param.scales      = scales;
+    quant_param.zero_points = std::vector<int64_t>(size, 0);
+    return true;
+}
+}  // namespace
+
+std::vector<QuantizedWeight> WeightQuantization::Run(Graph&                          graph,
+                                                     const std::vector<std::string>& op_outputs,
+                                                     DataType                        weight_type,
+                                                     uint64_t                        min_elements,
+                                                     size_t                          num_threads) {
+    LOG(INFO) << "WeightQuantization::Run Start.";
+    REPORT_ERROR_IF(weight_type != DataType::INT8 && weight_type != DataType::INT4, "Weights can't be quantized to ",
+                    ToStr(weight_type), ", only INT8 and INT4 are supported.");
+    std::unordered_set<std::string> selected(op_outputs.begin(), op_outputs.end());
+    std::vector<WeightJob>          jobs;
+    // In execution order rather than the order of the operator hash map, so that the report is reproducible.
+    for (auto* op : graph.TopologicalSort()) {
+        if (!selected.empty() && (op->GetOutputIDs().empty() || !selected.erase(op->GetOutputBlob(0)->GetName()))) {
+            continue;
+        }
+        WeightJob job {};
+        if (CreateJob(graph, *op, weight_type, min_elements, job)) {
+            jobs.push_back(std::move(job));
+        }
+    }
+    REPORT_ERROR_IF(!selected.empty(), "Operator with output `", *selected.begin(), "` is not found.");
+
+    // Channels are independent, so tasks of one tensor never write the same scale or value.
+    std::vector<Task> tasks;
+    for (size_t index = 0; index < jobs.size(); index++) {
+        auto& job  = jobs[index];
+        job.source = job.dequantized.empty()
+                         ? reinterpret_cast<const float*>(graph.GetBuffer(job.weights->GetID())->data())
+                         : job.dequantized.data();
+        job.scales.resize(job.channels);
+        job.values.resize(job.outer * job.channels * job.inner);
+        size_t task_channels = std::max<size_t>(1, task_elements / std::max<size_t>(1, job.outer * job.inner));
+        for (size_t begin = 0; begin < job.channels; begin += task_channels) {
+            tasks.push_back({index, begin, std::min(job.channels, begin + task_channels)});
+        }
+    }
+    auto quantized_max = QuantizedMax(weight_type);
+    common::parallel_for(tasks.size(), num_threads == 0 ? common::default_num_threads() : num_threads,
+                         [&](size_t index) {
+                             const auto& task = tasks[index];
+                             RunTask(jobs[task.job], quantized_max, task.begin, task.end);
+                         });
+
+    std::vector<QuantizedWeight> quantized_weights;
+    uint64_t                     original_bytes  = 0;
+    uint64_t                     quantized_bytes = 0;
+    for (auto& job : jobs) {
+        auto bias_quantized = QuantizeBias(graph, job);
+        auto weights_bytes  = graph.GetBuffer(job.weights->GetID())->size();
+        if (weight_type == DataType::INT4) {
+            graph.SetBuffer(job.weights->GetID(), Int4Buffer::Pack(job.values));
+        } else {
+            graph.SetBuffer(job.weights->GetID(), job.values);
+        }
+        job.weights->SetDataType(weight_type);
+        auto& quant_param               = ResetQuantParam(*job.weights);
+        quant_param.scales              = job.scales;
+        quant_param.zero_points         = std::vector<int64_t>(job.channels, 0);
+        quant_param.quantized_dimension = std::max(job.channel_axis, 0);
+
+        quantized_weights.push_back({job.weights->GetName(), job.op->GetOpType(), static_cast<uint32_t>(job.channels),
+                                     weights_bytes, graph.GetBuffer(job.weights->GetID())->size(), bias_quantized});
+        original_bytes += quantized_weights.back().original_bytes;
+        quantized_bytes += quantized_weights.back().quantized_bytes;
+    }
+    LOG(INFO) << "WeightQuantization::Run End. Quantized " << quantized_weights.size() << " weights from "
+              << original_bytes << " to " << quantized_bytes << " bytes.";
+    return quantized_weights;
+}
+
+DataBlob* WeightQuantization::GetFloatWeights(Graph& graph, Operator& op, DataType weight_type, int& channel_axis) {
+    WeightLayout layout;
+    if (!GetWeightLayout(op, weight_type, layout)) {
+        return nullptr;
+    }
+    channel_axis = layout.channel_axis;
+    return GetOwnedConstant(graph, op, layout.weights_index, DataType::FLOAT32);
+}
@@ -0,0 +1,409 @@
+#include "transforms/weight_sharding.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "common/stl_wrapper.h"
+#include "transforms/transform_utils.h"
+
+namespace {
+using Axis            = WeightSharding::Axis;
+using ShardedOperator = WeightSharding::ShardedOperator;
+
+// Where the channels of an operator live. The activation is always input 0 and the constant weights input 1.
+struct ChannelLayout {
+    int  weights_axis;  // axis of the weights split between shards
+    int  input_axis;    // channel axis of the activation, split between shards along input channels
+    bool has_bias;      // bias is input 2, one value per output channel
+};
+
+bool IsShardable(const Operator& op) {
+    auto op_type = op.GetOpType();
+    return (op_type == OperatorType::FULLY_CONNECTED || op_type == OperatorType::CONV2D ||
+            op_type == OperatorType::BATCH_MATMUL) &&
+           op.GetInputIDs().size() >= 2 && !op.GetOutputIDs().empty();
+}
+
+ChannelLayout GetChannelLayout(const Operator& op, Axis axis) {
+    int  weights_rank   = op.GetInputBlob(1)->GetShape().GetDims().size();
+    int  input_rank     = op.GetInputBlob(0)->GetShape().GetDims().size();
+    bool output_channel = axis == Axis::OUTPUT_CHANNEL;
+    bool has_bias       = op.GetInputIDs().size() > 2 && op.GetInputBlob(2) != nullptr;
+    switch (op.GetOpType()) {
+        // Weights are [output_channels, input_channels].
+        case OperatorType::FULLY_CONNECTED:
+            return {output_channel ? 0 : 1, input_rank - 1, has_bias};
+        // Filter is OHWI and the activation NHWC.
+        case OperatorType::CONV2D:
+            return {output_channel ? 0 : 3, 3, has_bias};
+        // Weights are [..., input_channels, output_channels], or transposed with adj_y.
+        default: {
+            const auto* option      = op.GetOption<BatchMatmulOption>();
+            int         output_axis = option->adj_y ? weights_rank - 2 : weights_rank - 1;
+            int         input_axis  = option->adj_y ? weights_rank - 1 : weights_rank - 2;
+            return {output_channel ? output_axis : input_axis, option->adj_x ? input_rank - 2 : input_rank - 1, false};
+        }
+    }
+}
+
+// Fused activation of the operator, which is reset to NONE when `reset` is set.
+OperatorType TakeActivation(Operator& op, bool reset) {
+    OperatorType* activation_type = nullptr;
+    if (op.GetOpType() == OperatorType::FULLY_CONNECTED) {
+        activation_type = &op.GetOption<FullyConnectedOption>()->activation_type;
+    } else if (op.GetOpType() == OperatorType::CONV2D) {
+        activation_type = &op.GetOption<Conv2DOption>()->activation_type;
+    }
+    if (activation_type == nullptr) {
+        return OperatorType::NONE;
+    }
+    auto activation = *activation_type;
+    if (reset) {
+        *activation_type = OperatorType::NONE;
+    }
+    return activation;
+}
+
+// Rows [begin, end) of `axis`, where a row is everything behind the axis.
+std::vector<uint8_t> SliceBuffer(const std::vector<uint8_t>& buffer,
+                                 const std::vector<int>&     dims,
+                                 int                         axis,
+                                 int                         begin,
+                                 int                         end) {
+    size_t outer = 1;
+    size_t inner = 1;
+    for (int dim = 0; dim < static_cast<int>(dims.size()); dim++) {
+        if (dim < axis) {
+            outer *= dims[dim];
+        } else if (dim > axis) {
+            inner *= dims[dim];
+        }
+    }
+    size_t elements = outer * dims[axis] * inner;
+    REPORT_ERROR_IF(elements == 0 || buffer.size() % elements != 0, "Buffer of ", buffer.size(),
+                    " bytes doesn't match its shape, packed weights can't be sharded.");
+    size_t row_bytes = inner * (buffer.size() / elements);
+
+    std::vector<uint8_t> slice;
+    slice.reserve(outer * (end - begin) * row_bytes);
+    for (size_t index = 0; index < outer; index++) {
+        auto* rows = buffer.data() + (index * dims[axis] + begin) * row_bytes;
+        slice.insert(slice.end(), rows, rows + (end - begin) * row_bytes);
+    }
+    return slice;
+}
+
+// Activation blob with the type and quantization of `like`.
+DataBlob* AddActivation(Graph& graph, const DataBlob& like, const std::string& name, const std::vector<int>& dims) {
+    auto* blob = graph.AddDataBlob(name);
+    blob->SetDataType(like.GetDataType());
+    blob->SetShape(Shape(dims));
+    if (like.HasQuantParam()) {
+        blob->CreateQuantParam() = like.GetQuantParam();
+    }
+    return blob;
+}
+
+// Constant blob holding slice [begin, end) of `constant` along `axis`. Per-channel quantization along the axis is
+// sliced with it.
+DataBlob* SliceConstant(Graph& graph, const DataBlob& constant, int axis, int begin, int end, const std::string& name) {
+    auto dims  = constant.GetShape().GetDims();
+    auto data  = SliceBuffer(*graph.GetBuffer(constant.GetID()), dims, axis, begin, end);
+    auto size  = dims[axis];
+    dims[axis] = end - begin;
+
+    auto* blob = AddActivation(graph, constant, name, dims);
+    graph.SetBuffer(blob->GetID(), data);
+    // The slice keeps quantized_dimension, and parameters along another axis, e.g. output channels of weights sharded
+    // by input channels, are kept whole.
+    if (blob->HasQuantParam() && blob->GetQuantParam().quantized_dimension == axis) {
+        auto& quant_param = blob->GetQuantParam();
+        if (size > 1 && quant_param.scales.size() == static_cast<size_t>(size)) {
+            quant_param.scales.assign(quant_param.scales.begin() + begin, quant_param.scales.begin() + end);
+        }
+        if (size > 1 && quant_param.zero_points.size() == static_cast<size_t>(size)) {
+            quant_param.zero_points.assign(quant_param.zero_points.begin() + begin,
+                                           quant_param.zero_points.begin() + end);
+        }
+    }
+    return blob;
+}
+
+// SPLIT the activation into equal slices along `axis` and return the slice of the shard.
+DataBlob* SplitInput(Graph&             graph,
+                     DataBlob*          input,
+                     int                axis,
+                     uint32_t           num_shards,
+                     uint32_t           shard_index,
+                     const std::string& prefix) {
+    auto* split_axis = graph.AddDataBlob(prefix + "_split_axis");
+    split_axis->SetDataType(DataType::INT32);
+    split_axis->SetShape(Shape(std::vector<int>()));
+    graph.SetBuffer(split_axis->GetID(), std::vector<int32_t>({axis}));
+
+    auto dims = input->GetShape().GetDims();
+    dims[axis] /= num_shards;
+    std::vector<DataBlob*> slices;
+    for (uint32_t shard = 0; shard < num_shards; shard++) {
+        slices.push_back(AddActivation(graph, *input, prefix + "_split" + std::to_string(shard), dims));
+    }
+    auto* split        = graph.AddOperator(OperatorType::SPLIT, {split_axis, input}, slices);
+    auto* option       = split->GetOption<SplitOption>();
+    option->num_splits = num_shards;
+    return slices[shard_index];
+}
+
+Operator* FindShardableOperator(const Graph& graph, const std::string& op_output) {
+    const DataBlob* output = nullptr;
+    for (const auto* blob : graph.GetDataBlobs()) {
+        if (blob->GetName() == op_output) {
+            output = blob;
+            break;
+        }
+    }
+    REPORT_ERROR_IF(output == nullptr, "`", op_output, "` doesn't exist. Please check tensor's name.");
+    auto* op = output->GetProducer();
+    REPORT_ERROR_IF(op == nullptr || !IsShardable(*op) || op->GetOutputBlob(0) != output, "`", op_output,
+                    "` isn't the output of a FULLY_CONNECTED, CONV2D or BATCH_MATMUL operator.");
+    return op;
+}
+
+// Stage of every selected operator: the most selected operators on any path into it, i.e. the exchanges of partial
+// results its inputs wait for.
+std::unordered_map<const Operator*, uint32_t> GetStages(const Graph& graph, const std::vector<Operator*>& ops) {
+    std::unordered_set<const Operator*>           selected(ops.begin(), ops.end());
+    std::unordered_map<const Operator*, uint32_t> levels;
+    for (const auto* op : graph.TopologicalSort()) {
+        uint32_t level = 0;
+        for (auto blob_id : op->GetInputIDs()) {
+            const auto* blob     = graph.GetDataBlob(blob_id);
+            const auto* producer = blob != nullptr ? blob->GetProducer() : nullptr;
+            if (producer != nullptr) {
+                level = std::max(level, levels.at(producer) + (common::contains(selected, producer) ? 1 : 0));
+            }
+        }
+        levels[op] = level;
+    }
+    std::unordered_map<const Operator*, uint32_t> stages;
+    for (const auto* op : ops) {
+        stages[op] = levels.at(op);
+    }
+    return stages;
+}
+
+ShardedOperator ShardOperator(Graph&    graph,
+                              Operator* op,
+                              Axis      axis,
+                              uint32_t  num_shards,
+                              uint32_t  shard_index,
+                              uint32_t  stage) {
+    auto* input          = op->GetInputBlob(0);
+    auto* weights        = op->GetInputBlob(1);
+    auto* output         = op->GetOutputBlob(0);
+    auto  output_dims    = output->GetShape().GetDims();
+    bool  output_channel = axis == Axis::OUTPUT_CHANNEL;
+    REPORT_ERROR_IF(graph.GetBuffer(weights->GetID()) == nullptr, "Weights of `", output->GetName(),
+                    "` aren't constant, they can't be sharded.");
+    REPORT_ERROR_IF(weights->HasSparsityParam(), "Weights of `", output->GetName(),
+                    "` are sparse, they can't be sharded.");
+    REPORT_ERROR_IF(output_dims.empty(), "Shape of `", output->GetName(), "` is unknown.");
+
+    auto        layout       = GetChannelLayout(*op, axis);
+    const auto& weights_dims = weights->GetShape().GetDims();
+    REPORT_ERROR_IF(layout.weights_axis < 0 || layout.weights_axis >= static_cast<int>(weights_dims.size()),
+                    "Shape of weights of `", output->GetName(), "` doesn't match its operator.");
+    int channels = weights_dims[layout.weights_axis];
+    REPORT_ERROR_IF(channels % num_shards != 0, "`", output->GetName(), "` has ", channels,
+                    " channels which can't be split into ", num_shards, " equal shards.");
+    int begin = channels / num_shards * shard_index;
+    int end   = begin + channels / num_shards;
+
+    ShardedOperator sharded_op {output->GetName(),
+                                op->GetOpType(),
+                                output_channel ? OperatorType::CONCAT : OperatorType::ADD,
+                                channels,
+                                {},
+                                stage};
+    for (uint32_t shard = 0; shard < num_shards; shard++) {
+        sharded_op.partials.push_back(output->GetName() + "_shard" + std::to_string(shard));
+    }
+
+    auto                   suffix         = "_shard" + std::to_string(shard_index);
+    std::vector<DataBlob*> partial_inputs = {
+        input, SliceConstant(graph, *weights, layout.weights_axis, begin, end, weights->GetName() + suffix)};
+    if (output_channel) {
+        REPORT_ERROR_IF(output_dims.back() != channels, "Output channels of `", output->GetName(),
+                        "` don't match its weights.");
+        output_dims.back() = end - begin;
+        if (layout.has_bias) {
+            auto* bias = op->GetInputBlob(2);
+            partial_inputs.push_back(SliceConstant(graph, *bias, 0, begin, end, bias->GetName() + suffix));
+        }
+    } else {
+        // Requantizing partial sums would change results, only float outputs are summed exactly.
+        REPORT_ERROR_IF(output->HasQuantParam(), "`", output->GetName(),
+                        "` is quantized, shard it along output channels instead.");
+        const auto& input_dims = input->GetShape().GetDims();
+        REPORT_ERROR_IF(layout.input_axis < 0 || layout.input_axis >= static_cast<int>(input_dims.size()) ||
+                            input_dims[layout.input_axis] != channels,
+                        "Input channels of `", output->GetName(), "` don't match its weights.");
+        partial_inputs[0] = SplitInput(graph, input, layout.input_axis, num_shards, shard_index, output->GetName());
+        if (layout.has_bias && shard_index == 0) {
+            partial_inputs.push_back(op->GetInputBlob(2));
+        }
+    }
+
+    std::vector<DataBlob*> partials;
+    for (const auto& partial_name : sharded_op.partials) {
+        partials.push_back(AddActivation(graph, *output, partial_name, output_dims));
+    }
+    auto op_type    = op->GetOpType();
+    auto option     = op->HasOption() ? op->GetBaseOption()->Clone() : nullptr;
+    auto old_inputs = op->GetInputIDs();
+    graph.RemoveOperator(op);
+    auto* partial_op = graph.AddOperator(op_type, partial_inputs, {partials[shard_index]});
+    partial_op->SetOption(std::move(option));
+
+    if (output_channel) {
+        auto* concat            = graph.AddOperator(OperatorType::CONCAT, partials, {output});
+        auto* option            = concat->GetOption<ConcatOption>();
+        option->axis            = output_dims.size() - 1;
+        option->activation_type = OperatorType::NONE;
+    } else {
+        // Add in shard order so that every shard computes the same sum, and activate the full sum only.
+        auto  activation = TakeActivation(*partial_op, true);
+        auto* sum        = partials[0];
+        for (uint32_t shard = 1; shard < num_shards; shard++) {
+            auto* sum_out = output;
+            if (shard + 1 < num_shards) {
+                sum_out = AddActivation(graph, *output, output->GetName() + "_sum" + std::to_string(shard),
+                                        output->GetShape().GetDims());
+            }
+            auto* add               = graph.AddOperator(OperatorType::ADD, {sum, partials[shard]}, {sum_out});
+            auto* option            = add->GetOption<AddOption>();
+            option->pot_scale_int16 = false;
+            option->activation_type = sum_out == output ? activation : OperatorType::NONE;
+            sum                     = sum_out;
+        }
+    }
+
+    for (auto blob_id : old_inputs) {
+        if (auto* blob = graph.GetDataBlob(blob_id)) {
+            transforms::EraseBlobIfUnused(graph, blob);
+        }
+    }
+    auto graph_inputs  = graph.GetGraphInputs();
+    auto graph_outputs = graph.GetGraphOutputs();
+    for (uint32_t shard = 0; shard < num_shards; shard++) {
+        (shard == shard_index ? graph_outputs : graph_inputs).push_back(partials[shard]->GetID());
+    }
+    graph.SetGraphInputs(graph_inputs);
+    graph.SetGraphOutputs(graph_outputs);
+    return sharded_op;
+}
+}  // namespace
+
+std::vector<WeightSharding::ShardedOperator> WeightSharding::Run(Graph&                          graph,
+                                                                 const std::vector<std::string>& op_outputs,
+                                                                 Axis                            axis,
+                                                                 uint32_t                        num_shards,
+                                                                 uint32_t                        shard_index) {
+    LOG(INFO) << "WeightSharding::Run Start.";
+    REPORT_ERROR_IF(num_shards < 2 || shard_index >= num_shards, "Shard ", shard_index, " of ", num_shards,
+                    " shards is invalid, at least 2 shards are needed.");
+    std::vector<Operator*> ops;
+    for (const auto& op_output : op_outputs) {
+        ops.push_back(FindShardableOperator(graph, op_output));
+        REPORT_ERROR_IF(std::count(ops.begin(), ops.end(), ops.back()) > 1, "`", op_output, "` is selected twice.");
+    }
+    auto stages = GetStages(graph, ops);
+
+    std::vector<ShardedOperator> sharded_ops;
+    for (auto* op : ops) {
+        sharded_ops.push_back(ShardOperator(graph, op, axis, num_shards, shard_index, stages.at(op)));
+    }
+    LOG(INFO) << "WeightSharding::Run End. Shard " << shard_index << " of " << num_shards << " holds slices of "
+              << sharded_ops.size() << " operators.";
+    return sharded_ops;
+}
+
+std::vector<GraphView> WeightSharding::SplitStages(const Graph&                        graph,
+                                                   const std::vector<ShardedOperator>& sharded_ops) {
+    // Partial results of the other shards are available once their stage has been exchanged.
+    std::unordered_map<BLOBID_T, uint32_t> ready_stages;
+    for (const auto& sharded_op : sharded_ops) {
+        for (auto blob_id : graph.GetGraphInputs()) {
+            if (common::contains(sharded_op.partials, graph.GetDataBlob(blob_id)->GetName())) {
+                ready_stages[blob_id] = sharded_op.stage + 1;
+            }
+        }
+    }
+    auto                  sorted_ops = graph.TopologicalSort();
+    std::vector<uint32_t> op_stages;
+    uint32_t              num_stages = 1;
+    for (const auto* op : sorted_ops) {
+        uint32_t stage = 0;
+        for (auto blob_id : op->GetInputIDs()) {
+            auto ready = ready_stages.find(blob_id);
+            stage      = ready != ready_stages.end() ? std::max(stage, ready->second) : stage;
+        }
+        for (auto blob_id : op->GetOutputIDs()) {
+            ready_stages[blob_id] = stage;
+        }
+        op_stages.push_back(stage);
+        num_stages = std::max(num_stages, stage + 1);
+    }
+
+    // A blob crosses stages if an operator of a later stage reads it.
+    std::unordered_map<BLOBID_T, uint32_t> last_reads;
+    for (size_t index = 0; index < sorted_ops.size(); index++) {
+        for (auto blob_id : sorted_ops[index]->GetInputIDs()) {
+            last_reads[blob_id] = std::max(last_reads[blob_id], op_stages[index]);
+        }
+    }
+    std::vector<GraphView> stages;
+    for (uint32_t stage = 0; stage < num_stages; stage++) {
+        std::vector<const Operator*> ops;
+        std::vector<BLOBID_T>        inputs;
+        std::vector<BLOBID_T>        outputs;
+        for (size_t index = 0; index < sorted_ops.size(); index++) {
+            if (op_stages[index] != stage) {
+                continue;
+            }
+            const auto* op = sorted_ops[index];
+            ops.push_back(op);
+            for (auto blob_id : op->GetInputIDs()) {
+                const auto* blob     = graph.GetDataBlob(blob_id);
+                bool        is_input = blob != nullptr && graph.GetBuffer(blob_id) == nullptr &&
+                                (blob->GetProducer() == nullptr || ready_stages.at(blob_id) < stage);
+                if (is_input && !common::contains(inputs, blob_id)) {
+                    inputs.push_back(blob_id);
+                }
+            }
+            for (auto blob_id : op->GetOutputIDs()) {
+                auto last_read = last_reads.find(blob_id);
+                if (graph.IsGraphOutput(blob_id) || (last_read != last_reads.end() && last_read->second > stage)) {
+                    outputs.push_back(blob_id);
+                }
+            }
+        }
+        stages.emplace_back(graph, std::move(ops), std::move(inputs), std::move(outputs));
+    }
+    return stages;
+}
+
+std::vector<std::string> WeightSharding::FindCandidates(const Graph& graph, uint64_t min_weight_bytes) {
+    std::vector<std::string> op_outputs;
+    for (const auto* op : graph.TopologicalSort()) {
+        if (!IsShardable(*op)) {
+            continue;
+        }
+        const auto* weights = graph.GetBuffer(op->GetInputIDs()[1]);
+        if (weights != nullptr && weights->size() >= min_weight_bytes && !op->GetInputBlob(1)->HasSparsityParam()) {
+            op_outputs.push_back(op->GetOutputBlob(0)->GetName());
+        }
+    }
+    return op_outputs;
+}
@@ -0,0 +1,112 @@
+#include "analysis/alias_analysis.h"
+
+#include "analysis/memory_planner.h"
+#include "googletest/include/gtest/gtest.h"
+
+namespace {
+DataBlob* AddActivation(Graph& graph, const std::string& name, const std::vector<int>& dims) {
+    auto* blob = graph.AddDataBlob(name);
+    blob->SetDataType(DataType::FLOAT32);
+    blob->SetShape(Shape(dims));
+    return blob;
+}
+
+const AliasAnalysis::Alias* FindAlias(const std::vector<AliasAnalysis::Alias>& aliases, const DataBlob* blob) {
+    for (const auto& alias : aliases) {
+        if (alias.blob_id == blob->GetID()) {
+            return &alias;
+        }
+    }
+    return nullptr;
+}
+}  // namespace
+
+TEST(ALIAS_ANALYSIS_TEST, ReshapeThenInPlace) {
+    Graph graph;
+    auto* input    = AddActivation(graph, "input", {1, 4, 4});
+    auto* scale    = AddActivation(graph, "scale", {1});
+    auto* scaled   = AddActivation(graph, "scaled", {1, 4, 4});
+    auto* reshaped = AddActivation(graph, "reshaped", {1, 16});
+    auto* relu     = AddActivation(graph, "relu", {1, 16});
+    auto* output   = AddActivation(graph, "output", {1, 16});
+    graph.SetBuffer(scale->GetID(), std::vector<float>({2.0F}));
+    graph.AddOperator(OperatorType::MUL, {input, scale}, {scaled});
+    graph.AddOperator(OperatorType::RESHAPE, {scaled}, {reshaped});
+    graph.AddOperator(OperatorType::ReLU, {reshaped}, {relu});
+    graph.AddOperator(OperatorType::TANH, {relu}, {output});
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    auto aliases = AliasAnalysis::Analyze(graph);
+    // MUL can't write into the graph input and the graph output owns its memory.
+    ASSERT_EQ(aliases.size(), 2U);
+    ASSERT_NE(FindAlias(aliases, reshaped), nullptr);
+    EXPECT_EQ(FindAlias(aliases, reshaped)->base_id, scaled->GetID());
+    EXPECT_EQ(FindAlias(aliases, reshaped)->kind, AliasAnalysis::AliasKind::RESHAPE);
+    ASSERT_NE(FindAlias(aliases, relu), nullptr);
+    EXPECT_EQ(FindAlias(aliases, relu)->base_id, scaled->GetID());
+    EXPECT_EQ(FindAlias(aliases, relu)->kind, AliasAnalysis::AliasKind::IN_PLACE);
+
+    auto plan = MemoryPlanner::Plan(graph, MemoryPlanner::Strategy::GREEDY_BY_SIZE, 64, aliases);
+    EXPECT_TRUE(MemoryPlanner::Verify(plan));
+    EXPECT_EQ(plan.allocations.size(), 3U);
+    EXPECT_EQ(plan.naive_bytes, 5U * 64);
+}
+
+TEST(ALIAS_ANALYSIS_TEST, KeepInputReadLater) {
+    // relu can't overwrite x, which is read again by ADD.
+    Graph graph;
+    auto* input  = AddActivation(graph, "input", {1, 8});
+    auto* x      = AddActivation(graph, "x", {1, 8});
+    auto* y      = AddActivation(graph, "y", {1, 8});
+    auto* z      = AddActivation(graph, "z", {1, 8});
+    auto* output = AddActivation(graph, "output", {1, 8});
+    graph.AddOperator(OperatorType::NEG, {input}, {x});
+    graph.AddOperator(OperatorType::ReLU, {x}, {y});
+    graph.AddOperator(OperatorType::ADD, {y, x}, {z});
+    graph.AddOperator(OperatorType::TANH, {z}, {output});
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    auto aliases = AliasAnalysis::Analyze(graph);
+    EXPECT_EQ(FindAlias(aliases, y), nullptr);
+    ASSERT_NE(FindAlias(aliases, z), nullptr);
+    EXPECT_EQ(FindAlias(aliases, z)->base_id, y->GetID());
+}
+
+TEST(ALIAS_ANALYSIS_TEST, ConcatAndSplitSlices) {
+    Graph graph;
+    auto* input0 = AddActivation(graph, "input0", {1, 4});
+    auto* input1 = AddActivation(graph, "input1", {1, 6});
+    auto* left   = AddActivation(graph, "left", {1, 4});
+    auto* right  = AddActivation(graph, "right", {1, 6});
+    auto* concat = AddActivation(graph, "concat", {1, 10});
+    auto* axis   = graph.AddDataBlob("axis");
+    auto* first  = AddActivation(graph, "first", {1, 5});
+    auto* second = AddActivation(graph, "second", {1, 5});
+    auto* output = AddActivation(graph, "output", {1, 5});
+    axis->SetDataType(DataType::INT32);
+    axis->SetShape(Shape({1}));
+    graph.SetBuffer(axis->GetID(), std::vector<int32_t>({1}));
+    graph.AddOperator(OperatorType::NEG, {input0}, {left});
+    graph.AddOperator(OperatorType::NEG, {input1}, {right});
+    graph.AddOperator(OperatorType::CONCAT, {left, right}, {concat})->GetOption<ConcatOption>()->axis = 1;
+    graph.AddOperator(OperatorType::SPLIT, {axis, concat}, {first, second});
+    graph.AddOperator(OperatorType::MUL, {first, second}, {output});
+    graph.SetGraphInputs({input0->GetID(), input1->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    auto aliases = AliasAnalysis::Analyze(graph);
+    ASSERT_EQ(aliases.size(), 4U);
+    EXPECT_EQ(FindAlias(aliases, left)->byte_offset, 0U);
+    EXPECT_EQ(FindAlias(aliases, right)->byte_offset, 16U);
+    EXPECT_EQ(FindAlias(aliases, right)->kind, AliasAnalysis::AliasKind::CONCAT_SLICE);
+    EXPECT_EQ(FindAlias(aliases, second)->base_id, concat->GetID());
+    EXPECT_EQ(FindAlias(aliases, second)->byte_offset, 20U);
+    EXPECT_EQ(FindAlias(aliases, second)->kind, AliasAnalysis::AliasKind::SPLIT_SLICE);
+
+    auto plan = MemoryPlanner::Plan(graph, MemoryPlanner::Strategy::BEST_FIT, 4, aliases);
+    EXPECT_TRUE(MemoryPlanner::Verify(plan));
+    // input0, input1, concat and output.
+    EXPECT_EQ(plan.allocations.size(), 4U);
+}
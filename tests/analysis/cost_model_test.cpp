@@ -0,0 +1,99 @@
+#include "analysis/cost_model.h"
+
+#include "googletest/include/gtest/gtest.h"
+
+namespace {
+DataBlob* AddBlob(Graph& graph, const std::string& name, const std::vector<int>& dims, DataType data_type) {
+    auto* blob = graph.AddDataBlob(name);
+    blob->SetDataType(data_type);
+    blob->SetShape(Shape(dims));
+    return blob;
+}
+}  // namespace
+
+TEST(COST_MODEL_TEST, MatmulOperators) {
+    Graph graph;
+    // 3x3 convolution from 3 to 16 channels with bias.
+    auto* input  = AddBlob(graph, "input", {1, 8, 8, 3}, DataType::FLOAT32);
+    auto* filter = AddBlob(graph, "filter", {16, 3, 3, 3}, DataType::FLOAT32);
+    auto* bias   = AddBlob(graph, "bias", {16}, DataType::FLOAT32);
+    auto* conv   = AddBlob(graph, "conv", {1, 8, 8, 16}, DataType::FLOAT32);
+    graph.SetBuffer(filter->GetID(), std::vector<float>(16 * 3 * 3 * 3));
+    graph.SetBuffer(bias->GetID(), std::vector<float>(16));
+    auto* conv_op                = graph.AddOperator(OperatorType::CONV2D, {input, filter, bias}, {conv});
+    auto* conv_option            = conv_op->GetOption<Conv2DOption>();
+    conv_option->stride_w        = 1;
+    conv_option->stride_h        = 1;
+    conv_option->dilation_w      = 1;
+    conv_option->dilation_h      = 1;
+    conv_option->pad_type        = Padding::SAME;
+    conv_option->activation_type = OperatorType::NONE;
+
+    // Int8 fully connected from 128 to 64 units without bias.
+    auto* features = AddBlob(graph, "features", {4, 128}, DataType::FLOAT32);
+    auto* weights  = AddBlob(graph, "weights", {64, 128}, DataType::INT8);
+    auto* dense    = AddBlob(graph, "dense", {4, 64}, DataType::FLOAT32);
+    graph.SetBuffer(weights->GetID(), std::vector<int8_t>(64 * 128));
+    graph.AddOperator(OperatorType::FULLY_CONNECTED, {features, weights}, {dense});
+
+    // Batch matmul with adjoint x, the reduction dim is the second last one of x.
+    auto* lhs    = AddBlob(graph, "lhs", {2, 16, 8}, DataType::FLOAT32);
+    auto* rhs    = AddBlob(graph, "rhs", {2, 16, 32}, DataType::FLOAT32);
+    auto* matmul = AddBlob(graph, "matmul", {2, 8, 32}, DataType::FLOAT32);
+    auto* bmm_op = graph.AddOperator(OperatorType::BATCH_MATMUL, {lhs, rhs}, {matmul});
+    bmm_op->GetOption<BatchMatmulOption>()->adj_x = true;
+
+    auto conv_cost = CostModel::EstimateOperator(graph, *conv_op);
+    EXPECT_EQ(conv_cost.macs, 8U * 8 * 16 * 27);
+    EXPECT_EQ(conv_cost.flops, 2U * 8 * 8 * 16 * 27 + 8 * 8 * 16);
+    EXPECT_EQ(conv_cost.weight_bytes, (16U * 27 + 16) * 4);
+    EXPECT_EQ(conv_cost.input_bytes, 8U * 8 * 3 * 4);
+    EXPECT_EQ(conv_cost.output_bytes, 8U * 8 * 16 * 4);
+
+    auto costs = CostModel::EstimateGraph(graph);
+    ASSERT_EQ(costs.size(), 3U);
+    for (const auto& cost : costs) {
+        if (cost.op->GetOpType() == OperatorType::FULLY_CONNECTED) {
+            EXPECT_EQ(cost.macs, 4U * 64 * 128);
+            EXPECT_EQ(cost.flops, 2U * 4 * 64 * 128);
+            EXPECT_EQ(cost.weight_bytes, 64U * 128);
+        } else if (cost.op->GetOpType() == OperatorType::BATCH_MATMUL) {
+            EXPECT_EQ(cost.macs, 2U * 8 * 32 * 16);
+            EXPECT_EQ(cost.weight_bytes, 0U);
+            EXPECT_EQ(cost.input_bytes, (2U * 16 * 8 + 2 * 16 * 32) * 4);
+        }
+    }
+}
+
+TEST(COST_MODEL_TEST, Roofline) {
+    Graph graph;
+    auto* input  = AddBlob(graph, "input", {1, 16, 16, 8}, DataType::FLOAT32);
+    auto* pooled = AddBlob(graph, "pooled", {1, 8, 8, 8}, DataType::FLOAT32);
+    auto* relu   = AddBlob(graph, "relu", {1, 8, 8, 8}, DataType::FLOAT32);
+    auto* pool   = graph.AddOperator(OperatorType::MAX_POOL, {input}, {pooled});
+
+    auto* pool_option     = pool->GetOption<Pool2DOption>();
+    pool_option->stride_w = 2;
+    pool_option->stride_h = 2;
+    pool_option->filter_w = 2;
+    pool_option->filter_h = 2;
+    pool_option->pad_type = Padding::VALID;
+    auto* act = graph.AddOperator(OperatorType::ReLU, {pooled}, {relu});
+
+    auto pool_cost = CostModel::EstimateOperator(graph, *pool);
+    auto act_cost  = CostModel::EstimateOperator(graph, *act);
+    EXPECT_EQ(pool_cost.macs, 0U);
+    EXPECT_EQ(pool_cost.flops, 8U * 8 * 8 * 4);
+    EXPECT_EQ(act_cost.flops, 8U * 8 * 8);
+    EXPECT_DOUBLE_EQ(act_cost.ArithmeticIntensity(), 1.0 / 8);
+
+    // Pooling runs at 0.2 FLOP/B and ReLU at 0.125 FLOP/B, only pooling is compute bound above the ridge at 0.15.
+    CostModel::Roofline low_ridge {10.0, 100.0};
+    CostModel::Roofline high_ridge {15.0, 100.0};
+    EXPECT_TRUE(low_ridge.IsComputeBound(pool_cost));
+    EXPECT_TRUE(low_ridge.IsComputeBound(act_cost));
+    EXPECT_TRUE(high_ridge.IsComputeBound(pool_cost));
+    EXPECT_FALSE(high_ridge.IsComputeBound(act_cost));
+    EXPECT_DOUBLE_EQ(high_ridge.EstimateSeconds(act_cost), act_cost.MemoryBytes() / 100e9);
+    EXPECT_DOUBLE_EQ(low_ridge.EstimateSeconds(pool_cost), pool_cost.flops / 10e9);
+}
@@ -0,0 +1,70 @@
+#include "analysis/memory_planner.h"
+
+#include "googletest/include/gtest/gtest.h"
+
+namespace {
+DataBlob* AddActivation(Graph& graph, const std::string& name, int channels) {
+    auto* blob = graph.AddDataBlob(name);
+    blob->SetDataType(DataType::FLOAT32);
+    blob->SetShape(Shape({1, channels}));
+    return blob;
+}
+}  // namespace
+
+TEST(MEMORY_PLANNER_TEST, ReuseAlongChain) {
+    // input -> relu -> relu -> relu -> output, at most two tensors are alive at the same time.
+    Graph graph;
+    auto* input = AddActivation(graph, "input", 256);
+    auto* blob  = input;
+    for (int index = 0; index < 4; index++) {
+        auto* output = AddActivation(graph, "relu" + std::to_string(index), 256);
+        graph.AddOperator(OperatorType::ReLU, {blob}, {output});
+        blob = output;
+    }
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({blob->GetID()});
+
+    for (auto strategy : {MemoryPlanner::Strategy::GREEDY_BY_SIZE, MemoryPlanner::Strategy::BEST_FIT}) {
+        auto plan = MemoryPlanner::Plan(graph, strategy);
+        EXPECT_TRUE(MemoryPlanner::Verify(plan));
+        EXPECT_EQ(plan.allocations.size(), 5U);
+        EXPECT_EQ(plan.naive_bytes, 5U * 1024);
+        EXPECT_EQ(plan.arena_bytes, 2U * 1024);
+    }
+}
+
+TEST(MEMORY_PLANNER_TEST, BranchesAndConstants) {
+    // A residual block whose skip connection stays alive while the branch runs, weights are not planned.
+    Graph graph;
+    auto* input   = AddActivation(graph, "input", 64);
+    auto* weights = AddActivation(graph, "weights", 64);
+    auto* wide    = AddActivation(graph, "wide", 1024);
+    auto* narrow  = AddActivation(graph, "narrow", 64);
+    auto* sum     = AddActivation(graph, "sum", 64);
+    auto* output  = AddActivation(graph, "output", 100);
+    graph.SetBuffer(weights->GetID(), std::vector<float>(64));
+    graph.AddOperator(OperatorType::MUL, {input, weights}, {wide});
+    graph.AddOperator(OperatorType::MEAN, {wide}, {narrow});
+    graph.AddOperator(OperatorType::ADD, {input, narrow}, {sum});
+    graph.AddOperator(OperatorType::TANH, {sum}, {output});
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    auto greedy   = MemoryPlanner::Plan(graph, MemoryPlanner::Strategy::GREEDY_BY_SIZE, 16);
+    auto best_fit = MemoryPlanner::Plan(graph, MemoryPlanner::Strategy::BEST_FIT, 16);
+    for (const auto* plan : {&greedy, &best_fit}) {
+        EXPECT_TRUE(MemoryPlanner::Verify(*plan));
+        EXPECT_EQ(plan->allocations.size(), 5U);
+        EXPECT_EQ(plan->naive_bytes, 256U + 4096U + 256U + 256U + 400U);
+        // input, wide and narrow are alive together at MEAN.
+        EXPECT_GE(plan->arena_bytes, 256U + 4096U + 256U);
+        EXPECT_LT(plan->arena_bytes, plan->naive_bytes);
+    }
+    EXPECT_EQ(greedy.arena_bytes, 256U + 4096U + 256U);
+
+    std::map<BLOBID_T, uint32_t> tensor_indices;
+    for (const auto& allocation : greedy.allocations) {
+        tensor_indices[allocation.blob_id] = static_cast<uint32_t>(tensor_indices.size());
+    }
+    EXPECT_EQ(MemoryPlanner::Encode(greedy, tensor_indices).size(), 20U + 5 * 28U + 4U);
+}
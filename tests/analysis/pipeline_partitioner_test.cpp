@@ -0,0 +1,69 @@
+#include "analysis/pipeline_partitioner.h"
+
+#include "googletest/include/gtest/gtest.h"
+
+namespace {
+// Bandwidth bound target, so every operator costs the bytes it reads and writes.
+const CostModel::Roofline roofline {1000.0, 1.0};
+
+DataBlob* AddActivation(Graph& graph, const std::string& name) {
+    auto* blob = graph.AddDataBlob(name);
+    blob->SetDataType(DataType::FLOAT32);
+    blob->SetShape(Shape({1, 256}));
+    return blob;
+}
+}  // namespace
+
+TEST(PIPELINE_PARTITIONER_TEST, BalancedChain) {
+    Graph                  graph;
+    std::vector<DataBlob*> blobs = {AddActivation(graph, "input")};
+    for (int index = 0; index < 8; index++) {
+        blobs.push_back(AddActivation(graph, "relu" + std::to_string(index)));
+        graph.AddOperator(OperatorType::ReLU, {blobs[index]}, {blobs[index + 1]});
+    }
+    graph.SetGraphInputs({blobs.front()->GetID()});
+    graph.SetGraphOutputs({blobs.back()->GetID()});
+
+    auto partition = PipelinePartitioner::Run(graph, 4, roofline);
+    ASSERT_EQ(partition.stages.size(), 4U);
+    EXPECT_EQ(partition.boundary_bytes, std::vector<uint64_t>(3, 1024));
+    for (uint32_t index = 0; index < 4; index++) {
+        const auto& stage = partition.stages[index];
+        EXPECT_EQ(stage.begin, 2 * index);
+        EXPECT_EQ(stage.end, 2 * index + 2);
+        EXPECT_EQ(stage.inputs, std::vector<BLOBID_T> {blobs[2 * index]->GetID()});
+        EXPECT_EQ(stage.outputs, std::vector<BLOBID_T> {blobs[2 * index + 2]->GetID()});
+    }
+}
+
+TEST(PIPELINE_PARTITIONER_TEST, FewerBoundaryBytesWithinTolerance) {
+    // input -> r0 -> r1 -> r2 -> r3 -> add(r3, r0), the skip connection crosses every cut but the first one.
+    Graph graph;
+    auto* input = AddActivation(graph, "input");
+    auto* r0    = AddActivation(graph, "r0");
+    auto* r1    = AddActivation(graph, "r1");
+    auto* r2    = AddActivation(graph, "r2");
+    auto* r3    = AddActivation(graph, "r3");
+    auto* sum   = AddActivation(graph, "sum");
+    graph.AddOperator(OperatorType::ReLU, {input}, {r0});
+    graph.AddOperator(OperatorType::ReLU, {r0}, {r1});
+    graph.AddOperator(OperatorType::ReLU, {r1}, {r2});
+    graph.AddOperator(OperatorType::ReLU, {r2}, {r3});
+    graph.AddOperator(OperatorType::ADD, {r3, r0}, {sum});
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({sum->GetID()});
+
+    // The most balanced split is after r2, where r2 and r0 cross.
+    auto balanced = PipelinePartitioner::Run(graph, 2, roofline, 0.0);
+    EXPECT_EQ(balanced.stages[0].end, 3U);
+    EXPECT_EQ(balanced.boundary_bytes, std::vector<uint64_t> {2048});
+    EXPECT_EQ(balanced.stages[0].outputs, (std::vector<BLOBID_T> {r0->GetID(), r2->GetID()}));
+    EXPECT_EQ(balanced.stages[1].inputs, (std::vector<BLOBID_T> {r2->GetID(), r0->GetID()}));
+    EXPECT_EQ(balanced.stages[1].outputs, std::vector<BLOBID_T> {sum->GetID()});
+
+    // Allowing a slower stage, only r0 crosses.
+    auto relaxed = PipelinePartitioner::Run(graph, 2, roofline, 1.0);
+    EXPECT_EQ(relaxed.stages[0].end, 1U);
+    EXPECT_EQ(relaxed.boundary_bytes, std::vector<uint64_t> {1024});
+    EXPECT_DOUBLE_EQ(relaxed.stages[0].seconds + relaxed.stages[1].seconds, 11264 / 1e9);
+}
@@ -0,0 +1,71 @@
+#include "analysis/repeated_block_detector.h"
+
+#include "googletest/include/gtest/gtest.h"
+
+namespace {
+DataBlob* AddBlob(Graph& graph, const std::string& name, const std::vector<int>& dims) {
+    auto* blob = graph.AddDataBlob(name);
+    blob->SetDataType(DataType::FLOAT32);
+    blob->SetShape(Shape(dims));
+    return blob;
+}
+
+// x -> FULLY_CONNECTED -> ADD x -> MUL mask, every block with weights of its own.
+DataBlob* AddBlock(Graph& graph, DataBlob* input, DataBlob* mask, int index, OperatorType activation) {
+    auto  prefix  = "block" + std::to_string(index);
+    auto* weights = AddBlob(graph, prefix + "_weights", {16, 16});
+    auto* dense   = AddBlob(graph, prefix + "_dense", {1, 16});
+    auto* sum     = AddBlob(graph, prefix + "_sum", {1, 16});
+    auto* output  = AddBlob(graph, prefix + "_output", {1, 16});
+    graph.SetBuffer(weights->GetID(), std::vector<float>(16 * 16, index));
+
+    auto* fc                = graph.AddOperator(OperatorType::FULLY_CONNECTED, {input, weights}, {dense});
+    auto* option            = fc->GetOption<FullyConnectedOption>();
+    option->keep_num_dims   = false;
+    option->activation_type = activation;
+    graph.AddOperator(OperatorType::ADD, {dense, input}, {sum});
+    graph.AddOperator(OperatorType::MUL, {sum, mask}, {output});
+    return output;
+}
+
+// input -> ReLU -> blocks -> SOFTMAX, with a mask shared by all blocks.
+void BuildModel(Graph& graph, const std::vector<OperatorType>& block_activations) {
+    auto* input = AddBlob(graph, "input", {1, 16});
+    auto* mask  = AddBlob(graph, "mask", {1, 16});
+    auto* stem  = AddBlob(graph, "stem", {1, 16});
+    graph.AddOperator(OperatorType::ReLU, {input}, {stem});
+    auto* hidden = stem;
+    for (size_t index = 0; index < block_activations.size(); index++) {
+        hidden = AddBlock(graph, hidden, mask, index, block_activations[index]);
+    }
+    auto* output = AddBlob(graph, "output", {1, 16});
+    graph.AddOperator(OperatorType::SOFTMAX, {hidden}, {output});
+    graph.SetGraphInputs({input->GetID(), mask->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+}
+}  // namespace
+
+TEST(REPEATED_BLOCK_DETECTOR_TEST, FindIdenticalLayers) {
+    Graph graph;
+    BuildModel(graph, std::vector<OperatorType>(4, OperatorType::NONE));
+    auto families = RepeatedBlockDetector::Run(graph);
+    ASSERT_EQ(families.size(), 1u);
+    EXPECT_EQ(families[0].num_ops, 3u);
+    ASSERT_EQ(families[0].instances.size(), 4u);
+    EXPECT_EQ(families[0].instances[0][0]->GetOutputBlob(0)->GetName(), "block0_dense");
+    EXPECT_EQ(families[0].instances[3][2]->GetOutputBlob(0)->GetName(), "block3_output");
+}
+
+TEST(REPEATED_BLOCK_DETECTOR_TEST, SplitFamiliesByOptions) {
+    Graph graph;
+    BuildModel(graph, {OperatorType::NONE, OperatorType::NONE, OperatorType::ReLU, OperatorType::ReLU});
+    auto families = RepeatedBlockDetector::Run(graph);
+    ASSERT_EQ(families.size(), 2u);
+    EXPECT_EQ(families[0].instances.size(), 2u);
+    EXPECT_EQ(families[0].instances[0][0]->GetOutputBlob(0)->GetName(), "block0_dense");
+    EXPECT_EQ(families[1].instances.size(), 2u);
+    EXPECT_EQ(families[1].instances[0][0]->GetOutputBlob(0)->GetName(), "block2_dense");
+
+    // Blocks larger than the layers can't repeat.
+    EXPECT_TRUE(RepeatedBlockDetector::Run(graph, 4).empty());
+}
@@ -0,0 +1,145 @@
+#include "analysis/shape_inference.h"
+
+#include <chrono>
+
+#include "googletest/include/gtest/gtest.h"
+#include "test_utils.h"
+
+namespace {
+DataBlob* AddIntConstant(Graph& graph, const std::vector<int32_t>& values) {
+    auto* blob = AddTensor(graph, "constant", {static_cast<int>(values.size())}, DataType::INT32);
+    graph.SetBuffer(blob->GetID(), values);
+    return blob;
+}
+}  // namespace
+
+TEST(SHAPE_INFERENCE_TEST, ConvPoolFullyConnected) {
+    Graph graph;
+    auto* input   = AddTensor(graph, "input", {1, 224, 224, 3});
+    auto* filter  = AddTensor(graph, "filter", {32, 3, 3, 3});
+    auto* conv    = AddTensor(graph, "conv", {});
+    auto* pool    = AddTensor(graph, "pool", {});
+    auto* weights = AddTensor(graph, "weights", {10, 55 * 55 * 32});
+    auto* output  = AddTensor(graph, "output", {});
+    graph.SetBuffer(filter->GetID(), std::vector<float>(32 * 3 * 3 * 3));
+    graph.SetBuffer(weights->GetID(), std::vector<float>(10 * 55 * 55 * 32));
+
+    auto* conv_option = graph.AddOperator(OperatorType::CONV2D, {input, filter}, {conv})->GetOption<Conv2DOption>();
+    conv_option->stride_h   = 2;
+    conv_option->stride_w   = 2;
+    conv_option->dilation_h = 1;
+    conv_option->dilation_w = 1;
+    conv_option->pad_type   = Padding::SAME;
+    auto* pool_option = graph.AddOperator(OperatorType::MAX_POOL, {conv}, {pool})->GetOption<Pool2DOption>();
+    pool_option->stride_h = 2;
+    pool_option->stride_w = 2;
+    pool_option->filter_h = 3;
+    pool_option->filter_w = 3;
+    pool_option->pad_type = Padding::VALID;
+    graph.AddOperator(OperatorType::FULLY_CONNECTED, {pool, weights}, {output});
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    EXPECT_EQ(ShapeInference::Run(graph), 3U);
+    EXPECT_EQ(conv->GetShape(), Shape({1, 112, 112, 32}));
+    EXPECT_EQ(pool->GetShape(), Shape({1, 55, 55, 32}));
+    EXPECT_EQ(output->GetShape(), Shape({1, 10}));
+    EXPECT_EQ(output->GetDataType(), DataType::FLOAT32);
+    // A second sweep is a fixed point.
+    EXPECT_EQ(ShapeInference::Run(graph), 0U);
+}
+
+TEST(SHAPE_INFERENCE_TEST, PropagateUnknownBatch) {
+    Graph graph;
+    auto* input    = AddTensor(graph, "input", {-1, 8, 16});
+    auto* bias     = AddTensor(graph, "bias", {16});
+    auto* sum      = AddTensor(graph, "sum", {});
+    auto* reshaped = AddTensor(graph, "reshaped", {});
+    auto* mean     = AddTensor(graph, "mean", {});
+    auto* shape    = AddTensor(graph, "shape", {});
+    graph.SetBuffer(bias->GetID(), std::vector<float>(16));
+    graph.AddOperator(OperatorType::ADD, {input, bias}, {sum});
+    graph.AddOperator(OperatorType::RESHAPE, {sum, AddIntConstant(graph, {-1, 4, 32})}, {reshaped});
+    graph.AddOperator(OperatorType::MEAN, {reshaped, AddIntConstant(graph, {-1})}, {mean})
+        ->GetOption<ReducerOption>()
+        ->keep_dims = true;
+    graph.AddOperator(OperatorType::SHAPE, {mean}, {shape});
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({shape->GetID()});
+
+    ShapeInference::Run(graph);
+    EXPECT_EQ(sum->GetShape(), Shape({-1, 8, 16}));
+    EXPECT_EQ(reshaped->GetShape(), Shape({-1, 4, 32}));
+    EXPECT_EQ(mean->GetShape(), Shape({-1, 4, 1}));
+    EXPECT_EQ(shape->GetShape(), Shape({3}));
+    EXPECT_EQ(shape->GetDataType(), DataType::INT32);
+
+    // Once the batch is fixed the wildcard of reshape is resolved.
+    input->SetShape(Shape({2, 8, 16}));
+    ShapeInference::Run(graph);
+    EXPECT_EQ(reshaped->GetShape(), Shape({2, 4, 32}));
+    EXPECT_EQ(mean->GetShape(), Shape({2, 4, 1}));
+}
+
+TEST(SHAPE_INFERENCE_TEST, StridedSliceAndSplit) {
+    Graph graph;
+    auto* input  = AddTensor(graph, "input", {4, 10, 6});
+    auto* sliced = AddTensor(graph, "sliced", {});
+    auto* first  = AddTensor(graph, "first", {});
+    auto* second = AddTensor(graph, "second", {});
+    auto* option = graph
+                       .AddOperator(OperatorType::STRIDED_SLICE,
+                                    {input, AddIntConstant(graph, {1, -1, 0}), AddIntConstant(graph, {2, 0, 6}),
+                                     AddIntConstant(graph, {1, -2, 1})},
+                                    {sliced})
+                       ->GetOption<StridedSliceOption>();
+    option->shrink_axis_mask = 1;
+    graph.AddOperator(OperatorType::SPLIT, {AddIntConstant(graph, {1}), sliced}, {first, second});
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({first->GetID(), second->GetID()});
+
+    EXPECT_EQ(ShapeInference::Run(graph), 3U);
+    // Axis 0 is shrunk, axis 1 walks 9, 7, 5, 3, 1 backwards.
+    EXPECT_EQ(sliced->GetShape(), Shape({5, 6}));
+    EXPECT_EQ(first->GetShape(), Shape({5, 3}));
+    EXPECT_EQ(second->GetShape(), Shape({5, 3}));
+}
+
+TEST(SHAPE_INFERENCE_TEST, BroadcastAndComparison) {
+    Graph graph;
+    auto* lhs     = AddTensor(graph, "lhs", {3, 1, 5});
+    auto* rhs     = AddTensor(graph, "rhs", {4, 1});
+    auto* equal   = AddTensor(graph, "equal", {}, DataType::UNDEFINED);
+    auto* invalid = AddTensor(graph, "invalid", {7}, DataType::UNDEFINED);
+    graph.AddOperator(OperatorType::EQUAL, {lhs, rhs}, {equal});
+    graph.AddOperator(OperatorType::MUL, {lhs, AddTensor(graph, "mismatch", {4})}, {invalid});
+    graph.SetGraphInputs({lhs->GetID(), rhs->GetID()});
+    graph.SetGraphOutputs({equal->GetID(), invalid->GetID()});
+
+    EXPECT_EQ(ShapeInference::Run(graph), 1U);
+    EXPECT_EQ(equal->GetShape(), Shape({3, 4, 5}));
+    EXPECT_EQ(equal->GetDataType(), DataType::BOOL);
+    // Incompatible broadcast isn't inferable, the imported shape is kept.
+    EXPECT_EQ(invalid->GetShape(), Shape({7}));
+}
+
+TEST(SHAPE_INFERENCE_TEST, LongChainInOneSweep) {
+    constexpr int num_ops = 100000;
+    Graph         graph;
+    auto*         input = AddTensor(graph, "input", {1, 64});
+    auto*         blob  = input;
+    for (int index = 0; index < num_ops; index++) {
+        auto* output = AddTensor(graph, "relu", {});
+        graph.AddOperator(OperatorType::ReLU, {blob}, {output});
+        blob = output;
+    }
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({blob->GetID()});
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(ShapeInference::Run(graph), static_cast<uint32_t>(num_ops));
+    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - start);
+    EXPECT_EQ(blob->GetShape(), Shape({1, 64}));
+    // Generous bound that only catches quadratic behaviour.
+    EXPECT_LT(elapsed.count(), 10);
+}
@@ -0,0 +1,92 @@
+#include "common/buffer_archive.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+#include "googletest/include/gtest/gtest.h"
+
+namespace {
+std::vector<uint8_t> GetRandomBytes(size_t size, uint32_t seed) {
+    std::mt19937         generator(seed);
+    std::vector<uint8_t> bytes(size);
+    for (auto& byte : bytes) {
+        byte = generator();
+    }
+    return bytes;
+}
+
+// Float weights drawn from a few values, which compress well once their bytes are shuffled.
+std::vector<uint8_t> GetClusteredFloats(size_t num_elements) {
+    const float          values[] = {-0.25f, 0.0f, 0.125f, 0.5f};
+    std::mt19937         generator(7);
+    std::vector<uint8_t> bytes(num_elements * sizeof(float));
+    for (size_t index = 0; index < num_elements; index++) {
+        memcpy(bytes.data() + index * sizeof(float), &values[generator() % 4], sizeof(float));
+    }
+    return bytes;
+}
+
+void ExpectRoundTrip(const std::vector<uint8_t>& raw) {
+    auto                 compressed = common::lz_compress(raw.data(), raw.size());
+    std::vector<uint8_t> restored(raw.size());
+    ASSERT_TRUE(common::lz_decompress(compressed.data(), compressed.size(), restored.data(), restored.size()));
+    EXPECT_EQ(restored, raw);
+}
+}  // namespace
+
+TEST(BUFFER_ARCHIVE_TEST, CompressRoundTrip) {
+    ExpectRoundTrip({});
+    ExpectRoundTrip({1, 2, 3});
+    ExpectRoundTrip(GetRandomBytes(100000, 1));
+    ExpectRoundTrip(GetClusteredFloats(30000));
+
+    // Runs are matches overlapping their own output.
+    std::vector<uint8_t> runs(70000, 0);
+    for (size_t index = 40000; index < runs.size(); index++) {
+        runs[index] = index % 3;
+    }
+    auto compressed = common::lz_compress(runs.data(), runs.size());
+    EXPECT_LT(compressed.size(), 1000u);
+    ExpectRoundTrip(runs);
+
+    // Truncated input or a wrong size is reported instead of overrunning the output.
+    std::vector<uint8_t> restored(runs.size());
+    EXPECT_FALSE(common::lz_decompress(compressed.data(), compressed.size() / 2, restored.data(), restored.size()));
+    EXPECT_FALSE(common::lz_decompress(compressed.data(), compressed.size(), restored.data(), restored.size() - 1));
+}
+
+TEST(BUFFER_ARCHIVE_TEST, PackAndUnpack) {
+    auto floats = GetClusteredFloats(10000);
+    auto random = GetRandomBytes(5000, 2);
+    auto packed = common::pack_buffers(
+        {{3, floats.data(), floats.size(), sizeof(float)}, {9, random.data(), random.size(), 1}, {4, nullptr, 0, 1}},
+        2, 4096);
+    EXPECT_LT(packed.size(), floats.size() / 2 + random.size() + 1024);
+
+    common::BufferArchive archive(packed.data(), packed.size());
+    ASSERT_EQ(archive.num_buffers(), 3u);
+    EXPECT_EQ(archive.key(0), 3u);
+    EXPECT_EQ(archive.raw_size(0), floats.size());
+    EXPECT_EQ(archive.num_chunks(0), 10u);
+    EXPECT_EQ(archive.key(1), 9u);
+    EXPECT_EQ(archive.num_chunks(2), 0u);
+
+    std::vector<uint8_t> restored_floats(floats.size());
+    std::vector<uint8_t> restored_random(random.size());
+    archive.unpack({restored_floats.data(), restored_random.data(), nullptr}, 3);
+    EXPECT_EQ(restored_floats, floats);
+    EXPECT_EQ(restored_random, random);
+
+    // Any chunk decompresses on its own, the last one may be short.
+    std::vector<uint8_t> chunk(archive.chunk_size());
+    archive.unpack_chunk(0, 9, chunk.data());
+    EXPECT_TRUE(std::equal(floats.begin() + 9 * 4096, floats.end(), chunk.begin()));
+    EXPECT_THROW(archive.unpack_chunk(0, 10, chunk.data()), std::runtime_error);
+
+    EXPECT_THROW(common::BufferArchive(packed.data(), 20), std::runtime_error);
+    packed[0] = 'X';
+    EXPECT_THROW(common::BufferArchive(packed.data(), packed.size()), std::runtime_error);
+}
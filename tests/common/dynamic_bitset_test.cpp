@@ -0,0 +1,34 @@
+#include "common/dynamic_bitset.h"
+
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+
+TEST(DYNAMIC_BITSET_TEST, SetAcrossWords) {
+    common::DynamicBitset bits(130);
+    EXPECT_TRUE(bits.test_and_set(0));
+    EXPECT_TRUE(bits.test_and_set(64));
+    EXPECT_FALSE(bits.test_and_set(64));
+    bits.set(129);
+    EXPECT_TRUE(bits.test(129));
+    EXPECT_FALSE(bits.test(128));
+    EXPECT_EQ(bits.count(), 3u);
+
+    std::vector<size_t> indices;
+    bits.for_each([&](size_t index) { indices.push_back(index); });
+    EXPECT_EQ(indices, std::vector<size_t>({0, 64, 129}));
+}
+
+TEST(DYNAMIC_BITSET_TEST, Intersect) {
+    common::DynamicBitset lhs(100), rhs(100);
+    for (size_t index = 0; index < 100; index += 2) {
+        lhs.set(index);
+    }
+    for (size_t index = 0; index < 100; index += 3) {
+        rhs.set(index);
+    }
+    lhs &= rhs;
+    EXPECT_EQ(lhs.count(), 17u);
+    EXPECT_TRUE(lhs.test(96));
+    EXPECT_FALSE(lhs.test(3));
+}
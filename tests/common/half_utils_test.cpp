@@ -0,0 +1,81 @@
+#include "common/half_utils.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+
+namespace {
+uint32_t to_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float from_bits(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+}  // namespace
+
+TEST(HALF_UTILS_TEST, ConvertScalars) {
+    EXPECT_EQ(common::float_to_half(1.0f), 0x3c00);
+    EXPECT_EQ(common::float_to_half(-2.0f), 0xc000);
+    EXPECT_EQ(common::float_to_half(0.1f), 0x2e66);
+    EXPECT_EQ(common::float_to_half(65504.0f), 0x7bff);
+    EXPECT_EQ(common::float_to_half(65520.0f), 0x7c00);
+    EXPECT_EQ(common::float_to_half(6e-8f), 0x0001);
+    EXPECT_EQ(common::float_to_half(1e-8f), 0x0000);
+    EXPECT_TRUE(isnan(common::half_to_float(common::float_to_half(NAN))));
+
+    EXPECT_EQ(common::half_to_float(0x3555), 0.333251953125f);
+    EXPECT_EQ(common::half_to_float(0x0001), 5.9604644775390625e-8f);
+    EXPECT_EQ(common::half_to_float(0xfc00), -INFINITY);
+}
+
+TEST(HALF_UTILS_TEST, ArraysMatchScalars) {
+    // Every half value, so vector paths and tails see subnormals, infinities and NaNs alike.
+    std::vector<uint16_t> halves(1 << 16);
+    for (size_t index = 0; index < halves.size(); index++) {
+        halves[index] = index;
+    }
+    std::vector<float> floats(halves.size() - 3);
+    common::half_to_float(halves.data(), floats.size(), floats.data());
+    std::vector<uint16_t> round_trip(floats.size());
+    common::float_to_half(floats.data(), floats.size(), round_trip.data());
+    for (size_t index = 0; index < floats.size(); index++) {
+        auto expected = common::half_to_float(halves[index]);
+        EXPECT_EQ(to_bits(floats[index]), to_bits(expected));
+        if (isnan(expected)) {
+            // Signaling NaNs come back quieted.
+            EXPECT_EQ(round_trip[index], halves[index] | 0x200);
+            EXPECT_EQ(common::float_to_half(expected), halves[index] | 0x200);
+            continue;
+        }
+        EXPECT_EQ(round_trip[index], halves[index]);
+        EXPECT_EQ(common::float_to_half(expected), halves[index]);
+    }
+
+    // NaN payloads of floats keep their top bits on every path.
+    std::vector<uint32_t> nan_bits = {0x7f800001u, 0x7fa00000u, 0xff812345u, 0x7fc00001u, 0x7fffe000u};
+    std::vector<float>    nans(32);
+    for (size_t index = 0; index < nans.size(); index++) {
+        nans[index] = from_bits(nan_bits[index % nan_bits.size()]);
+    }
+    std::vector<uint16_t> nan_halves(nans.size());
+    common::float_to_half(nans.data(), nans.size(), nan_halves.data());
+    for (size_t index = 0; index < nans.size(); index++) {
+        EXPECT_EQ(nan_halves[index], common::float_to_half(nans[index]));
+    }
+    EXPECT_EQ(common::float_to_half(from_bits(0x7f800001u)), 0x7e00);
+    EXPECT_EQ(common::float_to_half(from_bits(0xff812345u)), 0xfe09);
+
+    // Halfway cases round to even.
+    std::vector<float>    ties = {1.0f + 1.0f / 2048, 1.0f + 3.0f / 2048, 2049.0f, 2051.0f};
+    std::vector<uint16_t> rounded(ties.size());
+    common::float_to_half(ties.data(), ties.size(), rounded.data());
+    EXPECT_EQ(rounded, std::vector<uint16_t>({0x3c00, 0x3c02, 0x6800, 0x6802}));
+}
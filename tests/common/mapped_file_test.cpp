@@ -0,0 +1,24 @@
+#include "common/mapped_file.h"
+
+#include <stdio.h>
+
+#include <fstream>
+#include <stdexcept>
+
+#include "googletest/include/gtest/gtest.h"
+
+TEST(MAPPED_FILE_TEST, MapFileContents) {
+    std::string path = testing::TempDir() + "mapped_file_test.bin";
+    std::string contents(10000, 'a');
+    contents[9999] = 'z';
+    std::ofstream(path, std::ios_base::binary) << contents;
+
+    {
+        common::MappedFile file(path);
+        ASSERT_EQ(file.size(), contents.size());
+        EXPECT_EQ(file.data()[0], 'a');
+        EXPECT_EQ(file.data()[9999], 'z');
+    }
+    remove(path.c_str());
+    EXPECT_THROW(common::MappedFile {path}, std::runtime_error);
+}
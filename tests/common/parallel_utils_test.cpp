@@ -0,0 +1,28 @@
+#include "common/parallel_utils.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+
+TEST(PARALLEL_UTILS_TEST, VisitEveryIndexOnce) {
+    std::vector<std::atomic<int>> visits(1000);
+    common::parallel_for(visits.size(), 8, [&](size_t index) { visits[index]++; });
+    for (const auto& visit : visits) {
+        EXPECT_EQ(visit.load(), 1);
+    }
+}
+
+TEST(PARALLEL_UTILS_TEST, RethrowAfterAllCalls) {
+    std::atomic<int> calls = 0;
+    EXPECT_THROW(common::parallel_for(100, 4,
+                                      [&](size_t index) {
+                                          calls++;
+                                          if (index % 10 == 0) {
+                                              throw std::runtime_error("failed");
+                                          }
+                                      }),
+                 std::runtime_error);
+    EXPECT_EQ(calls.load(), 100);
+}
@@ -19,3 +19,27 @@ TEST(STRING_UTIL_TEST, JoinTestChar) {
     std::string              expected_result = "Please don't make joke";
     EXPECT_EQ(common::join(strs, ' '), expected_result);
 }
+
+TEST(STRING_UTIL_TEST, EscapeJson) {
+    EXPECT_EQ(common::escape_json("conv/\"weights\"\\0"), "conv/\\\"weights\\\"\\\\0");
+    EXPECT_EQ(common::escape_json("line\n\ttab"), "line\\u000a\\u0009tab");
+}
+
+TEST(STRING_UTIL_TEST, ReplaceSuffix) {
+    EXPECT_EQ(common::replace_suffix("model.tflite", ".tflite", "_stage0.tflite"), "model_stage0.tflite");
+    EXPECT_EQ(common::replace_suffix("model", ".tflite", "_manifest.json"), "model_manifest.json");
+    EXPECT_EQ(common::replace_suffix(".tflite", ".tflite", "_shard1.tflite"), ".tflite_shard1.tflite");
+}
+
+TEST(STRING_UTIL_TEST, ParseInt) {
+    int value = 0;
+    EXPECT_TRUE(common::parse_int("224", value));
+    EXPECT_EQ(value, 224);
+    EXPECT_TRUE(common::parse_int("-8", value));
+    EXPECT_EQ(value, -8);
+    EXPECT_FALSE(common::parse_int("", value));
+    EXPECT_FALSE(common::parse_int("8x", value));
+    EXPECT_FALSE(common::parse_int(" 8", value));
+    EXPECT_FALSE(common::parse_int("4294967296", value));
+    EXPECT_EQ(value, -8);
+}
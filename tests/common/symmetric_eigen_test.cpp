@@ -0,0 +1,54 @@
+#include "common/symmetric_eigen.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "googletest/include/gtest/gtest.h"
+
+TEST(SYMMETRIC_EIGEN_TEST, DecomposeRandomMatrix) {
+    constexpr size_t                 n = 37;
+    std::mt19937                     generator(3);
+    std::normal_distribution<double> distribution;
+    std::vector<double>              matrix(n * n);
+    for (size_t row = 0; row < n; row++) {
+        for (size_t col = 0; col <= row; col++) {
+            matrix[row * n + col] = matrix[col * n + row] = distribution(generator);
+        }
+    }
+    auto vectors     = matrix;
+    auto eigenvalues = common::symmetric_eigen(vectors, n);
+    ASSERT_EQ(eigenvalues.size(), n);
+    EXPECT_TRUE(std::is_sorted(eigenvalues.rbegin(), eigenvalues.rend()));
+
+    // A v = lambda v, and eigenvectors are orthonormal.
+    for (size_t index = 0; index < n; index++) {
+        const double* vector = vectors.data() + index * n;
+        for (size_t row = 0; row < n; row++) {
+            double product = 0.0;
+            for (size_t col = 0; col < n; col++) {
+                product += matrix[row * n + col] * vector[col];
+            }
+            EXPECT_NEAR(product, eigenvalues[index] * vector[row], 1e-9);
+        }
+        for (size_t other = 0; other <= index; other++) {
+            double dot = 0.0;
+            for (size_t col = 0; col < n; col++) {
+                dot += vector[col] * vectors[other * n + col];
+            }
+            EXPECT_NEAR(dot, other == index ? 1.0 : 0.0, 1e-9);
+        }
+    }
+}
+
+TEST(SYMMETRIC_EIGEN_TEST, DiagonalAndRepeatedEigenvalues) {
+    std::vector<double> matrix = {2, 0, 0, 0, 5, 0, 0, 0, 2};
+    auto                eigenvalues = common::symmetric_eigen(matrix, 3);
+    EXPECT_EQ(eigenvalues, std::vector<double>({5, 2, 2}));
+    EXPECT_DOUBLE_EQ(std::fabs(matrix[1]), 1.0);
+
+    std::vector<double> single = {-4};
+    EXPECT_EQ(common::symmetric_eigen(single, 1), std::vector<double>({-4}));
+    EXPECT_EQ(single, std::vector<double>({1}));
+    EXPECT_THROW(common::symmetric_eigen(single, 2), std::runtime_error);
+}
@@ -0,0 +1,66 @@
+#include "model/data_blob.h"
+
+#include "googletest/include/gtest/gtest.h"
+#include "model/graph.h"
+
+TEST(DATA_BLOB_TEST, PerTensorQuantParamIsInline) {
+    Graph graph;
+    auto* blob        = graph.AddDataBlob("activation");
+    auto& quant_param = blob->CreateQuantParam();
+
+    quant_param.scales      = {0.5f};
+    quant_param.zero_points = {-3};
+    EXPECT_TRUE(blob->HasQuantParam());
+    ASSERT_EQ(quant_param.scales.size(), 1u);
+    EXPECT_FLOAT_EQ(quant_param.scales[0], 0.5f);
+    EXPECT_EQ(quant_param.zero_points, std::vector<int64_t>({-3}));
+
+    // The value lives in the parameter itself, copies don't share it.
+    auto copy = quant_param;
+    EXPECT_NE(copy.scales.data(), quant_param.scales.data());
+    EXPECT_EQ(copy.scales, quant_param.scales);
+    EXPECT_THROW(blob->CreateQuantParam(), std::runtime_error);
+}
+
+TEST(DATA_BLOB_TEST, PerChannelQuantParamIsPooled) {
+    Graph graph;
+    auto& weights1 = graph.AddDataBlob("weights1")->CreateQuantParam();
+    auto& weights2 = graph.AddDataBlob("weights2")->CreateQuantParam();
+
+    weights1.scales      = std::vector<float>({0.1f, 0.2f, 0.3f, 0.4f});
+    weights1.zero_points = std::vector<int64_t>(4, 0);
+    weights2.scales      = std::vector<float>({0.1f, 0.2f, 0.3f, 0.5f});
+    weights2.zero_points = std::vector<int64_t>(4, 0);
+    EXPECT_EQ(weights1.zero_points.data(), weights2.zero_points.data());
+    EXPECT_NE(weights1.scales.data(), weights2.scales.data());
+    EXPECT_NE(weights1.scales, weights2.scales);
+
+    // A slice of its own values, as sharding does, and a shrink to a single value.
+    weights2.scales.assign(weights2.scales.begin() + 2, weights2.scales.end());
+    EXPECT_EQ(weights2.scales, std::vector<float>({0.3f, 0.5f}));
+    weights2.scales.assign(weights2.scales.begin() + 1, weights2.scales.end());
+    EXPECT_EQ(weights2.scales, std::vector<float>({0.5f}));
+    weights2.zero_points = {};
+    EXPECT_TRUE(weights2.zero_points.empty());
+}
+
+TEST(DATA_BLOB_TEST, ExpiredQuantValuesAreReleased) {
+    // Enough distinct arrays to sweep expired buckets several times.
+    for (int index = 0; index < 1000; index++) {
+        QuantValues<float> scales(std::vector<float>({static_cast<float>(index), 1.0f}));
+        EXPECT_EQ(scales, std::vector<float>({static_cast<float>(index), 1.0f}));
+    }
+    QuantValues<float> scales1(std::vector<float>({7.0f, 1.0f}));
+    QuantValues<float> scales2(std::vector<float>({7.0f, 1.0f}));
+    EXPECT_EQ(scales1.data(), scales2.data());
+
+    // An array released by every holder is interned anew.
+    auto values = InternQuantValues(scales1.begin(), scales1.end());
+    std::weak_ptr<const std::vector<float>> released(values);
+    values.reset();
+    scales1 = {};
+    scales2 = {};
+    EXPECT_TRUE(released.expired());
+    QuantValues<float> scales3(std::vector<float>({7.0f, 1.0f}));
+    EXPECT_EQ(scales3, std::vector<float>({7.0f, 1.0f}));
+}
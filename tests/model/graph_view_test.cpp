@@ -0,0 +1,54 @@
+#include "model/graph_view.h"
+
+#include "googletest/include/gtest/gtest.h"
+
+TEST(GRAPH_VIEW_TEST, WholeGraph) {
+    Graph graph;
+    auto* input  = graph.AddDataBlob("input");
+    auto* output = graph.AddDataBlob("output");
+    graph.AddDataBlob("unused");
+    auto* op = graph.AddOperator(OperatorType::ReLU, {input}, {output});
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    GraphView view(graph);
+    EXPECT_EQ(view.GetOperators(), std::vector<const Operator*>({op}));
+    EXPECT_EQ(view.GetDataBlobs().size(), 3u);
+    EXPECT_EQ(view.GetGraphInputs(), graph.GetGraphInputs());
+    EXPECT_EQ(view.GetGraphOutputs(), graph.GetGraphOutputs());
+}
+
+TEST(GRAPH_VIEW_TEST, Subset) {
+    // a -> ADD of a and a -> b -> ReLU -> c -> ABS -> d
+    Graph graph;
+    auto* a        = graph.AddDataBlob("a");
+    auto* b        = graph.AddDataBlob("b");
+    auto* c        = graph.AddDataBlob("c");
+    auto* d        = graph.AddDataBlob("d");
+    auto* add      = graph.AddOperator(OperatorType::ADD, {a, a}, {b});
+    auto* relu     = graph.AddOperator(OperatorType::ReLU, {b}, {c});
+    auto* absolute = graph.AddOperator(OperatorType::ABS, {c}, {d});
+    auto  names    = [](const GraphView& view) {
+        std::vector<std::string> blob_names;
+        for (const auto* blob : view.GetDataBlobs()) {
+            blob_names.push_back(blob->GetName());
+        }
+        return blob_names;
+    };
+
+    // Blobs are listed once, inputs first, then in operator order.
+    GraphView head(graph, {add, relu}, {a->GetID()}, {c->GetID(), b->GetID()});
+    EXPECT_EQ(head.GetOperators(), std::vector<const Operator*>({add, relu}));
+    EXPECT_EQ(head.GetGraphInputs(), std::vector<BLOBID_T>({a->GetID()}));
+    EXPECT_EQ(head.GetGraphOutputs(), std::vector<BLOBID_T>({c->GetID(), b->GetID()}));
+    EXPECT_EQ(names(head), std::vector<std::string>({"a", "b", "c"}));
+
+    GraphView tail(graph, {absolute}, {c->GetID()}, {d->GetID()});
+    EXPECT_EQ(names(tail), std::vector<std::string>({"c", "d"}));
+
+    // A boundary tensor no operator of the view touches is still part of it.
+    GraphView passthrough(graph, {relu}, {a->GetID(), b->GetID()}, {c->GetID()});
+    EXPECT_EQ(names(passthrough), std::vector<std::string>({"a", "b", "c"}));
+
+    EXPECT_THROW(GraphView(graph, {}, {INVALID_ID}, {}), std::runtime_error);
+}
@@ -0,0 +1,96 @@
+#include "parser_and_serializer/tflite/serializer.h"
+
+#include <stdio.h>
+
+#include <fstream>
+#include <iterator>
+
+#include "googletest/include/gtest/gtest.h"
+#include "test_utils.h"
+
+namespace {
+std::vector<uint8_t> ReadFile(const std::string& path) {
+    std::ifstream file(path, std::ios_base::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+const tflite::Tensor* FindTensor(const tflite::SubGraph& subgraph, const std::string& name) {
+    for (const auto* tensor : *subgraph.tensors()) {
+        if (tensor->name()->str() == name) {
+            return tensor;
+        }
+    }
+    return nullptr;
+}
+}  // namespace
+
+TEST(TFLITE_SERIALIZER_TEST, MergeGraphsSharingWeights) {
+    std::vector<float> weights_data = {1, 2, 3, 4, 5, 6, 7, 8};
+    Graph              graph_a;
+    Graph              graph_b;
+    auto*              fc_a = BuildFullyConnected(graph_a, 1, 4, 2, {"input", "weights", "bias_a", "output"});
+    auto*              fc_b = BuildFullyConnected(graph_b, 1, 4, 2, {"x", "w", "bias", "y"});
+    graph_a.SetBuffer(fc_a->GetInputBlob(1)->GetID(), weights_data);
+    graph_a.SetBuffer(fc_a->GetInputBlob(2)->GetID(), std::vector<float>({0.5f, -0.5f}));
+    graph_b.SetBuffer(fc_b->GetInputBlob(1)->GetID(), weights_data);
+    graph_b.SetBuffer(fc_b->GetInputBlob(2)->GetID(), std::vector<float>({1.0f, 2.0f}));
+
+    std::string path = testing::TempDir() + "tflite_serializer_test.tflite";
+    TfLiteSerializer().ExportToTfLite({{"a", GraphView(graph_a)}, {"b", GraphView(graph_b)}}, path);
+    auto contents = ReadFile(path);
+    remove(path.c_str());
+    flatbuffers::Verifier verifier(contents.data(), contents.size());
+    ASSERT_TRUE(tflite::VerifyModelBuffer(verifier));
+    const auto* model = tflite::GetModel(contents.data());
+    ASSERT_EQ(model->subgraphs()->size(), 2u);
+
+    // Equal weights are stored once, biases of the same size but different values aren't merged.
+    size_t filled_buffers = 0;
+    for (const auto* buffer : *model->buffers()) {
+        filled_buffers += buffer->data() != nullptr && buffer->data()->size() > 0 ? 1 : 0;
+    }
+    EXPECT_EQ(filled_buffers, 3u);
+    const auto* subgraph_a = model->subgraphs()->Get(0);
+    const auto* subgraph_b = model->subgraphs()->Get(1);
+    ASSERT_NE(FindTensor(*subgraph_a, "weights"), nullptr);
+    ASSERT_NE(FindTensor(*subgraph_b, "w"), nullptr);
+    EXPECT_EQ(FindTensor(*subgraph_a, "weights")->buffer(), FindTensor(*subgraph_b, "w")->buffer());
+    EXPECT_NE(FindTensor(*subgraph_a, "bias_a")->buffer(), FindTensor(*subgraph_b, "bias")->buffer());
+    const auto* shared = model->buffers()->Get(FindTensor(*subgraph_b, "w")->buffer())->data();
+    ASSERT_EQ(shared->size(), weights_data.size() * sizeof(float));
+
+    // Every signature refers its own subgraph, and tensor indices are those of that subgraph.
+    ASSERT_NE(model->signature_defs(), nullptr);
+    ASSERT_EQ(model->signature_defs()->size(), 2u);
+    const std::vector<std::pair<std::string, std::string>> boundaries = {{"input", "output"}, {"x", "y"}};
+    for (uint32_t index = 0; index < 2; index++) {
+        const auto* signature = model->signature_defs()->Get(index);
+        const auto* subgraph  = model->subgraphs()->Get(index);
+        EXPECT_EQ(signature->signature_key()->str(), index == 0 ? "a" : "b");
+        EXPECT_EQ(signature->subgraph_index(), index);
+        EXPECT_EQ(subgraph->name()->str(), signature->signature_key()->str());
+        ASSERT_EQ(signature->inputs()->size(), 1u);
+        ASSERT_EQ(signature->outputs()->size(), 1u);
+        const auto* input  = signature->inputs()->Get(0);
+        const auto* output = signature->outputs()->Get(0);
+        EXPECT_EQ(input->name()->str(), boundaries[index].first);
+        EXPECT_EQ(output->name()->str(), boundaries[index].second);
+        EXPECT_EQ(subgraph->tensors()->Get(input->tensor_index())->name()->str(), boundaries[index].first);
+        EXPECT_EQ(subgraph->tensors()->Get(output->tensor_index())->name()->str(), boundaries[index].second);
+        EXPECT_EQ(subgraph->inputs()->Get(0), static_cast<int32_t>(input->tensor_index()));
+        EXPECT_EQ(subgraph->outputs()->Get(0), static_cast<int32_t>(output->tensor_index()));
+    }
+    // Tensors are ordered by name, so the boundaries sit at different indices in the two subgraphs.
+    EXPECT_NE(model->signature_defs()->Get(0)->inputs()->Get(0)->tensor_index(),
+              model->signature_defs()->Get(1)->inputs()->Get(0)->tensor_index());
+}
+
+TEST(TFLITE_SERIALIZER_TEST, RejectDuplicatedSignatures) {
+    Graph graph;
+    auto* fc = BuildFullyConnected(graph, 1, 4, 2);
+    graph.SetBuffer(fc->GetInputBlob(1)->GetID(), std::vector<float>(8, 1.0f));
+    graph.SetBuffer(fc->GetInputBlob(2)->GetID(), std::vector<float>({0.0f, 0.0f}));
+    std::string path = testing::TempDir() + "tflite_serializer_duplicated.tflite";
+    EXPECT_THROW(TfLiteSerializer().ExportToTfLite({{"main", GraphView(graph)}, {"main", GraphView(graph)}}, path),
+                 std::runtime_error);
+}
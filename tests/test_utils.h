@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "model/graph.h"
+
+// Helpers shared by the unit tests to build small graphs by hand.
+
+inline DataBlob* AddTensor(Graph& graph, const std::string& name, const std::vector<int>& dims,
+                           DataType data_type = DataType::FLOAT32) {
+    auto* blob = graph.AddDataBlob(name);
+    blob->SetDataType(data_type);
+    blob->SetShape(Shape(dims));
+    return blob;
+}
+
+// input [batch, in_channels] -> FULLY_CONNECTED with weights [out_channels, in_channels] and bias [out_channels]
+// -> output [batch, out_channels], all float32 and named by `names` in this order. The constant buffers are left to
+// the caller, and the input and output become the graph boundaries.
+inline Operator* BuildFullyConnected(Graph& graph, int batch, int in_channels, int out_channels,
+                                     const std::vector<std::string>& names = {"input", "weights", "bias", "output"}) {
+    auto* input                  = AddTensor(graph, names[0], {batch, in_channels});
+    auto* weights                = AddTensor(graph, names[1], {out_channels, in_channels});
+    auto* bias                   = AddTensor(graph, names[2], {out_channels});
+    auto* output                 = AddTensor(graph, names[3], {batch, out_channels});
+    auto* fc                     = graph.AddOperator(OperatorType::FULLY_CONNECTED, {input, weights, bias}, {output});
+    auto* option                 = fc->GetOption<FullyConnectedOption>();
+    option->keep_num_dims        = false;
+    option->asym_quantize_inputs = false;
+    option->activation_type      = OperatorType::NONE;
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+    return fc;
+}
@@ -0,0 +1,97 @@
+#include "tools/graph_cutter/cutting_utils.h"
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+
+#include "common/stl_wrapper.h"
+#include "googletest/include/gtest/gtest.h"
+
+namespace {
+std::vector<std::string> GetBlobNames(const GraphView& view) {
+    std::vector<std::string> names;
+    for (const auto* blob : view.GetDataBlobs()) {
+        names.push_back(blob->GetName());
+    }
+    return names;
+}
+
+// a -> ReLU -> b -> ADD with the constant w -> c -> ADD of c and d -> e -> TANH -> f, and b -> ABS -> d.
+void BuildBranchingGraph(Graph& graph, std::vector<Operator*>& ops) {
+    std::map<std::string, DataBlob*> blobs;
+    for (const auto* name : {"a", "b", "w", "c", "d", "e", "f"}) {
+        blobs[name] = graph.AddDataBlob(name);
+    }
+    graph.SetBuffer(blobs["w"]->GetID(), std::vector<float>({1.0f}));
+    ops.push_back(graph.AddOperator(OperatorType::ReLU, {blobs["a"]}, {blobs["b"]}));
+    ops.push_back(graph.AddOperator(OperatorType::ADD, {blobs["b"], blobs["w"]}, {blobs["c"]}));
+    ops.push_back(graph.AddOperator(OperatorType::ABS, {blobs["b"]}, {blobs["d"]}));
+    ops.push_back(graph.AddOperator(OperatorType::ADD, {blobs["c"], blobs["d"]}, {blobs["e"]}));
+    ops.push_back(graph.AddOperator(OperatorType::TANH, {blobs["e"]}, {blobs["f"]}));
+    graph.SetGraphInputs({blobs["a"]->GetID()});
+    graph.SetGraphOutputs({blobs["f"]->GetID()});
+}
+}  // namespace
+
+TEST(CUTTING_UTILS_TEST, CutManyViewsOfOneGraph) {
+    Graph                  graph;
+    std::vector<Operator*> ops;
+    BuildBranchingGraph(graph, ops);
+    auto index = CuttingUtils::BuildOperatorIndex(graph);
+    ASSERT_EQ(index.sorted_ops.size(), 5u);
+
+    // Both branches between b and e.
+    auto middle = CuttingUtils::CutGraphView(graph, index, {"b"}, {"e"});
+    EXPECT_EQ(&middle.GetGraph(), &graph);
+    EXPECT_EQ(middle.GetGraphInputs(), std::vector<BLOBID_T>({ops[0]->GetOutputIDs()[0]}));
+    EXPECT_EQ(middle.GetGraphOutputs(), std::vector<BLOBID_T>({ops[3]->GetOutputIDs()[0]}));
+    ASSERT_EQ(middle.GetOperators().size(), 3u);
+    EXPECT_EQ(middle.GetOperators().back(), ops[3]);
+    EXPECT_TRUE(common::contains(middle.GetOperators(), static_cast<const Operator*>(ops[1])));
+    EXPECT_TRUE(common::contains(middle.GetOperators(), static_cast<const Operator*>(ops[2])));
+    auto middle_blobs = GetBlobNames(middle);
+    std::sort(middle_blobs.begin(), middle_blobs.end());
+    EXPECT_EQ(middle_blobs, std::vector<std::string>({"b", "c", "d", "e", "w"}));
+
+    // Operators off the paths between the tensors are left out, the constant stays with its reader.
+    auto head = CuttingUtils::CutGraphView(graph, index, {"a"}, {"c", "b"});
+    ASSERT_EQ(head.GetOperators().size(), 2u);
+    EXPECT_EQ(head.GetOperators()[0], ops[0]);
+    EXPECT_EQ(head.GetOperators()[1], ops[1]);
+    EXPECT_EQ(head.GetGraphOutputs(), std::vector<BLOBID_T>({ops[1]->GetOutputIDs()[0], ops[0]->GetOutputIDs()[0]}));
+    EXPECT_EQ(GetBlobNames(head), std::vector<std::string>({"a", "b", "w", "c"}));
+
+    auto tail = CuttingUtils::CutStageView(graph, index, 3, 5, ops[3]->GetInputIDs(), ops[4]->GetOutputIDs());
+    EXPECT_EQ(tail.GetOperators(), std::vector<const Operator*>({ops[3], ops[4]}));
+    EXPECT_EQ(GetBlobNames(tail), std::vector<std::string>({"c", "d", "e", "f"}));
+    EXPECT_THROW(CuttingUtils::CutStageView(graph, index, 3, 6, {}, {}), std::runtime_error);
+
+    EXPECT_THROW(CuttingUtils::CutGraphView(graph, index, {"f"}, {"a"}), std::runtime_error);
+    EXPECT_THROW(CuttingUtils::CutGraphView(graph, index, {"a"}, {"missing"}), std::runtime_error);
+
+    // Views leave the graph as it was.
+    EXPECT_EQ(graph.GetOperators().size(), 5u);
+    EXPECT_EQ(graph.GetDataBlobs().size(), 7u);
+}
+
+TEST(CUTTING_UTILS_TEST, ParseJobs) {
+    std::istringstream jobs("# from to output\n"
+                            "a,b c first.tflite\n"
+                            "\n"
+                            "  d  e,f   second.tflite  \n");
+    auto parsed = CuttingUtils::ParseJobs(jobs, "jobs.txt");
+    ASSERT_EQ(parsed.size(), 2u);
+    EXPECT_EQ(parsed[0].input_tensors, std::vector<std::string>({"a", "b"}));
+    EXPECT_EQ(parsed[0].output_tensors, std::vector<std::string>({"c"}));
+    EXPECT_EQ(parsed[0].output_path, "first.tflite");
+    EXPECT_EQ(parsed[1].input_tensors, std::vector<std::string>({"d"}));
+    EXPECT_EQ(parsed[1].output_tensors, std::vector<std::string>({"e", "f"}));
+    EXPECT_EQ(parsed[1].output_path, "second.tflite");
+
+    std::istringstream missing_output("a b\n");
+    EXPECT_THROW(CuttingUtils::ParseJobs(missing_output, "jobs.txt"), std::runtime_error);
+    std::istringstream extra_field("a b c.tflite d\n");
+    EXPECT_THROW(CuttingUtils::ParseJobs(extra_field, "jobs.txt"), std::runtime_error);
+    std::istringstream comments_only("# nothing\n\n");
+    EXPECT_THROW(CuttingUtils::ParseJobs(comments_only, "jobs.txt"), std::runtime_error);
+}
@@ -0,0 +1,103 @@
+#include "tools/model_stats/stats_utils.h"
+
+#include <stdio.h>
+
+#include <fstream>
+
+#include "googletest/include/gtest/gtest.h"
+#include "parser_and_serializer/tflite/serializer.h"
+#include "test_utils.h"
+
+namespace {
+void SetQuantParam(DataBlob* blob, const std::vector<float>& scales) {
+    auto& quant_param       = blob->CreateQuantParam();
+    quant_param.scales      = scales;
+    quant_param.zero_points = std::vector<int64_t>(scales.size(), 0);
+}
+
+// input [1, 4] -> FULLY_CONNECTED with per-channel int8 weights [2, 4] and bias [2] -> output [1, 2], tensors named
+// with `prefix`. Activations and the bias are int8 and int32 if `quantized`, float32 otherwise.
+void BuildInt8FullyConnected(Graph&                    graph,
+                             const std::string&        prefix,
+                             const std::vector<float>& bias_data,
+                             bool                      quantized) {
+    std::vector<std::string> names = {prefix + "input", prefix + "weights", prefix + "bias", prefix + "output"};
+    auto*                    fc    = BuildFullyConnected(graph, 1, 4, 2, names);
+    auto* input   = fc->GetInputBlob(0);
+    auto* weights = fc->GetInputBlob(1);
+    auto* bias    = fc->GetInputBlob(2);
+    auto* output  = fc->GetOutputBlob(0);
+    weights->SetDataType(DataType::INT8);
+    graph.SetBuffer(weights->GetID(), std::vector<int8_t>({1, 2, 3, 4, -1, -2, -3, -4}));
+    SetQuantParam(weights, {0.5f, 0.25f});
+    if (quantized) {
+        input->SetDataType(DataType::INT8);
+        output->SetDataType(DataType::INT8);
+        bias->SetDataType(DataType::INT32);
+        graph.SetBuffer(bias->GetID(), std::vector<int32_t>(bias_data.begin(), bias_data.end()));
+        SetQuantParam(bias, {0.5f, 0.25f});
+        SetQuantParam(input, {1.0f});
+        SetQuantParam(output, {2.0f});
+    } else {
+        graph.SetBuffer(bias->GetID(), bias_data);
+    }
+}
+
+StatsUtils::ModelStats CollectStats(const std::vector<TfLiteSerializer::Signature>& signatures) {
+    std::string path = testing::TempDir() + "stats_utils_test.tflite";
+    TfLiteSerializer().ExportToTfLite(signatures, path);
+    auto stats = StatsUtils::CollectStats(common::MappedFile(path));
+    remove(path.c_str());
+    return stats;
+}
+}  // namespace
+
+TEST(STATS_UTILS_TEST, CountSharedWeightsOnce) {
+    Graph graph_a;
+    Graph graph_b;
+    BuildInt8FullyConnected(graph_a, "a_", {0.5f, -0.5f}, false);
+    BuildInt8FullyConnected(graph_b, "b_", {1.0f, 2.0f}, false);
+    auto stats = CollectStats({{"a", GraphView(graph_a)}, {"b", GraphView(graph_b)}});
+
+    EXPECT_EQ(stats.subgraphs, 2u);
+    EXPECT_EQ(stats.operators, 2u);
+    EXPECT_EQ(stats.tensors, 8u);
+    EXPECT_EQ(stats.op_counts, (std::map<std::string, uint64_t>{{"FULLY_CONNECTED", 2}}));
+
+    // Both subgraphs use the same weights buffer, the biases differ.
+    ASSERT_EQ(stats.constants.size(), 2u);
+    EXPECT_EQ(stats.constants["INT8"].tensors, 1u);
+    EXPECT_EQ(stats.constants["INT8"].parameters, 8u);
+    EXPECT_EQ(stats.constants["INT8"].bytes, 8u);
+    EXPECT_EQ(stats.constants["FLOAT32"].tensors, 2u);
+    EXPECT_EQ(stats.constants["FLOAT32"].parameters, 4u);
+    EXPECT_EQ(stats.constants["FLOAT32"].bytes, 16u);
+    EXPECT_EQ(stats.parameters, 12u);
+    EXPECT_EQ(stats.constant_tensors, 3u);
+    EXPECT_EQ(stats.quantized_parameters, 8u);
+    EXPECT_EQ(stats.quantized_constant_tensors, 1u);
+    EXPECT_EQ(stats.per_channel_tensors, 1u);
+    EXPECT_EQ(stats.activation_tensors, 4u);
+    EXPECT_EQ(stats.quantized_activation_tensors, 0u);
+    EXPECT_EQ(stats.quantized_operators, 0u);
+}
+
+TEST(STATS_UTILS_TEST, CountQuantizedOperators) {
+    Graph graph;
+    BuildInt8FullyConnected(graph, "", {4.0f, -4.0f}, true);
+    auto stats = CollectStats({{"main", GraphView(graph)}});
+
+    EXPECT_EQ(stats.constants["INT32"].tensors, 1u);
+    EXPECT_EQ(stats.quantized_parameters, stats.parameters);
+    EXPECT_EQ(stats.quantized_constant_tensors, 2u);
+    EXPECT_EQ(stats.per_channel_tensors, 2u);
+    EXPECT_EQ(stats.quantized_activation_tensors, 2u);
+    EXPECT_EQ(stats.quantized_operators, 1u);
+}
+
+TEST(STATS_UTILS_TEST, RejectInvalidModel) {
+    std::string path = testing::TempDir() + "stats_utils_test.bin";
+    std::ofstream(path) << "not a tflite model";
+    EXPECT_THROW(StatsUtils::CollectStats(common::MappedFile(path)), std::runtime_error);
+    remove(path.c_str());
+}
@@ -0,0 +1,107 @@
+#include "transforms/common_subexpression_elimination.h"
+
+#include "googletest/include/gtest/gtest.h"
+
+namespace {
+DataBlob* AddConstant(Graph& graph, const std::string& name, const std::vector<int32_t>& values) {
+    auto* blob = graph.AddDataBlob(name);
+    blob->SetDataType(DataType::INT32);
+    blob->SetShape(Shape({static_cast<int>(values.size())}));
+    graph.SetBuffer(blob->GetID(), values);
+    return blob;
+}
+
+DataBlob* AddActivation(Graph& graph, const std::string& name) {
+    auto* blob = graph.AddDataBlob(name);
+    blob->SetDataType(DataType::FLOAT32);
+    blob->SetShape(Shape({1, 8, 8, 4}));
+    return blob;
+}
+
+Operator* AddBinaryOp(Graph& graph, OperatorType op_type, DataBlob* lhs, DataBlob* rhs, DataBlob* output) {
+    auto* op = graph.AddOperator(op_type, {lhs, rhs}, {output});
+    if (op_type == OperatorType::ADD) {
+        op->GetOption<AddOption>()->pot_scale_int16 = false;
+        op->GetOption<AddOption>()->activation_type = OperatorType::NONE;
+    }
+    return op;
+}
+}  // namespace
+
+TEST(CSE_TEST, MergeTransposeWithDuplicatedPermutation) {
+    Graph graph;
+    auto* input      = AddActivation(graph, "input");
+    auto* perm1      = AddConstant(graph, "perm1", {0, 2, 1, 3});
+    auto* perm2      = AddConstant(graph, "perm2", {0, 2, 1, 3});
+    auto* transpose1 = AddActivation(graph, "transpose1");
+    auto* transpose2 = AddActivation(graph, "transpose2");
+    auto* output     = AddActivation(graph, "output");
+    AddBinaryOp(graph, OperatorType::TRANSPOSE, input, perm1, transpose1);
+    AddBinaryOp(graph, OperatorType::TRANSPOSE, input, perm2, transpose2);
+    auto* add = AddBinaryOp(graph, OperatorType::ADD, transpose1, transpose2, output);
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    EXPECT_EQ(CommonSubexpressionElimination::Run(graph), 1U);
+    EXPECT_EQ(graph.GetOperators().size(), 2U);
+    EXPECT_EQ(graph.GetDataBlobs().size(), 4U);
+    EXPECT_EQ(add->GetInputIDs(), std::vector<BLOBID_T>({transpose1->GetID(), transpose1->GetID()}));
+    EXPECT_EQ(transpose1->GetConsumers().size(), 2U);
+}
+
+TEST(CSE_TEST, MergeCascadedDuplicates) {
+    Graph graph;
+    auto* input  = AddActivation(graph, "input");
+    auto* bias   = AddActivation(graph, "bias");
+    auto* add1   = AddActivation(graph, "add1");
+    auto* add2   = AddActivation(graph, "add2");
+    auto* tanh1  = AddActivation(graph, "tanh1");
+    auto* tanh2  = AddActivation(graph, "tanh2");
+    auto* output = AddActivation(graph, "output");
+    AddBinaryOp(graph, OperatorType::ADD, input, bias, add1);
+    AddBinaryOp(graph, OperatorType::ADD, input, bias, add2);
+    graph.AddOperator(OperatorType::TANH, {add1}, {tanh1});
+    graph.AddOperator(OperatorType::TANH, {add2}, {tanh2});
+    AddBinaryOp(graph, OperatorType::MUL, tanh1, tanh2, output);
+    graph.SetGraphInputs({input->GetID(), bias->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+    auto add2_id  = add2->GetID();
+    auto tanh2_id = tanh2->GetID();
+
+    EXPECT_EQ(CommonSubexpressionElimination::Run(graph), 2U);
+    EXPECT_EQ(graph.GetOperators().size(), 3U);
+    EXPECT_EQ(graph.GetDataBlob(add2_id), nullptr);
+    EXPECT_EQ(graph.GetDataBlob(tanh2_id), nullptr);
+}
+
+TEST(CSE_TEST, KeepOperatorsWithDifferentOptions) {
+    Graph graph;
+    auto* input  = AddActivation(graph, "input");
+    auto* bias   = AddActivation(graph, "bias");
+    auto* add1   = AddActivation(graph, "add1");
+    auto* add2   = AddActivation(graph, "add2");
+    auto* output = AddActivation(graph, "output");
+    AddBinaryOp(graph, OperatorType::ADD, input, bias, add1);
+    auto* relu_add = AddBinaryOp(graph, OperatorType::ADD, input, bias, add2);
+    relu_add->GetOption<AddOption>()->activation_type = OperatorType::ReLU;
+    AddBinaryOp(graph, OperatorType::MUL, add1, add2, output);
+    graph.SetGraphInputs({input->GetID(), bias->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    EXPECT_EQ(CommonSubexpressionElimination::Run(graph), 0U);
+    EXPECT_EQ(graph.GetOperators().size(), 3U);
+}
+
+TEST(CSE_TEST, KeepDuplicateProducingGraphOutput) {
+    Graph graph;
+    auto* input = AddActivation(graph, "input");
+    auto* tanh1 = AddActivation(graph, "tanh1");
+    auto* tanh2 = AddActivation(graph, "tanh2");
+    graph.AddOperator(OperatorType::TANH, {input}, {tanh1});
+    graph.AddOperator(OperatorType::TANH, {input}, {tanh2});
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({tanh1->GetID(), tanh2->GetID()});
+
+    EXPECT_EQ(CommonSubexpressionElimination::Run(graph), 0U);
+    EXPECT_EQ(graph.GetOperators().size(), 2U);
+}
@@ -0,0 +1,52 @@
+#include "transforms/float16_conversion.h"
+
+#include "googletest/include/gtest/gtest.h"
+#include "test_utils.h"
+
+TEST(FLOAT16_CONVERSION_TEST, ConvertAndDequantize) {
+    Graph graph;
+    auto* input   = AddTensor(graph, "input", {1, 4});
+    auto* weights = AddTensor(graph, "weights", {2, 4});
+    auto* bias    = AddTensor(graph, "bias", {2});
+    auto* output  = AddTensor(graph, "output", {1, 2});
+    graph.SetBuffer(weights->GetID(), std::vector<float>({1, -2, 0.5, 0, 0.1, 4096, -3, 2049}));
+    graph.SetBuffer(bias->GetID(), std::vector<float>({1, 1e5}));
+    auto* fc = graph.AddOperator(OperatorType::FULLY_CONNECTED, {input, weights, bias}, {output});
+
+    auto converted_tensors = Float16Conversion::Run(graph, {}, 0, 2);
+    ASSERT_EQ(converted_tensors.size(), 1u);
+    EXPECT_EQ(converted_tensors[0].name, "weights");
+    EXPECT_EQ(converted_tensors[0].elements, 8u);
+    // 2049 rounds to 2048 and 0.1 to 0.0999755859375.
+    EXPECT_FLOAT_EQ(converted_tensors[0].max_error, 1.0f);
+    EXPECT_NEAR(converted_tensors[0].mean_error, (1.0 + 0.1 - 0.0999755859375) / 8, 1e-7);
+
+    EXPECT_EQ(weights->GetDataType(), DataType::FLOAT16);
+    EXPECT_EQ(graph.GetBuffer(weights->GetID())->size(), 16u);
+    const auto* dequantized = fc->GetInputBlob(1);
+    EXPECT_EQ(dequantized->GetName(), "weights_dequantized");
+    EXPECT_EQ(dequantized->GetDataType(), DataType::FLOAT32);
+    EXPECT_EQ(dequantized->GetShape().GetDims(), std::vector<int>({2, 4}));
+    ASSERT_NE(dequantized->GetProducer(), nullptr);
+    EXPECT_EQ(dequantized->GetProducer()->GetOpType(), OperatorType::DEQUANTIZE);
+    EXPECT_EQ(dequantized->GetProducer()->GetInputBlob(0), weights);
+
+    // 1e5 is out of float16 range.
+    EXPECT_EQ(fc->GetInputBlob(2), bias);
+    EXPECT_EQ(bias->GetDataType(), DataType::FLOAT32);
+}
+
+TEST(FLOAT16_CONVERSION_TEST, SelectByName) {
+    Graph graph;
+    auto* input   = AddTensor(graph, "input", {1, 2});
+    auto* weights = AddTensor(graph, "weights", {1, 2});
+    auto* output  = AddTensor(graph, "output", {1, 2});
+    graph.SetBuffer(weights->GetID(), std::vector<float>({1, 2}));
+    graph.AddOperator(OperatorType::ADD, {input, weights}, {output});
+
+    EXPECT_TRUE(Float16Conversion::Run(graph, {}).empty());
+    EXPECT_THROW(Float16Conversion::Run(graph, {"input", "unknown"}), std::runtime_error);
+    // Selected constants are converted whatever their size.
+    EXPECT_EQ(Float16Conversion::Run(graph, {"weights"}).size(), 1u);
+    EXPECT_EQ(weights->GetDataType(), DataType::FLOAT16);
+}
@@ -0,0 +1,273 @@
+#include "transforms/full_integer_quantization.h"
+
+#include <string.h>
+
+#include "googletest/include/gtest/gtest.h"
+#include "test_utils.h"
+
+namespace {
+using Range = FullIntegerQuantization::Range;
+
+template <typename T> std::vector<T> ReadBuffer(const Graph& graph, const DataBlob* blob) {
+    const auto*    buffer = graph.GetBuffer(blob->GetID());
+    std::vector<T> values(buffer->size() / sizeof(T));
+    memcpy(values.data(), buffer->data(), buffer->size());
+    return values;
+}
+
+const DataBlob* FindBlob(const Graph& graph, const std::string& name) {
+    for (const auto* blob : graph.GetDataBlobs()) {
+        if (blob->GetName() == name) {
+            return blob;
+        }
+    }
+    return nullptr;
+}
+
+// input [1, 4, 4, 3] -> CONV2D with ReLU -> conv [1, 4, 4, 4] -> MAX_POOL -> pool [1, 2, 2, 4] -> RESHAPE
+// -> flat [1, 16] -> FULLY_CONNECTED -> logits [1, 5] -> ADD with a constant -> sum [1, 5] -> SOFTMAX -> output [1, 5]
+void BuildClassifier(Graph& graph) {
+    auto* input        = AddTensor(graph, "input", {1, 4, 4, 3});
+    auto* filter       = AddTensor(graph, "filter", {4, 1, 1, 3});
+    auto* conv_bias    = AddTensor(graph, "conv_bias", {4});
+    auto* conv         = AddTensor(graph, "conv", {1, 4, 4, 4});
+    auto* pool         = AddTensor(graph, "pool", {1, 2, 2, 4});
+    auto* shape        = AddTensor(graph, "shape", {2});
+    auto* flat         = AddTensor(graph, "flat", {1, 16});
+    auto* weights      = AddTensor(graph, "weights", {5, 16});
+    auto* logits       = AddTensor(graph, "logits", {1, 5});
+    auto* offsets      = AddTensor(graph, "offsets", {5});
+    auto* sum          = AddTensor(graph, "sum", {1, 5});
+    auto* output       = AddTensor(graph, "output", {1, 5});
+    auto  filter_data  = std::vector<float>({1, -1, 0.5, 0.25, 0.5, -0.25, 2, 0, 0, -0.1, 0.1, 0.2});
+    auto  weights_data = std::vector<float>(80);
+    for (size_t index = 0; index < weights_data.size(); index++) {
+        weights_data[index] = static_cast<float>(index % 7) / 7 - 0.5f;
+    }
+    shape->SetDataType(DataType::INT32);
+    graph.SetBuffer(filter->GetID(), filter_data);
+    graph.SetBuffer(conv_bias->GetID(), std::vector<float>({0.1, -0.1, 0.2, 0}));
+    graph.SetBuffer(shape->GetID(), std::vector<int32_t>({1, 16}));
+    graph.SetBuffer(weights->GetID(), weights_data);
+    graph.SetBuffer(offsets->GetID(), std::vector<float>({-1, 0, 1, 2, 0.5}));
+
+    auto* conv2d = graph.AddOperator(OperatorType::CONV2D, {input, filter, conv_bias}, {conv});
+    conv2d->GetOption<Conv2DOption>()->activation_type = OperatorType::ReLU;
+    graph.AddOperator(OperatorType::MAX_POOL, {conv}, {pool});
+    graph.AddOperator(OperatorType::RESHAPE, {pool, shape}, {flat});
+    graph.AddOperator(OperatorType::FULLY_CONNECTED, {flat, weights}, {logits});
+    auto* add               = graph.AddOperator(OperatorType::ADD, {logits, offsets}, {sum});
+    auto* option            = add->GetOption<AddOption>();
+    option->pot_scale_int16 = true;
+    option->activation_type = OperatorType::NONE;
+    graph.AddOperator(OperatorType::SOFTMAX, {sum}, {output});
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+}
+
+std::unordered_map<std::string, Range> GetRanges() {
+    return {
+        {"input",  {-1.0f, 3.0f}},
+        {"conv",   {0.0f, 6.0f} },
+        {"logits", {-4.0f, 4.0f}},
+        {"sum",    {-5.0f, 5.0f}},
+    };
+}
+}  // namespace
+
+TEST(FULL_INTEGER_QUANTIZATION_TEST, QuantizeClassifier) {
+    Graph graph;
+    BuildClassifier(graph);
+    auto summary = FullIntegerQuantization::Run(graph, GetRanges(), 2);
+    EXPECT_EQ(summary.activations, 7u);
+    EXPECT_EQ(summary.weights, 2u);
+    EXPECT_EQ(summary.constants, 1u);
+    EXPECT_EQ(summary.quantize_ops, 1u);
+    EXPECT_EQ(summary.dequantize_ops, 1u);
+
+    // The float32 interface is kept, QUANTIZE and DEQUANTIZE sit right behind and in front of it.
+    const auto* input  = FindBlob(graph, "input");
+    const auto* output = FindBlob(graph, "output");
+    EXPECT_EQ(graph.GetGraphInputs(), std::vector<BLOBID_T>({input->GetID()}));
+    EXPECT_EQ(graph.GetGraphOutputs(), std::vector<BLOBID_T>({output->GetID()}));
+    EXPECT_EQ(input->GetDataType(), DataType::FLOAT32);
+    EXPECT_EQ(output->GetDataType(), DataType::FLOAT32);
+    ASSERT_EQ(input->GetConsumers().size(), 1u);
+    EXPECT_EQ((*input->GetConsumers().begin())->GetOpType(), OperatorType::QUANTIZE);
+    EXPECT_EQ(output->GetProducer()->GetOpType(), OperatorType::DEQUANTIZE);
+    size_t boundary_ops = 0;
+    for (const auto* op : graph.GetOperators()) {
+        if (op->GetOpType() == OperatorType::QUANTIZE || op->GetOpType() == OperatorType::DEQUANTIZE) {
+            boundary_ops++;
+        }
+    }
+    EXPECT_EQ(boundary_ops, 2u);
+
+    const auto* input_int8 = FindBlob(graph, "input_int8");
+    ASSERT_NE(input_int8, nullptr);
+    EXPECT_EQ(input_int8->GetDataType(), DataType::INT8);
+    EXPECT_FLOAT_EQ(input_int8->GetQuantParam().scales[0], 4.0f / 255);
+    EXPECT_EQ(input_int8->GetQuantParam().zero_points[0], -64);
+
+    // Pooling and reshaping keep the parameters of the convolution output.
+    for (const auto* name : {"conv", "pool", "flat"}) {
+        const auto* blob = FindBlob(graph, name);
+        EXPECT_EQ(blob->GetDataType(), DataType::INT8) << name;
+        EXPECT_FLOAT_EQ(blob->GetQuantParam().scales[0], 6.0f / 255) << name;
+        EXPECT_EQ(blob->GetQuantParam().zero_points[0], -128) << name;
+    }
+    const auto* output_int8 = FindBlob(graph, "output_int8");
+    EXPECT_EQ(output_int8->GetProducer()->GetOpType(), OperatorType::SOFTMAX);
+    EXPECT_FLOAT_EQ(output_int8->GetQuantParam().scales[0], 1.0f / 256);
+    EXPECT_EQ(output_int8->GetQuantParam().zero_points[0], -128);
+
+    // Per-channel weights with an int32 bias, and the ADD operand per tensor.
+    const auto* filter    = FindBlob(graph, "filter");
+    const auto* conv_bias = FindBlob(graph, "conv_bias");
+    EXPECT_EQ(filter->GetDataType(), DataType::INT8);
+    EXPECT_EQ(filter->GetQuantParam().scales.size(), 4u);
+    EXPECT_EQ(conv_bias->GetDataType(), DataType::INT32);
+    EXPECT_FLOAT_EQ(conv_bias->GetQuantParam().scales[0], 4.0f / 255 * filter->GetQuantParam().scales[0]);
+    EXPECT_EQ(FindBlob(graph, "weights")->GetDataType(), DataType::INT8);
+    const auto* offsets = FindBlob(graph, "offsets");
+    EXPECT_EQ(offsets->GetDataType(), DataType::INT8);
+    EXPECT_FLOAT_EQ(offsets->GetQuantParam().scales[0], 3.0f / 255);
+    EXPECT_EQ(ReadBuffer<int8_t>(graph, offsets), std::vector<int8_t>({-128, -43, 42, 127, 0}));
+    EXPECT_EQ(FindBlob(graph, "shape")->GetDataType(), DataType::INT32);
+
+    EXPECT_FALSE(FindBlob(graph, "sum")->GetProducer()->GetOption<AddOption>()->pot_scale_int16);
+}
+
+TEST(FULL_INTEGER_QUANTIZATION_TEST, RejectIncompleteCalibration) {
+    Graph graph;
+    BuildClassifier(graph);
+    auto ranges = GetRanges();
+    ranges.erase("logits");
+    EXPECT_THROW(FullIntegerQuantization::Run(graph, ranges), std::runtime_error);
+
+    ranges        = GetRanges();
+    ranges["sum"] = {1.0f, -1.0f};
+    EXPECT_THROW(FullIntegerQuantization::Run(graph, ranges), std::runtime_error);
+
+    // Errors come before any change, the graph is still float32.
+    EXPECT_EQ(graph.GetOperators().size(), 6u);
+    EXPECT_EQ(FindBlob(graph, "conv")->GetDataType(), DataType::FLOAT32);
+    EXPECT_FALSE(FindBlob(graph, "conv")->HasQuantParam());
+
+    // DIV has no int8 kernel.
+    auto* sum = graph.GetDataBlob(FindBlob(graph, "sum")->GetID());
+    graph.AddOperator(OperatorType::DIV, {sum, sum}, {AddTensor(graph, "ratio", {1, 5})});
+    EXPECT_THROW(FullIntegerQuantization::Run(graph, GetRanges()), std::runtime_error);
+}
+
+TEST(FULL_INTEGER_QUANTIZATION_TEST, ShareParamsThroughResize) {
+    // input [1, 2, 2, 3] -> RESIZE_NEAREST_NEIGHBOR -> resized [1, 4, 4, 3] -> RESIZE_BILINEAR -> output [1, 8, 8, 3]
+    Graph graph;
+    auto* input   = AddTensor(graph, "input", {1, 2, 2, 3});
+    auto* resized = AddTensor(graph, "resized", {1, 4, 4, 3});
+    auto* output  = AddTensor(graph, "output", {1, 8, 8, 3});
+    auto* size1   = AddTensor(graph, "size1", {2});
+    auto* size2   = AddTensor(graph, "size2", {2});
+    size1->SetDataType(DataType::INT32);
+    size2->SetDataType(DataType::INT32);
+    graph.SetBuffer(size1->GetID(), std::vector<int32_t>({4, 4}));
+    graph.SetBuffer(size2->GetID(), std::vector<int32_t>({8, 8}));
+    graph.AddOperator(OperatorType::RESIZE_NEAREST_NEIGHBOR, {input, size1}, {resized});
+    graph.AddOperator(OperatorType::RESIZE_BILINEAR, {resized, size2}, {output});
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    // Int8 kernels of both resizes require the parameters of their input.
+    FullIntegerQuantization::Run(graph,
+                                 {{"input", {-1.0f, 1.0f}}, {"resized", {-1.5f, 1.5f}}, {"output", {-2.0f, 2.0f}}});
+    for (const auto* name : {"input_int8", "resized", "output_int8"}) {
+        const auto* blob = FindBlob(graph, name);
+        EXPECT_EQ(blob->GetDataType(), DataType::INT8) << name;
+        EXPECT_FLOAT_EQ(blob->GetQuantParam().scales[0], 4.0f / 255) << name;
+        EXPECT_EQ(blob->GetQuantParam().zero_points[0], -1) << name;
+    }
+    EXPECT_EQ(size1->GetDataType(), DataType::INT32);
+}
+
+TEST(FULL_INTEGER_QUANTIZATION_TEST, CheckFixedParamsOfGroups) {
+    // input [1, 4] -> `first` and `second` -> a [1, 4] and b [1, 4] -> CONCAT -> output [1, 8]
+    auto build = [](Graph& graph, OperatorType first, OperatorType second) {
+        auto* input  = AddTensor(graph, "input", {1, 4});
+        auto* a      = AddTensor(graph, "a", {1, 4});
+        auto* b      = AddTensor(graph, "b", {1, 4});
+        auto* output = AddTensor(graph, "output", {1, 8});
+        graph.AddOperator(first, {input}, {a});
+        graph.AddOperator(second, {input}, {b});
+        graph.AddOperator(OperatorType::CONCAT, {a, b}, {output})->GetOption<ConcatOption>()->axis = 1;
+        graph.SetGraphInputs({input->GetID()});
+        graph.SetGraphOutputs({output->GetID()});
+    };
+    std::unordered_map<std::string, FullIntegerQuantization::Range> ranges = {
+        {"input", {-4.0f, 4.0f}},
+        {"a",     {-1.0f, 1.0f}},
+        {"b",     {0.0f, 1.0f} },
+    };
+
+    // Two LOGISTIC outputs have the same fixed parameters, which the CONCAT keeps.
+    Graph logistics;
+    build(logistics, OperatorType::LOGISTIC, OperatorType::LOGISTIC);
+    FullIntegerQuantization::Run(logistics, ranges);
+    for (const auto* name : {"a", "b", "output_int8"}) {
+        const auto* blob = FindBlob(logistics, name);
+        EXPECT_FLOAT_EQ(blob->GetQuantParam().scales[0], 1.0f / 256) << name;
+        EXPECT_EQ(blob->GetQuantParam().zero_points[0], -128) << name;
+    }
+
+    // TANH and LOGISTIC fix different parameters, and a calibrated ReLU output would be clipped to [0, 1).
+    for (auto first : {OperatorType::TANH, OperatorType::ReLU}) {
+        Graph graph;
+        build(graph, first, OperatorType::LOGISTIC);
+        EXPECT_THROW(FullIntegerQuantization::Run(graph, ranges), std::runtime_error);
+        EXPECT_EQ(graph.GetOperators().size(), 3u);
+        EXPECT_EQ(FindBlob(graph, "a")->GetDataType(), DataType::FLOAT32);
+    }
+}
+
+TEST(FULL_INTEGER_QUANTIZATION_TEST, CheckBiases) {
+    // input [1, 4] -> FULLY_CONNECTED -> hidden [1, 4] -> FULLY_CONNECTED -> output [1, 4], both with `bias`.
+    auto build = [](Graph& graph, const std::vector<int>& bias_dims) {
+        auto* input   = AddTensor(graph, "input", {1, 4});
+        auto* weights = AddTensor(graph, "weights", {4, 4});
+        auto* bias    = AddTensor(graph, "bias", bias_dims);
+        auto* hidden  = AddTensor(graph, "hidden", {1, 4});
+        auto* output  = AddTensor(graph, "output", {1, 4});
+        graph.SetBuffer(weights->GetID(), std::vector<float>(16, 0.5f));
+        graph.SetBuffer(bias->GetID(), std::vector<float>(bias_dims[0], 1.0f));
+        graph.AddOperator(OperatorType::FULLY_CONNECTED, {input, weights, bias}, {hidden});
+        graph.AddOperator(OperatorType::FULLY_CONNECTED, {hidden, weights, bias}, {output});
+        graph.SetGraphInputs({input->GetID()});
+        graph.SetGraphOutputs({output->GetID()});
+    };
+    std::unordered_map<std::string, FullIntegerQuantization::Range> ranges = {
+        {"input",  {-1.0f, 1.0f}},
+        {"hidden", {-4.0f, 4.0f}},
+        {"output", {-8.0f, 8.0f}},
+    };
+
+    // A bias needs one value per output channel.
+    Graph mismatched;
+    build(mismatched, {3});
+    EXPECT_THROW(FullIntegerQuantization::Run(mismatched, ranges), std::runtime_error);
+    EXPECT_EQ(mismatched.GetOperators().size(), 2u);
+    EXPECT_EQ(FindBlob(mismatched, "hidden")->GetDataType(), DataType::FLOAT32);
+
+    // A shared bias is copied for each operator, since scales follow the input of the operator.
+    Graph graph;
+    build(graph, {4});
+    FullIntegerQuantization::Run(graph, ranges);
+    EXPECT_EQ(FindBlob(graph, "bias"), nullptr);
+    const auto* weights = FindBlob(graph, "weights");
+    const auto* bias1   = FindBlob(graph, "bias_hidden");
+    const auto* bias2   = FindBlob(graph, "bias_output");
+    ASSERT_NE(bias1, nullptr);
+    ASSERT_NE(bias2, nullptr);
+    EXPECT_EQ(bias1->GetDataType(), DataType::INT32);
+    EXPECT_EQ(bias2->GetDataType(), DataType::INT32);
+    EXPECT_FLOAT_EQ(bias1->GetQuantParam().scales[0], 2.0f / 255 * weights->GetQuantParam().scales[0]);
+    EXPECT_FLOAT_EQ(bias2->GetQuantParam().scales[0], 8.0f / 255 * weights->GetQuantParam().scales[0]);
+}
@@ -0,0 +1,201 @@
+#include "transforms/low_rank_factorization.h"
+
+#include <string.h>
+
+#include <random>
+
+#include "googletest/include/gtest/gtest.h"
+#include "test_utils.h"
+
+namespace {
+std::vector<float> ReadFloats(const Graph& graph, const DataBlob* blob) {
+    const auto*        buffer = graph.GetBuffer(blob->GetID());
+    std::vector<float> values(buffer->size() / sizeof(float));
+    memcpy(values.data(), buffer->data(), buffer->size());
+    return values;
+}
+
+// Row-major [rows, cols] matrix, the sum of `rank` random outer products.
+std::vector<float> LowRankMatrix(size_t rows, size_t cols, size_t rank, uint32_t seed) {
+    std::mt19937                          rng(seed);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    std::vector<float>                    matrix(rows * cols, 0.0f);
+    for (size_t k = 0; k < rank; k++) {
+        std::vector<float> u(rows);
+        std::vector<float> v(cols);
+        for (auto& value : u) {
+            value = uniform(rng);
+        }
+        for (auto& value : v) {
+            value = uniform(rng);
+        }
+        for (size_t row = 0; row < rows; row++) {
+            for (size_t col = 0; col < cols; col++) {
+                matrix[row * cols + col] += u[row] * v[col];
+            }
+        }
+    }
+    return matrix;
+}
+
+// The product of the weights of the second operator, [m, r], and of the first one, [r, n].
+std::vector<float> Reconstruct(const Graph& graph, const Operator& first, const Operator& second) {
+    auto a    = ReadFloats(graph, second.GetInputBlob(1));
+    auto b    = ReadFloats(graph, first.GetInputBlob(1));
+    auto rank = static_cast<size_t>(first.GetInputBlob(1)->GetShape().GetDim(0));
+    auto m    = a.size() / rank;
+    auto n    = b.size() / rank;
+
+    std::vector<float> product(m * n, 0.0f);
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            for (size_t k = 0; k < rank; k++) {
+                product[i * n + j] += a[i * rank + k] * b[k * n + j];
+            }
+        }
+    }
+    return product;
+}
+}  // namespace
+
+TEST(LOW_RANK_FACTORIZATION_TEST, FactorizeFullyConnected) {
+    Graph graph;
+    auto* input   = AddTensor(graph, "input", {3, 20});
+    auto* weights = AddTensor(graph, "weights", {12, 20});
+    auto* bias    = AddTensor(graph, "bias", {12});
+    auto* output  = AddTensor(graph, "output", {3, 12});
+    auto  matrix  = LowRankMatrix(12, 20, 2, 7);
+    graph.SetBuffer(weights->GetID(), matrix);
+    graph.SetBuffer(bias->GetID(), std::vector<float>(12, 0.5f));
+    auto* fc                = graph.AddOperator(OperatorType::FULLY_CONNECTED, {input, weights, bias}, {output});
+    auto* option            = fc->GetOption<FullyConnectedOption>();
+    option->keep_num_dims   = false;
+    option->activation_type = OperatorType::ReLU;
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    EXPECT_EQ(LowRankFactorization::FindCandidates(graph, 240), std::vector<std::string>({"output"}));
+    EXPECT_TRUE(LowRankFactorization::FindCandidates(graph, 241).empty());
+    EXPECT_THROW(LowRankFactorization::Run(graph, {"output"}, 0.0), std::runtime_error);
+    EXPECT_THROW(LowRankFactorization::Run(graph, {"input"}, 0.99), std::runtime_error);
+
+    auto layers = LowRankFactorization::Run(graph, {"output"}, 0.999, 4);
+    ASSERT_EQ(layers.size(), 1u);
+    EXPECT_TRUE(layers[0].factorized);
+    EXPECT_EQ(layers[0].output_channels, 12);
+    EXPECT_EQ(layers[0].input_channels, 20);
+    EXPECT_EQ(layers[0].rank, 2);
+    EXPECT_NEAR(layers[0].retained_energy, 1.0, 1e-9);
+    EXPECT_EQ(layers[0].original_params, 240u);
+    EXPECT_EQ(layers[0].factorized_params, 64u);
+    EXPECT_EQ(layers[0].original_macs, 720u);
+    EXPECT_EQ(layers[0].factorized_macs, 192u);
+
+    // input -> FULLY_CONNECTED -> output_lowrank [3, 2] -> FULLY_CONNECTED with bias and ReLU -> output
+    auto ops = graph.TopologicalSort();
+    ASSERT_EQ(ops.size(), 2u);
+    const auto* first  = ops[0];
+    const auto* second = ops[1];
+    EXPECT_EQ(first->GetOpType(), OperatorType::FULLY_CONNECTED);
+    EXPECT_EQ(first->GetInputIDs().size(), 2u);
+    EXPECT_EQ(first->GetOutputBlob(0)->GetName(), "output_lowrank");
+    EXPECT_EQ(first->GetOutputBlob(0)->GetShape().GetDims(), std::vector<int>({3, 2}));
+    EXPECT_EQ(first->GetOption<FullyConnectedOption>()->activation_type, OperatorType::NONE);
+    EXPECT_EQ(second->GetInputBlob(0), first->GetOutputBlob(0));
+    EXPECT_EQ(second->GetInputBlob(1)->GetShape().GetDims(), std::vector<int>({12, 2}));
+    EXPECT_EQ(second->GetInputBlob(2), bias);
+    EXPECT_EQ(second->GetOutputBlob(0), output);
+    EXPECT_EQ(second->GetOption<FullyConnectedOption>()->activation_type, OperatorType::ReLU);
+    EXPECT_FALSE(second->GetOption<FullyConnectedOption>()->keep_num_dims);
+    EXPECT_EQ(graph.GetDataBlob(weights->GetID()), nullptr);
+
+    auto product = Reconstruct(graph, *first, *second);
+    ASSERT_EQ(product.size(), matrix.size());
+    for (size_t index = 0; index < matrix.size(); index++) {
+        EXPECT_NEAR(product[index], matrix[index], 1e-4);
+    }
+}
+
+TEST(LOW_RANK_FACTORIZATION_TEST, FactorizeBatchMatmul) {
+    // x [2, 5, 8] -> BATCH_MATMUL with y [8, 6] -> output [2, 5, 6], W = y^T is [6, 8].
+    auto build = [](Graph& graph, const std::vector<float>& y) {
+        auto* x      = AddTensor(graph, "x", {2, 5, 8});
+        auto* y_blob = AddTensor(graph, "y", {8, 6});
+        auto* output = AddTensor(graph, "output", {2, 5, 6});
+        graph.SetBuffer(y_blob->GetID(), y);
+        auto* bmm = graph.AddOperator(OperatorType::BATCH_MATMUL, {x, y_blob}, {output});
+        bmm->GetOption<BatchMatmulOption>()->adj_y = false;
+        graph.SetGraphInputs({x->GetID()});
+        graph.SetGraphOutputs({output->GetID()});
+    };
+
+    // Full rank weights would only grow.
+    Graph full_rank;
+    build(full_rank, LowRankMatrix(8, 6, 6, 11));
+    auto layers = LowRankFactorization::Run(full_rank, {"output"}, 1.0);
+    ASSERT_EQ(layers.size(), 1u);
+    EXPECT_FALSE(layers[0].factorized);
+    EXPECT_EQ(layers[0].rank, 6);
+    EXPECT_EQ(layers[0].factorized_macs, layers[0].original_macs);
+    ASSERT_EQ(full_rank.GetOperators().size(), 1u);
+    EXPECT_EQ(full_rank.TopologicalSort()[0]->GetOpType(), OperatorType::BATCH_MATMUL);
+
+    Graph rank_one;
+    auto  y = LowRankMatrix(8, 6, 1, 13);
+    build(rank_one, y);
+    layers = LowRankFactorization::Run(rank_one, {"output"}, 0.99, 2);
+    ASSERT_EQ(layers.size(), 1u);
+    EXPECT_TRUE(layers[0].factorized);
+    EXPECT_EQ(layers[0].output_channels, 6);
+    EXPECT_EQ(layers[0].input_channels, 8);
+    EXPECT_EQ(layers[0].rank, 1);
+    EXPECT_EQ(layers[0].original_macs, 480u);
+    EXPECT_EQ(layers[0].factorized_macs, 140u);
+
+    auto ops = rank_one.TopologicalSort();
+    ASSERT_EQ(ops.size(), 2u);
+    for (const auto* op : ops) {
+        EXPECT_EQ(op->GetOpType(), OperatorType::FULLY_CONNECTED);
+        EXPECT_TRUE(op->GetOption<FullyConnectedOption>()->keep_num_dims);
+    }
+    EXPECT_EQ(ops[0]->GetOutputBlob(0)->GetShape().GetDims(), std::vector<int>({2, 5, 1}));
+    auto product = Reconstruct(rank_one, *ops[0], *ops[1]);
+    for (size_t i = 0; i < 6; i++) {
+        for (size_t j = 0; j < 8; j++) {
+            EXPECT_NEAR(product[i * 8 + j], y[j * 6 + i], 1e-4);
+        }
+    }
+}
+
+TEST(LOW_RANK_FACTORIZATION_TEST, FactorizeLayersInBatches) {
+    // input [1, 16] -> three FULLY_CONNECTED layers with weights [16, 16] of rank 1, 2 and 3.
+    Graph                  graph;
+    std::vector<DataBlob*> activations;
+    for (int layer = 0; layer <= 3; layer++) {
+        activations.push_back(AddTensor(graph, "activation" + std::to_string(layer), {1, 16}));
+    }
+    for (int layer = 0; layer < 3; layer++) {
+        auto* weights = AddTensor(graph, "weights" + std::to_string(layer), {16, 16});
+        graph.SetBuffer(weights->GetID(), LowRankMatrix(16, 16, layer + 1, layer + 17));
+        graph.AddOperator(OperatorType::FULLY_CONNECTED, {activations[layer], weights}, {activations[layer + 1]})
+            ->GetOption<FullyConnectedOption>()
+            ->keep_num_dims = false;
+    }
+    graph.SetGraphInputs({activations[0]->GetID()});
+    graph.SetGraphOutputs({activations[3]->GetID()});
+
+    // Selections are checked before any layer is factorized.
+    EXPECT_THROW(LowRankFactorization::Run(graph, {"activation1", "activation2", "input"}, 0.999, 2),
+                 std::runtime_error);
+    EXPECT_EQ(graph.GetOperators().size(), 3u);
+
+    // Two threads decompose the first two layers together, then the third one.
+    auto layers = LowRankFactorization::Run(graph, {"activation1", "activation2", "activation3"}, 0.999, 2);
+    ASSERT_EQ(layers.size(), 3u);
+    for (int layer = 0; layer < 3; layer++) {
+        EXPECT_EQ(layers[layer].op_output, "activation" + std::to_string(layer + 1));
+        EXPECT_TRUE(layers[layer].factorized);
+        EXPECT_EQ(layers[layer].rank, layer + 1);
+    }
+    EXPECT_EQ(graph.GetOperators().size(), 6u);
+}
@@ -0,0 +1,92 @@
+#include "transforms/mixed_precision.h"
+
+#include <cmath>
+
+#include "googletest/include/gtest/gtest.h"
+#include "test_utils.h"
+
+namespace {
+// A FULLY_CONNECTED and a BATCH_MATMUL, each with 64x64 float32 weights of 16384 bytes.
+void BuildGraph(Graph& graph) {
+    std::vector<float> values(64 * 64);
+    for (size_t index = 0; index < values.size(); index++) {
+        values[index] = 0.5f * std::sin(0.37f * index);
+    }
+    auto* input    = AddTensor(graph, "input", {1, 64});
+    auto* weights1 = AddTensor(graph, "weights1", {64, 64});
+    auto* hidden   = AddTensor(graph, "hidden", {1, 64});
+    auto* weights2 = AddTensor(graph, "weights2", {64, 64});
+    auto* output   = AddTensor(graph, "output", {1, 64});
+    graph.SetBuffer(weights1->GetID(), values);
+    graph.SetBuffer(weights2->GetID(), values);
+    graph.AddOperator(OperatorType::FULLY_CONNECTED, {input, weights1}, {hidden});
+    graph.AddOperator(OperatorType::BATCH_MATMUL, {hidden, weights2}, {output});
+}
+
+DataType GetWeightType(const Graph& graph, const std::string& name) {
+    for (const auto* blob : graph.GetDataBlobs()) {
+        if (blob->GetName() == name) {
+            return blob->GetDataType();
+        }
+    }
+    return DataType::UNDEFINED;
+}
+}  // namespace
+
+TEST(MIXED_PRECISION_TEST, SmallestChoiceAboveSnr) {
+    Graph graph;
+    BuildGraph(graph);
+
+    // Int8 and int4 fall below 60 dB, float16 stays above it. Analyze leaves the graph alone.
+    auto plan = MixedPrecision::Analyze(graph, {0, 0.0, 60.0}, CostModel::Roofline(), 0, 2);
+    ASSERT_EQ(plan.layers.size(), 2u);
+    // The operator still reads float32 weights, which a DEQUANTIZE of 4096 elements rebuilds.
+    CostModel::OperatorCost dequantize {nullptr, 0, 4096, 0, 4096 * 2, 4096 * sizeof(float)};
+    double                  dequantize_seconds = CostModel::Roofline().EstimateSeconds(dequantize);
+    for (const auto& layer : plan.layers) {
+        ASSERT_EQ(layer.choices.size(), 2u);
+        EXPECT_EQ(layer.choices[layer.chosen].precision, MixedPrecision::Precision::FLOAT16);
+        EXPECT_EQ(layer.choices[layer.chosen].weight_bytes, 8192u);
+        EXPECT_DOUBLE_EQ(layer.choices[layer.chosen].seconds, layer.choices[0].seconds + dequantize_seconds);
+    }
+    EXPECT_EQ(GetWeightType(graph, "weights1"), DataType::FLOAT32);
+
+    // Without a floor, kernels of FULLY_CONNECTED take int4 and those of BATCH_MATMUL int8.
+    plan = MixedPrecision::Run(graph, {}, CostModel::Roofline(), 0, 2);
+    EXPECT_TRUE(plan.budget_met);
+    EXPECT_EQ(plan.layers[0].op_output, "hidden");
+    EXPECT_EQ(plan.layers[0].choices.size(), 4u);
+    EXPECT_EQ(plan.layers[1].choices.size(), 3u);
+    EXPECT_GT(plan.layers[0].choices[2].snr_db, 40.0);
+    EXPECT_LT(plan.layers[0].choices[3].snr_db, 30.0);
+    EXPECT_EQ(GetWeightType(graph, "weights1"), DataType::INT4);
+    EXPECT_EQ(GetWeightType(graph, "weights2"), DataType::INT8);
+}
+
+TEST(MIXED_PRECISION_TEST, SizeBudget) {
+    Graph graph;
+    BuildGraph(graph);
+
+    // Float16 on both layers leaves 16384 bytes, int8 on both 2 * (4096 + 64 * 12) bytes.
+    auto plan = MixedPrecision::Analyze(graph, {20000, 0.0, 0.0}, CostModel::Roofline(), 0, 2);
+    EXPECT_TRUE(plan.budget_met);
+    for (const auto& layer : plan.layers) {
+        EXPECT_EQ(layer.choices[layer.chosen].precision, MixedPrecision::Precision::FLOAT16);
+    }
+    plan = MixedPrecision::Analyze(graph, {12000, 0.0, 0.0}, CostModel::Roofline(), 0, 2);
+    EXPECT_TRUE(plan.budget_met);
+    for (const auto& layer : plan.layers) {
+        EXPECT_EQ(layer.choices[layer.chosen].precision, MixedPrecision::Precision::INT8);
+    }
+    plan = MixedPrecision::Analyze(graph, {100, 0.0, 0.0}, CostModel::Roofline(), 0, 2);
+    EXPECT_FALSE(plan.budget_met);
+
+    // Float16 weights need a DEQUANTIZE on every run, so a time budget skips them.
+    auto float32_seconds = plan.layers[0].choices[0].seconds + plan.layers[1].choices[0].seconds;
+    plan                 = MixedPrecision::Run(graph, {0, float32_seconds * 0.9, 0.0}, CostModel::Roofline(), 0, 2);
+    EXPECT_TRUE(plan.budget_met);
+    for (const auto& layer : plan.layers) {
+        EXPECT_NE(layer.choices[layer.chosen].precision, MixedPrecision::Precision::FLOAT16);
+    }
+    EXPECT_EQ(graph.GetOperators().size(), 2u);
+}
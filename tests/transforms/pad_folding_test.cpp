@@ -0,0 +1,131 @@
+#include "transforms/pad_folding.h"
+
+#include "googletest/include/gtest/gtest.h"
+
+namespace {
+DataBlob* AddActivation(Graph& graph, const std::string& name, const std::vector<int>& dims) {
+    auto* blob = graph.AddDataBlob(name);
+    blob->SetDataType(DataType::FLOAT32);
+    blob->SetShape(Shape(dims));
+    return blob;
+}
+
+DataBlob* AddPaddings(Graph& graph, int top, int bottom, int left, int right) {
+    auto* blob = graph.AddDataBlob("paddings");
+    blob->SetDataType(DataType::INT32);
+    blob->SetShape(Shape({4, 2}));
+    graph.SetBuffer(blob->GetID(), std::vector<int32_t>({0, 0, top, bottom, left, right, 0, 0}));
+    return blob;
+}
+
+Operator* AddConv2D(Graph& graph, DataBlob* input, DataBlob* output, int stride) {
+    auto* filter = graph.AddDataBlob("filter");
+    filter->SetDataType(DataType::FLOAT32);
+    filter->SetShape(Shape({8, 3, 3, 4}));
+    graph.SetBuffer(filter->GetID(), std::vector<float>(8 * 3 * 3 * 4, 1.0F));
+
+    auto* conv              = graph.AddOperator(OperatorType::CONV2D, {input, filter}, {output});
+    auto* option            = conv->GetOption<Conv2DOption>();
+    option->stride_h        = stride;
+    option->stride_w        = stride;
+    option->dilation_h      = 1;
+    option->dilation_w      = 1;
+    option->pad_type        = Padding::VALID;
+    option->activation_type = OperatorType::NONE;
+    return conv;
+}
+
+Operator* AddMaxPool(Graph& graph, DataBlob* input, DataBlob* output) {
+    auto* pool       = graph.AddOperator(OperatorType::MAX_POOL, {input}, {output});
+    auto* option     = pool->GetOption<Pool2DOption>();
+    option->stride_h = 1;
+    option->stride_w = 1;
+    option->filter_h = 3;
+    option->filter_w = 3;
+    option->pad_type = Padding::VALID;
+    return pool;
+}
+}  // namespace
+
+TEST(PAD_FOLDING_TEST, FoldPadIntoConv2D) {
+    Graph graph;
+    auto* input  = AddActivation(graph, "input", {1, 8, 8, 4});
+    auto* padded = AddActivation(graph, "padded", {1, 10, 10, 4});
+    auto* output = AddActivation(graph, "output", {1, 8, 8, 8});
+    graph.AddOperator(OperatorType::PAD, {input, AddPaddings(graph, 1, 1, 1, 1)}, {padded});
+    auto* conv = AddConv2D(graph, padded, output, 1);
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    EXPECT_EQ(PadFolding::Run(graph), 1U);
+    EXPECT_EQ(graph.GetOperators().size(), 1U);
+    EXPECT_EQ(conv->GetInputBlob(0), input);
+    EXPECT_EQ(conv->GetOption<Conv2DOption>()->pad_type, Padding::SAME);
+    // input, filter and output are left.
+    EXPECT_EQ(graph.GetDataBlobs().size(), 3U);
+}
+
+TEST(PAD_FOLDING_TEST, KeepPadDifferentFromSamePadding) {
+    Graph graph;
+    auto* input  = AddActivation(graph, "input", {1, 8, 8, 4});
+    auto* padded = AddActivation(graph, "padded", {1, 10, 10, 4});
+    auto* output = AddActivation(graph, "output", {1, 4, 4, 8});
+    graph.AddOperator(OperatorType::PAD, {input, AddPaddings(graph, 1, 1, 1, 1)}, {padded});
+    // SAME padding of a 3x3 filter with stride 2 over 8 pixels is (0, 1).
+    auto* conv = AddConv2D(graph, padded, output, 2);
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    EXPECT_EQ(PadFolding::Run(graph), 0U);
+    EXPECT_EQ(graph.GetOperators().size(), 2U);
+    EXPECT_EQ(conv->GetOption<Conv2DOption>()->pad_type, Padding::VALID);
+}
+
+TEST(PAD_FOLDING_TEST, KeepZeroPadBeforeMaxPool) {
+    Graph graph;
+    auto* input  = AddActivation(graph, "input", {1, 8, 8, 4});
+    auto* padded = AddActivation(graph, "padded", {1, 10, 10, 4});
+    auto* output = AddActivation(graph, "output", {1, 8, 8, 4});
+    graph.AddOperator(OperatorType::PAD, {input, AddPaddings(graph, 1, 1, 1, 1)}, {padded});
+    AddMaxPool(graph, padded, output);
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    // Zero padding wins over negative values in the window, unlike SAME padding of MAX_POOL.
+    EXPECT_EQ(PadFolding::Run(graph), 0U);
+    EXPECT_EQ(graph.GetOperators().size(), 2U);
+}
+
+TEST(PAD_FOLDING_TEST, FoldZeroPadIntoMaxPoolAfterReLU) {
+    Graph graph;
+    auto* input  = AddActivation(graph, "input", {1, 8, 8, 4});
+    auto* relu   = AddActivation(graph, "relu", {1, 8, 8, 4});
+    auto* padded = AddActivation(graph, "padded", {1, 10, 10, 4});
+    auto* output = AddActivation(graph, "output", {1, 8, 8, 4});
+    graph.AddOperator(OperatorType::ReLU, {input}, {relu});
+    graph.AddOperator(OperatorType::PAD, {relu, AddPaddings(graph, 1, 1, 1, 1)}, {padded});
+    auto* pool = AddMaxPool(graph, padded, output);
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    EXPECT_EQ(PadFolding::Run(graph), 1U);
+    EXPECT_EQ(graph.GetOperators().size(), 2U);
+    EXPECT_EQ(pool->GetInputBlob(0), relu);
+    EXPECT_EQ(pool->GetOption<Pool2DOption>()->pad_type, Padding::SAME);
+}
+
+TEST(PAD_FOLDING_TEST, FoldMirrorPadIntoMaxPool) {
+    Graph graph;
+    auto* input  = AddActivation(graph, "input", {1, 8, 8, 4});
+    auto* padded = AddActivation(graph, "padded", {1, 10, 10, 4});
+    auto* output = AddActivation(graph, "output", {1, 8, 8, 4});
+    auto* mirror = graph.AddOperator(OperatorType::MIRROR_PAD, {input, AddPaddings(graph, 1, 1, 1, 1)}, {padded});
+    mirror->GetOption<MirrorPadOption>()->mirror_pad_type = MirrorPadType::REFLECT;
+    auto* pool = AddMaxPool(graph, padded, output);
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    EXPECT_EQ(PadFolding::Run(graph), 1U);
+    EXPECT_EQ(graph.GetOperators().size(), 1U);
+    EXPECT_EQ(pool->GetInputBlob(0), input);
+}
@@ -0,0 +1,107 @@
+#include "transforms/pattern_fusion.h"
+
+#include "common/stl_wrapper.h"
+#include "googletest/include/gtest/gtest.h"
+
+namespace {
+DataBlob* AddActivation(Graph& graph, const std::string& name) {
+    auto* blob = graph.AddDataBlob(name);
+    blob->SetDataType(DataType::FLOAT32);
+    blob->SetShape(Shape({1, 16}));
+    return blob;
+}
+
+DataBlob* AddScalar(Graph& graph, float value) {
+    auto* blob = graph.AddDataBlob("scalar");
+    blob->SetDataType(DataType::FLOAT32);
+    blob->SetShape(Shape({1}));
+    graph.SetBuffer(blob->GetID(), std::vector<float>({value}));
+    return blob;
+}
+
+// Build 0.5 * x * (1 + tanh(0.7978846 * (x + 0.044715 * pow(x, 3)))) and return the output blob.
+DataBlob* AddGELUPattern(Graph& graph, DataBlob* x) {
+    auto* cube       = AddActivation(graph, "cube");
+    auto* cubic_term = AddActivation(graph, "cubic_term");
+    auto* inner      = AddActivation(graph, "inner");
+    auto* scaled     = AddActivation(graph, "scaled");
+    auto* tanh       = AddActivation(graph, "tanh");
+    auto* add_one    = AddActivation(graph, "add_one");
+    auto* half_x     = AddActivation(graph, "half_x");
+    auto* output     = AddActivation(graph, "output");
+    graph.AddOperator(OperatorType::POW, {x, AddScalar(graph, 3.0F)}, {cube});
+    graph.AddOperator(OperatorType::MUL, {AddScalar(graph, 0.044715F), cube}, {cubic_term});
+    graph.AddOperator(OperatorType::ADD, {x, cubic_term}, {inner});
+    graph.AddOperator(OperatorType::MUL, {inner, AddScalar(graph, 0.7978846F)}, {scaled});
+    graph.AddOperator(OperatorType::TANH, {scaled}, {tanh});
+    graph.AddOperator(OperatorType::ADD, {tanh, AddScalar(graph, 1.0F)}, {add_one});
+    graph.AddOperator(OperatorType::MUL, {x, AddScalar(graph, 0.5F)}, {half_x});
+    graph.AddOperator(OperatorType::MUL, {add_one, half_x}, {output});
+    return output;
+}
+}  // namespace
+
+TEST(PATTERN_FUSION_TEST, FuseGELU) {
+    Graph graph;
+    auto* input  = AddActivation(graph, "input");
+    auto* output = AddGELUPattern(graph, input);
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    EXPECT_EQ(PatternFusion::Run(graph), 1U);
+    ASSERT_EQ(graph.GetOperators().size(), 1U);
+    auto* gelu = *graph.GetOperators().begin();
+    EXPECT_EQ(gelu->GetOpType(), OperatorType::GELU);
+    EXPECT_EQ(gelu->GetInputBlob(0), input);
+    EXPECT_EQ(gelu->GetOutputBlob(0), output);
+    // All intermediates and coefficients are erased.
+    EXPECT_EQ(graph.GetDataBlobs().size(), 2U);
+}
+
+TEST(PATTERN_FUSION_TEST, KeepGELUWithSharedIntermediate) {
+    Graph graph;
+    auto* input  = AddActivation(graph, "input");
+    auto* output = AddGELUPattern(graph, input);
+    auto* tanh   = *common::find_if(graph.GetDataBlobs(), [](const DataBlob* blob) {
+        return blob->GetName() == "tanh";
+    });
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID(), tanh->GetID()});
+
+    EXPECT_EQ(PatternFusion::Run(graph), 0U);
+    EXPECT_EQ(graph.GetOperators().size(), 8U);
+}
+
+TEST(PATTERN_FUSION_TEST, FuseHardSwishWithFusedReLU6) {
+    Graph graph;
+    auto* input   = AddActivation(graph, "input");
+    auto* relu6   = AddActivation(graph, "relu6");
+    auto* product = AddActivation(graph, "product");
+    auto* output  = AddActivation(graph, "output");
+    auto* add     = graph.AddOperator(OperatorType::ADD, {input, AddScalar(graph, 3.0F)}, {relu6});
+    add->GetOption<AddOption>()->pot_scale_int16 = false;
+    add->GetOption<AddOption>()->activation_type = OperatorType::ReLU6;
+    graph.AddOperator(OperatorType::MUL, {input, relu6}, {product});
+    graph.AddOperator(OperatorType::DIV, {product, AddScalar(graph, 6.0F)}, {output});
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    EXPECT_EQ(PatternFusion::Run(graph), 1U);
+    ASSERT_EQ(graph.GetOperators().size(), 1U);
+    EXPECT_EQ((*graph.GetOperators().begin())->GetOpType(), OperatorType::HARDSWISH);
+}
+
+TEST(PATTERN_FUSION_TEST, FuseLogSoftmax) {
+    Graph graph;
+    auto* input   = AddActivation(graph, "input");
+    auto* softmax = AddActivation(graph, "softmax");
+    auto* output  = AddActivation(graph, "output");
+    graph.AddOperator(OperatorType::SOFTMAX, {input}, {softmax})->GetOption<SoftmaxOption>()->beta = 1.0F;
+    graph.AddOperator(OperatorType::LOG, {softmax}, {output});
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    EXPECT_EQ(PatternFusion::Run(graph), 1U);
+    ASSERT_EQ(graph.GetOperators().size(), 1U);
+    EXPECT_EQ((*graph.GetOperators().begin())->GetOpType(), OperatorType::LOG_SOFTMAX);
+}
@@ -0,0 +1,76 @@
+#include "transforms/shape_specialization.h"
+
+#include "googletest/include/gtest/gtest.h"
+#include "test_utils.h"
+
+namespace {
+DataBlob* AddIntConstant(Graph& graph, const std::vector<int32_t>& values, const std::vector<int>& dims) {
+    auto* blob = AddTensor(graph, "constant", dims, DataType::INT32);
+    graph.SetBuffer(blob->GetID(), values);
+    return blob;
+}
+}  // namespace
+
+TEST(SHAPE_SPECIALIZATION_TEST, FoldDynamicReshape) {
+    // reshape(input, pack(shape(input)[0], 128)), the usual way to flatten with a dynamic batch.
+    Graph graph;
+    auto* input  = AddTensor(graph, "input", {-1, 8, 16}, DataType::FLOAT32);
+    auto* shape  = AddTensor(graph, "shape", {3}, DataType::INT32);
+    auto* batch  = AddTensor(graph, "batch", {}, DataType::INT32);
+    auto* packed = AddTensor(graph, "packed", {2}, DataType::INT32);
+    auto* output = AddTensor(graph, "output", {-1, 128}, DataType::FLOAT32);
+    graph.AddOperator(OperatorType::SHAPE, {input}, {shape});
+    graph
+        .AddOperator(OperatorType::STRIDED_SLICE,
+                     {shape, AddIntConstant(graph, {0}, {1}), AddIntConstant(graph, {1}, {1}),
+                      AddIntConstant(graph, {1}, {1})},
+                     {batch})
+        ->GetOption<StridedSliceOption>()
+        ->shrink_axis_mask = 1;
+    graph.AddOperator(OperatorType::PACK, {batch, AddIntConstant(graph, {128}, {})}, {packed});
+    auto* reshape = graph.AddOperator(OperatorType::RESHAPE, {input, packed}, {output});
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    // SHAPE, STRIDED_SLICE and PACK are folded, the reshape is rewritten.
+    EXPECT_EQ(ShapeSpecialization::Run(graph, {{"input", {4, 8, 16}}}), 4U);
+    ASSERT_EQ(graph.GetOperators().size(), 1U);
+    EXPECT_EQ(output->GetShape(), Shape({4, 128}));
+    EXPECT_EQ(reshape->GetOption<ReshapeOption>()->new_shape, std::vector<int32_t>({4, 128}));
+    std::vector<int64_t> new_shape;
+    ASSERT_TRUE(graph.GetIntegerConstant(reshape->GetInputIDs()[1], new_shape));
+    EXPECT_EQ(new_shape, std::vector<int64_t>({4, 128}));
+    // input, output and the shape constant.
+    EXPECT_EQ(graph.GetDataBlobs().size(), 3U);
+}
+
+TEST(SHAPE_SPECIALIZATION_TEST, RewriteWildcardReshape) {
+    Graph graph;
+    auto* input   = AddTensor(graph, "input", {-1, 4, 4}, DataType::FLOAT32);
+    auto* output  = AddTensor(graph, "output", {-1, 16}, DataType::FLOAT32);
+    auto* reshape = graph.AddOperator(OperatorType::RESHAPE, {input, AddIntConstant(graph, {-1, 16}, {2})}, {output});
+    reshape->GetOption<ReshapeOption>()->new_shape = {-1, 16};
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    EXPECT_EQ(ShapeSpecialization::Run(graph, {{"input", {8, 4, 4}}}), 1U);
+    EXPECT_EQ(output->GetShape(), Shape({8, 16}));
+    EXPECT_EQ(reshape->GetOption<ReshapeOption>()->new_shape, std::vector<int32_t>({8, 16}));
+    // Specializing again is a no-op.
+    EXPECT_EQ(ShapeSpecialization::Run(graph, {{"input", {8, 4, 4}}}), 0U);
+}
+
+TEST(SHAPE_SPECIALIZATION_TEST, KeepOperatorsWithoutOutputs) {
+    // An operator writing a resource variable has inputs only.
+    Graph graph;
+    auto* input  = AddTensor(graph, "input", {-1, 4}, DataType::FLOAT32);
+    auto* output = AddTensor(graph, "output", {-1, 4}, DataType::FLOAT32);
+    graph.AddOperator(OperatorType::ReLU, {input}, {output});
+    auto* sink = graph.AddOperator(OperatorType::NONE, {input}, {});
+    graph.SetGraphInputs({input->GetID()});
+    graph.SetGraphOutputs({output->GetID()});
+
+    EXPECT_EQ(ShapeSpecialization::Run(graph, {{"input", {2, 4}}}), 0U);
+    EXPECT_EQ(graph.GetOperators().size(), 2U);
+    EXPECT_EQ(graph.GetOperator(sink->GetID()), sink);
+}
@@ -0,0 +1,112 @@
+#include "transforms/sparse_encoding.h"
+
+#include <string.h>
+
+#include "googletest/include/gtest/gtest.h"
+#include "test_utils.h"
+
+namespace {
+// Weights [4, 8] with non-zero 1x4 blocks at (0, 1), (2, 0) and (2, 1).
+std::vector<float> GetSparseWeights() {
+    std::vector<float> weights(4 * 8, 0.0f);
+    for (int col = 4; col < 8; col++) {
+        weights[0 * 8 + col] = col;
+    }
+    for (int col = 0; col < 8; col++) {
+        weights[2 * 8 + col] = -col - 1;
+    }
+    return weights;
+}
+}  // namespace
+
+TEST(SPARSE_ENCODING_TEST, EncodeBlockSparseRows) {
+    Graph graph;
+    auto* input   = AddTensor(graph, "input", {1, 8});
+    auto* weights = AddTensor(graph, "weights", {4, 8});
+    auto* output  = AddTensor(graph, "output", {1, 4});
+    auto  dense   = GetSparseWeights();
+    graph.SetBuffer(weights->GetID(), dense);
+    graph.AddOperator(OperatorType::FULLY_CONNECTED, {input, weights}, {output});
+
+    EXPECT_TRUE(SparseEncoding::Run(graph, 0.7f, 1, 4, 0).empty());
+    auto encoded_tensors = SparseEncoding::Run(graph, 0.5f, 1, 4, 0);
+    ASSERT_EQ(encoded_tensors.size(), 1u);
+    EXPECT_EQ(encoded_tensors[0].name, "weights");
+    EXPECT_FLOAT_EQ(encoded_tensors[0].sparsity, 5.0f / 8);
+    EXPECT_EQ(encoded_tensors[0].dense_bytes, 128u);
+    // 12 floats, 5 row pointers and 3 block columns of one byte.
+    EXPECT_EQ(encoded_tensors[0].sparse_bytes, 48u + 5 + 3);
+    EXPECT_EQ(graph.GetBuffer(weights->GetID())->size(), 48u);
+
+    ASSERT_TRUE(weights->HasSparsityParam());
+    const auto& sparsity = weights->GetSparsityParam();
+    EXPECT_EQ(sparsity.traversal_order, std::vector<int32_t>({0, 1, 2}));
+    EXPECT_EQ(sparsity.block_map, std::vector<int32_t>({1}));
+    ASSERT_EQ(sparsity.dim_metadata.size(), 3u);
+    EXPECT_FALSE(sparsity.dim_metadata[0].sparse);
+    EXPECT_EQ(sparsity.dim_metadata[0].dense_size, 4);
+    EXPECT_TRUE(sparsity.dim_metadata[1].sparse);
+    EXPECT_EQ(sparsity.dim_metadata[1].array_segments, std::vector<int32_t>({0, 1, 1, 3, 3}));
+    EXPECT_EQ(sparsity.dim_metadata[1].array_indices, std::vector<int32_t>({1, 0, 1}));
+    EXPECT_FALSE(sparsity.dim_metadata[2].sparse);
+    EXPECT_EQ(sparsity.dim_metadata[2].dense_size, 4);
+
+    auto restored = SparseEncoding::Densify(graph, *weights);
+    ASSERT_EQ(restored.size(), dense.size() * sizeof(float));
+    EXPECT_EQ(memcmp(restored.data(), dense.data(), restored.size()), 0);
+
+    // Encoded weights are left alone.
+    EXPECT_TRUE(SparseEncoding::Run(graph, 0.0f, 1, 4, 0).empty());
+}
+
+TEST(SPARSE_ENCODING_TEST, EncodeTwoDimensionalBlocks) {
+    Graph graph;
+    auto* input   = AddTensor(graph, "input", {1, 8});
+    auto* weights = AddTensor(graph, "weights", {4, 8});
+    auto* output  = AddTensor(graph, "output", {1, 4});
+    auto  dense   = GetSparseWeights();
+    graph.SetBuffer(weights->GetID(), dense);
+    graph.AddOperator(OperatorType::FULLY_CONNECTED, {input, weights}, {output});
+
+    // Blocks don't divide the weights.
+    EXPECT_TRUE(SparseEncoding::Run(graph, 0.0f, 3, 4, 0).empty());
+    ASSERT_EQ(SparseEncoding::Run(graph, 0.25f, 2, 4, 0).size(), 1u);
+    const auto& sparsity = weights->GetSparsityParam();
+    EXPECT_EQ(sparsity.traversal_order, std::vector<int32_t>({0, 1, 2, 3}));
+    EXPECT_EQ(sparsity.block_map, std::vector<int32_t>({0, 1}));
+    EXPECT_EQ(sparsity.dim_metadata[1].array_segments, std::vector<int32_t>({0, 1, 3}));
+    EXPECT_EQ(sparsity.dim_metadata[1].array_indices, std::vector<int32_t>({1, 0, 1}));
+
+    auto restored = SparseEncoding::Densify(graph, *weights);
+    ASSERT_EQ(restored.size(), dense.size() * sizeof(float));
+    EXPECT_EQ(memcmp(restored.data(), dense.data(), restored.size()), 0);
+}
+
+TEST(SPARSE_ENCODING_TEST, SkipOtherConsumers) {
+    Graph graph;
+    auto* input   = AddTensor(graph, "input", {4, 8});
+    auto* weights = AddTensor(graph, "weights", {4, 8});
+    auto* output  = AddTensor(graph, "output", {4, 8});
+    graph.SetBuffer(weights->GetID(), std::vector<float>(4 * 8, 0.0f));
+    graph.AddOperator(OperatorType::ADD, {input, weights}, {output});
+
+    EXPECT_TRUE(SparseEncoding::Run(graph, 0.0f, 1, 4, 0).empty());
+    EXPECT_FALSE(weights->HasSparsityParam());
+}
+
+TEST(SPARSE_ENCODING_TEST, ReportInBlobOrder) {
+    Graph graph;
+    auto* input = AddTensor(graph, "input", {1, 8});
+    for (int index = 0; index < 16; index++) {
+        auto* weights = AddTensor(graph, "weights_" + std::to_string(index), {4, 8});
+        auto* output  = AddTensor(graph, "output_" + std::to_string(index), {1, 4});
+        graph.SetBuffer(weights->GetID(), GetSparseWeights());
+        graph.AddOperator(OperatorType::FULLY_CONNECTED, {input, weights}, {output});
+    }
+
+    auto encoded_tensors = SparseEncoding::Run(graph, 0.5f, 1, 4, 0);
+    ASSERT_EQ(encoded_tensors.size(), 16u);
+    for (size_t index = 0; index < encoded_tensors.size(); index++) {
+        EXPECT_EQ(encoded_tensors[index].name, "weights_" + std::to_string(index));
+    }
+}
@@ -0,0 +1,104 @@
+#include "transforms/weight_clustering.h"
+
+#include "googletest/include/gtest/gtest.h"
+#include "test_utils.h"
+
+namespace {
+template <typename T> std::vector<T> GetValues(const Graph& graph, const DataBlob* blob) {
+    const auto* buffer = graph.GetBuffer(blob->GetID());
+    const auto* data   = reinterpret_cast<const T*>(buffer->data());
+    return std::vector<T>(data, data + buffer->size() / sizeof(T));
+}
+}  // namespace
+
+TEST(WEIGHT_CLUSTERING_TEST, GatherFromCodebook) {
+    Graph graph;
+    auto* input   = AddTensor(graph, "input", {1, 4});
+    auto* weights = AddTensor(graph, "weights", {3, 4});
+    auto* output  = AddTensor(graph, "output", {1, 3});
+    graph.SetBuffer(weights->GetID(), std::vector<float>({-1.1, -0.9, 0, 0, 2, 2.2, 1.8, 2, -1, 0, 0.1, -0.1}));
+    auto* fc = graph.AddOperator(OperatorType::FULLY_CONNECTED, {input, weights}, {output});
+
+    auto clustered_tensors =
+        WeightClustering::Run(graph, {}, 3, false, WeightClustering::Reconstruction::GATHER, 0, 2);
+    ASSERT_EQ(clustered_tensors.size(), 1u);
+    EXPECT_EQ(clustered_tensors[0].name, "weights");
+    EXPECT_EQ(clustered_tensors[0].channels, 1u);
+    EXPECT_EQ(clustered_tensors[0].original_bytes, 48u);
+    EXPECT_EQ(clustered_tensors[0].clustered_bytes, 3 * 4 + 12u);
+    EXPECT_NEAR(clustered_tensors[0].max_error, 0.2f, 1e-6);
+
+    const auto* clustered = fc->GetInputBlob(1);
+    EXPECT_EQ(clustered->GetName(), "weights_clustered");
+    EXPECT_EQ(clustered->GetShape().GetDims(), std::vector<int>({3, 4}));
+    const auto* gather = clustered->GetProducer();
+    ASSERT_NE(gather, nullptr);
+    EXPECT_EQ(gather->GetOpType(), OperatorType::GATHER);
+    EXPECT_EQ(gather->GetOption<GatherOption>()->axis, 0);
+    const auto* positions = gather->GetInputBlob(1);
+    EXPECT_EQ(positions->GetName(), "weights_positions");
+    EXPECT_EQ(positions->GetDataType(), DataType::INT16);
+    const auto* cast = positions->GetProducer();
+    ASSERT_NE(cast, nullptr);
+    EXPECT_EQ(cast->GetOpType(), OperatorType::CAST);
+    EXPECT_EQ(cast->GetInputBlob(0), weights);
+    EXPECT_EQ(cast->GetOption<CastOption>()->out_data_type, DataType::INT16);
+
+    const auto* codebook = gather->GetInputBlob(0);
+    EXPECT_EQ(codebook->GetShape().GetDims(), std::vector<int>({3}));
+    auto centroids = GetValues<float>(graph, codebook);
+    EXPECT_NEAR(centroids[0], -1.0f, 1e-6);
+    EXPECT_NEAR(centroids[1], 0.0f, 1e-6);
+    EXPECT_NEAR(centroids[2], 2.0f, 1e-6);
+    EXPECT_EQ(weights->GetDataType(), DataType::UINT8);
+    EXPECT_EQ(GetValues<uint8_t>(graph, weights), std::vector<uint8_t>({0, 0, 1, 1, 2, 2, 2, 2, 0, 1, 1, 1}));
+}
+
+TEST(WEIGHT_CLUSTERING_TEST, PerChannelInPlace) {
+    Graph graph;
+    auto* input   = AddTensor(graph, "input", {1, 4});
+    auto* weights = AddTensor(graph, "weights", {2, 4});
+    auto* bias    = AddTensor(graph, "bias", {2});
+    auto* output  = AddTensor(graph, "output", {1, 2});
+    graph.SetBuffer(weights->GetID(), std::vector<float>({1, 3, 3, 1, -5, -5, 7, 7}));
+    graph.SetBuffer(bias->GetID(), std::vector<float>({1, 2}));
+    auto* fc = graph.AddOperator(OperatorType::FULLY_CONNECTED, {input, weights, bias}, {output});
+
+    // Two values per channel need no more than two centroids each.
+    auto clustered_tensors =
+        WeightClustering::Run(graph, {"weights"}, 2, true, WeightClustering::Reconstruction::IN_PLACE);
+    ASSERT_EQ(clustered_tensors.size(), 1u);
+    EXPECT_EQ(clustered_tensors[0].channels, 2u);
+    EXPECT_EQ(clustered_tensors[0].clustered_bytes, 32u);
+    EXPECT_FLOAT_EQ(clustered_tensors[0].max_error, 0.0f);
+    EXPECT_EQ(fc->GetInputBlob(1), weights);
+    EXPECT_EQ(weights->GetDataType(), DataType::FLOAT32);
+    EXPECT_EQ(GetValues<float>(graph, weights), std::vector<float>({1, 3, 3, 1, -5, -5, 7, 7}));
+
+    EXPECT_THROW(WeightClustering::Run(graph, {"weights"}, 1, true), std::runtime_error);
+    EXPECT_THROW(WeightClustering::Run(graph, {"unknown"}, 2, true), std::runtime_error);
+}
+
+TEST(WEIGHT_CLUSTERING_TEST, IndicesFitInOneByte) {
+    Graph              graph;
+    auto*              input   = AddTensor(graph, "input", {1, 512});
+    auto*              weights = AddTensor(graph, "weights", {2, 512});
+    auto*              output  = AddTensor(graph, "output", {1, 2});
+    std::vector<float> values(1024);
+    for (size_t index = 0; index < values.size(); index++) {
+        values[index] = static_cast<float>(index % 256);
+    }
+    graph.SetBuffer(weights->GetID(), values);
+    graph.AddOperator(OperatorType::FULLY_CONNECTED, {input, weights}, {output});
+
+    // 256 distinct values per channel take every index of the largest codebook.
+    auto clustered_tensors = WeightClustering::Run(graph, {}, 256, true);
+    ASSERT_EQ(clustered_tensors.size(), 1u);
+    EXPECT_EQ(clustered_tensors[0].clustered_bytes, 2 * 256 * 4 + 1024u);
+    EXPECT_EQ(clustered_tensors[0].max_error, 0.0f);
+    auto indices = GetValues<uint8_t>(graph, weights);
+    ASSERT_EQ(indices.size(), values.size());
+    for (size_t index = 0; index < indices.size(); index++) {
+        EXPECT_EQ(indices[index], index % 256);
+    }
+}
@@ -0,0 +1,137 @@
+#include "transforms/weight_quantization.h"
+
+#include <string.h>
+
+#include "model/int4_buffer.h"
+
+#include "googletest/include/gtest/gtest.h"
+#include "test_utils.h"
+
+namespace {
+template <typename T> std::vector<T> ReadBuffer(const Graph& graph, const DataBlob* blob) {
+    const auto*    buffer = graph.GetBuffer(blob->GetID());
+    std::vector<T> values(buffer->size() / sizeof(T));
+    memcpy(values.data(), buffer->data(), buffer->size());
+    return values;
+}
+}  // namespace
+
+TEST(WEIGHT_QUANTIZATION_TEST, QuantizePerOutputChannel) {
+    Graph graph;
+    auto* input   = AddTensor(graph, "input", {1, 4});
+    auto* weights = AddTensor(graph, "weights", {2, 4});
+    auto* bias    = AddTensor(graph, "bias", {2});
+    auto* output  = AddTensor(graph, "output", {1, 2});
+    graph.SetBuffer(weights->GetID(), std::vector<float>({1, -2, 0.5, 0, 0.1, 0.2, -0.4, 0.3}));
+    graph.SetBuffer(bias->GetID(), std::vector<float>({1, -0.2}));
+    input->CreateQuantParam().scales = {0.5};
+    graph.AddOperator(OperatorType::FULLY_CONNECTED, {input, weights, bias}, {output});
+
+    auto quantized_weights = WeightQuantization::Run(graph, {}, DataType::INT8, 0, 4);
+    ASSERT_EQ(quantized_weights.size(), 1u);
+    EXPECT_EQ(quantized_weights[0].weights, "weights");
+    EXPECT_EQ(quantized_weights[0].channels, 2u);
+    EXPECT_EQ(quantized_weights[0].original_bytes, 32u);
+    EXPECT_EQ(quantized_weights[0].quantized_bytes, 8u);
+    EXPECT_TRUE(quantized_weights[0].bias_quantized);
+
+    EXPECT_EQ(weights->GetDataType(), DataType::INT8);
+    EXPECT_EQ(ReadBuffer<int8_t>(graph, weights), std::vector<int8_t>({64, -127, 32, 0, 32, 64, -127, 95}));
+    ASSERT_TRUE(weights->HasQuantParam());
+    EXPECT_FLOAT_EQ(weights->GetQuantParam().scales[0], 2.0f / 127);
+    EXPECT_FLOAT_EQ(weights->GetQuantParam().scales[1], 0.4f / 127);
+    EXPECT_EQ(weights->GetQuantParam().zero_points, std::vector<int64_t>({0, 0}));
+    EXPECT_EQ(weights->GetQuantParam().quantized_dimension, 0);
+
+    EXPECT_EQ(bias->GetDataType(), DataType::INT32);
+    EXPECT_EQ(ReadBuffer<int32_t>(graph, bias), std::vector<int32_t>({127, -127}));
+}
+
+TEST(WEIGHT_QUANTIZATION_TEST, QuantizeDepthwiseChannelsLast) {
+    Graph graph;
+    auto* input   = AddTensor(graph, "input", {1, 2, 2, 3});
+    auto* weights = AddTensor(graph, "weights", {1, 1, 2, 3});
+    auto* bias    = AddTensor(graph, "bias", {3});
+    auto* output  = AddTensor(graph, "output", {1, 2, 1, 3});
+    graph.SetBuffer(weights->GetID(), std::vector<float>({1, 4, -0.5, -0.5, 2, 0.25}));
+    graph.SetBuffer(bias->GetID(), std::vector<float>({1, 2, 3}));
+    graph.AddOperator(OperatorType::DEPTHWISE_CONV2D, {input, weights, bias}, {output});
+
+    auto quantized_weights = WeightQuantization::Run(graph, {"output"}, DataType::INT8, 0);
+    ASSERT_EQ(quantized_weights.size(), 1u);
+    EXPECT_EQ(quantized_weights[0].channels, 3u);
+    EXPECT_EQ(ReadBuffer<int8_t>(graph, weights), std::vector<int8_t>({127, 127, -127, -64, 64, 64}));
+    EXPECT_EQ(weights->GetQuantParam().quantized_dimension, 3);
+
+    // Without input scale the bias stays float.
+    EXPECT_FALSE(quantized_weights[0].bias_quantized);
+    EXPECT_EQ(bias->GetDataType(), DataType::FLOAT32);
+}
+
+TEST(WEIGHT_QUANTIZATION_TEST, SkipSmallAndSharedWeights) {
+    Graph graph;
+    auto* input   = AddTensor(graph, "input", {1, 4});
+    auto* weights = AddTensor(graph, "weights", {4, 4});
+    auto* output1 = AddTensor(graph, "output1", {1, 4});
+    auto* output2 = AddTensor(graph, "output2", {1, 4});
+    graph.SetBuffer(weights->GetID(), std::vector<float>(16, 1.0f));
+    graph.AddOperator(OperatorType::FULLY_CONNECTED, {input, weights}, {output1});
+    EXPECT_TRUE(WeightQuantization::Run(graph, {}, DataType::INT8, 32).empty());
+
+    graph.AddOperator(OperatorType::BATCH_MATMUL, {input, weights}, {output2});
+    EXPECT_TRUE(WeightQuantization::Run(graph, {}, DataType::INT8, 0).empty());
+    EXPECT_EQ(weights->GetDataType(), DataType::FLOAT32);
+    EXPECT_THROW(WeightQuantization::Run(graph, {"unknown"}), std::runtime_error);
+}
+
+TEST(WEIGHT_QUANTIZATION_TEST, ReportInExecutionOrder) {
+    // A chain of fully-connected layers, added out of order.
+    Graph                  graph;
+    std::vector<DataBlob*> activations;
+    for (int layer = 0; layer <= 8; layer++) {
+        activations.push_back(AddTensor(graph, "activation" + std::to_string(layer), {1, 4}));
+    }
+    for (int layer : {3, 0, 6, 1, 7, 4, 2, 5}) {
+        auto* weights = AddTensor(graph, "weights" + std::to_string(layer), {4, 4});
+        graph.SetBuffer(weights->GetID(), std::vector<float>(16, 0.5f + layer));
+        graph.AddOperator(OperatorType::FULLY_CONNECTED, {activations[layer], weights}, {activations[layer + 1]});
+    }
+
+    auto quantized_weights = WeightQuantization::Run(graph, {}, DataType::INT8, 0, 4);
+    ASSERT_EQ(quantized_weights.size(), 8u);
+    for (size_t layer = 0; layer < quantized_weights.size(); layer++) {
+        EXPECT_EQ(quantized_weights[layer].weights, "weights" + std::to_string(layer));
+    }
+}
+
+TEST(WEIGHT_QUANTIZATION_TEST, QuantizeToInt4) {
+    Graph graph;
+    auto* input   = AddTensor(graph, "input", {1, 3});
+    auto* weights = AddTensor(graph, "weights", {2, 3});
+    auto* output  = AddTensor(graph, "output", {1, 2});
+    graph.SetBuffer(weights->GetID(), std::vector<float>({1, -2, 0.5, 0.7, 0.2, -0.35}));
+    graph.AddOperator(OperatorType::FULLY_CONNECTED, {input, weights}, {output});
+
+    // Float weights to int8 first, then the int8 weights to int4.
+    WeightQuantization::Run(graph, {}, DataType::INT8, 0);
+    auto quantized_weights = WeightQuantization::Run(graph, {}, DataType::INT4, 0);
+    ASSERT_EQ(quantized_weights.size(), 1u);
+    EXPECT_EQ(quantized_weights[0].original_bytes, 6u);
+    EXPECT_EQ(quantized_weights[0].quantized_bytes, 3u);
+
+    EXPECT_EQ(weights->GetDataType(), DataType::INT4);
+    const auto* buffer = graph.GetBuffer(weights->GetID());
+    EXPECT_EQ(Int4Buffer::Unpack(buffer->data(), 6), std::vector<int8_t>({4, -7, 2, 7, 2, -4}));
+    EXPECT_EQ(Int4Buffer(buffer->data(), 6)[1], -7);
+    EXPECT_EQ(buffer->at(0), 0x94);
+    EXPECT_NEAR(weights->GetQuantParam().scales[0], 2.0f / 7, 1e-6);
+    EXPECT_NEAR(weights->GetQuantParam().scales[1], 0.7f / 7, 1e-3);
+
+    // BATCH_MATMUL has no int4 kernel.
+    auto* bmm_weights = AddTensor(graph, "bmm_weights", {3, 2});
+    auto* bmm_output  = AddTensor(graph, "bmm_output", {1, 2});
+    graph.SetBuffer(bmm_weights->GetID(), std::vector<float>(6, 1.0f));
+    graph.AddOperator(OperatorType::BATCH_MATMUL, {input, bmm_weights}, {bmm_output});
+    EXPECT_TRUE(WeightQuantization::Run(graph, {"bmm_output"}, DataType::INT4, 0).empty());
+    EXPECT_THROW(WeightQuantization::Run(graph, {}, DataType::INT16, 0), std::runtime_error);
+}
@@ -0,0 +1,273 @@
+#include "transforms/weight_sharding.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "googletest/include/gtest/gtest.h"
+#include "test_utils.h"
+
+namespace {
+// input [2, 4] -> FULLY_CONNECTED with weights [6, 4] and bias [6] -> output [2, 6], fused ReLU
+Operator* BuildModel(Graph& graph) {
+    auto* fc = BuildFullyConnected(graph, 2, 4, 6);
+
+    std::vector<float> weights_data(24);
+    for (size_t index = 0; index < weights_data.size(); index++) {
+        weights_data[index] = index;
+    }
+    graph.SetBuffer(fc->GetInputBlob(1)->GetID(), weights_data);
+    graph.SetBuffer(fc->GetInputBlob(2)->GetID(), std::vector<float>({0, 1, 2, 3, 4, 5}));
+    fc->GetOption<FullyConnectedOption>()->activation_type = OperatorType::ReLU;
+    return fc;
+}
+
+std::vector<float> ReadFloats(const Graph& graph, const DataBlob* blob) {
+    const auto*        buffer = graph.GetBuffer(blob->GetID());
+    std::vector<float> values(buffer->size() / sizeof(float));
+    memcpy(values.data(), buffer->data(), buffer->size());
+    return values;
+}
+
+const Operator* FindOperator(const Graph& graph, OperatorType op_type) {
+    for (const auto* op : graph.GetOperators()) {
+        if (op->GetOpType() == op_type) {
+            return op;
+        }
+    }
+    return nullptr;
+}
+}  // namespace
+
+TEST(WEIGHT_SHARDING_TEST, ShardOutputChannels) {
+    Graph graph;
+    BuildModel(graph);
+    auto sharded_ops = WeightSharding::Run(graph, {"output"}, WeightSharding::Axis::OUTPUT_CHANNEL, 3, 1);
+    ASSERT_EQ(sharded_ops.size(), 1u);
+    EXPECT_EQ(sharded_ops[0].combine_type, OperatorType::CONCAT);
+    EXPECT_EQ(sharded_ops[0].channels, 6);
+    EXPECT_EQ(sharded_ops[0].partials, std::vector<std::string>({"output_shard0", "output_shard1", "output_shard2"}));
+
+    const auto* fc = FindOperator(graph, OperatorType::FULLY_CONNECTED);
+    ASSERT_NE(fc, nullptr);
+    EXPECT_EQ(fc->GetInputBlob(1)->GetShape().GetDims(), std::vector<int>({2, 4}));
+    EXPECT_EQ(ReadFloats(graph, fc->GetInputBlob(1)), std::vector<float>({8, 9, 10, 11, 12, 13, 14, 15}));
+    EXPECT_EQ(ReadFloats(graph, fc->GetInputBlob(2)), std::vector<float>({2, 3}));
+    EXPECT_EQ(fc->GetOutputBlob(0)->GetName(), "output_shard1");
+    EXPECT_EQ(fc->GetOutputBlob(0)->GetShape().GetDims(), std::vector<int>({2, 2}));
+    EXPECT_EQ(fc->GetOption<FullyConnectedOption>()->activation_type, OperatorType::ReLU);
+
+    const auto* concat = FindOperator(graph, OperatorType::CONCAT);
+    ASSERT_NE(concat, nullptr);
+    EXPECT_EQ(concat->GetOption<ConcatOption>()->axis, 1);
+    EXPECT_EQ(concat->GetOutputBlob(0)->GetName(), "output");
+    EXPECT_EQ(concat->GetInputBlob(1), fc->GetOutputBlob(0));
+
+    // Full weights are gone, slices of the other shards are exchanged through graph inputs and outputs.
+    for (const auto* blob : graph.GetDataBlobs()) {
+        EXPECT_NE(blob->GetName(), "weights");
+    }
+    EXPECT_EQ(graph.GetGraphInputs().size(), 3u);
+    EXPECT_EQ(graph.GetDataBlob(graph.GetGraphInputs()[1])->GetName(), "output_shard0");
+    EXPECT_EQ(graph.GetDataBlob(graph.GetGraphOutputs()[1])->GetName(), "output_shard1");
+}
+
+TEST(WEIGHT_SHARDING_TEST, ShardInputChannels) {
+    Graph graph;
+    BuildModel(graph);
+    WeightSharding::Run(graph, {"output"}, WeightSharding::Axis::INPUT_CHANNEL, 2, 1);
+
+    const auto* split = FindOperator(graph, OperatorType::SPLIT);
+    ASSERT_NE(split, nullptr);
+    std::vector<int64_t> split_axis;
+    ASSERT_TRUE(graph.GetIntegerConstant(split->GetInputIDs()[0], split_axis));
+    EXPECT_EQ(split_axis, std::vector<int64_t>({1}));
+    EXPECT_EQ(split->GetOutputIDs().size(), 2u);
+
+    // Shard 1 reads the second half of input channels and leaves bias and activation to shard 0 and the sum.
+    const auto* fc = FindOperator(graph, OperatorType::FULLY_CONNECTED);
+    ASSERT_NE(fc, nullptr);
+    EXPECT_EQ(fc->GetInputIDs().size(), 2u);
+    EXPECT_EQ(fc->GetInputBlob(0), split->GetOutputBlob(1));
+    EXPECT_EQ(ReadFloats(graph, fc->GetInputBlob(1)),
+              std::vector<float>({2, 3, 6, 7, 10, 11, 14, 15, 18, 19, 22, 23}));
+    EXPECT_EQ(fc->GetOption<FullyConnectedOption>()->activation_type, OperatorType::NONE);
+
+    const auto* add = FindOperator(graph, OperatorType::ADD);
+    ASSERT_NE(add, nullptr);
+    EXPECT_EQ(add->GetInputBlob(0)->GetName(), "output_shard0");
+    EXPECT_EQ(add->GetInputBlob(1), fc->GetOutputBlob(0));
+    EXPECT_EQ(add->GetOutputBlob(0)->GetName(), "output");
+    EXPECT_EQ(add->GetOption<AddOption>()->activation_type, OperatorType::ReLU);
+}
+
+TEST(WEIGHT_SHARDING_TEST, RejectUnevenShards) {
+    Graph graph;
+    BuildModel(graph);
+    EXPECT_THROW(WeightSharding::Run(graph, {"output"}, WeightSharding::Axis::OUTPUT_CHANNEL, 4, 0),
+                 std::runtime_error);
+    EXPECT_EQ(WeightSharding::FindCandidates(graph, 0), std::vector<std::string>({"output"}));
+    EXPECT_TRUE(WeightSharding::FindCandidates(graph, 1024).empty());
+}
+
+TEST(WEIGHT_SHARDING_TEST, ShardDependentOperators) {
+    // input -> FULLY_CONNECTED -> hidden [2, 4] -> FULLY_CONNECTED -> output [2, 6], and input -> FULLY_CONNECTED ->
+    // side [2, 2] on its own branch.
+    Graph graph;
+    auto* fc     = BuildModel(graph);
+    auto* input  = fc->GetInputBlob(0);
+    auto* hidden = AddTensor(graph, "hidden", {2, 4});
+    auto* first  = AddTensor(graph, "first_weights", {4, 4});
+    auto* side   = AddTensor(graph, "side", {2, 2});
+    auto* third  = AddTensor(graph, "side_weights", {2, 4});
+    graph.SetBuffer(first->GetID(), std::vector<float>(16, 1.0f));
+    graph.SetBuffer(third->GetID(), std::vector<float>(8, 1.0f));
+    graph.AddOperator(OperatorType::FULLY_CONNECTED, {input, first}, {hidden});
+    graph.AddOperator(OperatorType::FULLY_CONNECTED, {input, third}, {side});
+    fc->SetInputBlob(0, hidden);
+    input->RemoveConsumer(fc);
+    hidden->AddConsumer(fc);
+    graph.SetGraphOutputs({fc->GetOutputIDs()[0], side->GetID()});
+
+    EXPECT_THROW(WeightSharding::Run(graph, {"side", "side"}, WeightSharding::Axis::OUTPUT_CHANNEL, 2, 0),
+                 std::runtime_error);
+    EXPECT_EQ(graph.GetOperators().size(), 3u);
+
+    // Candidates are picked by their weights alone, whether they depend on each other or not.
+    auto candidates = WeightSharding::FindCandidates(graph, 0);
+    std::sort(candidates.begin(), candidates.end());
+    EXPECT_EQ(candidates, std::vector<std::string>({"hidden", "output", "side"}));
+    EXPECT_EQ(WeightSharding::FindCandidates(graph, 64), std::vector<std::string>({"hidden", "output"}));
+
+    // `output` waits for the exchange of the partial results of `hidden`.
+    auto sharded_ops =
+        WeightSharding::Run(graph, {"output", "hidden", "side"}, WeightSharding::Axis::OUTPUT_CHANNEL, 2, 1);
+    ASSERT_EQ(sharded_ops.size(), 3u);
+    EXPECT_EQ(sharded_ops[0].stage, 1u);
+    EXPECT_EQ(sharded_ops[1].stage, 0u);
+    EXPECT_EQ(sharded_ops[2].stage, 0u);
+
+    auto stages = WeightSharding::SplitStages(graph, sharded_ops);
+    ASSERT_EQ(stages.size(), 3u);
+    auto names = [&](const std::vector<BLOBID_T>& blob_ids) {
+        std::vector<std::string> blob_names;
+        for (auto blob_id : blob_ids) {
+            blob_names.push_back(graph.GetDataBlob(blob_id)->GetName());
+        }
+        std::sort(blob_names.begin(), blob_names.end());
+        return blob_names;
+    };
+    auto op_types = [](const GraphView& stage) {
+        std::vector<OperatorType> types;
+        for (const auto* op : stage.GetOperators()) {
+            types.push_back(op->GetOpType());
+        }
+        std::sort(types.begin(), types.end());
+        return types;
+    };
+    EXPECT_EQ(op_types(stages[0]),
+              std::vector<OperatorType>({OperatorType::FULLY_CONNECTED, OperatorType::FULLY_CONNECTED}));
+    EXPECT_EQ(names(stages[0].GetGraphInputs()), std::vector<std::string>({"input"}));
+    EXPECT_EQ(names(stages[0].GetGraphOutputs()), std::vector<std::string>({"hidden_shard1", "side_shard1"}));
+    EXPECT_EQ(op_types(stages[1]), std::vector<OperatorType>({OperatorType::CONCAT, OperatorType::CONCAT,
+                                                              OperatorType::FULLY_CONNECTED}));
+    EXPECT_EQ(names(stages[1].GetGraphInputs()),
+              std::vector<std::string>({"hidden_shard0", "hidden_shard1", "side_shard0", "side_shard1"}));
+    EXPECT_EQ(names(stages[1].GetGraphOutputs()), std::vector<std::string>({"output_shard1", "side"}));
+    EXPECT_EQ(op_types(stages[2]), std::vector<OperatorType>({OperatorType::CONCAT}));
+    EXPECT_EQ(names(stages[2].GetGraphInputs()), std::vector<std::string>({"output_shard0", "output_shard1"}));
+    EXPECT_EQ(names(stages[2].GetGraphOutputs()), std::vector<std::string>({"output"}));
+}
+
+TEST(WEIGHT_SHARDING_TEST, ShardLayerStack) {
+    // Four FULLY_CONNECTED layers with weights [64, 64] in a chain, every one of them sharded.
+    auto build = [](Graph& graph) {
+        auto* activation = AddTensor(graph, "input", {1, 64});
+        graph.SetGraphInputs({activation->GetID()});
+        for (int layer = 0; layer < 4; layer++) {
+            auto* weights = AddTensor(graph, "weights" + std::to_string(layer), {64, 64});
+            auto* output  = AddTensor(graph, "layer" + std::to_string(layer), {1, 64});
+            graph.SetBuffer(weights->GetID(), std::vector<float>(64 * 64, layer));
+            auto* fc                = graph.AddOperator(OperatorType::FULLY_CONNECTED, {activation, weights}, {output});
+            auto* option            = fc->GetOption<FullyConnectedOption>();
+            option->activation_type = OperatorType::NONE;
+            activation              = output;
+        }
+        graph.SetGraphOutputs({activation->GetID()});
+    };
+    auto weight_bytes = [](const Graph& graph) {
+        size_t bytes = 0;
+        for (const auto* blob : graph.GetDataBlobs()) {
+            const auto* buffer = graph.GetBuffer(blob->GetID());
+            bytes += buffer != nullptr ? buffer->size() : 0;
+        }
+        return bytes;
+    };
+
+    Graph original;
+    build(original);
+    auto candidates = WeightSharding::FindCandidates(original, 1024);
+    EXPECT_EQ(candidates, std::vector<std::string>({"layer0", "layer1", "layer2", "layer3"}));
+    size_t total_bytes = weight_bytes(original);
+    for (uint32_t shard = 0; shard < 4; shard++) {
+        Graph graph;
+        build(graph);
+        auto sharded_ops = WeightSharding::Run(graph, candidates, WeightSharding::Axis::OUTPUT_CHANNEL, 4, shard);
+        ASSERT_EQ(sharded_ops.size(), 4u);
+        for (uint32_t layer = 0; layer < 4; layer++) {
+            EXPECT_EQ(sharded_ops[layer].stage, layer);
+        }
+        // Every shard holds a quarter of the weights of every layer.
+        EXPECT_EQ(weight_bytes(graph), total_bytes / 4);
+        EXPECT_EQ(WeightSharding::SplitStages(graph, sharded_ops).size(), 5u);
+    }
+}
+
+TEST(WEIGHT_SHARDING_TEST, ShardSquarePerChannelWeights) {
+    // Hybrid FULLY_CONNECTED with int8 weights [4, 4] quantized per output channel.
+    auto build = [](Graph& graph) {
+        auto* input   = AddTensor(graph, "input", {2, 4});
+        auto* weights = AddTensor(graph, "weights", {4, 4});
+        auto* output  = AddTensor(graph, "output", {2, 4});
+        weights->SetDataType(DataType::INT8);
+        std::vector<int8_t> weights_data(16);
+        for (size_t index = 0; index < weights_data.size(); index++) {
+            weights_data[index] = index;
+        }
+        graph.SetBuffer(weights->GetID(), weights_data);
+        auto& quant_param               = weights->CreateQuantParam();
+        quant_param.scales              = std::vector<float>({0.1f, 0.2f, 0.3f, 0.4f});
+        quant_param.zero_points         = std::vector<int64_t>(4, 0);
+        quant_param.quantized_dimension = 0;
+        graph.AddOperator(OperatorType::FULLY_CONNECTED, {input, weights}, {output});
+        graph.SetGraphInputs({input->GetID()});
+        graph.SetGraphOutputs({output->GetID()});
+    };
+    auto read_weights = [](const Graph& graph, const Operator& fc) {
+        const auto* buffer = graph.GetBuffer(fc.GetInputIDs()[1]);
+        return std::vector<int8_t>(buffer->begin(), buffer->end());
+    };
+
+    // Input channels are columns, every row keeps its own scale.
+    Graph by_input;
+    build(by_input);
+    WeightSharding::Run(by_input, {"output"}, WeightSharding::Axis::INPUT_CHANNEL, 2, 1);
+    const auto* fc = FindOperator(by_input, OperatorType::FULLY_CONNECTED);
+    ASSERT_NE(fc, nullptr);
+    EXPECT_EQ(read_weights(by_input, *fc), std::vector<int8_t>({2, 3, 6, 7, 10, 11, 14, 15}));
+    const auto& input_param = fc->GetInputBlob(1)->GetQuantParam();
+    EXPECT_EQ(input_param.scales, std::vector<float>({0.1f, 0.2f, 0.3f, 0.4f}));
+    EXPECT_EQ(input_param.zero_points.size(), 4u);
+    EXPECT_EQ(input_param.quantized_dimension, 0);
+
+    Graph by_output;
+    build(by_output);
+    WeightSharding::Run(by_output, {"output"}, WeightSharding::Axis::OUTPUT_CHANNEL, 2, 1);
+    fc = FindOperator(by_output, OperatorType::FULLY_CONNECTED);
+    ASSERT_NE(fc, nullptr);
+    EXPECT_EQ(read_weights(by_output, *fc), std::vector<int8_t>({8, 9, 10, 11, 12, 13, 14, 15}));
+    const auto& output_param = fc->GetInputBlob(1)->GetQuantParam();
+    EXPECT_EQ(output_param.scales, std::vector<float>({0.3f, 0.4f}));
+    EXPECT_EQ(output_param.zero_points.size(), 2u);
+    EXPECT_EQ(output_param.quantized_dimension, 0);
+}